@@ -1,6 +1,7 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include "interfaces/IDirectoryWatcher.h"
 #include "interfaces/IFileSystem.h"
 #include "interfaces/IHardwareInterface.h"
 #include "interfaces/IMetadataReader.h"
@@ -8,6 +9,7 @@
 #include "interfaces/IPlaybackEngine.h"
 #include "interfaces/IViewFactory.h"
 
+#include "app/model/AlbumArtStore.h"
 #include "app/model/History.h"
 #include "app/model/Library.h"
 #include "app/model/PlaybackState.h"
@@ -21,6 +23,7 @@
 
 #include "app/view/MainWindow.h"
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -28,6 +31,9 @@
 struct SDL_Window;
 struct SDL_Renderer;
 
+class UnreadableFileCache;
+struct HybridReaderStats;
+
 /**
  * @file Application.h
  * @brief Main application class - Dependency Injection Container
@@ -94,6 +100,15 @@ class Application
         return shouldQuit_;
     }
 
+    /**
+     * @brief Time from the start of init() to the end of the first frame
+     * @return Zero until a frame has been completed
+     */
+    std::chrono::milliseconds getTimeToFirstFrame() const
+    {
+        return timeToFirstFrame_;
+    }
+
   private:
     // SDL resources
     SDL_Window *window_;
@@ -103,7 +118,11 @@ class Application
     // Services (concrete implementations - owned)
     std::unique_ptr<IPlaybackEngine> playbackEngine_;
     std::unique_ptr<IFileSystem> fileSystem_;
+    std::unique_ptr<IDirectoryWatcher> directoryWatcher_; // Null when watchLibrary is off
     std::unique_ptr<IMetadataReader> metadataReader_;
+    std::shared_ptr<IMetadataReader> mpvReader_; // mpv probe pool shared by every metadata reader
+    std::shared_ptr<UnreadableFileCache> unreadableCache_;
+    std::shared_ptr<HybridReaderStats> readerStats_; // Read counters of every metadata reader
     std::unique_ptr<IHardwareInterface> hardwareInterface_;
     std::unique_ptr<IPersistence> persistence_;
     std::unique_ptr<IViewFactory> viewFactory_;
@@ -113,6 +132,7 @@ class Application
     std::unique_ptr<PlaylistManager> playlistManager_;
     std::unique_ptr<History> history_;
     std::unique_ptr<PlaybackState> playbackState_;
+    std::unique_ptr<AlbumArtStore> albumArtStore_;
 
     // Controllers (owned)
     std::unique_ptr<LibraryController> libraryController_;
@@ -129,6 +149,16 @@ class Application
     bool initialized_;
     bool headless_;
 
+    // Startup timing: library verification and refresh wait for the first frame
+    std::chrono::steady_clock::time_point initStarted_;
+    std::chrono::milliseconds timeToFirstFrame_{0};
+    bool firstFrameDone_ = false;
+
+    /**
+     * @brief Record time-to-first-frame and start the deferred startup work
+     */
+    void onFirstFrame();
+
     /**
      * @brief Initialize SDL and ImGui
      * @return true if successful
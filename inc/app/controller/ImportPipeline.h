@@ -0,0 +1,183 @@
+#ifndef IMPORT_PIPELINE_H
+#define IMPORT_PIPELINE_H
+
+#include "app/model/Library.h"
+#include "interfaces/IFileSystem.h"
+#include "interfaces/IMetadataReader.h"
+#include "utils/BoundedQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file ImportPipeline.h
+ * @brief Streaming import: scan (or a path list) -> read metadata -> commit in batches
+ *
+ * Replaces "collect every path, then add files one at a time". Each stage
+ * runs on its own thread(s) and hands work over through bounded queues, so
+ * a fast scanner cannot run far ahead of the metadata readers and memory
+ * stays flat however large the tree is.
+ */
+
+/**
+ * @brief Counters describing an import in progress
+ */
+struct ImportProgress
+{
+    size_t discovered = 0; ///< Paths found by the scanner
+    size_t processed = 0;  ///< Paths whose metadata has been read (or that were skipped)
+    size_t added = 0;      ///< Tracks committed to the library
+    bool running = false;
+    bool cancelled = false;
+};
+
+/**
+ * @brief Bounded, back-pressured import pipeline
+ *
+ * Stages:
+ * - source: IFileSystem::scanDirectoryStreaming() or a fixed path list pushes
+ *   numbered paths into a bounded queue
+ * - readers: N workers stat and tag each new path and push MediaFiles onward,
+ *   each through its own IMetadataReader when a reader factory is set
+ * - committer: restores source order and commits with Library::addMediaBatch(),
+ *   one lock and one notification per batch. Readers stay within
+ *   Options::reorderWindow of the next path to commit, so one slow read
+ *   holds back the pipeline instead of piling results up behind it.
+ *
+ * cancel() is cooperative: the scanner stops, readers drop queued paths, and
+ * files already read are still committed. The destructor cancels and joins.
+ *
+ * **Thread Safety**: start(), cancel(), wait() and getProgress() may be called
+ * from any thread. The progress callback runs on the committer thread.
+ */
+class ImportPipeline
+{
+  public:
+    struct Options
+    {
+        size_t readers = 0;         ///< Metadata workers (0 = one per core)
+        size_t queueCapacity = 512; ///< Slots in each inter-stage queue
+        size_t batchSize = 256;     ///< Files per addMediaBatch() call
+        std::chrono::milliseconds maxBatchDelay{250}; ///< Commit a partial batch after this long
+
+        /**
+         * How far past the oldest uncommitted path readers may go. Results that
+         * overtake a slow read wait in the committer to restore source order;
+         * this bounds how many.
+         */
+        size_t reorderWindow = 1024;
+
+        /**
+         * Builds one private reader per worker so readers that are not
+         * thread-safe, or that serialize internally, do not share state.
+         * When unset (or when it returns null) the shared reader is used.
+         */
+        std::function<std::unique_ptr<IMetadataReader>()> readerFactory;
+    };
+
+    using ProgressCallback = std::function<void(const ImportProgress &)>;
+
+    ImportPipeline(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader);
+    ImportPipeline(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader,
+                   const Options &options);
+
+    /**
+     * @brief Destructor - cancels and waits for every stage
+     */
+    ~ImportPipeline();
+
+    ImportPipeline(const ImportPipeline &) = delete;
+    ImportPipeline &operator=(const ImportPipeline &) = delete;
+
+    /**
+     * @brief Set a callback invoked after each committed batch and once at the end
+     * Must be set before start().
+     */
+    void setProgressCallback(ProgressCallback callback)
+    {
+        progressCallback_ = std::move(callback);
+    }
+
+    /**
+     * @brief Launch the stages and return immediately
+     * @param directoryPath Root to scan recursively
+     * @param extensions File extensions to import
+     * @return false if already started or a dependency is missing
+     */
+    bool start(const std::string &directoryPath, const std::vector<std::string> &extensions);
+
+    /**
+     * @brief Launch the stages over a fixed list of files
+     * The file system is optional here; it only supplies fingerprints.
+     * @param filepaths Files to import, committed in this order
+     * @return false if already started or the library or reader is missing
+     */
+    bool start(std::vector<std::string> filepaths);
+
+    /**
+     * @brief Ask every stage to stop as soon as possible
+     */
+    void cancel();
+
+    /**
+     * @brief Block until every stage has finished
+     */
+    void wait();
+
+    ImportProgress getProgress() const;
+
+  private:
+    Library *library_;
+    IFileSystem *fileSystem_;
+    IMetadataReader *metadataReader_;
+    Options options_;
+    ProgressCallback progressCallback_;
+
+    /**
+     * @brief A path or its result, tagged with its position in the source
+     * Skipped paths travel as null files so the committer can move past them.
+     */
+    template <typename T> struct Sequenced
+    {
+        size_t sequence = 0;
+        T value;
+    };
+
+    BoundedQueue<Sequenced<std::string>> paths_;
+    BoundedQueue<Sequenced<std::shared_ptr<MediaFile>>> files_;
+
+    std::atomic<size_t> discovered_{0};
+    std::atomic<size_t> processed_{0};
+    std::atomic<size_t> added_{0};
+    std::atomic<size_t> activeReaders_{0};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancelled_{false};
+
+    std::mutex windowMutex_;
+    std::condition_variable windowCv_;
+    size_t nextToCommit_ = 0; ///< Sequence the committer waits for (guarded by windowMutex_)
+
+    std::mutex threadsMutex_;
+    std::vector<std::thread> threads_;
+    bool started_ = false;
+
+    bool launch(std::function<void()> source, const std::string &description, size_t maxReaders);
+    bool enqueue(size_t sequence, const std::string &path);
+    void readStage();
+
+    /**
+     * @brief Block a reader until a sequence is within the reorder window
+     * @return false if the import was cancelled meanwhile
+     */
+    bool waitForWindow(size_t sequence);
+    void commitStage();
+    void commit(std::vector<std::shared_ptr<MediaFile>> &batch);
+};
+
+#endif // IMPORT_PIPELINE_H
@@ -1,12 +1,17 @@
 #ifndef LIBRARY_CONTROLLER_H
 #define LIBRARY_CONTROLLER_H
 
+#include "app/controller/ImportPipeline.h"
 #include "app/controller/PlaybackController.h"
 #include "app/model/Library.h"
+#include "interfaces/IDirectoryWatcher.h"
 #include "interfaces/IFileSystem.h"
 #include "interfaces/IMetadataReader.h"
 #include "interfaces/ITrackListController.h"
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <thread>
 
 /**
  * @file LibraryController.h
@@ -17,6 +22,16 @@
  * Follows Single Responsibility Principle - only manages library operations.
  */
 
+/**
+ * @brief Outcome of the last refreshLibrary() pass
+ */
+struct RefreshStats
+{
+    int updated = 0;   ///< Tracks whose tags were re-read and changed
+    int unchanged = 0; ///< Tracks re-read because their file changed, with the same tags
+    int skipped = 0;   ///< Tracks whose fingerprint matched, so nothing was read
+};
+
 /**
  * @brief Library controller class
  *
@@ -35,14 +50,119 @@ class LibraryController : public ITrackListController
     LibraryController(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader,
                       PlaybackController *playbackController);
 
+    /**
+     * @brief Destructor - stops and joins the background maintenance pass
+     */
+    ~LibraryController() override;
+
     /**
      * @brief Add media files from a directory
+     * Runs an ImportPipeline and blocks until it finishes.
      * @param directoryPath Path to scan
      * @param recursive Scan recursively
      * @return Number of files added
      */
     int addMediaFilesFromDirectory(const std::string &directoryPath, bool recursive = true);
 
+    /**
+     * @brief Import a directory in the background
+     * Poll getImportProgress() to follow it; observers of the library see
+     * each committed batch.
+     * @param directoryPath Root to scan recursively
+     * @return false if an import is already running or dependencies are missing
+     */
+    virtual bool startDirectoryImport(const std::string &directoryPath);
+
+    /**
+     * @brief Stop the background import; files already read are still added
+     */
+    void cancelDirectoryImport();
+
+    /**
+     * @brief Stop every background import (directory and file lists) and maintenance pass
+     */
+    void cancelImports();
+
+    /**
+     * @brief Block until every background import and maintenance pass has finished
+     */
+    void waitForImports();
+
+    /**
+     * @brief Run verifyLibrary() and then refreshLibrary() on a low-priority thread
+     *
+     * Lets the UI come up on the saved library straight away: removals and
+     * re-read tags reach observers track by track as the pass goes. The pass
+     * starts by finishing the search index (Library::buildSearchIndex()).
+     * @param onFinished Called on the worker thread when the pass ends (optional)
+     * @return false if a pass is already running or the library is missing
+     */
+    bool startMaintenance(std::function<void()> onFinished = nullptr);
+
+    bool isMaintenanceRunning() const
+    {
+        return maintenanceRunning_;
+    }
+
+    /**
+     * @brief Watcher used by startWatching() (not owned)
+     */
+    void setDirectoryWatcher(IDirectoryWatcher *watcher)
+    {
+        watcher_ = watcher;
+    }
+
+    /**
+     * @brief Keep the library in step with its folders as they change
+     *
+     * Watches the library folders and the folders of tracks that were added
+     * some other way. Each debounced batch of changes is worked out on the
+     * watcher's thread (stat, folder scans, tag reads), so no full rescan is
+     * needed to pick up new, edited or deleted files. Removals run the
+     * removal callback, which edits the queue, playlists and history, so they
+     * wait for dispatchFileEvents() on the main thread.
+     * @return false without a watcher, or if it cannot start
+     */
+    bool startWatching();
+
+    /**
+     * @brief Stop the watcher; no batch is applied after this returns
+     */
+    void stopWatching();
+
+    /**
+     * @brief Remove the tracks that watcher batches found deleted
+     *
+     * Call from the main thread once per frame. The watcher thread waits
+     * for this before it goes on to the next batch, so a file deleted and
+     * written again is seen in that order.
+     */
+    void dispatchFileEvents();
+
+    /**
+     * @brief Folders imported into the library (restored from the config at startup)
+     */
+    void setLibraryFolders(const std::vector<std::string> &folders);
+
+    std::vector<std::string> getLibraryFolders() const;
+
+    /**
+     * @brief Apply one batch of file changes to the library
+     *
+     * - Removed files and folders leave the library in one batch
+     * - New files are imported in the background
+     * - Changed tracks have their tags re-read if their fingerprint moved
+     * - New folders and RESCAN folders are scanned and compared with the library
+     *
+     * Runs entirely on the calling thread, which must be the main thread.
+     */
+    void applyFileEvents(const std::vector<FileEvent> &events);
+
+    /**
+     * @brief Progress of the current or last background import
+     */
+    ImportProgress getImportProgress() const;
+
     /**
      * @brief Add a single media file
      * @param filepath Path to the media file
@@ -52,10 +172,24 @@ class LibraryController : public ITrackListController
 
     /**
      * @brief Add multiple media files asynchronously
+     *
+     * Tags are read on a worker pool sized to the machine and committed to
+     * the library in batches, in the order given. The workers are owned by
+     * the controller and joined by cancelImports()/waitForImports() or on
+     * destruction; they never outlive the library.
      * @param filepaths Vector of file paths to add
      */
     virtual void addMediaFilesAsync(const std::vector<std::string> &filepaths);
 
+    /**
+     * @brief Give every import worker its own metadata reader
+     * @param factory Creates one reader per worker (see ImportPipeline::Options)
+     */
+    void setMetadataReaderFactory(std::function<std::unique_ptr<IMetadataReader>()> factory)
+    {
+        readerFactory_ = std::move(factory);
+    }
+
     /**
      * @brief Remove media from library
      * @param filepath Path of file to remove
@@ -81,11 +215,23 @@ class LibraryController : public ITrackListController
     searchMedia(const std::string &query, const std::vector<std::string> &searchFields = {"title", "artist", "album"});
 
     /**
-     * @brief Refresh library (reload metadata for all files)
+     * @brief Refresh library (reload metadata for changed files)
+     *
+     * Each track carries the stat fingerprint (size, mtime, inode) of the file
+     * its tags were read from. Files whose fingerprint still matches are
+     * skipped without being opened; the rest are re-read and re-stamped.
      * @return Number of files refreshed
      */
     virtual int refreshLibrary();
 
+    /**
+     * @brief Counts from the most recent refreshLibrary()
+     */
+    const RefreshStats &getLastRefreshStats() const
+    {
+        return lastRefreshStats_;
+    }
+
     /**
      * @brief Get all track paths in the library
      * @return Set of file paths
@@ -122,6 +268,68 @@ class LibraryController : public ITrackListController
     IMetadataReader *metadataReader_;
     PlaybackController *playbackController_;
     std::function<void(const std::string &)> onTrackRemovedCallback_;
+    RefreshStats lastRefreshStats_;
+
+    std::function<std::unique_ptr<IMetadataReader>()> readerFactory_;
+    mutable std::mutex importMutex_;
+    std::unique_ptr<ImportPipeline> import_;                   ///< Directory import; joined on destruction
+    std::vector<std::unique_ptr<ImportPipeline>> fileImports_; ///< addMediaFilesAsync() runs
+
+    ImportPipeline::Options importOptions() const;
+
+    std::thread maintenanceThread_;
+    std::atomic<bool> maintenanceRunning_{false};
+    std::atomic<bool> maintenanceCancelled_{false};
+
+    static constexpr size_t VERIFY_CHUNK = 1024; ///< Files per IFileSystem::verifyFiles() call
+
+    IDirectoryWatcher *watcher_ = nullptr;
+    std::atomic<bool> watching_{false};
+    std::mutex applyMutex_;   ///< One batch of file events at a time
+    std::mutex removalsMutex_;
+    std::condition_variable removalsApplied_;
+    std::set<std::string> pendingRemovals_; ///< Found by the watcher thread, removed by dispatchFileEvents()
+    uint64_t removalsQueued_ = 0;           ///< Batches handed to the main thread
+    uint64_t removalsDone_ = 0;             ///< Batches dispatchFileEvents() has removed
+    std::mutex refreshMutex_; ///< Maintenance and watcher batches may both re-read tags
+    mutable std::mutex foldersMutex_;
+    std::vector<std::string> libraryFolders_;
+
+    /**
+     * @brief Remember an imported folder and watch it if watching
+     */
+    void addLibraryFolder(const std::string &folder);
+
+    /**
+     * @param fromWatcher Hand removals to dispatchFileEvents() instead of removing them here
+     */
+    void applyFileEvents(const std::vector<FileEvent> &events, bool fromWatcher);
+
+    /**
+     * @brief Queue removals for the main thread and wait until they are done
+     * @return false if watching stopped first
+     */
+    bool removeOnMainThread(const std::set<std::string> &paths);
+
+    /**
+     * @brief Compare a folder on disk with the tracks the library holds under it
+     */
+    void reconcileFolder(const std::string &folder, const std::unordered_set<std::string> &known,
+                         std::vector<std::string> &removed, std::vector<std::string> &added,
+                         std::vector<FileCheck> &checks);
+
+    /**
+     * @param cancelled Stops the pass early when set (null for none)
+     * @param verified Receives the missing and changed files (optional)
+     */
+    int verifyTracks(const std::atomic<bool> *cancelled, VerifyResult *verified);
+
+    /**
+     * @param cancelled Stops the pass early when set (null for none)
+     * @param verified Result of a verifyTracks() just before: only its changed
+     *                 files are read, with no second stat (null stats every track)
+     */
+    int refreshTracks(const std::atomic<bool> *cancelled, const VerifyResult *verified);
 };
 
 #endif // LIBRARY_CONTROLLER_H
@@ -24,7 +24,7 @@
  * @brief Playback controller class
  *
  * Orchestrates playback operations.
- * Implements IObserver to receive hardware commands.
+ * Implements IObserver to receive hardware commands and engine events.
  * Manages playback state, history, and playlist progression.
  */
 class PlaybackController : public IObserver
@@ -140,6 +140,23 @@ class PlaybackController : public IObserver
         return globalRepeatMode_;
     }
 
+    /**
+     * @brief Enable or disable gapless playback
+     *
+     * When enabled, the track that will follow the current one is handed to
+     * the engine PRELOAD_LEAD_SECONDS before the end, so the switch at the
+     * end of the track needs no new load. Edits to the play queue or the
+     * current playlist after that point are picked up on the next
+     * updateTime(), which hands the engine the new upcoming track.
+     * @param enabled true to preload upcoming tracks
+     */
+    void setGapless(bool enabled);
+
+    bool isGapless() const
+    {
+        return gapless_;
+    }
+
     /**
      * @brief Play a track within a context (queue)
      * @param context List of tracks (queue)
@@ -149,7 +166,9 @@ class PlaybackController : public IObserver
 
     /**
      * @brief Update from observed subject (Observer pattern)
-     * Handles hardware events
+     * Handles hardware events, and engine errors and ends of file as the
+     * engine's dispatchEvents() reports them: a finished track advances in
+     * the frame its end is dispatched.
      * @param subject Subject that changed
      */
     void update(void *subject) override;
@@ -169,6 +188,22 @@ class PlaybackController : public IObserver
      */
     void handlePlaybackFinished();
 
+    /**
+     * @brief Track next() would play after the current one, without changing any state
+     * @return Upcoming track, nullptr at the end of the playlist or queue
+     */
+    std::shared_ptr<MediaFile> peekUpcomingTrack();
+
+    /**
+     * @brief Hand the upcoming track to the engine (gapless mode)
+     */
+    void preloadUpcoming();
+
+    /**
+     * @brief Whether the queue or the current playlist changed since preloadUpcoming()
+     */
+    bool preloadIsStale() const;
+
   public:
     /**
      * @brief Update playback time
@@ -199,6 +234,13 @@ class PlaybackController : public IObserver
     double lastPlayTime_ = 0.0;
     std::string lastPlayedPath_;
 
+    // Gapless state
+    static constexpr double PRELOAD_LEAD_SECONDS = 10.0; // Before the end of the track
+    bool gapless_ = false;
+    bool preloadDone_ = false; // The upcoming track of the current one was handed to the engine
+    size_t preloadQueueRevision_ = 0;    // Queue revision the preload was worked out from
+    size_t preloadPlaylistRevision_ = 0; // Same for the current playlist
+
     /**
      * @brief Add track to history
      * @param track Track to add
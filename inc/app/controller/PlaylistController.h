@@ -62,6 +62,16 @@ class PlaylistController
      */
     bool addToPlaylist(const std::string &playlistName, const std::string &filepath);
 
+    /**
+     * @brief Add a track object to a playlist
+     * Unlike addToPlaylist() the track does not have to be in the library
+     * (e.g. a history entry or the current track).
+     * @param playlistName Playlist to add to
+     * @param track Track to add
+     * @return true if added successfully
+     */
+    bool addTrackToPlaylist(const std::string &playlistName, std::shared_ptr<MediaFile> track);
+
     /**
      * @brief Add track to playlist and library
      * If track not in library, adds it first
@@ -0,0 +1,99 @@
+#ifndef ALBUM_ART_STORE_H
+#define ALBUM_ART_STORE_H
+
+#include "interfaces/IMetadataReader.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file AlbumArtStore.h
+ * @brief On-demand, size-bounded cache of embedded cover images
+ *
+ * Tracks only record whether they have a cover (MediaMetadata::hasAlbumArt).
+ * The bytes are read when a view asks for them and kept in a least-recently
+ * used cache keyed by content, so the cover shared by every track of an
+ * album is held once.
+ */
+
+/**
+ * @brief Content-addressed LRU album art cache
+ *
+ * Each path maps to a content key (a hash of the image bytes). Images are
+ * evicted oldest-first once their total size passes the capacity; the
+ * path mapping survives, and an evicted image is simply read again on the
+ * next request. Returned images stay valid while the caller holds them,
+ * even if the cache drops its own reference.
+ *
+ * **Thread Safety**: All methods may be called from any thread. File reads
+ * happen outside the lock.
+ */
+class AlbumArtStore
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 32 * 1024 * 1024;
+
+    /**
+     * @param reader Source of the images (may be null: the store then only serves put() entries)
+     * @param capacityBytes Upper bound on cached image bytes
+     */
+    explicit AlbumArtStore(IMetadataReader *reader, size_t capacityBytes = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Get the cover of a file, reading it on a miss
+     * @param filepath Media file
+     * @return The image, or null if the file has none
+     */
+    std::shared_ptr<const AlbumArt> get(const std::string &filepath);
+
+    /**
+     * @brief Cache an image already in memory for a file
+     * @param filepath Media file the image belongs to
+     * @param art Image; identical bytes already cached are reused
+     * @return The cached image
+     */
+    std::shared_ptr<const AlbumArt> put(const std::string &filepath, AlbumArt art);
+
+    /**
+     * @brief Number of distinct images held
+     */
+    size_t size() const;
+
+    /**
+     * @brief Image bytes held
+     */
+    size_t memoryUsage() const;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+  private:
+    using Key = uint64_t; ///< 0 is reserved for "this file has no cover"
+
+    struct Entry
+    {
+        std::shared_ptr<const AlbumArt> art;
+        std::list<Key>::iterator recent;
+    };
+
+    IMetadataReader *reader_;
+    const size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Key> keys_; ///< Path -> content key
+    std::unordered_map<Key, Entry> entries_;
+    std::list<Key> recent_; ///< Most recently used first
+    size_t bytes_ = 0;
+
+    static Key hash(const AlbumArt &art);
+    std::shared_ptr<const AlbumArt> insertLocked(const std::string &filepath, AlbumArt art);
+    void touchLocked(Entry &entry);
+    void evictLocked();
+};
+
+#endif // ALBUM_ART_STORE_H
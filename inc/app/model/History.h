@@ -4,6 +4,7 @@
 #include "app/model/MediaFile.h"
 #include "interfaces/IPersistence.h"
 #include "interfaces/ITrackCollection.h"
+#include "utils/Journal.h"
 #include "utils/Subject.h"
 #include <deque>
 #include <memory>
@@ -72,11 +73,12 @@ class History : public Subject, public ITrackCollection
         return history_;
     }
 
-    // ITrackCollection implementation
-    const std::vector<std::shared_ptr<MediaFile>> &getTracks() const override
+    const std::vector<std::shared_ptr<MediaFile>> &getTracks() const
     {
         return getAll();
     }
+
+    // ITrackCollection implementation
     size_t size() const override
     {
         return history_.size();
@@ -105,17 +107,35 @@ class History : public Subject, public ITrackCollection
      */
     bool load();
 
+    /**
+     * @brief Record each change in history.journal instead of rewriting history.json
+     * save() and background compaction fold the journal back into history.json.
+     * @param compactThreshold Records after which background compaction starts
+     */
+    void enableJournal(size_t compactThreshold = 256);
+
   private:
     std::vector<std::shared_ptr<MediaFile>> history_;
     size_t maxSize_;
     IPersistence *persistence_;
     mutable std::mutex dataMutex_; ///< Thread-safety for history operations
+    std::unique_ptr<Journal> journal_; ///< Optional; destroyed first so compaction never outlives the data
 
     /**
      * @brief Internal save helper (expects mutex to be locked)
      */
     bool saveInternal();
 
+    /**
+     * @brief Persist one change: append it to the journal, or rewrite the file without one
+     */
+    bool persistLocked(const nlohmann::json &record);
+
+    /**
+     * @brief Re-apply one journal record during load() (lock held)
+     */
+    void applyRecordLocked(const nlohmann::json &record);
+
     /**
      * @brief Find index of track by path
      * @param filepath Path to find
@@ -2,12 +2,16 @@
 #define LIBRARY_H
 
 #include "app/model/MediaFile.h"
+#include "app/model/SearchIndex.h"
 #include "interfaces/IPersistence.h"
 #include "interfaces/ITrackCollection.h"
+#include "utils/Journal.h"
 #include "utils/Subject.h"
+#include <atomic>
 #include <json.hpp>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -25,10 +29,19 @@
  * Manages the collection of media files in the library.
  * Implements Observer pattern to notify views of changes.
  * Follows Single Responsibility Principle - only manages library data.
+ *
+ * **Thread Safety**: Writers serialize on the data mutex. Readers that walk
+ * the whole collection (views, every frame) should use snapshot(), which
+ * never waits on a writer. Observers are notified after the lock is released.
  */
 class Library : public Subject, public ITrackCollection
 {
   public:
+    /**
+     * @brief Immutable, shared view of the tracks at one point in time
+     */
+    using TrackSnapshot = std::shared_ptr<const std::vector<std::shared_ptr<MediaFile>>>;
+
     /**
      * @brief Constructor
      * @param persistence Persistence layer for saving/loading
@@ -56,6 +69,13 @@ class Library : public Subject, public ITrackCollection
      */
     bool removeMedia(const std::string &filepath);
 
+    /**
+     * @brief Remove several media files under one lock and one notification
+     * @param filepaths Paths of the files to remove
+     * @return Number of files actually removed
+     */
+    int removeMediaBatch(const std::vector<std::string> &filepaths);
+
     /**
      * @brief Check if a file is in the library
      * @param filepath Path to check
@@ -65,18 +85,80 @@ class Library : public Subject, public ITrackCollection
 
     /**
      * @brief Save library to disk
+     * With a journal enabled this compacts it: the full snapshot is written
+     * and the journal records it now covers are dropped.
      * @return true if successful
      */
     bool save();
 
     /**
      * @brief Load library from disk
+     * With the binary snapshot enabled, data/library.bin is preferred and
+     * data/library.json is read only if the snapshot is missing or invalid.
+     * Tracks loaded from the binary snapshot are not indexed for search yet;
+     * see buildSearchIndex().
      * @return true if successful
      */
     bool load();
 
+    /**
+     * @brief Save and load through the binary snapshot format (LibrarySnapshot)
+     *
+     * save() then writes data/library.bin instead of pretty-printed JSON.
+     * An existing data/library.json is still imported on the next load() if
+     * no snapshot exists yet.
+     */
+    void enableBinarySnapshot()
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        binarySnapshot_ = true;
+    }
+
+    /**
+     * @brief Persist every change as one appended record in data/library.journal
+     *
+     * Adds, removes, metadata updates and clears each cost one small append
+     * instead of a full rewrite. load() replays the journal on top of the
+     * base snapshot; it is folded back into the snapshot by save() or by a
+     * background compaction once it holds compactThreshold records.
+     * Needs a persistence layer; does nothing without one.
+     * @param compactThreshold Records after which background compaction starts
+     */
+    void enableJournal(size_t compactThreshold = 256);
+
+    bool hasJournal() const
+    {
+        return journal_ != nullptr;
+    }
+
+    /**
+     * @brief Replace the metadata of a track in the library
+     * Keeps the search index in sync; prefer this over MediaFile::setMetadata
+     * for tracks that are already in the library. The track is updated in
+     * place, so every holder of it (playlists, history, the play queue) sees
+     * the new tags.
+     * @param filepath Path of the track
+     * @param metadata New metadata
+     * @return true if the track was found and updated
+     */
+    bool updateMetadata(const std::string &filepath, const MediaMetadata &metadata);
+
+    /**
+     * @brief Replace the metadata of a track and the fingerprint it was read from
+     * @param filepath Path of the track
+     * @param metadata New metadata
+     * @param fingerprint Stat fingerprint of the file the metadata came from
+     * @return true if the track was found and updated
+     */
+    bool updateMetadata(const std::string &filepath, const MediaMetadata &metadata,
+                        const FileFingerprint &fingerprint);
+
     /**
      * @brief Search library by various criteria
+     * Served from a trigram index, so cost tracks the number of matches
+     * rather than the size of the library. Never blocks: while a writer
+     * holds the library, or until buildSearchIndex() has caught up after a
+     * binary load, the last published snapshot is scanned instead.
      * @param query Search query
      * @param searchFields Fields to search in (e.g., "title", "artist")
      * @return Vector of matching media files
@@ -84,6 +166,14 @@ class Library : public Subject, public ITrackCollection
     std::vector<std::shared_ptr<MediaFile>>
     search(const std::string &query, const std::vector<std::string> &searchFields = {"title", "artist", "album"}) const;
 
+    /**
+     * @brief Index the tracks that a binary load() left out of the search index
+     * Meant for a background thread once the UI is up. Works in chunks and
+     * releases the lock between them, so writers and search() keep going.
+     * Returns at once when every track is indexed.
+     */
+    void buildSearchIndex();
+
     /**
      * @brief Get media file by path
      * @param filepath Path to the file
@@ -91,21 +181,35 @@ class Library : public Subject, public ITrackCollection
      */
     std::shared_ptr<MediaFile> getByPath(const std::string &filepath) const;
 
-    size_t size() const override
-    {
-        return mediaFiles_.size();
-    }
-    const std::vector<std::shared_ptr<MediaFile>> &getAll() const
-    {
-        return mediaFiles_;
-    }
+    size_t size() const override;
 
-    std::unordered_set<std::string> getPathIndex() const
+    /**
+     * @brief Get the latest published track list
+     *
+     * Cheap (one refcount bump) and safe to iterate while other threads keep
+     * adding or removing tracks; the returned vector never changes. If a
+     * writer holds the lock when a newer list is due, the previous snapshot
+     * is returned instead of waiting, and the writer's notify() prompts the
+     * caller to ask again.
+     * @return Never null
+     */
+    TrackSnapshot snapshot() const;
+
+    /**
+     * @brief Whether changes are waiting for the next snapshot() to publish them
+     */
+    bool hasPendingSnapshot() const
     {
-        std::lock_guard<std::mutex> lock(dataMutex_);
-        return pathIndex_;
+        return snapshotDirty_.load(std::memory_order_acquire);
     }
 
+    /**
+     * @brief Copy of all tracks in library order
+     */
+    std::vector<std::shared_ptr<MediaFile>> getAll() const;
+
+    std::unordered_set<std::string> getPathIndex() const;
+
     void clear() override;
 
     // ITrackCollection implementation
@@ -117,18 +221,100 @@ class Library : public Subject, public ITrackCollection
     {
         return removeMedia(path);
     }
-    const std::vector<std::shared_ptr<MediaFile>> &getTracks() const override
+
+    /**
+     * @brief Same as snapshot(); the list stays valid for as long as it is held
+     */
+    TrackSnapshot getTracks() const
     {
-        return getAll();
+        return snapshot();
     }
 
   private:
     friend class LibraryTest;
-    std::vector<std::shared_ptr<MediaFile>> mediaFiles_;
-    std::unordered_set<std::string> pathIndex_; // For fast lookup
+    // Slots may hold nullptr tombstones left by removals; compactLocked() squeezes
+    // them out before anything that exposes positions. It runs from const readers
+    // such as snapshot(), hence the mutable storage.
+    mutable std::vector<std::shared_ptr<MediaFile>> mediaFiles_;
+    mutable std::unordered_map<std::string, size_t> pathIndex_; ///< Path -> slot in mediaFiles_
+    mutable size_t tombstones_ = 0;
+    SearchIndex searchIndex_;    ///< Trigram index backing search()
+    mutable size_t indexed_ = 0; ///< Slots below this are in searchIndex_; the rest wait for buildSearchIndex()
     IPersistence *persistence_;
     mutable std::mutex dataMutex_; ///< Thread-safety for library operations
 
+    // Published copy of mediaFiles_; only touched through std::atomic_load/atomic_store
+    mutable TrackSnapshot snapshot_;
+    mutable std::atomic<bool> snapshotDirty_{false}; ///< mediaFiles_ changed since the last publish
+    bool binarySnapshot_ = false;                    ///< save()/load() use data/library.bin
+
+    // Declared last so it is destroyed first: its compaction thread calls back into this object
+    std::unique_ptr<Journal> journal_;
+
+    /**
+     * @brief Append a track to the slots and every index (lock held)
+     */
+    void appendLocked(const std::shared_ptr<MediaFile> &file);
+
+    /**
+     * @brief Tombstone a track's slot and drop it from the indexes (lock held)
+     * @return false if the path is not in the library
+     */
+    bool removeLocked(const std::string &filepath);
+
+    /**
+     * @brief Close tombstone gaps, preserving order (lock held)
+     */
+    void compactLocked() const;
+
+    /**
+     * @brief Drop every track from the slots and indexes (lock held)
+     */
+    void resetLocked();
+
+    /**
+     * @brief Write the full base snapshot (JSON or binary) without touching the journal
+     */
+    bool saveBase();
+
+    /**
+     * @brief Replace the tracks with the contents of data/library.json (lock held)
+     * @return false if the file is missing or not a JSON array
+     */
+    bool loadJsonLocked();
+
+    /**
+     * @brief Metadata update shared by updateMetadata() and journal replay (lock held)
+     */
+    bool updateMetadataLocked(const std::string &filepath, const MediaMetadata &metadata,
+                              const FileFingerprint *fingerprint = nullptr);
+
+    /**
+     * @brief Append a mutation record if journaling is enabled (lock held)
+     */
+    void journalLocked(const nlohmann::json &record);
+
+    /**
+     * @brief Re-apply one journal record during load() (lock held)
+     */
+    void applyRecordLocked(const nlohmann::json &record);
+
+    /**
+     * @brief Serialize the tracks as JSON to a file (lock held, slots compacted)
+     */
+    bool saveJsonLocked(const std::string &filepath);
+
+    /**
+     * @brief Replace the tracks with the contents of data/library.bin (lock held)
+     * @return false if the snapshot is missing or fails validation; tracks are untouched then
+     */
+    bool loadBinaryLocked();
+
+    /**
+     * @brief Compact and publish a fresh snapshot of mediaFiles_ (lock held)
+     */
+    void publishLocked() const;
+
     /**
      * @brief Update path index
      */
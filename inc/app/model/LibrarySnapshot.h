@@ -0,0 +1,163 @@
+#ifndef LIBRARY_SNAPSHOT_H
+#define LIBRARY_SNAPSHOT_H
+
+#include "app/model/MediaFile.h"
+#include "utils/MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file LibrarySnapshot.h
+ * @brief Binary on-disk format for the library
+ *
+ * A faster alternative to data/library.json: no text parsing and no DOM.
+ * Layout (native byte order):
+ *
+ *     Header    magic "MPLB", version, record count, string table size,
+ *               section count, checksum of the header and section table
+ *     Sections  one checksum per SECTION_SIZE bytes of the body
+ *     Records   one fixed-width record per track (string refs + integer fields),
+ *               covering every MediaMetadata field
+ *     Strings   deduplicated UTF-8 bytes referenced by (offset, length)
+ *
+ * Records and strings form the body. Checksums are FNV-1a.
+ */
+
+/**
+ * @brief Read-only decoder over a binary library snapshot
+ *
+ * Opening validates the header, sizes and section table but reads none of
+ * the body, so it costs the same for any library size. Fields are read
+ * straight out of the mapped bytes when asked for; a body section is
+ * checked the first time a read touches it, and reads from a section that
+ * fails return empty values and mark the snapshot damaged().
+ *
+ * **Thread Safety**: Not synchronized; the section checks update internal state.
+ */
+class LibrarySnapshot
+{
+  public:
+    static const uint32_t VERSION = 2;
+    static constexpr size_t SECTION_SIZE = 64 * 1024;
+
+    /**
+     * @brief Encode tracks into the binary format
+     * @param files Tracks to write (null entries are skipped)
+     * @return Encoded bytes, ready for IPersistence::saveToFile
+     */
+    static std::string encode(const std::vector<std::shared_ptr<MediaFile>> &files);
+
+    /**
+     * @brief Validate and open encoded bytes
+     * @param file Bytes from IPersistence::mapFile (kept alive by the snapshot)
+     * @return Snapshot, or nullptr if the magic, version, sizes or header checksum are wrong
+     */
+    static std::unique_ptr<LibrarySnapshot> open(std::shared_ptr<MappedFile> file);
+
+    size_t size() const
+    {
+        return count_;
+    }
+
+    /**
+     * @brief Path of a record without materializing the track
+     */
+    std::string_view path(size_t index) const;
+
+    /**
+     * @brief Decode the metadata stored for a record
+     */
+    MediaMetadata metadata(size_t index) const;
+
+    /**
+     * @brief Build a MediaFile for a record
+     * @return New MediaFile carrying the saved inLibrary flag
+     */
+    std::shared_ptr<MediaFile> materialize(size_t index) const;
+
+    /**
+     * @brief Whether a read so far has hit a section whose checksum did not match
+     */
+    bool damaged() const
+    {
+        return damaged_;
+    }
+
+  private:
+    struct StringRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordCount;
+        uint32_t recordSize;
+        uint64_t stringBytes;
+        uint32_t sectionCount;
+        uint32_t checksum; ///< Over the header (this field zeroed) and the section table
+    };
+
+    struct Record
+    {
+        StringRef path;
+        StringRef title;
+        StringRef artist;
+        StringRef album;
+        StringRef genre;
+        StringRef codec;
+        StringRef comment;
+        StringRef customFields; ///< Key and value pairs, each string followed by a NUL
+        int32_t year;
+        int32_t track;
+        int32_t duration;
+        int32_t bitrate;
+        int32_t sampleRate;
+        int32_t channels;
+        uint32_t flags;    ///< FLAG_* bits
+        uint32_t reserved; ///< Keeps the 64-bit fields aligned
+        uint64_t fileSize;
+        int64_t mtime;
+        uint64_t inode;
+    };
+
+    static const uint32_t FLAG_IN_LIBRARY = 1u;
+    static const uint32_t FLAG_HAS_ALBUM_ART = 2u;
+
+    enum SectionState : uint8_t
+    {
+        SECTION_UNCHECKED,
+        SECTION_GOOD,
+        SECTION_BAD
+    };
+
+    LibrarySnapshot() = default;
+
+    Record record(size_t index) const;
+    std::string_view string(const StringRef &ref) const;
+
+    /**
+     * @brief Check every section overlapping body bytes [offset, offset + length)
+     * @return false if one of them is damaged
+     */
+    bool verify(size_t offset, size_t length) const;
+
+    static uint32_t checksum(const char *data, size_t size, uint32_t hash = 2166136261u);
+
+    std::shared_ptr<MappedFile> file_;
+    const char *body_ = nullptr;
+    const char *sectionSums_ = nullptr; ///< Unaligned uint32 per section
+    size_t bodySize_ = 0;
+    size_t count_ = 0;
+    size_t stringBytes_ = 0;
+    mutable std::vector<uint8_t> sections_; ///< SectionState per section
+    mutable bool damaged_ = false;
+};
+
+#endif // LIBRARY_SNAPSHOT_H
@@ -1,6 +1,7 @@
 #ifndef MEDIA_FILE_H
 #define MEDIA_FILE_H
 
+#include "interfaces/IFileSystem.h"
 #include "interfaces/IMetadataReader.h"
 #include <json.hpp>
 #include <memory>
@@ -29,6 +30,11 @@ enum class MediaType
  *
  * Encapsulates all information about a media file including
  * path, metadata, and library membership status.
+ *
+ * **Thread Safety**: The metadata and fingerprint may be replaced while
+ * other threads read them: they live in an immutable block that setters
+ * swap atomically, and getters return copies. Setters must not race each
+ * other (the library serializes them under its lock).
  */
 class MediaFile
 {
@@ -59,9 +65,20 @@ class MediaFile
     {
         return extension_;
     }
-    const MediaMetadata &getMetadata() const
+    /**
+     * @brief Copy of the current metadata
+     */
+    MediaMetadata getMetadata() const
+    {
+        return details()->metadata;
+    }
+    /**
+     * @brief The current metadata without copying it; stays valid while held
+     */
+    std::shared_ptr<const MediaMetadata> getMetadataSnapshot() const
     {
-        return metadata_;
+        auto current = details();
+        return std::shared_ptr<const MediaMetadata>(current, &current->metadata);
     }
     MediaType getType() const
     {
@@ -71,16 +88,32 @@ class MediaFile
     {
         return inLibrary_;
     }
-
-    // Setters
-    void setMetadata(const MediaMetadata &metadata)
+    FileFingerprint getFingerprint() const
     {
-        metadata_ = metadata;
+        return details()->fingerprint;
     }
+    /**
+     * @brief Bumped whenever the metadata is replaced, so views can tell their cached text is stale
+     */
+    uint64_t getMetadataRevision() const
+    {
+        return details()->revision;
+    }
+
+    // Setters
+    void setMetadata(const MediaMetadata &metadata);
+    /**
+     * @brief Replace the metadata and the fingerprint it was read from in one step
+     */
+    void setMetadata(const MediaMetadata &metadata, const FileFingerprint &fingerprint);
     void setInLibrary(bool inLibrary)
     {
         inLibrary_ = inLibrary;
     }
+    /**
+     * @brief Record the on-disk state the metadata was read from
+     */
+    void setFingerprint(const FileFingerprint &fingerprint);
 
     /**
      * @brief Get display name (title if available, filename otherwise)
@@ -108,10 +141,32 @@ class MediaFile
     std::string filepath_;
     std::string filename_;
     std::string extension_;
-    MediaMetadata metadata_;
     MediaType type_;
     bool inLibrary_;
 
+    /**
+     * @brief Everything that changes after the file is read, published as one immutable block
+     */
+    struct Details
+    {
+        MediaMetadata metadata;
+        FileFingerprint fingerprint; ///< Invalid until the file has been stat'ed
+        uint64_t revision = 0;
+    };
+
+    // Only touched through std::atomic_load/atomic_store
+    std::shared_ptr<const Details> details_;
+
+    std::shared_ptr<const Details> details() const
+    {
+        return std::atomic_load(&details_);
+    }
+
+    /**
+     * @brief Publish a changed copy of the current details
+     */
+    void publish(Details details);
+
     /**
      * @brief Parse filepath to extract filename and extension
      */
@@ -2,6 +2,7 @@
 #define MEDIA_FILE_FACTORY_H
 
 #include "app/model/MediaFile.h"
+#include "interfaces/IFileSystem.h"
 #include "interfaces/IMetadataReader.h"
 #include <memory>
 #include <string>
@@ -31,6 +32,19 @@ class MediaFileFactory
     static std::unique_ptr<MediaFile> createMediaFile(const std::string &filepath,
                                                       IMetadataReader *metadataReader = nullptr);
 
+    /**
+     * @brief Create a MediaFile and stamp it with the file's stat fingerprint
+     *
+     * The fingerprint is taken before the tags are read, so a write during
+     * the read shows up as a change on the next library refresh.
+     * @param filepath Path to the media file
+     * @param metadataReader Metadata reader to extract tags
+     * @param fileSystem File system used to stat the file (may be null)
+     * @return Unique pointer to MediaFile
+     */
+    static std::unique_ptr<MediaFile> createMediaFile(const std::string &filepath, IMetadataReader *metadataReader,
+                                                      IFileSystem *fileSystem);
+
     /**
      * @brief Create a MediaFile with pre-loaded metadata
      * @param filepath Path to the media file
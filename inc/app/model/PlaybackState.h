@@ -134,6 +134,13 @@ class PlaybackState : public Subject
      */
     void removeTrackFromBackStack(const std::string &path);
 
+    /**
+     * @brief Remove every occurrence of a track from the play queue
+     * Played tracks are dropped too; the queue still resumes at the same upcoming track.
+     * @param path Filepath to remove
+     */
+    void removeTrackFromQueue(const std::string &path);
+
     /**
      * @brief Set play queue for Next functionality
      * @param queue Queue of tracks to play
@@ -159,6 +166,12 @@ class PlaybackState : public Subject
      */
     std::shared_ptr<MediaFile> getNextTrack();
 
+    /**
+     * @brief Get the track getNextTrack() would return, without advancing
+     * @return Next track, nullptr if queue exhausted
+     */
+    std::shared_ptr<MediaFile> peekNextTrack() const;
+
     /**
      * @brief Check if has next track
      * @return true if queue has more tracks
@@ -170,6 +183,12 @@ class PlaybackState : public Subject
      */
     void clearPlayQueue();
 
+    /**
+     * @brief Counter bumped by every change to the play queue's contents
+     * setQueueIndex() and syncQueueIndex() only move within it and leave it alone.
+     */
+    size_t getQueueRevision() const;
+
     /**
      * @brief Reset state to initial values
      */
@@ -184,6 +203,7 @@ class PlaybackState : public Subject
     std::stack<std::shared_ptr<MediaFile>> backStack_;  // For Previous functionality
     std::vector<std::shared_ptr<MediaFile>> playQueue_; // For Next functionality
     size_t queueIndex_;                                 // Current position in play queue
+    size_t queueRevision_ = 0;                          // See getQueueRevision()
     mutable std::mutex dataMutex_;                      ///< Thread-safety for state access
 };
 
@@ -88,7 +88,7 @@ class Playlist : public Subject, public ITrackCollection
      * @brief Get tracks in the playlist
      * @return Vector of tracks
      */
-    const std::vector<std::shared_ptr<MediaFile>> &getTracks() const override
+    const std::vector<std::shared_ptr<MediaFile>> &getTracks() const
     {
         std::lock_guard<std::mutex> lock(dataMutex_);
         return tracks_;
@@ -115,6 +115,16 @@ class Playlist : public Subject, public ITrackCollection
         return tracks_.empty();
     }
 
+    /**
+     * @brief Counter bumped by every change to the tracks or their order
+     * Lets a reader tell whether what it derived from getTracks() is stale.
+     */
+    size_t getRevision() const
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        return revision_;
+    }
+
     /**
      * @brief Clear all tracks
      */
@@ -155,6 +165,7 @@ class Playlist : public Subject, public ITrackCollection
     std::string name_;
     std::vector<std::shared_ptr<MediaFile>> tracks_;
     RepeatMode repeatMode_;
+    size_t revision_ = 0;
     mutable std::mutex dataMutex_; ///< Thread-safety for playlist operations
 };
 
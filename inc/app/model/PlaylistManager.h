@@ -3,6 +3,7 @@
 
 #include "app/model/Playlist.h"
 #include "interfaces/IPersistence.h"
+#include "utils/Journal.h"
 #include "utils/Subject.h"
 #include <memory>
 #include <string>
@@ -100,6 +101,48 @@ class PlaylistManager : public Subject
      */
     bool loadAll();
 
+    /**
+     * @brief Add a track to a playlist and record the change
+     * @param name Playlist name
+     * @param track Track to add
+     * @return true if the playlist exists and the track was added
+     */
+    bool addTrackTo(const std::string &name, std::shared_ptr<MediaFile> track);
+
+    /**
+     * @brief Remove the track at an index of a playlist and record the change
+     * @param name Playlist name
+     * @param index Track index
+     * @return true if removed
+     */
+    bool removeTrackAt(const std::string &name, size_t index);
+
+    /**
+     * @brief Remove a track from a playlist by path and record the change
+     * @param name Playlist name
+     * @param filepath Track path
+     * @return true if removed
+     */
+    bool removeTrackFrom(const std::string &name, const std::string &filepath);
+
+    /**
+     * @brief Remove a track from every playlist
+     * Without a journal this rewrites playlists.json when anything changed.
+     * @param filepath Track path
+     * @return Number of playlists that contained the track
+     */
+    int removeTrackFromAll(const std::string &filepath);
+
+    /**
+     * @brief Record playlist changes in data/playlists.journal
+     *
+     * Creates, deletes, renames and the track changes made through this
+     * manager are appended as they happen. loadAll() replays them after
+     * playlists.json; saveAll() and background compaction fold them back.
+     * @param compactThreshold Records after which background compaction starts
+     */
+    void enableJournal(size_t compactThreshold = 256);
+
     /**
      * @brief Rename a playlist
      * @param oldName Current name
@@ -115,6 +158,7 @@ class PlaylistManager : public Subject
     std::unordered_map<std::string, std::shared_ptr<Playlist>> playlists_;
     IPersistence *persistence_;
     mutable std::mutex dataMutex_; ///< Thread-safety for playlist manager operations
+    std::unique_ptr<Journal> journal_; ///< Optional; destroyed first so compaction never outlives the data
 
     static constexpr const char *NOW_PLAYING_NAME = "Now Playing";
 
@@ -128,6 +172,21 @@ class PlaylistManager : public Subject
      * @brief Internal helper to save all without locking (prevents deadlock)
      */
     bool saveAllInternal();
+
+    /**
+     * @brief Load playlists.json (or migrate legacy files) without the journal (lock held)
+     */
+    bool loadBaseLocked();
+
+    /**
+     * @brief Append a change record if journaling is enabled (lock held)
+     */
+    void journalLocked(const nlohmann::json &record);
+
+    /**
+     * @brief Re-apply one journal record during loadAll() (lock held)
+     */
+    void applyRecordLocked(const nlohmann::json &record);
 };
 
 #endif // PLAYLIST_MANAGER_H
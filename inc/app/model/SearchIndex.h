@@ -0,0 +1,132 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "app/model/MediaFile.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file SearchIndex.h
+ * @brief Trigram inverted index over track metadata
+ *
+ * Lets Library answer substring searches with a posting-list intersection
+ * instead of lowercasing and scanning every track on every keystroke.
+ */
+
+/**
+ * @brief Trigram inverted index
+ *
+ * Each indexed field (title, artist, album, genre) is lowercased once when a
+ * track is added. Every distinct 3-byte window of that text is a posting key
+ * holding the sorted ids of the documents containing it. A query intersects
+ * the postings of its own trigrams and verifies the few surviving candidates
+ * with a plain substring check. Queries shorter than three characters fall
+ * back to a scan over the pre-lowercased text.
+ *
+ * Document ids grow with insertion order, so results come back in the same
+ * order the tracks were added.
+ *
+ * **Thread Safety**: Not synchronized. The owner (Library) guards it with its data mutex.
+ */
+class SearchIndex
+{
+  public:
+    /**
+     * @brief Index a track
+     * @param file Track to index (ignored if null or already indexed)
+     */
+    void add(const std::shared_ptr<MediaFile> &file);
+
+    /**
+     * @brief Remove a track from the index
+     * @param file Track to remove
+     * @return true if the track was indexed
+     */
+    bool remove(const MediaFile *file);
+
+    /**
+     * @brief Re-index a track after its metadata changed
+     * Keeps the track's position in result order.
+     * @param file Track to refresh
+     * @return true if the track was indexed
+     */
+    bool update(const MediaFile *file);
+
+    /**
+     * @brief Drop all documents and postings
+     */
+    void clear();
+
+    /**
+     * @brief Find tracks whose fields contain the query (case-insensitive)
+     * @param query Search query (must not be empty)
+     * @param searchFields Fields to match ("title", "artist", "album", "genre")
+     * @return Matching tracks in insertion order
+     */
+    std::vector<std::shared_ptr<MediaFile>> search(const std::string &query,
+                                                   const std::vector<std::string> &searchFields) const;
+
+    /**
+     * @brief Match tracks the way search() does, without an index
+     * Scans every track, for callers that cannot use the index right now
+     * (Library while a writer holds it).
+     * @param tracks Tracks to scan
+     * @param query Search query (must not be empty)
+     * @param searchFields Fields to match ("title", "artist", "album", "genre")
+     * @return Matching tracks in the order of tracks
+     */
+    static std::vector<std::shared_ptr<MediaFile>> scan(const std::vector<std::shared_ptr<MediaFile>> &tracks,
+                                                        const std::string &query,
+                                                        const std::vector<std::string> &searchFields);
+
+    /**
+     * @brief Number of live documents
+     */
+    size_t size() const
+    {
+        return docIds_.size();
+    }
+
+  private:
+    friend class SearchIndexTest;
+
+    enum Field : uint32_t
+    {
+        FIELD_TITLE = 0,
+        FIELD_ARTIST,
+        FIELD_ALBUM,
+        FIELD_GENRE,
+        FIELD_COUNT
+    };
+
+    using DocId = uint32_t;
+
+    struct Document
+    {
+        std::shared_ptr<MediaFile> file; ///< nullptr once removed (tombstone)
+        std::array<std::string, FIELD_COUNT> text; ///< Lowercased field values
+    };
+
+    std::vector<Document> documents_;                   ///< Indexed by DocId
+    std::unordered_map<const MediaFile *, DocId> docIds_; ///< Live documents
+    std::unordered_map<uint32_t, std::vector<DocId>> postings_; ///< (field, trigram) -> sorted doc ids
+    size_t tombstones_ = 0;
+
+    void indexDocument(DocId id, bool appendOnly);
+    void unindexDocument(DocId id);
+
+    /**
+     * @brief Renumber live documents densely once tombstones dominate
+     */
+    void compactIfNeeded();
+
+    static void extractText(Document &doc);
+    static bool fieldFromName(const std::string &name, Field &field);
+    static std::vector<uint32_t> trigramKeys(Field field, const std::string &text);
+};
+
+#endif // SEARCH_INDEX_H
@@ -5,9 +5,13 @@
 #include "app/view/BaseView.h"
 #include "app/view/components/PagedFileSelector.h"
 #include "interfaces/IFileSystem.h"
+#include "service/DirectoryLoader.h"
 #include <functional>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 /**
@@ -23,6 +27,10 @@
  *
  * ImGui-based file system browser.
  * Shows directory tree and file list.
+ *
+ * Folders are listed by a DirectoryLoader on a background thread; each
+ * frame picks up what it has found so far, so the window stays responsive
+ * while a large tree is scanned.
  */
 class FileBrowserView : public BaseView
 {
@@ -72,6 +80,12 @@ class FileBrowserView : public BaseView
     void navigateUp();
     void processFiles(const std::vector<std::string> &paths);
 
+    /**
+     * @brief Apply whatever the loader found since the last frame
+     * @return true if the lists changed
+     */
+    bool pollDirectory();
+
   private:
     IFileSystem *fileSystem_;
     LibraryController *libController_;
@@ -84,13 +98,27 @@ class FileBrowserView : public BaseView
     // UI state
     // Filter logic
     void applyFilter();
+
+    /**
+     * @brief Whether the file, or the path it resolves to, is already in the library
+     */
+    bool isInLibrary(const FileInfo &file) const;
+
+    /**
+     * @brief List order: files not yet in the library first, then by name
+     */
+    bool listedBefore(const FileInfo &a, const FileInfo &b) const;
     
     // Internal data
     std::vector<FileInfo> allMediaFiles_; // Store all files before filtering
+    std::unordered_set<std::string> libraryPaths_; // Fetched once per listing
     std::set<std::string> availableExtensions_;
     std::string selectedExtension_ = "All"; // Default filter
 
     std::vector<FileInfo> currentFiles_; // Folders
+    std::unordered_map<std::string, std::string> canonicalPaths_; // Media path -> resolved path, where they differ
+    std::unique_ptr<DirectoryLoader> loader_;
+    bool loading_ = false;
     // std::set<std::string> selectedFiles_;  // For multi-select - Moved to PagedFileSelector
 
 
@@ -130,9 +158,10 @@ class FileBrowserView : public BaseView
     void renderUSBDevices();
 
     /**
-     * @brief Navigate to parent directory
+     * @brief Start listing currentPath_ in the background
+     * @param force Rescan even if the cached listing looks fresh
      */
-    void refreshCurrentDirectory();
+    void refreshCurrentDirectory(bool force = false);
 
     /**
      * @brief Add selected files to library
@@ -151,6 +180,7 @@ class FileBrowserView : public BaseView
     void onFolderDoubleClicked(const std::string &path);
     void onAddSelectedClicked();
     void onAddRandomClicked();
+    void onImportFolderClicked();
 };
 
 #endif // FILE_BROWSER_VIEW_H
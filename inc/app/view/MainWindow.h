@@ -1,6 +1,7 @@
 #ifndef MAIN_WINDOW_H
 #define MAIN_WINDOW_H
 
+#include "app/model/AlbumArtStore.h"
 #include "app/model/PlaybackState.h"
 #include "app/view/BaseView.h"
 #include "app/view/FileBrowserView.h"
@@ -107,6 +108,12 @@ class MainWindow : public BaseView
         playbackState_ = state;
     }
 
+    // Source of cover images for the current track
+    void setAlbumArtStore(AlbumArtStore *store)
+    {
+        albumArtStore_ = store;
+    }
+
   private:
     // Views
     LibraryView *libraryView_ = nullptr;
@@ -121,6 +128,7 @@ class MainWindow : public BaseView
     // Playback references
     PlaybackController *playbackController_ = nullptr;
     PlaybackState *playbackState_ = nullptr;
+    AlbumArtStore *albumArtStore_ = nullptr;
 
     // Album art texture
     GLuint albumArtTexture_ = 0;
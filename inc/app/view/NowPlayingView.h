@@ -2,7 +2,7 @@
 #define NOW_PLAYING_VIEW_H
 
 #include "app/controller/PlaybackController.h"
-#include "app/model/PlaylistManager.h"
+#include "app/controller/PlaylistController.h"
 #include "app/view/BaseView.h"
 
 // ... (existing comments)
@@ -15,9 +15,12 @@ class NowPlayingView : public BaseView
     NowPlayingView(PlaybackController *controller, PlaybackState *state);
     ~NowPlayingView() override;
 
-    void setPlaylistManager(PlaylistManager *manager)
+    /**
+     * @brief Controller behind the favourite button; the button is hidden without one
+     */
+    void setPlaylistController(PlaylistController *controller)
     {
-        playlistManager_ = manager;
+        playlistController_ = controller;
     }
 
     void render() override;
@@ -27,7 +30,7 @@ class NowPlayingView : public BaseView
   private:
     PlaybackController *controller_;
     PlaybackState *state_;
-    PlaylistManager *playlistManager_ = nullptr;
+    PlaylistController *playlistController_ = nullptr;
 
     // UI state
     float volumeSlider_;
@@ -49,7 +49,6 @@ class PlaylistView : public TrackListView
 
   protected:
   private:
-    PlaylistController *playlistController_;
     FileBrowserView *fileBrowserView_ = nullptr;
 
     // UI state
@@ -2,14 +2,17 @@
 #define TRACK_LIST_VIEW_H
 
 #include "app/controller/PlaybackController.h"
+#include "app/controller/PlaylistController.h"
 #include "app/model/MediaFile.h"
 #include "app/model/PlaylistManager.h"
 #include "app/view/BaseView.h"
+#include "app/view/components/TrackRowCache.h"
 #include "imgui.h"
 #include "interfaces/ITrackListController.h"
 #include "utils/Logger.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <memory>
 #include <set>
 #include <string>
@@ -31,6 +34,14 @@ class TrackListView : public BaseView
 
     virtual ~TrackListView() = default;
 
+    /**
+     * @brief Controller behind "Add to Playlist"; without one the popup lists nothing
+     */
+    void setPlaylistController(PlaylistController *controller)
+    {
+        playlistController_ = controller;
+    }
+
   protected:
     // Shared State
     bool isEditMode_;
@@ -39,6 +50,11 @@ class TrackListView : public BaseView
     ITrackListController *listController_;
     PlaybackController *playbackController_;
     PlaylistManager *playlistManager_;
+    PlaylistController *playlistController_ = nullptr;
+
+    static constexpr float TRACK_ROW_HEIGHT = 60.0f;
+    int popupRow_ = -1; // Row whose popup is open, -1 if none
+    TrackRowCache rowCache_; // Row text, so a frame formats nothing for tracks it has shown before
 
     // UI Helpers
     void renderEditToolbar(const std::vector<std::shared_ptr<MediaFile>> &tracks)
@@ -81,239 +97,244 @@ class TrackListView : public BaseView
 
         ImGui::BeginChild("TrackListContent", ImVec2(0, scrollHeight), false);
 
-        for (size_t i = 0; i < tracks.size(); ++i)
+        // Once per frame, not per row: it locks the playback state
+        std::string currentPath;
+        auto state = playbackController_ ? playbackController_->getPlaybackState() : nullptr;
+        auto current = state ? state->getCurrentTrack() : nullptr;
+        if (current)
+            currentPath = current->getPath();
+
+        // Rows have a fixed height, so only the visible ones are built.
+        // The Selectable and the Dummy that closes a row each add one ItemSpacing.
+        int count = static_cast<int>(tracks.size());
+        ImGuiListClipper clipper;
+        clipper.Begin(count, TRACK_ROW_HEIGHT + ImGui::GetStyle().ItemSpacing.y * 2);
+        if (popupRow_ >= 0 && popupRow_ < count)
         {
-            auto file = tracks[i];
-            if (!file)
-                continue;
-
-            const auto &meta = file->getMetadata();
-            std::string title = file->getDisplayName();
-            std::string artist = meta.artist.empty() ? "Unknown Artist" : meta.artist;
-            std::string album = meta.album.empty() ? "Unknown Album" : meta.album;
-            std::string subtitle = artist + " • " + album;
-
-            bool isPlaying = false;
-            if (playbackController_)
+            // Keep submitting an open popup while its row is scrolled away
+            clipper.IncludeItemByIndex(popupRow_);
+        }
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
             {
-                auto current = playbackController_->getPlaybackState()
-                                   ? playbackController_->getPlaybackState()->getCurrentTrack()
-                                   : nullptr;
-                if (current && current->getPath() == file->getPath())
-                {
-                    isPlaying = true;
-                }
+                renderTrackRow(tracks, static_cast<size_t>(i), currentPath);
             }
+        }
+        ImGui::EndChild();
+    }
+
+    /**
+     * @brief Render one row of renderTrackListTable()
+     * @param currentPath Path of the playing track, empty if none
+     */
+    virtual void renderTrackRow(const std::vector<std::shared_ptr<MediaFile>> &tracks, size_t i,
+                                const std::string &currentPath)
+    {
+        auto file = tracks[i];
+        if (!file)
+        {
+            // Same height as a track row, or the clipper's positions drift
+            ImGui::Dummy(ImVec2(0, TRACK_ROW_HEIGHT + ImGui::GetStyle().ItemSpacing.y));
+            return;
+        }
 
-            ImGui::PushID(static_cast<int>(i));
+        TrackRowCache::Row &row = rowCache_.get(file);
 
-            if (isPlaying)
-            {
-                ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.0f, 0.5f, 0.5f, 0.8f));
-                ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.0f, 0.6f, 0.6f, 1.0f));
-            }
+        bool isPlaying = !currentPath.empty() && currentPath == file->getPath();
 
-            float trackItemHeight = 60.0f;
-            float buttonSize = 28.0f;
-            float btnSpacing = 5.0f;
-            float paddingX = 10.0f;
-            float paddingY = 8.0f;
+        ImGui::PushID(static_cast<int>(i));
 
-            float contentAvailX = ImGui::GetContentRegionAvail().x;
-            ImVec2 startPosLocal = ImGui::GetCursorPos();
-            ImVec2 startPosScreen = ImGui::GetCursorScreenPos();
+        if (isPlaying)
+        {
+            ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.0f, 0.5f, 0.5f, 0.8f));
+            ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.0f, 0.6f, 0.6f, 1.0f));
+        }
 
-            float buttonsAreaWidth = (buttonSize * 2) + btnSpacing + 15.0f;
-            float checkboxWidth = 30.0f;
-            float contentStartX = paddingX;
+        float trackItemHeight = TRACK_ROW_HEIGHT;
+        float buttonSize = 28.0f;
+        float btnSpacing = 5.0f;
+        float paddingX = 10.0f;
+        float paddingY = 8.0f;
 
-            if (isEditMode_)
-                contentStartX += checkboxWidth;
+        float contentAvailX = ImGui::GetContentRegionAvail().x;
+        ImVec2 startPosLocal = ImGui::GetCursorPos();
+        ImVec2 startPosScreen = ImGui::GetCursorScreenPos();
 
-            float textAreaWidth = contentAvailX - buttonsAreaWidth - contentStartX;
+        float buttonsAreaWidth = (buttonSize * 2) + btnSpacing + 15.0f;
+        float checkboxWidth = 30.0f;
+        float contentStartX = paddingX;
 
-            bool clicked = ImGui::Selectable("##track", isPlaying,
-                                             ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap,
-                                             ImVec2(contentAvailX, trackItemHeight));
-            ImVec2 endPosLocal = ImGui::GetCursorPos();
+        if (isEditMode_)
+            contentStartX += checkboxWidth;
 
-            if (isEditMode_)
-            {
-                bool selected = isSelected(file->getPath());
-                ImGui::SetCursorPos(ImVec2(startPosLocal.x + 5.0f, startPosLocal.y + (trackItemHeight - 20) / 2));
-                if (ImGui::Checkbox("##check", &selected))
-                {
-                    toggleSelection(file->getPath());
-                }
-                if (clicked)
-                    toggleSelection(file->getPath());
-            }
+        float textAreaWidth = contentAvailX - buttonsAreaWidth - contentStartX;
 
-            // Buttons
-            float btn2X = startPosLocal.x + contentAvailX - buttonSize - 10.0f;
-            float btn1X = btn2X - buttonSize - btnSpacing;
-            float btnY = startPosLocal.y + (trackItemHeight - buttonSize) / 2.0f;
+        bool clicked = ImGui::Selectable("##track", isPlaying,
+                                         ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap,
+                                         ImVec2(contentAvailX, trackItemHeight));
+        ImVec2 endPosLocal = ImGui::GetCursorPos();
 
-            ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
-            ImGui::SetCursorPos(ImVec2(btn1X, btnY));
-            std::string addPopupId = "AddToPlaylistPopup##" + std::to_string(i);
-            if (ImGui::Button("+", ImVec2(buttonSize, buttonSize)))
+        if (isEditMode_)
+        {
+            bool selected = isSelected(file->getPath());
+            ImGui::SetCursorPos(ImVec2(startPosLocal.x + 5.0f, startPosLocal.y + (trackItemHeight - 20) / 2));
+            if (ImGui::Checkbox("##check", &selected))
             {
-                ImGui::OpenPopup(addPopupId.c_str());
+                toggleSelection(file->getPath());
             }
+            if (clicked)
+                toggleSelection(file->getPath());
+        }
 
-            if (ImGui::BeginPopup(addPopupId.c_str()))
-            {
-                ImGui::Text("Add to Playlist");
-                ImGui::Separator();
-
-                if (playlistManager_)
-                {
-                    auto playlists = playlistManager_->getAllPlaylists();
+        // Buttons
+        float btn2X = startPosLocal.x + contentAvailX - buttonSize - 10.0f;
+        float btn1X = btn2X - buttonSize - btnSpacing;
+        float btnY = startPosLocal.y + (trackItemHeight - buttonSize) / 2.0f;
 
-                    // 1. List existing playlists
-                    if (ImGui::BeginChild("PlaylistListSub", ImVec2(200, 150), false))
-                    {
-                        for (const auto &playlist : playlists)
-                        {
-                            if (playlist->getName() == "Now Playing")
-                                continue;
-                            if (ImGui::Selectable(playlist->getName().c_str()))
-                            {
-                                playlist->addTrack(file);
-                                // playlistManager_->saveAll(); // Removed: Save only on exit
-                                ImGui::CloseCurrentPopup();
-                            }
-                        }
-                    }
-                    ImGui::EndChild();
-
-                    ImGui::Separator();
+        ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
+        ImGui::SetCursorPos(ImVec2(btn1X, btnY));
+        char addPopupId[48];
+        std::snprintf(addPopupId, sizeof(addPopupId), "AddToPlaylistPopup##%zu", i);
+        if (ImGui::Button("+", ImVec2(buttonSize, buttonSize)))
+        {
+            ImGui::OpenPopup(addPopupId);
+            popupRow_ = static_cast<int>(i);
+        }
 
-                    // 2. Create new playlist and add
-                    static char newPlaylistBuffer[128] = "";
-                    ImGui::PushItemWidth(160);
-                    ImGui::InputTextWithHint("##new_pl", "New Playlist...", newPlaylistBuffer,
-                                             sizeof(newPlaylistBuffer));
-                    ImGui::PopItemWidth();
+        bool popupOpen = false;
+        if (ImGui::BeginPopup(addPopupId))
+        {
+            popupOpen = true;
+            ImGui::Text("Add to Playlist");
+            ImGui::Separator();
 
-                    ImGui::SameLine();
-                    if (ImGui::Button("+##create_add", ImVec2(30, 0)))
+            if (playlistController_)
+            {
+                // 1. List existing playlists
+                if (ImGui::BeginChild("PlaylistListSub", ImVec2(200, 150), false))
+                {
+                    for (const auto &name : playlistController_->getPlaylistNames())
                     {
-                        std::string name(newPlaylistBuffer);
-                        if (!name.empty())
+                        if (name == "Now Playing")
+                            continue;
+                        if (ImGui::Selectable(name.c_str()))
                         {
-                            auto newPl = playlistManager_->createPlaylist(name);
-                            if (newPl)
-                            {
-                                newPl->addTrack(file);
-                                // playlistManager_->saveAll(); // Removed: Save only on exit
-                                newPlaylistBuffer[0] = '\0';
-                                ImGui::CloseCurrentPopup();
-                            }
+                            playlistController_->addTrackToPlaylist(name, file);
+                            ImGui::CloseCurrentPopup();
                         }
                     }
                 }
-                ImGui::EndPopup();
-            }
+                ImGui::EndChild();
 
-            ImGui::SetCursorPos(ImVec2(btn2X, btnY));
-            if (ImGui::Button("i", ImVec2(buttonSize, buttonSize)))
-            {
-                ImGui::OpenPopup("MetadataPopup");
-            }
-
-            if (ImGui::BeginPopup("MetadataPopup"))
-            {
-                ImGui::Text("Track Details");
                 ImGui::Separator();
-                ImGui::Text("Title: %s", file->getDisplayName().c_str());
-                ImGui::Text("Artist: %s", artist.c_str());
-                ImGui::Text("Album: %s", album.c_str());
 
-                ImGui::Separator();
+                // 2. Create new playlist and add
+                static char newPlaylistBuffer[128] = "";
+                ImGui::PushItemWidth(160);
+                ImGui::InputTextWithHint("##new_pl", "New Playlist...", newPlaylistBuffer,
+                                         sizeof(newPlaylistBuffer));
+                ImGui::PopItemWidth();
 
-                // Extension
-                std::string ext = file->getExtension();
-                if (!ext.empty() && ext[0] == '.')
-                    ext = ext.substr(1);
-                std::transform(ext.begin(), ext.end(), ext.begin(), ::toupper);
-                ImGui::Text("Format: %s", ext.c_str());
-
-                // Duration
-                int dur = meta.duration;
-                int min = dur / 60;
-                int sec = dur % 60;
-                ImGui::Text("Duration: %d:%02d", min, sec);
-
-                // File Size
-                size_t sizeBytes = file->getFileSize();
-                if (sizeBytes > 0)
+                ImGui::SameLine();
+                if (ImGui::Button("+##create_add", ImVec2(30, 0)))
                 {
-                    const char *units[] = {"B", "KB", "MB", "GB"};
-                    int i = 0;
-                    double size = static_cast<double>(sizeBytes);
-                    while (size > 1024 && i < 3)
+                    std::string name(newPlaylistBuffer);
+                    if (!name.empty())
                     {
-                        size /= 1024;
-                        i++;
+                        if (playlistController_->createPlaylist(name))
+                        {
+                            playlistController_->addTrackToPlaylist(name, file);
+                            newPlaylistBuffer[0] = '\0';
+                            ImGui::CloseCurrentPopup();
+                        }
                     }
-                    ImGui::Text("Size: %.2f %s", size, units[i]);
                 }
-
-                // Audio Properties
-                if (meta.bitrate > 0)
-                    ImGui::Text("Bitrate: %d kbps", meta.bitrate);
-                if (meta.sampleRate > 0)
-                    ImGui::Text("Sample Rate: %d Hz", meta.sampleRate);
-                if (meta.channels > 0)
-                    ImGui::Text("Channels: %d (%s)", meta.channels, (meta.channels == 1 ? "Mono" : "Stereo"));
-                if (!meta.codec.empty())
-                    ImGui::Text("Codec: %s", meta.codec.c_str());
-
-                ImGui::EndPopup();
             }
-            ImGui::PopStyleVar();
-
-            // Text with Marquee
-            ImGui::PushClipRect(
-                startPosScreen,
-                ImVec2(startPosScreen.x + textAreaWidth + contentStartX, startPosScreen.y + trackItemHeight), true);
-            ImVec2 titlePos = ImVec2(startPosScreen.x + contentStartX, startPosScreen.y + paddingY);
-            ImVec2 subtitlePos = ImVec2(startPosScreen.x + contentStartX, startPosScreen.y + paddingY + 24.0f);
-
-            auto fonts = ImGui::GetIO().Fonts;
-            ImFont *titleFont = (fonts->Fonts.Size > 2) ? fonts->Fonts[2] : fonts->Fonts[0];
-
-            ImGui::PushFont(titleFont);
-            ImVec2 titleSize = ImGui::CalcTextSize(title.c_str());
-            float scrollOffsetX = 0.0f;
-            if (isHoveredRow(startPosScreen, ImVec2(contentAvailX, trackItemHeight)) && titleSize.x > textAreaWidth)
-            {
-                scrollOffsetX = calculateMarqueeOffset(titleSize.x, textAreaWidth, i);
-            }
-            ImGui::GetWindowDrawList()->AddText(ImVec2(titlePos.x - scrollOffsetX, titlePos.y),
-                                                ImGui::GetColorU32(ImGuiCol_Text), title.c_str());
-            ImGui::PopFont();
-            ImGui::GetWindowDrawList()->AddText(subtitlePos, ImGui::GetColorU32(ImGuiCol_TextDisabled),
-                                                subtitle.c_str());
-            ImGui::PopClipRect();
+            ImGui::EndPopup();
+        }
+
+        ImGui::SetCursorPos(ImVec2(btn2X, btnY));
+        if (ImGui::Button("i", ImVec2(buttonSize, buttonSize)))
+        {
+            ImGui::OpenPopup("MetadataPopup");
+            popupRow_ = static_cast<int>(i);
+        }
 
-            if (isPlaying)
-                ImGui::PopStyleColor(2);
+        if (ImGui::BeginPopup("MetadataPopup"))
+        {
+            popupOpen = true;
+            ImGui::Text("Track Details");
+            ImGui::Separator();
+            ImGui::Text("Title: %s", row.title.c_str());
+            ImGui::Text("Artist: %s", row.artist.c_str());
+            ImGui::Text("Album: %s", row.album.c_str());
+
+            ImGui::Separator();
+
+            ImGui::Text("Format: %s", row.format.c_str());
+            ImGui::Text("Duration: %s", row.durationText.c_str());
+            if (!row.sizeText.empty())
+                ImGui::Text("Size: %s", row.sizeText.c_str());
+
+            // Audio Properties
+            const MediaMetadata meta = file->getMetadata();
+            if (meta.bitrate > 0)
+                ImGui::Text("Bitrate: %d kbps", meta.bitrate);
+            if (meta.sampleRate > 0)
+                ImGui::Text("Sample Rate: %d Hz", meta.sampleRate);
+            if (meta.channels > 0)
+                ImGui::Text("Channels: %d (%s)", meta.channels, (meta.channels == 1 ? "Mono" : "Stereo"));
+            if (!meta.codec.empty())
+                ImGui::Text("Codec: %s", meta.codec.c_str());
+
+            ImGui::EndPopup();
+        }
+        if (!popupOpen && popupRow_ == static_cast<int>(i))
+            popupRow_ = -1;
+        ImGui::PopStyleVar();
+
+        // Text with Marquee
+        ImGui::PushClipRect(
+            startPosScreen,
+            ImVec2(startPosScreen.x + textAreaWidth + contentStartX, startPosScreen.y + trackItemHeight), true);
+        ImVec2 titlePos = ImVec2(startPosScreen.x + contentStartX, startPosScreen.y + paddingY);
+        ImVec2 subtitlePos = ImVec2(startPosScreen.x + contentStartX, startPosScreen.y + paddingY + 24.0f);
+
+        auto fonts = ImGui::GetIO().Fonts;
+        ImFont *titleFont = (fonts->Fonts.Size > 2) ? fonts->Fonts[2] : fonts->Fonts[0];
+
+        ImGui::PushFont(titleFont);
+        if (row.titleFont != titleFont)
+        {
+            row.titleWidth = ImGui::CalcTextSize(row.title.c_str()).x;
+            row.titleFont = titleFont;
+        }
+        float scrollOffsetX = 0.0f;
+        if (isHoveredRow(startPosScreen, ImVec2(contentAvailX, trackItemHeight)) && row.titleWidth > textAreaWidth)
+        {
+            scrollOffsetX = calculateMarqueeOffset(row.titleWidth, textAreaWidth, i);
+        }
+        ImGui::GetWindowDrawList()->AddText(ImVec2(titlePos.x - scrollOffsetX, titlePos.y),
+                                            ImGui::GetColorU32(ImGuiCol_Text), row.title.c_str());
+        ImGui::PopFont();
+        ImGui::GetWindowDrawList()->AddText(subtitlePos, ImGui::GetColorU32(ImGuiCol_TextDisabled),
+                                            row.subtitle.c_str());
+        ImGui::PopClipRect();
 
-            ImGui::SetCursorPos(endPosLocal);
-            // Submit a dummy item to ensure window boundaries are updated correctly after manual positioning
-            ImGui::Dummy(ImVec2(0, 0));
+        if (isPlaying)
+            ImGui::PopStyleColor(2);
 
-            if (clicked && playbackController_ && !isEditMode_)
-            {
-                listController_->playTrack(tracks, i);
-            }
+        ImGui::SetCursorPos(endPosLocal);
+        // Submit a dummy item to ensure window boundaries are updated correctly after manual positioning
+        ImGui::Dummy(ImVec2(0, 0));
 
-            ImGui::PopID();
+        if (clicked && playbackController_ && !isEditMode_)
+        {
+            listController_->playTrack(tracks, i);
         }
-        ImGui::EndChild();
+
+        ImGui::PopID();
     }
 
     void toggleEditMode()
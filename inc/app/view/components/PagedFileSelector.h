@@ -26,6 +26,18 @@ class PagedFileSelector
      */
     void setItems(const std::vector<FileInfo> &items);
 
+    /**
+     * @brief Merge more items into the list without re-sorting what is already there
+     * @param items Items to add, in any order
+     * @param before Order the current items are sorted by
+     */
+    void mergeItems(std::vector<FileInfo> items, const std::function<bool(const FileInfo &, const FileInfo &)> &before);
+
+    const std::vector<FileInfo> &getItems() const
+    {
+        return items_;
+    }
+
     /**
      * @brief Render the file list table
      */
@@ -103,6 +115,11 @@ class PagedFileSelector
         disabledPaths_ = paths;
     }
 
+    void addDisabledItem(const std::string &path)
+    {
+        disabledPaths_.insert(path);
+    }
+
     const std::set<std::string> &getDisabledItems() const
     {
         return disabledPaths_;
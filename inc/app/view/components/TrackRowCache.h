@@ -0,0 +1,75 @@
+#ifndef TRACK_ROW_CACHE_H
+#define TRACK_ROW_CACHE_H
+
+#include "app/model/MediaFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct ImFont;
+
+/**
+ * @file TrackRowCache.h
+ * @brief Formatted text of track list rows, kept between frames
+ */
+
+/**
+ * @brief Display strings per track, built once instead of every frame
+ *
+ * A row is rebuilt when its track's metadata revision changes. The file
+ * size comes from the stored fingerprint, or from one stat when there is
+ * none. The title width depends on the font, so the view measures it and
+ * stores it in the row.
+ */
+class TrackRowCache
+{
+  public:
+    struct Row
+    {
+        std::string title;
+        std::string artist;
+        std::string album;
+        std::string subtitle;              ///< "artist • album"
+        std::string format;                ///< Upper-case extension without the dot
+        std::string durationText;          ///< "m:ss"
+        std::string sizeText;              ///< Empty when the size is unknown
+        float titleWidth = 0.0f;           ///< Valid for titleFont only
+        const ImFont *titleFont = nullptr; ///< Font titleWidth was measured with, null if not measured
+
+      private:
+        friend class TrackRowCache;
+        std::weak_ptr<MediaFile> file_;
+        uint64_t revision_ = 0;
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 4096; ///< Rows kept before stale ones are dropped
+
+    explicit TrackRowCache(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Row for a track, built if missing or stale
+     * @return Reference valid until the next get() or clear()
+     */
+    Row &get(const std::shared_ptr<MediaFile> &file);
+
+    void clear();
+
+    size_t size() const
+    {
+        return rows_.size();
+    }
+
+  private:
+    size_t capacity_;
+    std::unordered_map<const MediaFile *, Row> rows_;
+
+    static void build(const MediaFile &file, Row &row);
+
+    /**
+     * @brief Make room: drop rows of deleted tracks, or everything if that is not enough
+     */
+    void trim();
+};
+
+#endif // TRACK_ROW_CACHE_H
@@ -0,0 +1,73 @@
+#ifndef IDIRECTORY_WATCHER_H
+#define IDIRECTORY_WATCHER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file IDirectoryWatcher.h
+ * @brief Interface for live notification of file system changes (Dependency Inversion Principle)
+ *
+ * Lets the library follow its folders as files are copied in, edited,
+ * renamed or deleted, instead of rescanning them.
+ */
+
+/**
+ * @brief One coalesced change under a watched folder
+ */
+struct FileEvent
+{
+    enum class Kind
+    {
+        CHANGED, ///< Created, rewritten or moved in (for a directory: everything below it is new)
+        REMOVED, ///< Deleted or moved out (for a directory: everything below it is gone)
+        RESCAN   ///< Events were lost; the folder must be compared with the library again
+    };
+
+    Kind kind = Kind::CHANGED;
+    std::string path;
+    bool directory = false;
+
+    bool operator==(const FileEvent &other) const
+    {
+        return kind == other.kind && path == other.path && directory == other.directory;
+    }
+};
+
+/**
+ * @brief Directory watcher interface
+ *
+ * Implementations collect raw notifications, merge bursts (a large copy, an
+ * rsync) and deliver them in debounced batches.
+ */
+class IDirectoryWatcher
+{
+  public:
+    using Callback = std::function<void(const std::vector<FileEvent> &)>;
+
+    virtual ~IDirectoryWatcher() = default;
+
+    /**
+     * @brief Start delivering batches
+     * @param callback Receives each batch, on the watcher's own thread
+     * @return false if watching is not available here
+     */
+    virtual bool start(Callback callback) = 0;
+
+    /**
+     * @brief Watch a folder and everything below it
+     * May be called before or after start(). Implementations may set the
+     * watches up later on their own thread, since that walks the whole tree.
+     * @return false if the folder is known not to be watchable
+     */
+    virtual bool addRoot(const std::string &path) = 0;
+
+    /**
+     * @brief Stop watching; pending events are dropped
+     * No callback runs after this returns.
+     */
+    virtual void stop() = 0;
+};
+
+#endif // IDIRECTORY_WATCHER_H
@@ -1,7 +1,10 @@
 #ifndef IFILESYSTEM_H
 #define IFILESYSTEM_H
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -23,6 +26,55 @@ struct FileInfo
     size_t size;
 };
 
+/**
+ * @brief Cheap identity of a file's contents, taken from stat()
+ *
+ * If size, modification time and inode all match a stored fingerprint the
+ * file is assumed unchanged and its tags need not be read again.
+ */
+struct FileFingerprint
+{
+    uint64_t size = 0;
+    int64_t mtime = 0; ///< Modification time in nanoseconds since the epoch
+    uint64_t inode = 0;
+
+    /**
+     * @brief Whether the fingerprint was ever filled in
+     */
+    bool isValid() const
+    {
+        return inode != 0 || mtime != 0 || size != 0;
+    }
+
+    bool operator==(const FileFingerprint &other) const
+    {
+        return size == other.size && mtime == other.mtime && inode == other.inode;
+    }
+
+    bool operator!=(const FileFingerprint &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief A file to check in IFileSystem::verifyFiles()
+ */
+struct FileCheck
+{
+    std::string path;
+    FileFingerprint expected; ///< Last known fingerprint (invalid if never stat'ed)
+};
+
+/**
+ * @brief Outcome of IFileSystem::verifyFiles()
+ */
+struct VerifyResult
+{
+    std::vector<std::string> missing;                             ///< Paths that no longer exist
+    std::vector<std::pair<std::string, FileFingerprint>> changed; ///< Paths and their new fingerprints
+};
+
 /**
  * @brief File system interface
  *
@@ -51,6 +103,46 @@ class IFileSystem
     virtual std::vector<std::string> scanDirectory(const std::string &path, const std::vector<std::string> &extensions,
                                                    int maxDepth = -1) = 0;
 
+    /**
+     * @brief List the subdirectories of a directory without stat'ing the files beside them
+     *
+     * The default implementation filters browse(); implementations that can
+     * tell directories apart from the listing alone should override it.
+     * @param path Directory path
+     * @return Full paths of the subdirectories, in no particular order
+     */
+    virtual std::vector<std::string> listDirectories(const std::string &path)
+    {
+        std::vector<std::string> directories;
+        for (const auto &entry : browse(path))
+        {
+            if (entry.isDirectory)
+                directories.push_back(entry.path);
+        }
+        return directories;
+    }
+
+    /**
+     * @brief Scan like scanDirectory(), handing each match over as soon as it is found
+     *
+     * The default implementation scans first and then replays the results;
+     * implementations that can stream should override it.
+     * @param path Directory path to scan
+     * @param extensions Supported file extensions
+     * @param maxDepth Maximum recursion depth (-1 for infinite)
+     * @param onFile Receives each matching path, possibly from several threads at
+     *               once; return false to stop the scan early
+     */
+    virtual void scanDirectoryStreaming(const std::string &path, const std::vector<std::string> &extensions,
+                                        int maxDepth, const std::function<bool(const std::string &)> &onFile)
+    {
+        for (const auto &file : scanDirectory(path, extensions, maxDepth))
+        {
+            if (!onFile(file))
+                return;
+        }
+    }
+
     /**
      * @brief Get all media files in a directory
      * @param path Directory path
@@ -95,6 +187,42 @@ class IFileSystem
      * @return true if path is a directory
      */
     virtual bool isDirectory(const std::string &path) = 0;
+
+    /**
+     * @brief Stat a file without opening it
+     * @param path File to stat
+     * @param fingerprint Output size, modification time and inode
+     * @return false if the file cannot be stat'ed
+     */
+    virtual bool getFingerprint(const std::string &path, FileFingerprint &fingerprint) = 0;
+
+    /**
+     * @brief Check many files at once
+     *
+     * The default implementation stats one file at a time and uses exists()
+     * to tell a missing file from one that cannot be stat'ed; implementations
+     * that can batch or parallelize should override it.
+     * @param files Paths and the fingerprints they had when last read
+     * @return Files that are gone and files whose fingerprint differs, each in input order
+     */
+    virtual VerifyResult verifyFiles(const std::vector<FileCheck> &files)
+    {
+        VerifyResult result;
+        for (const auto &file : files)
+        {
+            FileFingerprint current;
+            if (getFingerprint(file.path, current))
+            {
+                if (current != file.expected)
+                    result.changed.emplace_back(file.path, current);
+            }
+            else if (!exists(file.path))
+            {
+                result.missing.push_back(file.path);
+            }
+        }
+        return result;
+    }
 };
 
 #endif // IFILESYSTEM_H
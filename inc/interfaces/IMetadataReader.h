@@ -27,18 +27,27 @@ struct MediaMetadata
     int bitrate = 0;      // in kbps
     int sampleRate = 0;   // in Hz (e.g., 44100, 48000)
     int channels = 0;     // number of audio channels (1=mono, 2=stereo)
-    bool hasAlbumArt = false; // true if file has embedded album artwork
+    bool hasAlbumArt = false; // true if file has embedded album artwork (fetch it with readAlbumArt)
     std::string codec;
     std::string comment;
-
-    // Album art data (raw bytes - typically JPEG or PNG)
-    std::vector<unsigned char> albumArtData;
-    std::string albumArtMimeType; // e.g., "image/jpeg", "image/png"
+    bool retryable = false; // The reader gave up before examining the file (timeout, busy); a later read may succeed
 
     // Additional fields can be stored here
     std::map<std::string, std::string> customFields;
 };
 
+/**
+ * @brief Embedded cover image
+ *
+ * Kept out of MediaMetadata so library tracks do not each carry a copy;
+ * AlbumArtStore loads and caches it when a view needs it.
+ */
+struct AlbumArt
+{
+    std::vector<unsigned char> data; // Raw bytes - typically JPEG or PNG
+    std::string mimeType;            // e.g., "image/jpeg", "image/png"
+};
+
 /**
  * @brief Metadata reader/writer interface
  *
@@ -79,6 +88,19 @@ class IMetadataReader
      * @return true if format supports editing
      */
     virtual bool supportsEditing(const std::string &filepath) = 0;
+
+    /**
+     * @brief Read the embedded cover image of a media file
+     * @param filepath Path to the media file
+     * @param art Receives the image on success
+     * @return true if the file has a cover (readers without art support return false)
+     */
+    virtual bool readAlbumArt(const std::string &filepath, AlbumArt &art)
+    {
+        (void)filepath;
+        (void)art;
+        return false;
+    }
 };
 
 #endif // IMETADATA_READER_H
@@ -1,7 +1,10 @@
 #ifndef IPERSISTENCE_H
 #define IPERSISTENCE_H
 
+#include "utils/MappedFile.h"
+#include <memory>
 #include <string>
+#include <utility>
 
 /**
  * @file IPersistence.h
@@ -37,6 +40,37 @@ class IPersistence
      */
     virtual bool loadFromFile(const std::string &filepath, std::string &data) = 0;
 
+    /**
+     * @brief Append data to the end of a file, creating it if needed
+     * The default rewrites the whole file; file-backed implementations
+     * override it with a real append so the cost tracks the new bytes only.
+     * @param filepath Path to the file
+     * @param data Bytes to append
+     * @return true if appended successfully
+     */
+    virtual bool appendToFile(const std::string &filepath, const std::string &data)
+    {
+        std::string existing;
+        if (fileExists(filepath) && !loadFromFile(filepath, existing))
+            return false;
+        return saveToFile(filepath, existing + data);
+    }
+
+    /**
+     * @brief Open a file for zero-copy binary reads
+     * The default reads the file through loadFromFile(); file-backed
+     * implementations override it with a real memory mapping.
+     * @param filepath Path to the file
+     * @return File bytes, or nullptr if the file cannot be read
+     */
+    virtual std::shared_ptr<MappedFile> mapFile(const std::string &filepath)
+    {
+        std::string data;
+        if (!loadFromFile(filepath, data))
+            return nullptr;
+        return MappedFile::fromString(std::move(data));
+    }
+
     /**
      * @brief Check if a file exists
      * @param filepath Path to check
@@ -51,6 +85,17 @@ class IPersistence
      */
     virtual bool deleteFile(const std::string &filepath) = 0;
 
+    /**
+     * @brief Wait until every accepted save has reached storage
+     * Implementations that write in the background must override this;
+     * synchronous ones are always flushed.
+     * @return false if a background write failed since the last flush
+     */
+    virtual bool flush()
+    {
+        return true;
+    }
+
     /**
      * @brief Serialize data to string format
      * @param data Data to serialize
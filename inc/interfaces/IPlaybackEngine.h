@@ -125,6 +125,38 @@ class IPlaybackEngine : public ISubject
     virtual void updateVideo()
     {
     }
+
+    /**
+     * @brief Open the track expected to play next, so it follows the current one without a gap
+     *
+     * A later play() of the same path switches to it without loading it
+     * again, also when the engine already went on to it at the end of the
+     * current track.
+     * @param filepath Track to open
+     * @return false if the engine cannot preload
+     */
+    virtual bool preloadNext(const std::string &filepath)
+    {
+        (void)filepath;
+        return false;
+    }
+
+    /**
+     * @brief Forget the track passed to preloadNext()
+     */
+    virtual void clearPreload()
+    {
+    }
+
+    /**
+     * @brief Notify observers of state changes the engine detected on its own threads
+     *
+     * Called every frame on the main thread, also when headless, so
+     * observers only ever run there.
+     */
+    virtual void dispatchEvents()
+    {
+    }
 };
 
 #endif // IPLAYBACK_ENGINE_H
@@ -20,7 +20,9 @@ class MediaFile;
  * @brief Interface for track collections
  *
  * Abstract interface defining common operations for
- * managing collections of MediaFile objects.
+ * managing collections of MediaFile objects. Reading the tracks is left to
+ * each collection: Library hands out a shared snapshot, the others a
+ * reference to their own list.
  */
 class ITrackCollection
 {
@@ -41,12 +43,6 @@ class ITrackCollection
      */
     virtual bool removeTrackByPath(const std::string &path) = 0;
 
-    /**
-     * @brief Get all tracks in the collection
-     * @return Vector of all tracks
-     */
-    virtual const std::vector<std::shared_ptr<MediaFile>> &getTracks() const = 0;
-
     /**
      * @brief Get the number of tracks
      * @return Number of tracks in collection
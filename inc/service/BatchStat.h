@@ -0,0 +1,73 @@
+#ifndef BATCH_STAT_H
+#define BATCH_STAT_H
+
+#include "interfaces/IFileSystem.h"
+#include <string>
+#include <vector>
+
+/**
+ * @file BatchStat.h
+ * @brief Stat many files at once
+ *
+ * Verifying a library means one stat per track. Issued one by one from a
+ * single thread, each call waits for the previous one, which is what makes
+ * startup slow on network and USB mounts. BatchStat keeps many of them in
+ * flight: through io_uring STATX requests where the kernel supports them,
+ * otherwise over a small pool of threads.
+ */
+
+/**
+ * @brief Batched stat over io_uring or a thread pool
+ *
+ * **Thread Safety**: Not thread-safe; each run() sets up its own ring or
+ * threads, so instances are cheap enough to create per call.
+ */
+class BatchStat
+{
+  public:
+    enum class Backend
+    {
+        IO_URING, ///< One ring, up to RING_ENTRIES statx requests in flight (Linux 5.6+)
+        THREADS   ///< stat() spread over worker threads
+    };
+
+    /**
+     * @brief Result for one path
+     */
+    struct Entry
+    {
+        bool found = false; ///< false if the path could not be stat'ed
+        FileFingerprint fingerprint;
+    };
+
+    static constexpr unsigned RING_ENTRIES = 256;
+
+    /**
+     * @param preferred Backend to try first; IO_URING falls back to THREADS when unavailable
+     * @param threads Workers for the THREADS backend (0 = twice the core count, at least 4)
+     */
+    explicit BatchStat(Backend preferred = Backend::IO_URING, unsigned threads = 0);
+
+    /**
+     * @brief Stat every path
+     * @return One entry per path, in the same order
+     */
+    std::vector<Entry> run(const std::vector<std::string> &paths);
+
+    /**
+     * @brief Backend used by the last run() (the preferred one before any run)
+     */
+    Backend getLastBackend() const
+    {
+        return lastBackend_;
+    }
+
+  private:
+    Backend preferred_;
+    Backend lastBackend_;
+    unsigned threads_;
+
+    void runThreads(const std::vector<std::string> &paths, std::vector<Entry> &entries) const;
+};
+
+#endif // BATCH_STAT_H
@@ -0,0 +1,154 @@
+#ifndef DIRECTORY_LOADER_H
+#define DIRECTORY_LOADER_H
+
+#include "interfaces/IFileSystem.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file DirectoryLoader.h
+ * @brief Lists a folder and the media below it off the UI thread
+ *
+ * Browsing a large USB stick means a directory listing, a recursive media
+ * scan and a path resolution per file. DirectoryLoader does all of it on a
+ * worker thread, hands results over in batches as they are found, and keeps
+ * recent listings so going back to a folder is instant.
+ */
+
+/**
+ * @brief Background, cached folder listing
+ *
+ * Only the latest load() matters: starting a new one cancels the one in
+ * progress, and its late results are dropped.
+ *
+ * Cached listings are checked against the modification times of every
+ * folder the scan looked into (down to maxDepth) before reuse, so a file
+ * added anywhere the scan would find it invalidates the listing.
+ *
+ * **Thread Safety**: load(), poll() and wait() are meant for one (UI) thread.
+ */
+class DirectoryLoader
+{
+  public:
+    struct MediaEntry
+    {
+        FileInfo info;
+        std::string canonicalPath; ///< Resolved path when it differs from info.path (symlinks, "..")
+    };
+
+    /**
+     * @brief What changed since the last poll()
+     */
+    struct Update
+    {
+        bool reset = false;            ///< A new listing starts: drop what is shown
+        std::string path;              ///< Folder the update belongs to
+        std::vector<FileInfo> folders; ///< Subfolders (set with reset)
+        std::vector<MediaEntry> media; ///< Media found since the last poll
+        bool complete = false;         ///< The listing is finished
+        bool fromCache = false;        ///< Served from the cache without scanning
+    };
+
+    static constexpr size_t DEFAULT_CACHE_SIZE = 32; ///< Folders kept
+    static constexpr size_t PUBLISH_BATCH = 256;     ///< Files per hand-over while scanning
+
+    /**
+     * @param fileSystem File system to list (not owned)
+     * @param extensions Media extensions to collect
+     * @param maxDepth How deep to look for media below the folder
+     * @param cacheSize Listings kept for reuse (0 disables the cache)
+     */
+    DirectoryLoader(IFileSystem *fileSystem, std::vector<std::string> extensions, int maxDepth = 3,
+                    size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * @brief Cancels the current load and joins the worker
+     */
+    ~DirectoryLoader();
+
+    DirectoryLoader(const DirectoryLoader &) = delete;
+    DirectoryLoader &operator=(const DirectoryLoader &) = delete;
+
+    /**
+     * @brief Start listing a folder, replacing any load in progress
+     * @param force Scan even if a cached listing is still fresh
+     */
+    void load(const std::string &path, bool force = false);
+
+    /**
+     * @brief Take the results that arrived since the last call
+     * @return false if nothing changed
+     */
+    bool poll(Update &update);
+
+    bool isLoading() const;
+
+    /**
+     * @brief Block until the latest load() has finished
+     */
+    void wait();
+
+    size_t getCachedCount() const;
+
+  private:
+    struct Listing
+    {
+        std::vector<FileInfo> folders;
+        std::vector<MediaEntry> media;
+        std::vector<FileCheck> stamps; ///< Folder fingerprints the listing was taken at
+    };
+
+    IFileSystem *fileSystem_;
+    std::vector<std::string> extensions_;
+    int maxDepth_;
+    size_t cacheSize_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_; ///< Worker waits for a request
+    std::condition_variable idle_; ///< wait() waits for completion
+    bool stopping_ = false;
+    bool requested_ = false;
+    std::string requestPath_;
+    bool requestForce_ = false;
+    std::atomic<uint64_t> generation_{0}; ///< Bumped by every load(); older runs stop
+    bool loading_ = false;
+    bool hasUpdate_ = false;
+    Update update_;
+
+    mutable std::mutex cacheMutex_;
+    std::list<std::string> lru_; ///< Most recently used first
+    std::unordered_map<std::string, std::pair<Listing, std::list<std::string>::iterator>> cache_;
+
+    std::thread worker_;
+
+    void run();
+    void list(const std::string &path, bool force, uint64_t generation);
+
+    /**
+     * @brief Hand results to the UI if they belong to the latest load
+     */
+    void publish(uint64_t generation, Update &&update);
+
+    bool lookup(const std::string &path, Listing &listing);
+    void store(const std::string &path, Listing listing);
+    bool isFresh(const Listing &listing);
+    bool stamp(const std::string &directory, std::vector<FileCheck> &stamps);
+
+    /**
+     * @brief Stamp a folder and the folders below it that a scan would enter
+     * @param depth Depth of directory below the loaded folder
+     * @param generation Load the walk belongs to; a newer load() stops it
+     * @return false if a folder could not be stamped (the listing is not cacheable)
+     */
+    bool stampTree(const std::string &directory, int depth, uint64_t generation, std::vector<FileCheck> &stamps);
+    static MediaEntry makeEntry(const std::string &path);
+};
+
+#endif // DIRECTORY_LOADER_H
@@ -0,0 +1,83 @@
+#ifndef FILE_EVENT_COALESCER_H
+#define FILE_EVENT_COALESCER_H
+
+#include "interfaces/IDirectoryWatcher.h"
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @file FileEventCoalescer.h
+ * @brief Merges raw file notifications into debounced batches
+ *
+ * A copy of a thousand files produces thousands of notifications; an
+ * editor saving a file produces several. The coalescer keeps only the
+ * latest state of each path and releases a batch once the file system has
+ * been quiet for a while, or once a continuous burst has gone on too long.
+ */
+
+/**
+ * @brief Debouncing, per-path merging event buffer
+ *
+ * Merging rules:
+ * - The newest event for a path wins (written then deleted = REMOVED;
+ *   deleted then recreated = CHANGED)
+ * - Removing a directory drops pending events for paths below it
+ * - RESCAN events are kept once per folder
+ *
+ * Batches list removals first, then changes, each sorted by path.
+ *
+ * **Thread Safety**: Not thread-safe; owned by the watcher thread.
+ */
+class FileEventCoalescer
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param quietPeriod Release a batch after this long without new events
+     * @param maxDelay Release a batch at the latest this long after its first event
+     */
+    explicit FileEventCoalescer(std::chrono::milliseconds quietPeriod = std::chrono::milliseconds(500),
+                                std::chrono::milliseconds maxDelay = std::chrono::milliseconds(5000));
+
+    void add(const FileEvent &event, Clock::time_point now = Clock::now());
+
+    bool empty() const
+    {
+        return pending_.empty() && rescans_.empty();
+    }
+
+    /**
+     * @brief Whether a batch is due
+     */
+    bool ready(Clock::time_point now = Clock::now()) const;
+
+    /**
+     * @brief When the pending batch becomes due (only meaningful if not empty())
+     */
+    Clock::time_point deadline() const;
+
+    /**
+     * @brief Hand over the pending batch and start a new one
+     */
+    std::vector<FileEvent> take();
+
+  private:
+    std::chrono::milliseconds quietPeriod_;
+    std::chrono::milliseconds maxDelay_;
+    Clock::time_point first_;
+    Clock::time_point last_;
+
+    struct Pending
+    {
+        FileEvent::Kind kind;
+        bool directory;
+    };
+    std::map<std::string, Pending> pending_;
+    std::set<std::string> rescans_;
+};
+
+#endif // FILE_EVENT_COALESCER_H
@@ -2,7 +2,11 @@
 #define HYBRID_METADATA_READER_H
 
 #include "interfaces/IMetadataReader.h"
+#include "service/UnreadableFileCache.h"
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 /**
  * @file HybridMetadataReader.h
@@ -10,12 +14,41 @@
  * 
  * Combines TagLib (fast, audio-focused) and Mpv (slower, unified format support).
  * Prioritizes TagLib, falls back to Mpv for video or missing data.
+ * An optional fast tier (NativeMetadataReader) is asked first; anything it
+ * cannot give a duration for goes down to TagLib and then Mpv.
+ * The secondary reader may be shared, so several hybrids (one per import
+ * worker) can draw on the same pool of mpv probe contexts.
  */
+
+/**
+ * @brief Read counters for one reader tier
+ */
+struct ReaderTierStats
+{
+    std::atomic<uint64_t> hits{0};        ///< Reads that produced a duration
+    std::atomic<uint64_t> misses{0};      ///< Reads that did not
+    std::atomic<uint64_t> totalMicros{0}; ///< Time spent inside the reader
+};
+
+/**
+ * @brief Counters for a family of hybrids (e.g. the import workers' readers)
+ */
+struct HybridReaderStats
+{
+    ReaderTierStats fast;
+    ReaderTierStats primary;
+    ReaderTierStats secondary;
+    std::atomic<uint64_t> routed{0};          ///< Files sent straight to the secondary by type
+    std::atomic<uint64_t> knownUnreadable{0}; ///< Reads skipped thanks to the unreadable-file cache
+};
+
 class HybridMetadataReader : public IMetadataReader
 {
 public:
     HybridMetadataReader(std::unique_ptr<IMetadataReader> primary, 
-                         std::unique_ptr<IMetadataReader> secondary);
+                         std::shared_ptr<IMetadataReader> secondary);
+    HybridMetadataReader(std::unique_ptr<IMetadataReader> fast, std::unique_ptr<IMetadataReader> primary,
+                         std::shared_ptr<IMetadataReader> secondary);
     ~HybridMetadataReader() override = default;
 
     MediaMetadata readMetadata(const std::string &filepath) override;
@@ -23,10 +56,41 @@ public:
     std::map<std::string, std::string> extractTags(const std::string &filepath,
                                                    const std::vector<std::string> &tags) override;
     bool supportsEditing(const std::string &filepath) override;
+    bool readAlbumArt(const std::string &filepath, AlbumArt &art) override;
+
+    /**
+     * @brief Send files with these extensions (e.g. videos) straight to the secondary
+     * @param extensions Lowercase extensions with the dot
+     */
+    void setSecondaryOnlyFormats(std::vector<std::string> extensions);
+
+    /**
+     * @brief Skip files that failed every tier before, and record new failures
+     * @param cache Shared negative cache (null disables it)
+     */
+    void setUnreadableCache(std::shared_ptr<UnreadableFileCache> cache);
+
+    /**
+     * @brief Count into shared counters instead of this reader's own
+     */
+    void setStats(std::shared_ptr<HybridReaderStats> stats);
+
+    const HybridReaderStats &getStats() const
+    {
+        return *stats_;
+    }
 
 private:
+    std::unique_ptr<IMetadataReader> fast_;      // Native parser (optional)
     std::unique_ptr<IMetadataReader> primary_;   // TagLib
-    std::unique_ptr<IMetadataReader> secondary_; // Mpv
+    std::shared_ptr<IMetadataReader> secondary_; // Mpv
+    std::vector<std::string> secondaryOnlyFormats_;
+    std::shared_ptr<UnreadableFileCache> unreadableCache_;
+    std::shared_ptr<HybridReaderStats> stats_;
+
+    bool isSecondaryOnly(const std::string &filepath) const;
+    MediaMetadata readTiers(const std::string &filepath);
+    static MediaMetadata timedRead(IMetadataReader &reader, ReaderTierStats &stats, const std::string &filepath);
 };
 
 #endif // HYBRID_METADATA_READER_H
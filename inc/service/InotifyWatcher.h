@@ -0,0 +1,125 @@
+#ifndef INOTIFY_WATCHER_H
+#define INOTIFY_WATCHER_H
+
+#include "interfaces/IDirectoryWatcher.h"
+#include "service/FileEventCoalescer.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @file InotifyWatcher.h
+ * @brief IDirectoryWatcher on top of Linux inotify
+ *
+ * inotify watches single directories, so every folder below a root gets its
+ * own watch; folders created or moved in later are picked up as they appear.
+ * Raw events go through a FileEventCoalescer and reach the callback in
+ * debounced batches.
+ */
+
+/**
+ * @brief inotify-based directory watcher
+ *
+ * Files are reported once they are complete (IN_CLOSE_WRITE or moved into
+ * place), so a file being copied shows up once, not once per write. When
+ * the kernel queue overflows a RESCAN is reported for every root. When the
+ * watch limit (fs.inotify.max_user_watches) is reached, the folders that
+ * could not be watched are logged and left unwatched.
+ *
+ * Setting up the watches means walking every folder below a root, so it
+ * happens on the watcher thread: start() and addRoot() only hand the root
+ * over and return. getWatchCount() grows as the walks go.
+ *
+ * On other platforms start() returns false.
+ *
+ * **Thread Safety**: addRoot() may be called from any thread; the callback
+ * runs on the watcher thread.
+ */
+class InotifyWatcher : public IDirectoryWatcher
+{
+  public:
+    /**
+     * @param extensions Only report files with these extensions (empty = every file)
+     * @param quietPeriod Deliver a batch after this long without new events
+     * @param maxDelay Deliver a batch at the latest this long after its first event
+     */
+    explicit InotifyWatcher(const std::vector<std::string> &extensions = {},
+                            std::chrono::milliseconds quietPeriod = std::chrono::milliseconds(500),
+                            std::chrono::milliseconds maxDelay = std::chrono::milliseconds(5000));
+
+    ~InotifyWatcher() override;
+
+    bool start(Callback callback) override;
+
+    /**
+     * @brief Queue a folder for the watcher thread to watch
+     * @return true; a folder that cannot be watched is reported in the log
+     */
+    bool addRoot(const std::string &path) override;
+
+    void stop() override;
+
+    /**
+     * @brief Number of directories currently watched
+     */
+    size_t getWatchCount() const;
+
+  private:
+    std::unordered_set<std::string> extensions_;
+    std::chrono::milliseconds quietPeriod_;
+    std::chrono::milliseconds maxDelay_;
+    Callback callback_;
+
+    int inotifyFd_ = -1;
+    int wakeFd_ = -1; ///< eventfd that interrupts poll() on stop() and addRoot()
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::mutex pendingMutex_;
+    std::vector<std::string> pendingRoots_; ///< Added but not yet walked
+
+    mutable std::mutex watchMutex_;
+    std::vector<std::string> roots_;
+    std::unordered_map<int, std::string> watchPaths_; ///< Watch descriptor -> directory
+    std::map<std::string, int> watchDescriptors_;     ///< Directory -> watch descriptor, ordered for subtree lookups
+    bool limitWarned_ = false;
+
+    void run();
+
+    /**
+     * @brief Watch the roots queued by addRoot() (watcher thread)
+     */
+    void watchPendingRoots();
+
+    /**
+     * @brief Interrupt poll() in run()
+     */
+    void wake();
+
+    /**
+     * @brief Handle every event in one read() buffer
+     */
+    void dispatch(const char *buffer, size_t length, FileEventCoalescer &coalescer);
+
+    /**
+     * @brief Watch a directory and every directory below it (caller holds watchMutex_)
+     * @return false if the directory itself could not be watched
+     */
+    bool watchTree(const std::string &path);
+
+    bool watchDirectory(const std::string &path);
+
+    /**
+     * @brief Drop the watches on a directory and everything below it (caller holds watchMutex_)
+     */
+    void unwatchTree(const std::string &path);
+
+    bool accepts(const std::string &filename) const;
+};
+
+#endif // INOTIFY_WATCHER_H
@@ -2,7 +2,13 @@
 #define JSON_PERSISTENCE_H
 
 #include "interfaces/IPersistence.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 /**
  * @file JsonPersistence.h
@@ -17,29 +23,53 @@
  *
  * Concrete implementation of IPersistence.
  * Serializes/deserializes data to/from JSON format.
+ *
+ * Every save replaces the target atomically (temp file, fsync, rename), so
+ * a crash mid-save leaves either the old or the new contents, never a mix.
+ *
+ * In ASYNC mode saveToFile() only queues the data and returns; a writer
+ * thread performs the replacement. Saves to the same path coalesce, so
+ * only the newest contents are written. Reads, appends and deletes see
+ * queued saves, and flush() waits for the queue to drain.
  */
 class JsonPersistence : public IPersistence
 {
   public:
+    enum class WriteMode
+    {
+        SYNC, ///< Write on the caller's thread
+        ASYNC ///< Queue for the writer thread
+    };
+
     /**
      * @brief Constructor
+     * @param mode Whether saves block the caller
      */
-    JsonPersistence() = default;
+    explicit JsonPersistence(WriteMode mode = WriteMode::SYNC);
 
     /**
-     * @brief Destructor
+     * @brief Destructor - flushes queued saves and stops the writer
      */
-    ~JsonPersistence() override = default;
+    ~JsonPersistence() override;
+
+    JsonPersistence(const JsonPersistence &) = delete;
+    JsonPersistence &operator=(const JsonPersistence &) = delete;
 
     // IPersistence implementation
     bool saveToFile(const std::string &filepath, const std::string &data) override;
 
     bool loadFromFile(const std::string &filepath, std::string &data) override;
 
+    bool appendToFile(const std::string &filepath, const std::string &data) override;
+
+    std::shared_ptr<MappedFile> mapFile(const std::string &filepath) override;
+
     bool fileExists(const std::string &filepath) override;
 
     bool deleteFile(const std::string &filepath) override;
 
+    bool flush() override;
+
     std::string serialize(const void *data) override;
 
     bool deserialize(const std::string &serialized, void *data) override;
@@ -51,6 +81,11 @@ class JsonPersistence : public IPersistence
      */
     bool ensureDirectoryExists(const std::string &dirPath);
 
+    WriteMode getWriteMode() const
+    {
+        return mode_;
+    }
+
   private:
     /**
      * @brief Validate JSON string
@@ -59,6 +94,45 @@ class JsonPersistence : public IPersistence
      */
     bool isValidJson(const std::string &jsonStr);
 
+    /**
+     * @brief Replace a file's contents via temp file + fsync + rename
+     * @return true if the new contents are durable
+     */
+    bool writeAtomically(const std::string &filepath, const std::string &data);
+
+    /**
+     * @brief Look up a save that is not on disk yet
+     * @param filepath Path to check
+     * @param data Receives the queued contents (may be nullptr)
+     * @return true if the path has a queued or in-flight save
+     */
+    bool findQueued(const std::string &filepath, std::string *data);
+
+    /**
+     * @brief Block until nothing is queued or in flight for a path
+     */
+    void waitForPath(const std::string &filepath);
+
+    void writerLoop();
+
+    struct QueuedWrite
+    {
+        std::string data;
+        uint64_t sequence = 0; ///< Bumped by every save; tells a finished write if it was superseded
+        bool queued = false;   ///< Path is in order_ (waiting for the writer)
+    };
+
+    WriteMode mode_;
+    std::mutex queueMutex_;
+    std::condition_variable workReady_; ///< Signals the writer
+    std::condition_variable drained_;   ///< Signals flush()/waitForPath() waiters
+    std::unordered_map<std::string, QueuedWrite> queue_;
+    std::deque<std::string> order_; ///< Paths waiting to be written, oldest first
+    uint64_t nextSequence_ = 0;
+    bool writeFailed_ = false;
+    bool stopping_ = false;
+    std::thread writer_;
+
     friend class JsonPersistenceTest;
 };
 
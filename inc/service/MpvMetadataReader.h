@@ -2,20 +2,30 @@
 #define MPV_METADATA_READER_H
 
 #include "interfaces/IMetadataReader.h"
+#include <chrono>
+#include <condition_variable>
 #include <mpv/client.h>
 #include <mutex>
+#include <vector>
 
 /**
  * @file MpvMetadataReader.h
  * @brief IMetadataReader implementation using libmpv
  * 
- * Extracts metadata (duration, title, etc.) using a standalone mpv handle.
- * Useful for video formats not supported by TagLib.
+ * Extracts metadata (duration, title, etc.) using a pool of standalone mpv
+ * handles ("probe contexts"). Useful for video formats not supported by TagLib.
  */
 class MpvMetadataReader : public IMetadataReader
 {
 public:
-    MpvMetadataReader();
+    /**
+     * @brief Create and initialize the probe contexts up front
+     * @param contexts Number of probes that may run at once (at least 1)
+     * @param timeout Deadline for a single file to load
+     * @throws std::runtime_error if no context can be created
+     */
+    explicit MpvMetadataReader(size_t contexts = 1,
+                               std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
     ~MpvMetadataReader() override;
 
     // IMetadataReader implementation
@@ -25,9 +35,35 @@ public:
                                                    const std::vector<std::string> &tags) override;
     bool supportsEditing(const std::string &filepath) override;
 
+    /**
+     * @brief Number of live probe contexts
+     */
+    size_t getContextCount() const;
+
 private:
-    mpv_handle *mpv_ = nullptr;
-    std::mutex mutex_; // Protect access to mpv handle
+    enum class ProbeResult
+    {
+        LOADED,  // Properties are readable; the file must be stopped afterwards
+        FAILED,  // mpv gave up on the file; the context is idle again
+        TIMEOUT  // Deadline passed; the context may still be busy with the file
+    };
+
+    std::chrono::milliseconds timeout_;
+    size_t contextCount_ = 0;
+
+    // Idle contexts; a probe takes one for its whole duration
+    mutable std::mutex poolMutex_;
+    std::condition_variable available_;
+    std::vector<mpv_handle *> idle_;
+
+    static mpv_handle *createContext();
+    mpv_handle *acquire();
+    void release(mpv_handle *mpv);
+
+    ProbeResult load(mpv_handle *mpv, const std::string &filepath);
+    bool settle(mpv_handle *mpv, std::chrono::steady_clock::time_point deadline);
+    mpv_handle *recycle(mpv_handle *mpv);
+    static void extract(mpv_handle *mpv, MediaMetadata &metadata);
 };
 
 #endif // MPV_METADATA_READER_H
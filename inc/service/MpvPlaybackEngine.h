@@ -2,16 +2,32 @@
 #define MPV_PLAYBACK_ENGINE_H
 
 #include "interfaces/IPlaybackEngine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mpv/client.h>
 #include <mpv/render_gl.h>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 /**
  * @file MpvPlaybackEngine.h
  * @brief Playback engine using libmpv
+ *
+ * Pause, idle, position, duration and volume are observed with
+ * mpv_observe_property() and cached from the property-change events, so the
+ * getters read an atomic instead of making a round-trip into the mpv core.
+ *
+ * mpv's events are handled on a dedicated thread as soon as the wakeup
+ * callback fires, independent of the frame rate. End-of-file and errors are
+ * queued for dispatchEvents(), so observers still run on the main thread.
+ *
+ * preloadNext() appends the upcoming track to mpv's playlist. mpv prefetches
+ * it and continues into it at the end of the current file without closing
+ * the audio output; play() of that path then only catches up.
  */
 
 class MpvPlaybackEngine : public IPlaybackEngine
@@ -43,6 +59,9 @@ class MpvPlaybackEngine : public IPlaybackEngine
     void *getVideoTexture() override;
     void getVideoSize(int &width, int &height) override;
     void updateVideo() override;
+    void dispatchEvents() override;
+    bool preloadNext(const std::string &filepath) override;
+    void clearPreload() override;
 
   private:
     struct Impl;
@@ -56,16 +75,64 @@ class MpvPlaybackEngine : public IPlaybackEngine
     unsigned int texture_ = 0;
     int videoWidth_ = 0;
     int videoHeight_ = 0;
-    bool eofReached_ = false; // Track EOF for auto-advance
-    bool errorOccurred_ = false; // Track error state
+    std::atomic<bool> eofReached_{false};    // Track EOF for auto-advance
+    std::atomic<bool> errorOccurred_{false}; // Track error state
+
+    /**
+     * @brief reply_userdata of the observed properties
+     */
+    enum ObservedProperty : uint64_t
+    {
+        PROP_PAUSE = 1,
+        PROP_IDLE_ACTIVE,
+        PROP_TIME_POS,
+        PROP_DURATION,
+        PROP_VOLUME
+    };
+
+    // Last values reported by mpv
+    std::atomic<bool> paused_{false};
+    std::atomic<bool> idle_{true};
+    std::atomic<double> position_{0.0};
+    std::atomic<double> duration_{0.0};
+    std::atomic<double> volume_{100.0}; // mpv scale, 0-100
 
     std::vector<IObserver *> observers_;
     std::mutex observerMutex_;
 
+    // Event thread, woken by mpv's wakeup callback
+    std::thread eventThread_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    bool wakePending_ = false;
+    bool stopEvents_ = false;
+
+    /**
+     * @brief Changes observers are told about, queued by the event thread for the main thread
+     */
+    enum class EngineEvent
+    {
+        END_OF_FILE,
+        ERROR
+    };
+    std::vector<EngineEvent> pendingEvents_;
+    std::mutex pendingMutex_;
+
+    // Gapless playback; the event thread moves preloadPath_ to advancedPath_ when mpv continues into it
+    std::mutex preloadMutex_;
+    std::string preloadPath_;  // Appended to mpv's playlist, not playing yet
+    std::string advancedPath_; // Playing since the previous file ended, play() not called for it yet
+
     void initMpv();
     void initGL();
     void cleanup();
+    void startEventThread();
+    void stopEventThread();
+    void eventLoop();
+    void post(EngineEvent event);
+    void observeProperties();
     void handleEvents();
+    void onPropertyChange(uint64_t id, const mpv_event_property *property);
 
     static void wakeupCallback(void *ctx);
 
@@ -0,0 +1,58 @@
+#ifndef NATIVE_METADATA_READER_H
+#define NATIVE_METADATA_READER_H
+
+#include "interfaces/IMetadataReader.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file NativeMetadataReader.h
+ * @brief Read-only IMetadataReader that parses common audio headers directly
+ *
+ * Maps the file and decodes just the bytes that hold tags and stream
+ * parameters, with no TagLib objects and no copies of audio data:
+ * - MP3: ID3v2.2/2.3/2.4 and ID3v1 tags, Xing/Info (LAME) or VBRI frame
+ *   counts, otherwise the CBR frame header
+ * - FLAC: STREAMINFO, VORBIS_COMMENT and PICTURE blocks
+ * - Ogg Vorbis/Opus: identification and comment headers, last granule position
+ * - MP4/M4A: moov/mvhd, the sound track's sample entry and esds, udta/meta/ilst
+ */
+
+/**
+ * @brief Fast-path metadata reader for bulk imports
+ *
+ * A file counts as answered when a duration could be worked out. Anything
+ * else (other formats, damaged or unusual headers) comes back with a zero
+ * duration so HybridMetadataReader can fall back to a full reader. Album
+ * art is only detected (hasAlbumArt); readAlbumArt() is left to TagLib.
+ *
+ * **Thread Safety**: Stateless; safe to call from several threads.
+ */
+class NativeMetadataReader : public IMetadataReader
+{
+  public:
+    // IMetadataReader implementation
+    MediaMetadata readMetadata(const std::string &filepath) override;
+    bool writeMetadata(const std::string &filepath, const MediaMetadata &metadata) override;
+    std::map<std::string, std::string> extractTags(const std::string &filepath,
+                                                   const std::vector<std::string> &tags) override;
+    bool supportsEditing(const std::string &filepath) override;
+
+    /**
+     * @brief Parse file contents already in memory
+     * @param extension Lowercase extension with the dot (selects the parser)
+     * @param data File bytes
+     * @param size Number of bytes
+     * @param metadata Receives what was found
+     * @return true if the format was recognized and a duration was found
+     */
+    static bool parse(const std::string &extension, const char *data, size_t size, MediaMetadata &metadata);
+
+    /**
+     * @brief Whether an extension has a native parser
+     */
+    static bool isFormatSupported(const std::string &extension);
+};
+
+#endif // NATIVE_METADATA_READER_H
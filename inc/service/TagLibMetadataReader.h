@@ -9,7 +9,8 @@
  * @file TagLibMetadataReader.h
  * @brief Concrete implementation of IMetadataReader using TagLib
  *
- * Provides metadata reading/writing using TagLib library.
+ * Provides metadata reading/writing using TagLib library. A read opens and
+ * parses the file once, whatever it extracts.
  */
 
 /**
@@ -21,9 +22,25 @@
 class TagLibMetadataReader : public IMetadataReader
 {
   public:
-    TagLibMetadataReader() = default;
+    /**
+     * @brief How much readMetadata() extracts
+     */
+    enum class ReadMode
+    {
+        FULL,     ///< Tags, audio properties and whether there is album art
+        TAGS_ONLY ///< Text tags only; skips the audio-property scan and picture lookup
+    };
+
+    explicit TagLibMetadataReader(ReadMode mode = ReadMode::FULL) : mode_(mode)
+    {
+    }
     ~TagLibMetadataReader() override = default;
 
+    ReadMode getReadMode() const
+    {
+        return mode_;
+    }
+
     // IMetadataReader implementation
     MediaMetadata readMetadata(const std::string &filepath) override;
 
@@ -34,7 +51,15 @@ class TagLibMetadataReader : public IMetadataReader
 
     bool supportsEditing(const std::string &filepath) override;
 
+    bool readAlbumArt(const std::string &filepath, AlbumArt &art) override;
+
   private:
+    ReadMode mode_;
+
+    bool readMpeg(const std::string &filepath, MediaMetadata &metadata);
+    bool readFlac(const std::string &filepath, MediaMetadata &metadata);
+    bool readGeneric(const std::string &filepath, MediaMetadata &metadata);
+
     std::string getExtension(const std::string &filepath);
     bool isFormatSupported(const std::string &extension);
 
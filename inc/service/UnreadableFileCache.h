@@ -0,0 +1,81 @@
+#ifndef UNREADABLE_FILE_CACHE_H
+#define UNREADABLE_FILE_CACHE_H
+
+#include "interfaces/IFileSystem.h"
+#include "interfaces/IPersistence.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file UnreadableFileCache.h
+ * @brief Persisted list of files no metadata reader could make sense of
+ *
+ * Broken and zero-length files otherwise go through every reader tier,
+ * mpv probe and timeout included, on each launch and each refresh.
+ */
+
+/**
+ * @brief Negative cache keyed by path and stat fingerprint
+ *
+ * An entry only holds while the file's fingerprint (size, mtime, inode) is
+ * unchanged; a file that is replaced or rewritten is read again and the
+ * stale entry is dropped.
+ *
+ * **Thread Safety**: All methods may be called from any thread. Stat calls
+ * happen outside the lock.
+ */
+class UnreadableFileCache
+{
+  public:
+    static constexpr const char *DEFAULT_PATH = "data/unreadable.json";
+
+    /**
+     * @param persistence Where the list is saved (may be null: the cache then lives in memory only)
+     * @param fileSystem Source of fingerprints
+     * @param filepath File the list is saved to
+     */
+    UnreadableFileCache(IPersistence *persistence, IFileSystem *fileSystem,
+                        const std::string &filepath = DEFAULT_PATH);
+
+    /**
+     * @brief Whether the file failed before and has not changed since
+     */
+    bool isKnownUnreadable(const std::string &path);
+
+    /**
+     * @brief Record that no reader could read the file as it is now
+     * Files that cannot be stat'ed are not recorded.
+     */
+    void markUnreadable(const std::string &path);
+
+    /**
+     * @brief Drop the entry for a file
+     */
+    void forget(const std::string &path);
+
+    size_t size() const;
+
+    /**
+     * @brief Replace the entries with the saved list
+     * @return true if a list was loaded
+     */
+    bool load();
+
+    /**
+     * @brief Save the list if it changed since the last load() or save()
+     * @return false if a save was needed and failed
+     */
+    bool save();
+
+  private:
+    IPersistence *persistence_;
+    IFileSystem *fileSystem_;
+    std::string filepath_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, FileFingerprint> entries_;
+    bool dirty_ = false;
+};
+
+#endif // UNREADABLE_FILE_CACHE_H
@@ -0,0 +1,120 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @file BoundedQueue.h
+ * @brief Blocking multi-producer, multi-consumer queue with a fixed capacity
+ *
+ * Connects pipeline stages: a producer that outruns its consumer blocks in
+ * push() instead of growing the queue without limit (back-pressure).
+ */
+
+/**
+ * @brief Bounded blocking queue
+ *
+ * close() ends the stream: later pushes fail, and pops drain what is left
+ * and then report CLOSED.
+ *
+ * **Thread Safety**: All methods may be called from any thread.
+ */
+template <typename T> class BoundedQueue
+{
+  public:
+    enum class PopResult
+    {
+        ITEM,    ///< A value was popped
+        TIMEOUT, ///< Nothing arrived in time; the queue is still open
+        CLOSED   ///< Closed and drained
+    };
+
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    /**
+     * @brief Append a value, waiting while the queue is full
+     * @return false if the queue was closed (the value is dropped)
+     */
+    bool push(T value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_)
+            return false;
+
+        items_.push_back(std::move(value));
+        lock.unlock();
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest value, waiting while the queue is empty
+     * @return false once the queue is closed and drained
+     */
+    bool pop(T &value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        return takeLocked(lock, value);
+    }
+
+    /**
+     * @brief Take the oldest value, waiting at most timeout
+     */
+    PopResult popFor(T &value, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!notEmpty_.wait_for(lock, timeout, [this]() { return closed_ || !items_.empty(); }))
+            return PopResult::TIMEOUT;
+        return takeLocked(lock, value) ? PopResult::ITEM : PopResult::CLOSED;
+    }
+
+    /**
+     * @brief Refuse further pushes and wake every waiter
+     */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+  private:
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    bool closed_ = false;
+
+    bool takeLocked(std::unique_lock<std::mutex> &lock, T &value)
+    {
+        if (items_.empty())
+            return false;
+
+        value = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return true;
+    }
+};
+
+#endif // BOUNDED_QUEUE_H
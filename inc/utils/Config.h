@@ -47,6 +47,20 @@ struct AppConfig
     // Playback settings
     int maxHistorySize = 50;
 
+    // Library settings
+    bool binaryLibrary = false;        // Save/load data/library.bin instead of library.json
+    bool journaledSaves = false;       // Append changes to journals instead of rewriting whole files
+    bool parallelScan = false;         // Walk directories on a work-stealing thread pool
+    int metadataProbes = 4;            // mpv contexts probing files in parallel
+    int metadataProbeTimeoutMs = 2000; // Give up on a file that mpv cannot open in this time
+    int albumArtCacheMB = 32;          // Cover images kept in memory (least recently shown are dropped)
+    bool nativeTagReader = true;       // Parse MP3/FLAC/Ogg/MP4 headers directly before trying TagLib
+    bool watchLibrary = true;          // Follow library folders with inotify instead of rescanning them
+    bool gaplessPlayback = true;       // Open the next track ahead of time and switch to it without a gap
+
+    // Folders imported into the library, watched for changes when watchLibrary is set
+    std::vector<std::string> libraryFolders;
+
     // Supported formats
     std::vector<std::string> supportedAudioFormats = {".mp3", ".wav", ".flac", ".ogg", ".m4a"};
     std::vector<std::string> supportedVideoFormats = {".mp4", ".avi", ".mkv", ".mov"};
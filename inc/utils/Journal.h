@@ -0,0 +1,112 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "interfaces/IPersistence.h"
+#include <atomic>
+#include <functional>
+#include <json.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file Journal.h
+ * @brief Append-only mutation log in front of a full snapshot file
+ *
+ * Lets a model persist each change with one small append instead of
+ * rewriting its whole file, and fold the log back into the snapshot later.
+ */
+
+/**
+ * @brief Write-ahead journal of JSON records (one per line)
+ *
+ * The owner appends a record for every mutation and replays the journal
+ * after loading its base snapshot. Records must be idempotent (applying
+ * one that the snapshot already contains changes nothing), which lets
+ * compaction run without stopping writers: a record appended while the
+ * base is being written keeps the journal alive until the next compaction.
+ *
+ * Once the journal holds compactThreshold records, compaction starts on a
+ * background thread; compact() runs it synchronously (e.g. on shutdown).
+ *
+ * **Thread Safety**: All methods are thread-safe. The base writer is called
+ * without the journal lock held, so it may take the owner's own lock, and
+ * append() may be called with that lock held.
+ */
+class Journal
+{
+  public:
+    /**
+     * @brief Writes the owner's full snapshot; returns false on failure
+     */
+    using BaseWriter = std::function<bool()>;
+
+    /**
+     * @brief Constructor
+     * @param persistence Persistence layer to write through
+     * @param filepath Journal file
+     * @param writeBase Callback that writes the owner's base snapshot
+     * @param compactThreshold Records after which background compaction starts
+     */
+    Journal(IPersistence *persistence, std::string filepath, BaseWriter writeBase, size_t compactThreshold = 256);
+
+    /**
+     * @brief Destructor - waits for a running compaction
+     */
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    /**
+     * @brief Append one record
+     * @param record JSON object describing the mutation
+     * @return true if the record reached the persistence layer
+     */
+    bool append(const nlohmann::json &record);
+
+    /**
+     * @brief Apply every complete record in the journal file
+     * A torn final line (crash mid-append) ends the replay.
+     * @param apply Called once per record, in append order
+     * @return Number of records applied
+     */
+    size_t replay(const std::function<void(const nlohmann::json &)> &apply);
+
+    /**
+     * @brief Write the base snapshot and drop the records it now contains
+     * @return false if the base could not be written
+     */
+    bool compact();
+
+    /**
+     * @brief Block until a background compaction (if any) has finished
+     */
+    void waitForCompaction();
+
+    /**
+     * @brief Records appended since the journal was last emptied
+     */
+    size_t pending() const;
+
+    const std::string &getPath() const
+    {
+        return filepath_;
+    }
+
+  private:
+    IPersistence *persistence_;
+    std::string filepath_;
+    BaseWriter writeBase_;
+    size_t compactThreshold_;
+
+    mutable std::mutex mutex_; ///< Guards the file, counters and thread handle
+    size_t pending_ = 0;       ///< Records in the journal file
+    uint64_t appended_ = 0;    ///< Total records ever appended (compaction watermark)
+    std::atomic<bool> compacting_{false};
+    std::thread compactor_;
+
+    void startBackgroundCompaction();
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,71 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @file MappedFile.h
+ * @brief Read-only view of a whole file's bytes
+ *
+ * Backed either by a read-only mmap of the file or by an owned buffer, so
+ * binary decoders can work on a flat byte range without caring which.
+ */
+
+/**
+ * @brief Read-only file contents
+ *
+ * Non-copyable; share it through std::shared_ptr. The bytes stay valid for
+ * the lifetime of the object.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * @brief Map a file read-only
+     * @param filepath File to map
+     * @return Mapped file, or nullptr if it cannot be opened or mapped
+     */
+    static std::shared_ptr<MappedFile> open(const std::string &filepath);
+
+    /**
+     * @brief Wrap bytes that were already read into memory
+     * @param bytes File contents (moved in)
+     * @return Buffer-backed file
+     */
+    static std::shared_ptr<MappedFile> fromString(std::string bytes);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Whether the bytes come from mmap rather than an owned buffer
+     */
+    bool isMapped() const
+    {
+        return mapping_ != nullptr;
+    }
+
+  private:
+    MappedFile() = default;
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    void *mapping_ = nullptr; ///< mmap base, nullptr for buffer-backed files
+    std::string owned_;
+};
+
+#endif // MAPPED_FILE_H
@@ -8,6 +8,9 @@
 #include "service/MpvMetadataReader.h"
 #include "service/TagLibMetadataReader.h"
 #include "service/HybridMetadataReader.h"
+#include "service/InotifyWatcher.h"
+#include "service/NativeMetadataReader.h"
+#include "app/model/MediaFileFactory.h"
 #include "utils/Config.h"
 #include "utils/Logger.h"
 #include "hal/S32K144Interface.h"
@@ -15,12 +18,50 @@
 #include <SDL.h>
 #include <SDL_opengl.h>
 #include <backends/imgui_impl_opengl3.h>
+#include <algorithm>
 #include <backends/imgui_impl_sdl2.h>
 #include <chrono>
 #include <fstream>
 #include <imgui.h>
 #include <thread>
 
+namespace
+{
+/**
+ * Native parser (optional) -> TagLib -> the shared mpv probe pool; videos go straight to mpv
+ */
+std::unique_ptr<IMetadataReader> createMetadataReader(std::shared_ptr<IMetadataReader> mpvReader,
+                                                      std::shared_ptr<UnreadableFileCache> unreadableCache,
+                                                      std::shared_ptr<HybridReaderStats> stats)
+{
+    const AppConfig &config = Config::getInstance().getConfig();
+    std::unique_ptr<HybridMetadataReader> reader;
+    if (config.nativeTagReader)
+    {
+        reader = std::make_unique<HybridMetadataReader>(std::make_unique<NativeMetadataReader>(),
+                                                        std::make_unique<TagLibMetadataReader>(), std::move(mpvReader));
+    }
+    else
+    {
+        reader = std::make_unique<HybridMetadataReader>(std::make_unique<TagLibMetadataReader>(), std::move(mpvReader));
+    }
+    reader->setSecondaryOnlyFormats(config.supportedVideoFormats);
+    reader->setUnreadableCache(std::move(unreadableCache));
+    reader->setStats(std::move(stats));
+    return reader;
+}
+
+void logTierStats(const char *name, const ReaderTierStats &tier)
+{
+    uint64_t reads = tier.hits + tier.misses;
+    if (reads == 0)
+        return;
+    Logger::info(std::string("Metadata reader ") + name + ": " + std::to_string(tier.hits.load()) + " hits, " +
+                 std::to_string(tier.misses.load()) + " misses, " +
+                 std::to_string(tier.totalMicros / reads) + " us per read");
+}
+} // namespace
+
 Application::Application()
     : window_(nullptr), renderer_(nullptr), glContext_(nullptr), shouldQuit_(false), initialized_(false), headless_(false)
 {
@@ -36,6 +77,9 @@ Application::~Application()
 bool Application::init(bool headless)
 {
     headless_ = headless;
+    initStarted_ = std::chrono::steady_clock::now();
+    timeToFirstFrame_ = std::chrono::milliseconds(0);
+    firstFrameDone_ = false;
     Logger::info("Initializing application" + std::string(headless_ ? " in headless mode" : "") + "...");
 
     try
@@ -64,15 +108,7 @@ bool Application::init(bool headless)
             Logger::warn("Failed to load application state");
         }
 
-        // Verify and refresh library to ensure data integrity and fix metadata issues
-        if (libraryController_) 
-        {
-            Logger::info("Verifying library integrity...");
-            libraryController_->verifyLibrary();
-            
-            Logger::info("Refreshing library metadata...");
-            libraryController_->refreshLibrary();
-        }
+        // Library verification and metadata refresh wait until the saved library is on screen (onFirstFrame)
 
         initialized_ = true;
         Logger::info("Application initialized successfully");
@@ -191,16 +227,30 @@ bool Application::initImGui()
 
 bool Application::createServices()
 {
-    persistence_ = std::make_unique<JsonPersistence>();
+    // Saves go to a background writer; saveState() flushes before shutdown
+    persistence_ = std::make_unique<JsonPersistence>(JsonPersistence::WriteMode::ASYNC);
     Config::getInstance().init(persistence_.get());
     if (!Config::getInstance().load())
     {
         Logger::warn("Failed to load configuration, using defaults");
     }
-    auto tagLibReader = std::make_unique<TagLibMetadataReader>();
-    auto mpvReader = std::make_unique<MpvMetadataReader>();
-    metadataReader_ = std::make_unique<HybridMetadataReader>(std::move(tagLibReader), std::move(mpvReader));
-    fileSystem_ = std::make_unique<LocalFileSystem>();
+    // One pool of mpv probe contexts serves every reader, including the import workers'
+    const AppConfig &appConfig = Config::getInstance().getConfig();
+    mpvReader_ = std::make_shared<MpvMetadataReader>(
+        static_cast<size_t>(std::max(1, appConfig.metadataProbes)),
+        std::chrono::milliseconds(std::max(100, appConfig.metadataProbeTimeoutMs)));
+    fileSystem_ = std::make_unique<LocalFileSystem>(Config::getInstance().getConfig().parallelScan
+                                                        ? LocalFileSystem::ScanMode::PARALLEL
+                                                        : LocalFileSystem::ScanMode::SEQUENTIAL);
+    // Files that defeated every reader stay skipped until they change on disk
+    unreadableCache_ = std::make_shared<UnreadableFileCache>(persistence_.get(), fileSystem_.get());
+    unreadableCache_->load();
+    readerStats_ = std::make_shared<HybridReaderStats>();
+    metadataReader_ = createMetadataReader(mpvReader_, unreadableCache_, readerStats_);
+    if (appConfig.watchLibrary)
+    {
+        directoryWatcher_ = std::make_unique<InotifyWatcher>(MediaFileFactory::getAllSupportedFormats());
+    }
     playbackEngine_ = std::make_unique<MpvPlaybackEngine>();
 
     auto s32k = std::make_unique<S32K144Interface>();
@@ -223,9 +273,20 @@ bool Application::createServices()
 bool Application::createModels()
 {
     library_ = std::make_unique<Library>(persistence_.get());
+    if (Config::getInstance().getConfig().binaryLibrary)
+    {
+        library_->enableBinarySnapshot();
+    }
     playlistManager_ = std::make_unique<PlaylistManager>(persistence_.get());
+    if (Config::getInstance().getConfig().journaledSaves)
+    {
+        library_->enableJournal();
+        playlistManager_->enableJournal();
+    }
     history_ = std::make_unique<History>(100);
     playbackState_ = std::make_unique<PlaybackState>();
+    size_t artCacheBytes = static_cast<size_t>(std::max(1, Config::getInstance().getConfig().albumArtCacheMB)) << 20;
+    albumArtStore_ = std::make_unique<AlbumArtStore>(metadataReader_.get(), artCacheBytes);
     return true;
 }
 
@@ -239,8 +300,15 @@ bool Application::createControllers()
         initialVolume = Config::getInstance().getConfig().defaultVolume;
     }
     playbackController_->setVolume(initialVolume);
+    playbackController_->setGapless(Config::getInstance().getConfig().gaplessPlayback);
     libraryController_ = std::make_unique<LibraryController>(library_.get(), fileSystem_.get(), metadataReader_.get(),
                                                              playbackController_.get());
+    // Import workers each get their own readers instead of contending on the shared one
+    libraryController_->setMetadataReaderFactory(
+        [mpvReader = mpvReader_, cache = unreadableCache_, stats = readerStats_]()
+        { return createMetadataReader(mpvReader, cache, stats); });
+    libraryController_->setDirectoryWatcher(directoryWatcher_.get());
+    libraryController_->setLibraryFolders(Config::getInstance().getConfig().libraryFolders);
     playlistController_ =
         std::make_unique<PlaylistController>(playlistManager_.get(), library_.get(), metadataReader_.get());
     historyController_ = std::make_unique<HistoryController>(history_.get(), playbackController_.get());
@@ -265,10 +333,21 @@ bool Application::createViews()
         viewFactory_->createNowPlayingView(playbackController_.get(), playbackState_.get())));
     if (auto *npView = dynamic_cast<NowPlayingView *>(mainWindow_->getNowPlayingView()))
     {
-        npView->setPlaylistManager(playlistManager_.get());
+        npView->setPlaylistController(playlistController_.get());
+    }
+    auto *historyView = dynamic_cast<HistoryView *>(viewFactory_->createHistoryView(
+        historyController_.get(), history_.get(), playbackController_.get(), playlistManager_.get()));
+    mainWindow_->setHistoryView(historyView);
+
+    // "Add to Playlist" goes through the controller so the change is journaled
+    if (mainWindow_->getLibraryView())
+    {
+        mainWindow_->getLibraryView()->setPlaylistController(playlistController_.get());
+    }
+    if (historyView)
+    {
+        historyView->setPlaylistController(playlistController_.get());
     }
-    mainWindow_->setHistoryView(dynamic_cast<HistoryView *>(viewFactory_->createHistoryView(
-        historyController_.get(), history_.get(), playbackController_.get(), playlistManager_.get())));
     mainWindow_->setFileBrowserView(dynamic_cast<FileBrowserView *>(
         viewFactory_->createFileBrowserView(fileSystem_.get(), libraryController_.get())));
     return true;
@@ -301,6 +380,7 @@ void Application::wireObservers()
                 if (playbackState_)
                 {
                     playbackState_->removeTrackFromBackStack(path);
+                    playbackState_->removeTrackFromQueue(path);
                 }
             });
     }
@@ -319,6 +399,7 @@ void Application::wireObservers()
     }
     mainWindow_->setPlaybackController(playbackController_.get());
     mainWindow_->setPlaybackState(playbackState_.get());
+    mainWindow_->setAlbumArtStore(albumArtStore_.get());
 
     if (playbackController_)
     {
@@ -359,12 +440,17 @@ bool Application::loadState()
 
 bool Application::saveState()
 {
+    if (libraryController_)
+        Config::getInstance().getConfig().libraryFolders = libraryController_->getLibraryFolders();
     Config::getInstance().save();
     if (library_)
         library_->save();
     if (playlistManager_)
         playlistManager_->saveAll();
-    return true;
+    if (unreadableCache_)
+        unreadableCache_->save();
+    // Block until the background writer has made every save durable
+    return persistence_ ? persistence_->flush() : true;
 }
 
 void Application::run()
@@ -406,6 +492,17 @@ void Application::runOneFrame(float deltaTime)
     if (!initialized_)
         return;
 
+    // Hand engine events (end of file, errors) to the observers, here on the main thread
+    if (playbackEngine_)
+    {
+        playbackEngine_->dispatchEvents();
+    }
+    // Tracks the folder watcher found deleted; their removal reaches the queue, playlists and history
+    if (libraryController_)
+    {
+        libraryController_->dispatchFileEvents();
+    }
+
     // Update playback controller
     if (playbackController_)
     {
@@ -453,6 +550,27 @@ void Application::runOneFrame(float deltaTime)
 
         SDL_GL_SwapWindow(window_);
     }
+
+    if (!firstFrameDone_)
+    {
+        onFirstFrame();
+    }
+}
+
+void Application::onFirstFrame()
+{
+    firstFrameDone_ = true;
+    timeToFirstFrame_ =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - initStarted_);
+    Logger::info("Time to first frame: " + std::to_string(timeToFirstFrame_.count()) + " ms");
+
+    // Check and re-read the library in the background; changes stream into the views
+    if (libraryController_)
+    {
+        libraryController_->startMaintenance();
+        // From here on, changes in the library folders are applied as they happen
+        libraryController_->startWatching();
+    }
 }
 
 void Application::shutdown()
@@ -465,6 +583,14 @@ void Application::shutdown()
 
     Logger::info("Shutting down application...");
 
+    // Stop background imports so the saved library does not race with their commits
+    if (libraryController_)
+    {
+        libraryController_->stopWatching();
+        libraryController_->cancelImports();
+        libraryController_->waitForImports();
+    }
+
     saveState();
 
     if (playbackController_)
@@ -511,6 +637,7 @@ void Application::shutdown()
     libraryController_.reset();
 
     playbackState_.reset();
+    albumArtStore_.reset();
     history_.reset();
     playlistManager_.reset();
     library_.reset();
@@ -518,7 +645,16 @@ void Application::shutdown()
     hardwareInterface_.reset();
     // playbackEngine_.reset(); // Already reset
     fileSystem_.reset();
+    if (readerStats_)
+    {
+        logTierStats("native", readerStats_->fast);
+        logTierStats("taglib", readerStats_->primary);
+        logTierStats("mpv", readerStats_->secondary);
+    }
     metadataReader_.reset();
+    mpvReader_.reset();
+    unreadableCache_.reset();
+    readerStats_.reset();
     persistence_.reset();
 
     initialized_ = false; // Mark as shut down
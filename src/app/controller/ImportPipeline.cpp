@@ -0,0 +1,277 @@
+#include "app/controller/ImportPipeline.h"
+#include "app/model/MediaFileFactory.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <map>
+
+ImportPipeline::ImportPipeline(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader)
+    : ImportPipeline(library, fileSystem, metadataReader, Options())
+{
+}
+
+ImportPipeline::ImportPipeline(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader,
+                               const Options &options)
+    : library_(library), fileSystem_(fileSystem), metadataReader_(metadataReader), options_(options),
+      paths_(options.queueCapacity), files_(options.queueCapacity)
+{
+    if (options_.readers == 0)
+    {
+        options_.readers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options_.batchSize = std::max<size_t>(1, options_.batchSize);
+    options_.reorderWindow = std::max<size_t>(1, options_.reorderWindow);
+}
+
+ImportPipeline::~ImportPipeline()
+{
+    cancel();
+    wait();
+}
+
+bool ImportPipeline::start(const std::string &directoryPath, const std::vector<std::string> &extensions)
+{
+    if (!fileSystem_)
+    {
+        return false;
+    }
+
+    return launch(
+        [this, directoryPath, extensions]()
+        {
+            // A parallel scan calls back from several walker threads. Numbering and queueing under
+            // one lock keeps the queue in sequence order, which the reorder window relies on
+            std::mutex order;
+            size_t sequence = 0;
+            fileSystem_->scanDirectoryStreaming(directoryPath, extensions, -1,
+                                                [this, &order, &sequence](const std::string &path)
+                                                {
+                                                    std::lock_guard<std::mutex> lock(order);
+                                                    return enqueue(sequence++, path);
+                                                });
+        },
+        directoryPath, options_.readers);
+}
+
+bool ImportPipeline::start(std::vector<std::string> filepaths)
+{
+    std::string description = std::to_string(filepaths.size()) + " files";
+    size_t count = filepaths.size();
+    return launch(
+        [this, filepaths = std::move(filepaths)]()
+        {
+            for (size_t i = 0; i < filepaths.size(); ++i)
+            {
+                if (!enqueue(i, filepaths[i]))
+                    break;
+            }
+        },
+        description, count);
+}
+
+bool ImportPipeline::launch(std::function<void()> source, const std::string &description, size_t maxReaders)
+{
+    if (!library_ || !metadataReader_)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    if (started_)
+    {
+        return false;
+    }
+    started_ = true;
+    running_ = true;
+
+    // A handful of files does not need a reader (and its private metadata reader) per core
+    options_.readers = std::max<size_t>(1, std::min(options_.readers, maxReaders));
+    Logger::info("Starting import of " + description + " with " + std::to_string(options_.readers) + " readers");
+
+    activeReaders_ = options_.readers;
+    threads_.emplace_back(
+        [this, source = std::move(source)]()
+        {
+            source();
+            paths_.close();
+        });
+    for (size_t i = 0; i < options_.readers; ++i)
+    {
+        threads_.emplace_back(&ImportPipeline::readStage, this);
+    }
+    threads_.emplace_back(&ImportPipeline::commitStage, this);
+    return true;
+}
+
+bool ImportPipeline::enqueue(size_t sequence, const std::string &path)
+{
+    // Blocks while the readers are behind
+    if (cancelled_ || !paths_.push(Sequenced<std::string>{sequence, path}))
+    {
+        return false;
+    }
+    discovered_++;
+    return true;
+}
+
+void ImportPipeline::cancel()
+{
+    if (cancelled_.exchange(true))
+    {
+        return;
+    }
+
+    // Unblock a scanner waiting for room; readers notice the flag and drain
+    paths_.close();
+    std::lock_guard<std::mutex> lock(windowMutex_);
+    windowCv_.notify_all();
+}
+
+void ImportPipeline::wait()
+{
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    for (auto &thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+ImportProgress ImportPipeline::getProgress() const
+{
+    ImportProgress progress;
+    progress.discovered = discovered_.load();
+    progress.processed = processed_.load();
+    progress.added = added_.load();
+    progress.running = running_.load();
+    progress.cancelled = cancelled_.load();
+    return progress;
+}
+
+void ImportPipeline::readStage()
+{
+    std::unique_ptr<IMetadataReader> ownReader;
+    if (options_.readerFactory)
+    {
+        ownReader = options_.readerFactory();
+    }
+    IMetadataReader *reader = ownReader ? ownReader.get() : metadataReader_;
+
+    Sequenced<std::string> item;
+    while (paths_.pop(item))
+    {
+        if (cancelled_ || !waitForWindow(item.sequence))
+        {
+            continue;
+        }
+
+        // Known files and unsupported types are not worth opening
+        Sequenced<std::shared_ptr<MediaFile>> result;
+        result.sequence = item.sequence;
+        if (!library_->contains(item.value) && MediaFile(item.value).getType() != MediaType::UNKNOWN)
+        {
+            result.value = MediaFileFactory::createMediaFile(item.value, reader, fileSystem_);
+        }
+        files_.push(std::move(result));
+        processed_++;
+    }
+
+    // The last reader out ends the committer's input
+    if (activeReaders_.fetch_sub(1) == 1)
+    {
+        files_.close();
+    }
+}
+
+bool ImportPipeline::waitForWindow(size_t sequence)
+{
+    // The queue hands out paths in sequence order, so the reader holding the next one to
+    // commit is never the one waiting here
+    std::unique_lock<std::mutex> lock(windowMutex_);
+    windowCv_.wait(lock, [&]() { return cancelled_ || sequence < nextToCommit_ + options_.reorderWindow; });
+    return !cancelled_;
+}
+
+void ImportPipeline::commitStage()
+{
+    using ResultQueue = BoundedQueue<Sequenced<std::shared_ptr<MediaFile>>>;
+
+    std::vector<std::shared_ptr<MediaFile>> batch;
+    batch.reserve(options_.batchSize);
+    auto batchStarted = std::chrono::steady_clock::now();
+
+    // Results that finished ahead of an earlier, slower one wait here
+    std::map<size_t, std::shared_ptr<MediaFile>> early;
+    size_t next = 0;
+
+    while (true)
+    {
+        Sequenced<std::shared_ptr<MediaFile>> result;
+        auto status = files_.popFor(result, options_.maxBatchDelay);
+        if (status == ResultQueue::PopResult::CLOSED)
+        {
+            break;
+        }
+        if (status == ResultQueue::PopResult::ITEM)
+        {
+            early.emplace(result.sequence, std::move(result.value));
+            size_t first = next;
+            for (auto it = early.begin(); it != early.end() && it->first == next; it = early.erase(it), ++next)
+            {
+                if (!it->second)
+                    continue;
+                if (batch.empty())
+                    batchStarted = std::chrono::steady_clock::now();
+                batch.push_back(std::move(it->second));
+            }
+            if (next != first)
+            {
+                std::lock_guard<std::mutex> lock(windowMutex_);
+                nextToCommit_ = next;
+                windowCv_.notify_all();
+            }
+        }
+
+        // Full batches go at once; a trickle still shows up within maxBatchDelay
+        if (batch.size() >= options_.batchSize ||
+            (!batch.empty() && std::chrono::steady_clock::now() - batchStarted >= options_.maxBatchDelay))
+        {
+            commit(batch);
+        }
+    }
+
+    // After a cancel, dropped paths leave gaps; keep the order of what was read
+    for (auto &entry : early)
+    {
+        if (entry.second)
+            batch.push_back(std::move(entry.second));
+    }
+    commit(batch);
+    running_ = false;
+
+    ImportProgress progress = getProgress();
+    Logger::info("Import " + std::string(progress.cancelled ? "cancelled" : "finished") + ": added " +
+                 std::to_string(progress.added) + " of " + std::to_string(progress.discovered) + " files found");
+    if (progressCallback_)
+    {
+        progressCallback_(progress);
+    }
+}
+
+void ImportPipeline::commit(std::vector<std::shared_ptr<MediaFile>> &batch)
+{
+    if (batch.empty())
+    {
+        return;
+    }
+
+    added_ += library_->addMediaBatch(batch);
+    batch.clear();
+
+    if (progressCallback_ && running_)
+    {
+        progressCallback_(getProgress());
+    }
+}
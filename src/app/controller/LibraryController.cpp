@@ -1,10 +1,29 @@
 #include "app/controller/LibraryController.h"
 #include "app/model/MediaFileFactory.h"
-#include "app/model/MediaFileFactory.h"
 #include "utils/Logger.h"
-#include <thread>
+#include <algorithm>
+#include <filesystem>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+bool isUnderFolder(const std::string &path, const std::string &folder)
+{
+    size_t length = folder.size();
+    while (length > 1 && folder[length - 1] == '/')
+    {
+        --length; // "/music/" and "/music" are the same folder
+    }
+    return path.size() > length && path.compare(0, length, folder, 0, length) == 0 && path[length] == '/';
+}
+} // namespace
+
 LibraryController::LibraryController(Library *library, IFileSystem *fileSystem, IMetadataReader *metadataReader,
                                      PlaybackController *playbackController)
     : library_(library), fileSystem_(fileSystem), metadataReader_(metadataReader),
@@ -12,6 +31,16 @@ LibraryController::LibraryController(Library *library, IFileSystem *fileSystem,
 {
 }
 
+LibraryController::~LibraryController()
+{
+    stopWatching();
+    maintenanceCancelled_ = true;
+    if (maintenanceThread_.joinable())
+    {
+        maintenanceThread_.join();
+    }
+}
+
 int LibraryController::addMediaFilesFromDirectory(const std::string &directoryPath, bool /*recursive*/)
 {
     if (!fileSystem_ || !library_)
@@ -19,20 +48,377 @@ int LibraryController::addMediaFilesFromDirectory(const std::string &directoryPa
         return 0;
     }
 
-    // scanDirectory returns vector<string> of file paths
-    auto filepaths = fileSystem_->scanDirectory(directoryPath, MediaFileFactory::getAllSupportedFormats());
-    int addedCount = 0;
+    ImportPipeline pipeline(library_, fileSystem_, metadataReader_, importOptions());
+    if (!pipeline.start(directoryPath, MediaFileFactory::getAllSupportedFormats()))
+    {
+        return 0;
+    }
+    pipeline.wait();
+
+    int addedCount = static_cast<int>(pipeline.getProgress().added);
+    Logger::info("Added " + std::to_string(addedCount) + " files from " + directoryPath);
+    return addedCount;
+}
 
-    for (const auto &filepath : filepaths)
+bool LibraryController::startDirectoryImport(const std::string &directoryPath)
+{
     {
-        if (addMediaFile(filepath))
+        std::lock_guard<std::mutex> lock(importMutex_);
+        if (import_ && import_->getProgress().running)
         {
-            addedCount++;
+            return false;
+        }
+
+        // Joins the previous, finished pipeline before replacing it
+        import_ = std::make_unique<ImportPipeline>(library_, fileSystem_, metadataReader_, importOptions());
+        if (!import_->start(directoryPath, MediaFileFactory::getAllSupportedFormats()))
+        {
+            return false;
         }
     }
 
-    Logger::info("Added " + std::to_string(addedCount) + " files from " + directoryPath);
-    return addedCount;
+    addLibraryFolder(directoryPath);
+    return true;
+}
+
+void LibraryController::cancelDirectoryImport()
+{
+    std::lock_guard<std::mutex> lock(importMutex_);
+    if (import_)
+    {
+        import_->cancel();
+    }
+}
+
+void LibraryController::cancelImports()
+{
+    std::lock_guard<std::mutex> lock(importMutex_);
+    maintenanceCancelled_ = true;
+    if (import_)
+    {
+        import_->cancel();
+    }
+    for (auto &run : fileImports_)
+    {
+        run->cancel();
+    }
+}
+
+void LibraryController::waitForImports()
+{
+    std::lock_guard<std::mutex> lock(importMutex_);
+    if (maintenanceThread_.joinable())
+    {
+        maintenanceThread_.join();
+    }
+    if (import_)
+    {
+        import_->wait();
+    }
+    for (auto &run : fileImports_)
+    {
+        run->wait();
+    }
+}
+
+bool LibraryController::startMaintenance(std::function<void()> onFinished)
+{
+    std::lock_guard<std::mutex> lock(importMutex_);
+    if (!library_ || maintenanceRunning_)
+    {
+        return false;
+    }
+    if (maintenanceThread_.joinable())
+    {
+        maintenanceThread_.join(); // The previous pass has already finished
+    }
+
+    maintenanceCancelled_ = false;
+    maintenanceRunning_ = true;
+    maintenanceThread_ = std::thread(
+        [this, onFinished = std::move(onFinished)]()
+        {
+#ifdef __linux__
+            // Nice just this thread so playback and rendering win any contention
+            setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+            auto started = std::chrono::steady_clock::now();
+            // A binary load leaves search indexing for now; search() scans until it is done
+            library_->buildSearchIndex();
+            Logger::info("Verifying library integrity...");
+            VerifyResult verified;
+            verifyTracks(&maintenanceCancelled_, &verified);
+            if (!maintenanceCancelled_)
+            {
+                Logger::info("Refreshing library metadata...");
+                refreshTracks(&maintenanceCancelled_, &verified);
+            }
+
+            auto elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            Logger::info("Library maintenance " + std::string(maintenanceCancelled_ ? "cancelled" : "finished") +
+                         " after " + std::to_string(elapsed.count()) + " ms");
+            maintenanceRunning_ = false;
+            if (onFinished)
+            {
+                onFinished();
+            }
+        });
+    return true;
+}
+
+bool LibraryController::startWatching()
+{
+    if (!watcher_ || watching_)
+    {
+        return false;
+    }
+
+    std::vector<std::string> roots = getLibraryFolders();
+    if (library_)
+    {
+        // Tracks added file by file or before folders were recorded: watch their folders too
+        for (const auto &path : library_->getPathIndex())
+        {
+            size_t slash = path.find_last_of('/');
+            if (slash != std::string::npos && slash > 0)
+            {
+                roots.push_back(path.substr(0, slash));
+            }
+        }
+    }
+
+    // Sorted, a folder comes right before the ones below it; keep only the outermost
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    std::vector<std::string> covering;
+    for (const auto &root : roots)
+    {
+        if (covering.empty() || !isUnderFolder(root, covering.back()))
+        {
+            covering.push_back(root);
+        }
+    }
+
+    for (const auto &root : covering)
+    {
+        watcher_->addRoot(root);
+    }
+    // Set before the first batch can arrive: a batch waiting for dispatchFileEvents() checks it
+    watching_ = true;
+    if (!watcher_->start([this](const std::vector<FileEvent> &events) { applyFileEvents(events, true); }))
+    {
+        watching_ = false;
+        Logger::warn("Library folders cannot be watched; changes are picked up at the next startup");
+        return false;
+    }
+    return true;
+}
+
+void LibraryController::stopWatching()
+{
+    if (watcher_ && watching_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(removalsMutex_);
+            watching_ = false;
+        }
+        removalsApplied_.notify_all(); // A batch waiting for the main thread gives up
+        watcher_->stop();
+    }
+}
+
+void LibraryController::dispatchFileEvents()
+{
+    std::set<std::string> paths;
+    uint64_t batches = 0;
+    {
+        std::lock_guard<std::mutex> lock(removalsMutex_);
+        if (removalsDone_ == removalsQueued_)
+        {
+            return;
+        }
+        paths.swap(pendingRemovals_);
+        batches = removalsQueued_;
+    }
+
+    removeTracks(paths);
+
+    {
+        std::lock_guard<std::mutex> lock(removalsMutex_);
+        removalsDone_ = batches;
+    }
+    removalsApplied_.notify_all();
+}
+
+bool LibraryController::removeOnMainThread(const std::set<std::string> &paths)
+{
+    std::unique_lock<std::mutex> lock(removalsMutex_);
+    pendingRemovals_.insert(paths.begin(), paths.end());
+    uint64_t batch = ++removalsQueued_;
+    removalsApplied_.wait(lock, [&]() { return removalsDone_ >= batch || !watching_; });
+    return removalsDone_ >= batch;
+}
+
+void LibraryController::setLibraryFolders(const std::vector<std::string> &folders)
+{
+    std::lock_guard<std::mutex> lock(foldersMutex_);
+    libraryFolders_ = folders;
+}
+
+std::vector<std::string> LibraryController::getLibraryFolders() const
+{
+    std::lock_guard<std::mutex> lock(foldersMutex_);
+    return libraryFolders_;
+}
+
+void LibraryController::addLibraryFolder(const std::string &folder)
+{
+    {
+        std::lock_guard<std::mutex> lock(foldersMutex_);
+        if (std::find(libraryFolders_.begin(), libraryFolders_.end(), folder) != libraryFolders_.end())
+        {
+            return;
+        }
+        libraryFolders_.push_back(folder);
+    }
+    if (watcher_ && watching_)
+    {
+        watcher_->addRoot(folder);
+    }
+}
+
+void LibraryController::applyFileEvents(const std::vector<FileEvent> &events)
+{
+    applyFileEvents(events, false);
+}
+
+void LibraryController::applyFileEvents(const std::vector<FileEvent> &events, bool fromWatcher)
+{
+    if (!library_ || events.empty())
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(applyMutex_);
+
+    std::vector<std::string> removed;
+    std::vector<std::string> added;
+    std::vector<FileCheck> checks;
+
+    // Folder events need every path; file events only need lookups
+    std::unordered_set<std::string> known;
+    bool haveKnown = false;
+    auto knownPaths = [&]() -> const std::unordered_set<std::string> &
+    {
+        if (!haveKnown)
+        {
+            known = library_->getPathIndex();
+            haveKnown = true;
+        }
+        return known;
+    };
+
+    for (const auto &event : events)
+    {
+        if (event.kind == FileEvent::Kind::REMOVED && event.directory)
+        {
+            for (const auto &path : knownPaths())
+            {
+                if (isUnderFolder(path, event.path))
+                    removed.push_back(path);
+            }
+        }
+        else if (event.kind == FileEvent::Kind::REMOVED)
+        {
+            if (library_->contains(event.path))
+                removed.push_back(event.path);
+        }
+        else if (event.directory)
+        {
+            // A folder moved in, created, or whose events were lost
+            reconcileFolder(event.path, knownPaths(), removed, added, checks);
+        }
+        else if (MediaFileFactory::isSupportedFormat(std::filesystem::path(event.path).extension().string()))
+        {
+            auto file = library_->getByPath(event.path);
+            if (file)
+                checks.push_back(FileCheck{event.path, file->getFingerprint()});
+            else
+                added.push_back(event.path);
+        }
+    }
+
+    VerifyResult verified;
+    if (!checks.empty() && fileSystem_)
+    {
+        verified = fileSystem_->verifyFiles(checks);
+        removed.insert(removed.end(), verified.missing.begin(), verified.missing.end());
+    }
+
+    if (!removed.empty())
+    {
+        std::sort(removed.begin(), removed.end());
+        removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+        std::set<std::string> paths(removed.begin(), removed.end());
+        if (!fromWatcher)
+        {
+            removeTracks(paths);
+        }
+        else if (!removeOnMainThread(paths))
+        {
+            return; // Watching stopped; the rest of the batch is dropped with it
+        }
+    }
+    if (!verified.changed.empty())
+    {
+        refreshTracks(nullptr, &verified);
+    }
+    if (!added.empty())
+    {
+        addMediaFilesAsync(added);
+    }
+
+    Logger::info("Library folders changed: " + std::to_string(removed.size()) + " removed, " +
+                 std::to_string(added.size()) + " new, " + std::to_string(verified.changed.size()) + " modified");
+}
+
+void LibraryController::reconcileFolder(const std::string &folder, const std::unordered_set<std::string> &known,
+                                        std::vector<std::string> &removed, std::vector<std::string> &added,
+                                        std::vector<FileCheck> &checks)
+{
+    if (!fileSystem_)
+    {
+        return;
+    }
+
+    std::vector<std::string> onDisk = fileSystem_->scanDirectory(folder, MediaFileFactory::getAllSupportedFormats());
+    std::unordered_set<std::string> present(onDisk.begin(), onDisk.end());
+    for (const auto &path : onDisk)
+    {
+        auto file = known.count(path) ? library_->getByPath(path) : nullptr;
+        if (file)
+            checks.push_back(FileCheck{path, file->getFingerprint()});
+        else
+            added.push_back(path);
+    }
+    for (const auto &path : known)
+    {
+        if (isUnderFolder(path, folder) && !present.count(path))
+            removed.push_back(path);
+    }
+}
+
+ImportProgress LibraryController::getImportProgress() const
+{
+    std::lock_guard<std::mutex> lock(importMutex_);
+    return import_ ? import_->getProgress() : ImportProgress();
+}
+
+ImportPipeline::Options LibraryController::importOptions() const
+{
+    ImportPipeline::Options options;
+    options.readerFactory = readerFactory_;
+    return options;
 }
 
 bool LibraryController::addMediaFile(const std::string &filepath)
@@ -43,7 +429,7 @@ bool LibraryController::addMediaFile(const std::string &filepath)
     }
 
     // Create MediaFile and add to library
-    auto file = MediaFileFactory::createMediaFile(filepath, metadataReader_);
+    auto file = MediaFileFactory::createMediaFile(filepath, metadataReader_, fileSystem_);
     if (!file || file->getType() == MediaType::UNKNOWN)
     {
         return false;
@@ -58,40 +444,19 @@ void LibraryController::addMediaFilesAsync(const std::vector<std::string> &filep
     if (!library_ || !metadataReader_ || filepaths.empty())
         return;
 
-    // Create a copy of filepaths to pass to the thread
-    std::vector<std::string> paths = filepaths;
-    
-    // Launch detached thread
-    std::thread([this, paths]() {
-        Logger::info("Starting async library import of " + std::to_string(paths.size()) + " files");
-        
-        std::vector<std::shared_ptr<MediaFile>> batch;
-        batch.reserve(20);
-        int totalAdded = 0;
-
-        for (const auto &path : paths)
-        {
-            auto file = MediaFileFactory::createMediaFile(path, metadataReader_);
-            if (file && file->getType() != MediaType::UNKNOWN)
-            {
-                batch.push_back(std::shared_ptr<MediaFile>(std::move(file)));
-            }
-            
-            if (batch.size() >= 20)
-            {
-                totalAdded += library_->addMediaBatch(batch);
-                batch.clear();
-            }
-        }
-        
-        // Add remaining
-        if (!batch.empty())
-        {
-            totalAdded += library_->addMediaBatch(batch);
-        }
-        
-        Logger::info("Async import finished. Added " + std::to_string(totalAdded) + " files.");
-    }).detach();
+    std::lock_guard<std::mutex> lock(importMutex_);
+
+    // Reap finished runs so the list only holds live workers
+    fileImports_.erase(std::remove_if(fileImports_.begin(), fileImports_.end(),
+                                      [](const std::unique_ptr<ImportPipeline> &run)
+                                      { return !run->getProgress().running; }),
+                       fileImports_.end());
+
+    auto run = std::make_unique<ImportPipeline>(library_, fileSystem_, metadataReader_, importOptions());
+    if (run->start(filepaths))
+    {
+        fileImports_.push_back(std::move(run));
+    }
 }
 
 bool LibraryController::removeMedia(const std::string &filepath)
@@ -124,39 +489,98 @@ LibraryController::searchMedia(const std::string &query, const std::vector<std::
 
 int LibraryController::refreshLibrary()
 {
+    return refreshTracks(nullptr, nullptr);
+}
+
+int LibraryController::refreshTracks(const std::atomic<bool> *cancelled, const VerifyResult *verified)
+{
+    std::lock_guard<std::mutex> lock(refreshMutex_);
+    lastRefreshStats_ = RefreshStats();
     if (!library_ || !metadataReader_)
     {
         return 0;
     }
 
-    // Re-read metadata for all files
-    auto allFiles = library_->getAll();
-    int refreshedCount = 0;
+    RefreshStats stats;
+    bool stamped = false;
+    auto refreshOne = [&](const std::shared_ptr<MediaFile> &file, bool statted, const FileFingerprint &fingerprint)
+    {
+        MediaMetadata metadata = metadataReader_->readMetadata(file->getPath());
 
-    for (auto &file : allFiles)
+        // Check if metadata actually changed or is valid
+        if (metadata.duration > 0 || metadata.title != file->getMetadata().title)
+        {
+            // Go through the library so its search index sees the new tags
+            if (statted)
+                library_->updateMetadata(file->getPath(), metadata, fingerprint);
+            else
+                library_->updateMetadata(file->getPath(), metadata);
+            stats.updated++;
+        }
+        else
+        {
+            // Keep the old tags but remember this file state so it is not read again
+            if (statted)
+            {
+                library_->updateMetadata(file->getPath(), file->getMetadata(), fingerprint);
+                stamped = true;
+            }
+            stats.unchanged++;
+        }
+    };
+
+    if (verified)
     {
-        if (file)
+        // verifyTracks() already stat'ed everything: only changed files need reading
+        size_t total = library_->size();
+        for (const auto &entry : verified->changed)
+        {
+            if (cancelled && *cancelled)
+            {
+                break;
+            }
+            auto file = library_->getByPath(entry.first);
+            if (file)
+            {
+                refreshOne(file, true, entry.second);
+            }
+        }
+        stats.skipped = static_cast<int>(total - std::min(total, verified->changed.size()));
+    }
+    else
+    {
+        for (auto &file : library_->getAll())
         {
-            // Only refresh if duration looks suspicious (0 or very large) to save time
-            // Or force all. Let's force all for now to be safe.
-            MediaMetadata metadata = metadataReader_->readMetadata(file->getPath());
-            
-            // Check if metadata actually changed or is valid
-            if (metadata.duration > 0 || metadata.title != file->getMetadata().title) 
+            if (cancelled && *cancelled)
             {
-               file->setMetadata(metadata);
-               refreshedCount++;
+                break;
             }
+            if (!file)
+            {
+                continue;
+            }
+
+            // Unchanged files are the common case on startup; skip them without opening
+            FileFingerprint fingerprint;
+            bool statted = fileSystem_ && fileSystem_->getFingerprint(file->getPath(), fingerprint);
+            if (statted && fingerprint == file->getFingerprint())
+            {
+                stats.skipped++;
+                continue;
+            }
+            refreshOne(file, statted, fingerprint);
         }
     }
-    
-    if (refreshedCount > 0)
+
+    if (stats.updated > 0 || stamped)
     {
         library_->save(); // Save to disk
     }
 
-    Logger::info("Refreshed " + std::to_string(refreshedCount) + " files");
-    return refreshedCount;
+    lastRefreshStats_ = stats;
+    Logger::info("Refreshed " + std::to_string(stats.updated) + " files (" + std::to_string(stats.unchanged) +
+                 " unchanged, " + std::to_string(stats.skipped) + " skipped by fingerprint)");
+    return stats.updated;
 }
 
 std::unordered_set<std::string> LibraryController::getAllTrackPaths() const
@@ -169,6 +593,11 @@ std::unordered_set<std::string> LibraryController::getAllTrackPaths() const
 }
 
 int LibraryController::verifyLibrary()
+{
+    return verifyTracks(nullptr, nullptr);
+}
+
+int LibraryController::verifyTracks(const std::atomic<bool> *cancelled, VerifyResult *verified)
 {
     if (!library_ || !fileSystem_)
     {
@@ -176,20 +605,40 @@ int LibraryController::verifyLibrary()
     }
 
     auto allFiles = library_->getAll();
-    int removedCount = 0;
+    VerifyResult result;
+    std::vector<FileCheck> checks;
 
-    for (const auto &file : allFiles)
+    // Chunks keep a cancel responsive; each one is a single batched check
+    for (size_t first = 0; first < allFiles.size(); first += VERIFY_CHUNK)
     {
-        if (file && !fileSystem_->exists(file->getPath()))
+        if (cancelled && *cancelled)
+        {
+            break;
+        }
+
+        checks.clear();
+        for (size_t i = first; i < std::min(allFiles.size(), first + VERIFY_CHUNK); ++i)
         {
-            library_->removeMedia(file->getPath());
-            removedCount++;
+            if (allFiles[i])
+                checks.push_back(FileCheck{allFiles[i]->getPath(), allFiles[i]->getFingerprint()});
         }
+
+        VerifyResult chunk = fileSystem_->verifyFiles(checks);
+        std::move(chunk.missing.begin(), chunk.missing.end(), std::back_inserter(result.missing));
+        std::move(chunk.changed.begin(), chunk.changed.end(), std::back_inserter(result.changed));
     }
 
+    // One lock and one notification for every missing file
+    int removedCount = library_->removeMediaBatch(result.missing);
     Logger::info("Removed " + std::to_string(removedCount) + " missing files");
+
+    if (verified)
+    {
+        *verified = std::move(result);
+    }
     return removedCount;
 }
+
 void LibraryController::playTrack(const std::vector<std::shared_ptr<MediaFile>> &context, size_t index)
 {
     if (playbackController_)
@@ -203,9 +652,24 @@ void LibraryController::removeTracks(const std::set<std::string> &paths)
 {
     if (!library_)
         return;
+
+    // Only paths that are really in the library should fire the removal callback
+    std::vector<std::string> toRemove;
+    toRemove.reserve(paths.size());
     for (const auto &path : paths)
     {
-        removeMedia(path); // Use internal method to trigger callback
+        if (library_->contains(path))
+            toRemove.push_back(path);
+    }
+
+    library_->removeMediaBatch(toRemove);
+
+    if (onTrackRemovedCallback_)
+    {
+        for (const auto &path : toRemove)
+        {
+            onTrackRemovedCallback_(path);
+        }
     }
 }
 
@@ -232,3 +696,4 @@ void LibraryController::clearAll()
 
     library_->clear();
 }
+
@@ -7,6 +7,10 @@ PlaybackController::PlaybackController(IPlaybackEngine *engine, PlaybackState *s
                                        IHardwareInterface *hardware, Playlist *currentPlaylist)
     : engine_(engine), state_(state), history_(history), hardware_(hardware), currentPlaylist_(currentPlaylist)
 {
+    if (engine_)
+    {
+        engine_->attach(this); // End of file and errors arrive through dispatchEvents()
+    }
     if (hardware_)
     {
         hardware_->attach(this);
@@ -15,6 +19,10 @@ PlaybackController::PlaybackController(IPlaybackEngine *engine, PlaybackState *s
 
 PlaybackController::~PlaybackController()
 {
+    if (engine_)
+    {
+        engine_->detach(this);
+    }
     if (hardware_)
     {
         hardware_->detach(this);
@@ -58,7 +66,9 @@ bool PlaybackController::play(std::shared_ptr<MediaFile> track, bool pushToStack
     }
 
     // Play via engine
-    return engine_->play(track->getPath());
+    bool started = engine_->play(track->getPath());
+    preloadDone_ = false; // What comes next depends on this track
+    return started;
 }
 
 void PlaybackController::pause()
@@ -250,9 +260,20 @@ void PlaybackController::setVolume(float volume)
     Config::getInstance().getConfig().customVolume = volume;
 }
 
+void PlaybackController::setGapless(bool enabled)
+{
+    gapless_ = enabled;
+    preloadDone_ = false;
+    if (!enabled && engine_)
+    {
+        engine_->clearPreload();
+    }
+}
+
 void PlaybackController::setCurrentPlaylist(Playlist *playlist)
 {
     currentPlaylist_ = playlist;
+    preloadDone_ = false;
     if (!playlist)
     {
         return;
@@ -340,6 +361,13 @@ void PlaybackController::update(void *subject)
             Logger::error("Reporting track load failure: " + lastPlayedPath_);
             onTrackLoadFailedCallback_(lastPlayedPath_);
         }
+        return;
+    }
+
+    // One notification per end of file: advance now rather than on a later frame's updateTime()
+    if (engine_->isFinished() && state_ && state_->getStatus() == PlaybackStatus::PLAYING)
+    {
+        handlePlaybackFinished();
     }
 }
 
@@ -358,14 +386,21 @@ void PlaybackController::updateTime(double deltaTime)
         double newPos = currentPos + deltaTime;
         state_->setPosition(newPos);
 
-        // Check for completion
-        // Use engine status as primary authority if available, time as fallback
-        if (engine_->isFinished())
+        // Queue and playlist edits (library removals included) can change what comes next
+        if (preloadDone_ && preloadIsStale())
         {
-            handlePlaybackFinished();
+            preloadDone_ = false;
         }
-        // Fallback: if duration is known and we exceeded it significantly (e.g. +1 sec buffer)
-        else if (duration > 0 && newPos > duration + 1.0)
+
+        // Without a known duration, preload right away
+        if (gapless_ && !preloadDone_ && (duration <= 0 || duration - newPos <= PRELOAD_LEAD_SECONDS))
+        {
+            preloadUpcoming();
+        }
+
+        // The engine's end-of-file event is handled in update(). Fallback for a track that
+        // outlived its known duration significantly (e.g. +1 sec buffer) without one
+        if (duration > 0 && newPos > duration + 1.0)
         {
             handlePlaybackFinished();
         }
@@ -395,6 +430,64 @@ void PlaybackController::handlePlaybackFinished()
     next(); // Simple auto-next
 }
 
+std::shared_ptr<MediaFile> PlaybackController::peekUpcomingTrack()
+{
+    // Mirrors handlePlaybackFinished() and next()
+    RepeatMode mode = currentPlaylist_ ? currentPlaylist_->getRepeatMode() : globalRepeatMode_;
+    auto currentTrack = state_->getCurrentTrack();
+    if (mode == RepeatMode::ONE)
+    {
+        return currentTrack;
+    }
+
+    if (currentPlaylist_)
+    {
+        auto tracks = currentPlaylist_->getTracks();
+        int currentIndex = findTrackIndexInPlaylist(currentTrack);
+        if (currentIndex != -1)
+        {
+            size_t nextIndex = static_cast<size_t>(currentIndex) + 1;
+            if (nextIndex < tracks.size())
+            {
+                return tracks[nextIndex];
+            }
+            return mode == RepeatMode::ALL ? tracks[0] : nullptr;
+        }
+        if (!tracks.empty())
+        {
+            return tracks[0];
+        }
+    }
+
+    // Wrapping around the queue (Loop ALL) is left to next(); it is not preloaded
+    return state_->peekNextTrack();
+}
+
+void PlaybackController::preloadUpcoming()
+{
+    preloadDone_ = true;
+    preloadQueueRevision_ = state_->getQueueRevision();
+    preloadPlaylistRevision_ = currentPlaylist_ ? currentPlaylist_->getRevision() : 0;
+    auto upcoming = peekUpcomingTrack();
+    if (upcoming)
+    {
+        engine_->preloadNext(upcoming->getPath());
+    }
+    else
+    {
+        engine_->clearPreload();
+    }
+}
+
+bool PlaybackController::preloadIsStale() const
+{
+    if (state_->getQueueRevision() != preloadQueueRevision_)
+    {
+        return true;
+    }
+    return currentPlaylist_ && currentPlaylist_->getRevision() != preloadPlaylistRevision_;
+}
+
 void PlaybackController::toggleRepeatMode()
 {
     // Determine current mode
@@ -423,6 +516,7 @@ void PlaybackController::toggleRepeatMode()
     {
         globalRepeatMode_ = nextMode;
     }
+    preloadDone_ = false; // The upcoming track may differ now
 
     std::string modeStr = "NONE";
     if (nextMode == RepeatMode::ALL)
@@ -443,4 +537,5 @@ void PlaybackController::setRepeatMode(RepeatMode mode)
     {
         globalRepeatMode_ = mode;
     }
+    preloadDone_ = false;
 }
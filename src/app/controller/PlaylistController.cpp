@@ -57,7 +57,7 @@ bool PlaylistController::addToPlaylist(const std::string &playlistName, const st
         return false;
     }
 
-    bool success = playlist->addTrack(file);
+    bool success = playlistManager_->addTrackTo(playlistName, file);
     if (success)
     {
         // playlistManager_->saveAll(); // Removed: Save only on exit
@@ -65,6 +65,12 @@ bool PlaylistController::addToPlaylist(const std::string &playlistName, const st
     return success;
 }
 
+bool PlaylistController::addTrackToPlaylist(const std::string &playlistName, std::shared_ptr<MediaFile> track)
+{
+    // Through the manager, so the change is journaled
+    return playlistManager_->addTrackTo(playlistName, std::move(track));
+}
+
 bool PlaylistController::addToPlaylistAndLibrary(const std::string &playlistName, const std::string &filepath)
 {
 
@@ -94,7 +100,7 @@ bool PlaylistController::removeFromPlaylist(const std::string &playlistName, siz
         return false;
     }
 
-    bool success = playlist->removeTrack(trackIndex);
+    bool success = playlistManager_->removeTrackAt(playlistName, trackIndex);
     if (success)
     {
         // playlistManager_->saveAll(); // Removed: Save only on exit
@@ -104,29 +110,16 @@ bool PlaylistController::removeFromPlaylist(const std::string &playlistName, siz
 
 bool PlaylistController::removeFromPlaylistByPath(const std::string &playlistName, const std::string &filepath)
 {
-    auto playlist = playlistManager_->getPlaylist(playlistName);
-    if (!playlist)
-        return false;
-
-    return playlist->removeTrackByPath(filepath);
+    return playlistManager_->removeTrackFrom(playlistName, filepath);
 }
 
 int PlaylistController::removeTrackFromAllPlaylists(const std::string &filepath)
 {
-    auto allPlaylists = playlistManager_->getAllPlaylists();
-    int affectedCount = 0;
-
-    for (auto &playlist : allPlaylists)
-    {
-        if (playlist->removeTrackByPath(filepath))
-        {
-            affectedCount++;
-        }
-    }
+    // The manager persists the change (journal record or full rewrite)
+    int affectedCount = playlistManager_->removeTrackFromAll(filepath);
 
     if (affectedCount > 0)
     {
-        playlistManager_->saveAll(); // Save changes
         Logger::info("Removed track from " + std::to_string(affectedCount) + " playlists: " + filepath);
     }
 
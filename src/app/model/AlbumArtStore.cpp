@@ -0,0 +1,125 @@
+#include "app/model/AlbumArtStore.h"
+
+AlbumArtStore::AlbumArtStore(IMetadataReader *reader, size_t capacityBytes)
+    : reader_(reader), capacity_(capacityBytes)
+{
+}
+
+std::shared_ptr<const AlbumArt> AlbumArtStore::get(const std::string &filepath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto known = keys_.find(filepath);
+        if (known != keys_.end())
+        {
+            if (known->second == 0)
+                return nullptr;
+
+            auto it = entries_.find(known->second);
+            if (it != entries_.end())
+            {
+                touchLocked(it->second);
+                return it->second.art;
+            }
+            // Evicted: read it again below
+        }
+    }
+
+    AlbumArt art;
+    if (!reader_ || !reader_->readAlbumArt(filepath, art) || art.data.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keys_[filepath] = 0;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return insertLocked(filepath, std::move(art));
+}
+
+std::shared_ptr<const AlbumArt> AlbumArtStore::put(const std::string &filepath, AlbumArt art)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (art.data.empty())
+    {
+        keys_[filepath] = 0;
+        return nullptr;
+    }
+    return insertLocked(filepath, std::move(art));
+}
+
+size_t AlbumArtStore::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t AlbumArtStore::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+AlbumArtStore::Key AlbumArtStore::hash(const AlbumArt &art)
+{
+    // FNV-1a over the image bytes
+    uint64_t value = 14695981039346656037ULL;
+    for (unsigned char byte : art.data)
+    {
+        value ^= byte;
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+std::shared_ptr<const AlbumArt> AlbumArtStore::insertLocked(const std::string &filepath, AlbumArt art)
+{
+    Key key = hash(art);
+    while (true)
+    {
+        if (key == 0)
+        {
+            key = 1;
+        }
+
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+        {
+            break;
+        }
+        if (it->second.art->data == art.data)
+        {
+            // Same cover as another track (or a racing reader): share it
+            keys_[filepath] = key;
+            touchLocked(it->second);
+            return it->second.art;
+        }
+        ++key; // Hash collision with different bytes
+    }
+
+    auto shared = std::make_shared<const AlbumArt>(std::move(art));
+    recent_.push_front(key);
+    entries_[key] = Entry{shared, recent_.begin()};
+    keys_[filepath] = key;
+    bytes_ += shared->data.size();
+
+    evictLocked();
+    return shared;
+}
+
+void AlbumArtStore::touchLocked(Entry &entry)
+{
+    recent_.splice(recent_.begin(), recent_, entry.recent);
+}
+
+void AlbumArtStore::evictLocked()
+{
+    // The newest image always stays, even if it alone exceeds the capacity
+    while (bytes_ > capacity_ && recent_.size() > 1)
+    {
+        auto it = entries_.find(recent_.back());
+        bytes_ -= it->second.art->data.size();
+        entries_.erase(it);
+        recent_.pop_back();
+    }
+}
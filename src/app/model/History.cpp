@@ -55,7 +55,7 @@ bool History::addTrack(std::shared_ptr<MediaFile> track)
     // Quick fix: Call save() logic here directly or helper.
     // Let's modify save() to use an internal helper.
 
-    return saveInternal();
+    return persistLocked({{"op", "add"}, {"track", *track}});
 }
 
 bool History::removeTrack(size_t index)
@@ -67,9 +67,10 @@ bool History::removeTrack(size_t index)
         return false;
     }
 
+    std::string path = history_[index]->getPath();
     history_.erase(history_.begin() + index);
     Subject::notify();
-    return saveInternal();
+    return persistLocked({{"op", "remove"}, {"path", path}});
 }
 
 bool History::removeTrackByPath(const std::string &filepath)
@@ -84,7 +85,7 @@ bool History::removeTrackByPath(const std::string &filepath)
 
     history_.erase(history_.begin() + index);
     Subject::notify();
-    return saveInternal();
+    return persistLocked({{"op", "remove"}, {"path", filepath}});
 }
 
 void History::clear()
@@ -94,7 +95,7 @@ void History::clear()
 
     Logger::info("History cleared");
     Subject::notify();
-    saveInternal();
+    persistLocked({{"op", "clear"}});
 }
 
 // ... existing code ...
@@ -129,10 +130,60 @@ void History::setMaxSize(size_t maxSize)
 
 bool History::save()
 {
+    // With a journal, saving folds it into history.json
+    if (journal_)
+        return journal_->compact();
+
     std::lock_guard<std::mutex> lock(dataMutex_);
     return saveInternal();
 }
 
+void History::enableJournal(size_t compactThreshold)
+{
+    if (!persistence_ || journal_)
+        return;
+
+    journal_ = std::make_unique<Journal>(persistence_, "history.journal",
+                                         [this]()
+                                         {
+                                             std::lock_guard<std::mutex> lock(dataMutex_);
+                                             return saveInternal();
+                                         },
+                                         compactThreshold);
+}
+
+bool History::persistLocked(const nlohmann::json &record)
+{
+    if (journal_)
+        return journal_->append(record);
+    return saveInternal();
+}
+
+void History::applyRecordLocked(const nlohmann::json &record)
+{
+    const std::string op = record.value("op", "");
+    if (op == "add")
+    {
+        auto track = std::make_shared<MediaFile>("");
+        record.at("track").get_to(*track);
+
+        int existingIndex = findTrackIndex(track->getPath());
+        if (existingIndex >= 0)
+            history_.erase(history_.begin() + existingIndex);
+        history_.insert(history_.begin(), track);
+    }
+    else if (op == "remove")
+    {
+        int index = findTrackIndex(record.at("path").get<std::string>());
+        if (index >= 0)
+            history_.erase(history_.begin() + index);
+    }
+    else if (op == "clear")
+    {
+        history_.clear();
+    }
+}
+
 bool History::saveInternal()
 {
     if (!persistence_)
@@ -196,21 +247,29 @@ bool History::load()
     try
     {
         std::string data;
-        if (!persistence_->loadFromFile("history.json", data))
+        bool loaded = persistence_->loadFromFile("history.json", data);
+        if (loaded)
         {
-            return false;
+            nlohmann::json j = nlohmann::json::parse(data);
+            if (j.contains("history") && j["history"].is_array())
+            {
+                history_.clear();
+                for (const auto &item : j["history"])
+                {
+                    auto track = std::make_shared<MediaFile>("");
+                    item.get_to(*track);
+                    history_.push_back(track);
+                }
+            }
         }
 
-        nlohmann::json j = nlohmann::json::parse(data);
-        if (j.contains("history") && j["history"].is_array())
+        // Plays recorded after history.json was last written
+        if (journal_ && journal_->replay([this](const nlohmann::json &record) { applyRecordLocked(record); }) > 0)
+            loaded = true;
+
+        if (!loaded)
         {
-            history_.clear();
-            for (const auto &item : j["history"])
-            {
-                auto track = std::make_shared<MediaFile>("");
-                item.get_to(*track);
-                history_.push_back(track);
-            }
+            return false;
         }
 
         trimToMaxSize();
@@ -1,11 +1,28 @@
 #include "app/model/Library.h"
+#include "app/model/LibrarySnapshot.h"
+#include "utils/Journal.h"
 #include "utils/Logger.h"
 #include <algorithm>
 #include <json.hpp>
 
 // ...
 
+namespace
+{
+const char *const kJsonPath = "data/library.json";
+const char *const kBinaryPath = "data/library.bin";
+const char *const kJournalPath = "data/library.journal";
+} // namespace
+
 bool Library::save()
+{
+    // With a journal, saving folds it into the base snapshot
+    if (journal_)
+        return journal_->compact();
+    return saveBase();
+}
+
+bool Library::saveBase()
 {
     if (!persistence_)
         return false;
@@ -14,28 +31,20 @@ bool Library::save()
 
     try
     {
-        std::vector<nlohmann::json> filesJson;
-        for (const auto &file : mediaFiles_)
+        compactLocked();
+
+        if (binarySnapshot_)
         {
-            if (file)
+            if (persistence_->saveToFile(kBinaryPath, LibrarySnapshot::encode(mediaFiles_)))
             {
-                nlohmann::json j;
-                to_json(j, *file); // Uses MediaFile friend
-                filesJson.push_back(j);
+                Logger::info("Library saved (binary snapshot)");
+                return true;
             }
-        }
-
-        nlohmann::json libraryJson = filesJson;
-        if (persistence_->saveToFile("data/library.json", libraryJson.dump(4)))
-        {
-            Logger::info("Library saved");
-            return true;
-        }
-        else
-        {
-            Logger::error("Failed to save library to data/library.json (persistence error)");
+            Logger::error(std::string("Failed to save library to ") + kBinaryPath + " (persistence error)");
             return false;
         }
+
+        return saveJsonLocked(kJsonPath);
     }
     catch (const std::exception &e)
     {
@@ -44,67 +53,160 @@ bool Library::save()
     }
 }
 
-bool Library::load()
+bool Library::saveJsonLocked(const std::string &filepath)
 {
-    if (!persistence_)
+    std::vector<nlohmann::json> filesJson;
+    for (const auto &file : mediaFiles_)
+    {
+        if (file)
+        {
+            nlohmann::json j;
+            to_json(j, *file); // Uses MediaFile friend
+            filesJson.push_back(j);
+        }
+    }
+
+    nlohmann::json libraryJson = filesJson;
+
+    if (persistence_->saveToFile(filepath, libraryJson.dump(4)))
+    {
+        Logger::info("Library saved");
+        return true;
+    }
+    else
+    {
+        Logger::error("Failed to save library to " + filepath + " (persistence error)");
+        return false;
+    }
+}
+
+bool Library::loadBinaryLocked()
+{
+    auto snapshot = LibrarySnapshot::open(persistence_->mapFile(kBinaryPath));
+    if (!snapshot)
         return false;
 
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    resetLocked();
+    mediaFiles_.reserve(snapshot->size());
+    pathIndex_.reserve(snapshot->size());
+    std::string path;
+    for (size_t i = 0; i < snapshot->size(); ++i)
+    {
+        // Check the path straight from the mapping before building a MediaFile
+        path.assign(snapshot->path(i));
+        if (path.empty() || pathIndex_.find(path) != pathIndex_.end())
+            continue;
+        // Search indexing is most of the cost of a load; buildSearchIndex() catches up after startup
+        pathIndex_[path] = mediaFiles_.size();
+        mediaFiles_.push_back(snapshot->materialize(i));
+    }
 
-    try
+    if (snapshot->damaged())
     {
-        if (!persistence_->fileExists("data/library.json"))
-            return false;
+        resetLocked();
+        return false;
+    }
+    return true;
+}
 
-        std::string content;
-        if (!persistence_->loadFromFile("data/library.json", content))
-            return false;
-        nlohmann::json libraryJson = nlohmann::json::parse(content);
+void Library::resetLocked()
+{
+    mediaFiles_.clear();
+    pathIndex_.clear();
+    searchIndex_.clear();
+    tombstones_ = 0;
+    indexed_ = 0;
+}
 
-        if (!libraryJson.is_array())
-            return false;
+bool Library::load()
+{
+    if (!persistence_)
+        return false;
 
-        mediaFiles_.clear();
-        pathIndex_.clear();
+    std::unique_lock<std::mutex> lock(dataMutex_);
 
-        for (const auto &item : libraryJson)
+    try
+    {
+        bool loaded = false;
+        if (binarySnapshot_ && persistence_->fileExists(kBinaryPath))
         {
-            if (!item.contains("path"))
-                continue;
+            loaded = loadBinaryLocked();
+            if (!loaded)
+                Logger::warn(std::string("Ignoring unreadable ") + kBinaryPath + ", falling back to JSON");
+        }
+        if (!loaded)
+            loaded = loadJsonLocked();
 
-            auto file = std::make_shared<MediaFile>("");
-            item.get_to(*file); // Uses MediaFile friend
+        // Changes made after the base snapshot was written
+        if (journal_ && journal_->replay([this](const nlohmann::json &record) { applyRecordLocked(record); }) > 0)
+            loaded = true;
 
-            // Re-validate if file exists? Maybe, but for now just load it.
-            if (file->exists())
-            {
-                mediaFiles_.push_back(file);
-                pathIndex_.insert(file->getPath());
-            }
-            else
-            {
-                // Determine what to do with missing files? For now, skip or keep?
-                // Keeping them is safer for removable drives, but checking exists() is good hygiene.
-                // Let's keep them if they were in the library, or maybe skip?
-                // MediaFile::from_json sets inLibrary to whatever was saved.
-                // Let's assume valid.
-                mediaFiles_.push_back(file);
-                pathIndex_.insert(file->getPath());
-            }
-        }
+        if (!loaded)
+            return false;
 
+        publishLocked();
         Logger::info("Loaded " + std::to_string(mediaFiles_.size()) + " files into library");
+
+        lock.unlock();
         Subject::notify();
         return true;
     }
     catch (const std::exception &e)
     {
+        // A half-read file may have replaced some tracks already
+        snapshotDirty_.store(true, std::memory_order_release);
         Logger::error("Failed to load library: " + std::string(e.what()));
         return false;
     }
 }
 
-Library::Library(IPersistence *persistence) : persistence_(persistence)
+bool Library::loadJsonLocked()
+{
+    if (!persistence_->fileExists(kJsonPath))
+        return false;
+
+    std::string content;
+    if (!persistence_->loadFromFile(kJsonPath, content))
+        return false;
+    nlohmann::json libraryJson = nlohmann::json::parse(content);
+
+    if (!libraryJson.is_array())
+        return false;
+
+    resetLocked();
+
+    for (const auto &item : libraryJson)
+    {
+        if (!item.contains("path"))
+            continue;
+
+        auto file = std::make_shared<MediaFile>("");
+        item.get_to(*file); // Uses MediaFile friend
+
+        // A hand-edited file may list the same path twice; the first entry wins
+        if (pathIndex_.find(file->getPath()) != pathIndex_.end())
+            continue;
+
+        // Re-validate if file exists? Maybe, but for now just load it.
+        if (file->exists())
+        {
+            appendLocked(file);
+        }
+        else
+        {
+            // Determine what to do with missing files? For now, skip or keep?
+            // Keeping them is safer for removable drives, but checking exists() is good hygiene.
+            // Let's keep them if they were in the library, or maybe skip?
+            // MediaFile::from_json sets inLibrary to whatever was saved.
+            // Let's assume valid.
+            appendLocked(file);
+        }
+    }
+    return true;
+}
+
+Library::Library(IPersistence *persistence)
+    : persistence_(persistence), snapshot_(std::make_shared<std::vector<std::shared_ptr<MediaFile>>>())
 {
 }
 
@@ -115,7 +217,7 @@ bool Library::addMedia(std::shared_ptr<MediaFile> mediaFile)
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::unique_lock<std::mutex> lock(dataMutex_);
 
     // Check for duplicates using path index
     const std::string &path = mediaFile->getPath();
@@ -126,11 +228,15 @@ bool Library::addMedia(std::shared_ptr<MediaFile> mediaFile)
     }
 
     // Add to collection
-    mediaFiles_.push_back(mediaFile);
-    pathIndex_.insert(path);
+    appendLocked(mediaFile);
     mediaFile->setInLibrary(true);
+    if (journal_)
+        journalLocked({{"op", "add"}, {"tracks", nlohmann::json::array({*mediaFile})}});
+    // Single adds often come in loops; publish lazily on the next snapshot()
+    snapshotDirty_.store(true, std::memory_order_release);
 
     Logger::info("Added to library: " + path);
+    lock.unlock();
     Subject::notify();
     return true;
 }
@@ -140,8 +246,9 @@ int Library::addMediaBatch(const std::vector<std::shared_ptr<MediaFile>> &mediaF
     if (mediaFiles.empty())
         return 0;
 
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::unique_lock<std::mutex> lock(dataMutex_);
     int addedCount = 0;
+    nlohmann::json added = nlohmann::json::array();
 
     for (const auto &file : mediaFiles)
     {
@@ -150,16 +257,20 @@ int Library::addMediaBatch(const std::vector<std::shared_ptr<MediaFile>> &mediaF
         const std::string &path = file->getPath();
         if (pathIndex_.find(path) == pathIndex_.end())
         {
-            mediaFiles_.push_back(file);
-            pathIndex_.insert(path);
+            appendLocked(file);
             file->setInLibrary(true);
             addedCount++;
+            if (journal_)
+                added.push_back(*file);
         }
     }
 
     if (addedCount > 0)
     {
+        journalLocked({{"op", "add"}, {"tracks", std::move(added)}});
+        publishLocked();
         Logger::info("Batch added " + std::to_string(addedCount) + " files to library");
+        lock.unlock();
         Subject::notify();
     }
     
@@ -168,111 +279,342 @@ int Library::addMediaBatch(const std::vector<std::shared_ptr<MediaFile>> &mediaF
 
 bool Library::removeMedia(const std::string &filepath)
 {
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::unique_lock<std::mutex> lock(dataMutex_);
 
-    auto it = std::find_if(mediaFiles_.begin(), mediaFiles_.end(),
-                           [&filepath](const std::shared_ptr<MediaFile> &file) { return file->getPath() == filepath; });
-
-    if (it == mediaFiles_.end())
+    if (!removeLocked(filepath))
     {
         return false;
     }
 
-    (*it)->setInLibrary(false);
-    mediaFiles_.erase(it);
-    pathIndex_.erase(filepath);
+    // Keep dead slots bounded without paying a compaction per removal
+    if (tombstones_ > mediaFiles_.size() / 2)
+    {
+        compactLocked();
+    }
+    if (journal_)
+        journalLocked({{"op", "remove"}, {"paths", nlohmann::json::array({filepath})}});
+    snapshotDirty_.store(true, std::memory_order_release);
 
     Logger::info("Removed from library: " + filepath);
+    lock.unlock();
     Subject::notify();
     return true;
 }
 
-std::vector<std::shared_ptr<MediaFile>> Library::search(const std::string &query,
-                                                        const std::vector<std::string> &searchFields) const
+int Library::removeMediaBatch(const std::vector<std::string> &filepaths)
 {
+    if (filepaths.empty())
+        return 0;
 
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    int removedCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        nlohmann::json removed = nlohmann::json::array();
 
-    if (query.empty())
+        for (const auto &path : filepaths)
+        {
+            if (removeLocked(path))
+            {
+                removedCount++;
+                if (journal_)
+                    removed.push_back(path);
+            }
+        }
+
+        if (removedCount > 0)
+        {
+            journalLocked({{"op", "remove"}, {"paths", std::move(removed)}});
+            publishLocked();
+        }
+    }
+
+    if (removedCount > 0)
     {
-        return mediaFiles_; // Return all if query is empty
+        Logger::info("Batch removed " + std::to_string(removedCount) + " files from library");
+        Subject::notify();
     }
 
-    std::vector<std::shared_ptr<MediaFile>> results;
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+    return removedCount;
+}
 
-    for (const auto &file : mediaFiles_)
+bool Library::updateMetadata(const std::string &filepath, const MediaMetadata &metadata)
+{
     {
-        const MediaMetadata &meta = file->getMetadata();
+        std::lock_guard<std::mutex> lock(dataMutex_);
 
-        for (const auto &field : searchFields)
+        if (!updateMetadataLocked(filepath, metadata))
         {
-            std::string fieldValue;
-
-            if (field == "title")
-                fieldValue = meta.title;
-            else if (field == "artist")
-                fieldValue = meta.artist;
-            else if (field == "album")
-                fieldValue = meta.album;
-            else if (field == "genre")
-                fieldValue = meta.genre;
-            else
-                continue;
+            return false;
+        }
+        if (journal_)
+            journalLocked({{"op", "update"}, {"track", *mediaFiles_[pathIndex_.at(filepath)]}});
+    }
 
-            // Case-insensitive search
-            std::transform(fieldValue.begin(), fieldValue.end(), fieldValue.begin(), ::tolower);
+    Subject::notify();
+    return true;
+}
 
-            if (fieldValue.find(lowerQuery) != std::string::npos)
-            {
-                results.push_back(file);
-                break; // Don't add same file multiple times
-            }
+bool Library::updateMetadata(const std::string &filepath, const MediaMetadata &metadata,
+                             const FileFingerprint &fingerprint)
+{
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+
+        if (!updateMetadataLocked(filepath, metadata, &fingerprint))
+        {
+            return false;
         }
+        if (journal_)
+            journalLocked({{"op", "update"}, {"track", *mediaFiles_[pathIndex_.at(filepath)]}});
     }
 
-    return results;
+    Subject::notify();
+    return true;
 }
 
-std::shared_ptr<MediaFile> Library::getByPath(const std::string &filepath) const
+std::vector<std::shared_ptr<MediaFile>> Library::search(const std::string &query,
+                                                        const std::vector<std::string> &searchFields) const
 {
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (query.empty())
+    {
+        return *snapshot(); // Return all if query is empty
+    }
+
+    // Never wait on a writer or on buildSearchIndex(): scan the published snapshot instead
+    std::unique_lock<std::mutex> lock(dataMutex_, std::try_to_lock);
+    if (lock.owns_lock())
+    {
+        if (indexed_ == mediaFiles_.size())
+            return searchIndex_.search(query, searchFields);
+        lock.unlock();
+    }
+    return SearchIndex::scan(*snapshot(), query, searchFields);
+}
 
-    // Fast lookup using path index
-    if (pathIndex_.find(filepath) == pathIndex_.end())
+void Library::buildSearchIndex()
+{
+    const size_t chunk = 1024;
+    for (;;)
     {
-        return nullptr;
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        size_t end = std::min(mediaFiles_.size(), indexed_ + chunk);
+        for (; indexed_ < end; ++indexed_)
+        {
+            if (mediaFiles_[indexed_])
+                searchIndex_.add(mediaFiles_[indexed_]);
+        }
+        if (indexed_ == mediaFiles_.size())
+            return;
     }
+}
 
-    auto it = std::find_if(mediaFiles_.begin(), mediaFiles_.end(),
-                           [&filepath](const std::shared_ptr<MediaFile> &file) { return file->getPath() == filepath; });
+std::shared_ptr<MediaFile> Library::getByPath(const std::string &filepath) const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
 
-    return (it != mediaFiles_.end()) ? *it : nullptr;
+    // Path index maps straight to the slot
+    auto it = pathIndex_.find(filepath);
+    return (it != pathIndex_.end()) ? mediaFiles_[it->second] : nullptr;
 }
 
 void Library::clear()
 {
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::unique_lock<std::mutex> lock(dataMutex_);
 
     for (auto &file : mediaFiles_)
     {
-        file->setInLibrary(false);
+        if (file)
+            file->setInLibrary(false);
     }
 
-    mediaFiles_.clear();
-    pathIndex_.clear();
+    resetLocked();
+    journalLocked({{"op", "clear"}});
+    publishLocked();
 
     Logger::info("Library cleared");
+    lock.unlock();
     Subject::notify();
 }
 
+Library::TrackSnapshot Library::snapshot() const
+{
+    if (snapshotDirty_.load(std::memory_order_acquire))
+    {
+        // Never wait on a writer: if one holds the lock, the last snapshot is good enough
+        std::unique_lock<std::mutex> lock(dataMutex_, std::try_to_lock);
+        if (lock.owns_lock() && snapshotDirty_.load(std::memory_order_relaxed))
+            publishLocked();
+    }
+    return std::atomic_load(&snapshot_);
+}
+
+std::vector<std::shared_ptr<MediaFile>> Library::getAll() const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    compactLocked();
+    return mediaFiles_;
+}
+
+size_t Library::size() const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return mediaFiles_.size() - tombstones_;
+}
+
+std::unordered_set<std::string> Library::getPathIndex() const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::unordered_set<std::string> paths;
+    paths.reserve(pathIndex_.size());
+    for (const auto &entry : pathIndex_)
+    {
+        paths.insert(entry.first);
+    }
+    return paths;
+}
+
+void Library::appendLocked(const std::shared_ptr<MediaFile> &file)
+{
+    // While buildSearchIndex() is behind, it indexes the new slot in order with the rest
+    if (indexed_ == mediaFiles_.size())
+    {
+        searchIndex_.add(file);
+        indexed_++;
+    }
+    pathIndex_[file->getPath()] = mediaFiles_.size();
+    mediaFiles_.push_back(file);
+}
+
+bool Library::removeLocked(const std::string &filepath)
+{
+    auto it = pathIndex_.find(filepath);
+    if (it == pathIndex_.end())
+    {
+        return false;
+    }
+
+    // Leave a tombstone; compactLocked() closes the gap later in one pass
+    auto &slot = mediaFiles_[it->second];
+    slot->setInLibrary(false);
+    searchIndex_.remove(slot.get());
+    slot.reset();
+    pathIndex_.erase(it);
+    tombstones_++;
+    return true;
+}
+
+void Library::compactLocked() const
+{
+    if (tombstones_ == 0)
+        return;
+
+    size_t write = 0;
+    size_t indexed = 0;
+    for (size_t read = 0; read < mediaFiles_.size(); ++read)
+    {
+        if (!mediaFiles_[read])
+            continue;
+
+        if (write != read)
+        {
+            mediaFiles_[write] = std::move(mediaFiles_[read]);
+            pathIndex_[mediaFiles_[write]->getPath()] = write;
+        }
+        if (read < indexed_)
+            indexed++;
+        write++;
+    }
+    indexed_ = indexed_ == mediaFiles_.size() ? write : indexed;
+    mediaFiles_.resize(write);
+    tombstones_ = 0;
+}
+
+bool Library::updateMetadataLocked(const std::string &filepath, const MediaMetadata &metadata,
+                                   const FileFingerprint *fingerprint)
+{
+    auto it = pathIndex_.find(filepath);
+    if (it == pathIndex_.end())
+    {
+        return false;
+    }
+
+    // In place, so playlists, history and the play queue that share the object see the new tags;
+    // MediaFile publishes the change atomically for readers on other threads
+    const auto &file = mediaFiles_[it->second];
+    if (fingerprint)
+        file->setMetadata(metadata, *fingerprint);
+    else
+        file->setMetadata(metadata);
+    searchIndex_.update(file.get());
+    return true;
+}
+
+void Library::enableJournal(size_t compactThreshold)
+{
+    if (!persistence_ || journal_)
+        return;
+
+    journal_ = std::make_unique<Journal>(persistence_, kJournalPath, [this]() { return saveBase(); },
+                                         compactThreshold);
+}
+
+void Library::journalLocked(const nlohmann::json &record)
+{
+    if (journal_)
+        journal_->append(record);
+}
+
+void Library::applyRecordLocked(const nlohmann::json &record)
+{
+    // Every record is idempotent, so replaying one the base already holds is harmless
+    const std::string op = record.value("op", "");
+    if (op == "add")
+    {
+        for (const auto &item : record.at("tracks"))
+        {
+            auto file = std::make_shared<MediaFile>("");
+            item.get_to(*file);
+            if (pathIndex_.find(file->getPath()) != pathIndex_.end())
+                continue;
+            file->setInLibrary(true);
+            appendLocked(file);
+        }
+    }
+    else if (op == "remove")
+    {
+        for (const auto &path : record.at("paths"))
+        {
+            removeLocked(path.get<std::string>());
+        }
+    }
+    else if (op == "update")
+    {
+        MediaFile parsed("");
+        record.at("track").get_to(parsed);
+        FileFingerprint fingerprint = parsed.getFingerprint();
+        updateMetadataLocked(parsed.getPath(), parsed.getMetadata(), &fingerprint);
+    }
+    else if (op == "clear")
+    {
+        resetLocked();
+    }
+}
+
+void Library::publishLocked() const
+{
+    compactLocked();
+    TrackSnapshot next = std::make_shared<std::vector<std::shared_ptr<MediaFile>>>(mediaFiles_);
+    std::atomic_store(&snapshot_, std::move(next));
+    snapshotDirty_.store(false, std::memory_order_release);
+}
+
 void Library::rebuildPathIndex()
 {
     pathIndex_.clear();
-    for (const auto &file : mediaFiles_)
+    for (size_t slot = 0; slot < mediaFiles_.size(); ++slot)
     {
-        pathIndex_.insert(file->getPath());
+        if (mediaFiles_[slot])
+            pathIndex_[mediaFiles_[slot]->getPath()] = slot;
     }
 }
 
@@ -0,0 +1,243 @@
+#include "app/model/LibrarySnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+const char kMagic[4] = {'M', 'P', 'L', 'B'};
+} // namespace
+
+std::string LibrarySnapshot::encode(const std::vector<std::shared_ptr<MediaFile>> &files)
+{
+    std::vector<Record> records;
+    records.reserve(files.size());
+    std::string strings;
+    // Artists, albums and genres repeat across tracks; store each value once
+    std::unordered_map<std::string, StringRef> interned;
+
+    auto addString = [&](const std::string &value) -> StringRef
+    {
+        if (value.empty())
+            return StringRef{0, 0};
+
+        auto it = interned.find(value);
+        if (it != interned.end())
+            return it->second;
+
+        StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+        strings.append(value);
+        interned.emplace(value, ref);
+        return ref;
+    };
+
+    for (const auto &file : files)
+    {
+        if (!file)
+            continue;
+
+        auto snapshot = file->getMetadataSnapshot();
+        const MediaMetadata &meta = *snapshot;
+        const FileFingerprint fingerprint = file->getFingerprint();
+        Record r{};
+        r.path = addString(file->getPath());
+        r.title = addString(meta.title);
+        r.artist = addString(meta.artist);
+        r.album = addString(meta.album);
+        r.genre = addString(meta.genre);
+        r.codec = addString(meta.codec);
+        r.comment = addString(meta.comment);
+        std::string fields;
+        for (const auto &field : meta.customFields)
+        {
+            fields.append(field.first).push_back('\0');
+            fields.append(field.second).push_back('\0');
+        }
+        r.customFields = addString(fields);
+        r.year = meta.year;
+        r.track = meta.track;
+        r.duration = meta.duration;
+        r.bitrate = meta.bitrate;
+        r.sampleRate = meta.sampleRate;
+        r.channels = meta.channels;
+        r.flags = (file->isInLibrary() ? FLAG_IN_LIBRARY : 0) | (meta.hasAlbumArt ? FLAG_HAS_ALBUM_ART : 0);
+        r.fileSize = fingerprint.size;
+        r.mtime = fingerprint.mtime;
+        r.inode = fingerprint.inode;
+        records.push_back(r);
+    }
+
+    std::string body(records.size() * sizeof(Record) + strings.size(), '\0');
+    if (!records.empty())
+        std::memcpy(&body[0], records.data(), records.size() * sizeof(Record));
+    if (!strings.empty())
+        std::memcpy(&body[records.size() * sizeof(Record)], strings.data(), strings.size());
+
+    std::vector<uint32_t> sums;
+    for (size_t offset = 0; offset < body.size(); offset += SECTION_SIZE)
+    {
+        sums.push_back(checksum(body.data() + offset, std::min(SECTION_SIZE, body.size() - offset)));
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = VERSION;
+    header.recordCount = static_cast<uint32_t>(records.size());
+    header.recordSize = sizeof(Record);
+    header.stringBytes = strings.size();
+    header.sectionCount = static_cast<uint32_t>(sums.size());
+
+    std::string out(sizeof(Header) + sums.size() * sizeof(uint32_t), '\0');
+    if (!sums.empty())
+        std::memcpy(&out[sizeof(Header)], sums.data(), sums.size() * sizeof(uint32_t));
+    header.checksum = checksum(reinterpret_cast<const char *>(&header), sizeof(Header));
+    header.checksum = checksum(out.data() + sizeof(Header), out.size() - sizeof(Header), header.checksum);
+    std::memcpy(&out[0], &header, sizeof(Header));
+    return out + body;
+}
+
+std::unique_ptr<LibrarySnapshot> LibrarySnapshot::open(std::shared_ptr<MappedFile> file)
+{
+    if (!file || file->size() < sizeof(Header))
+        return nullptr;
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        return nullptr;
+    if (header.version != VERSION || header.recordSize != sizeof(Record))
+        return nullptr;
+
+    // Compare in 64 bits so a corrupt count cannot overflow the size checks
+    uint64_t bodySize = static_cast<uint64_t>(header.recordCount) * sizeof(Record) + header.stringBytes;
+    uint64_t sections = (bodySize + SECTION_SIZE - 1) / SECTION_SIZE;
+    if (header.sectionCount != sections ||
+        sizeof(Header) + sections * sizeof(uint32_t) + bodySize != file->size())
+        return nullptr;
+
+    // Only the header and the section table are checked here; the body is checked as it is read
+    const size_t tableSize = header.sectionCount * sizeof(uint32_t);
+    const char *table = file->data() + sizeof(Header);
+    uint32_t expected = header.checksum;
+    header.checksum = 0;
+    uint32_t actual = checksum(reinterpret_cast<const char *>(&header), sizeof(Header));
+    if (checksum(table, tableSize, actual) != expected)
+        return nullptr;
+
+    std::unique_ptr<LibrarySnapshot> snapshot(new LibrarySnapshot());
+    snapshot->count_ = header.recordCount;
+    snapshot->stringBytes_ = static_cast<size_t>(header.stringBytes);
+    snapshot->sectionSums_ = table;
+    snapshot->body_ = table + tableSize;
+    snapshot->bodySize_ = static_cast<size_t>(bodySize);
+    snapshot->sections_.assign(header.sectionCount, SECTION_UNCHECKED);
+    snapshot->file_ = std::move(file);
+    return snapshot;
+}
+
+std::string_view LibrarySnapshot::path(size_t index) const
+{
+    return string(record(index).path);
+}
+
+MediaMetadata LibrarySnapshot::metadata(size_t index) const
+{
+    Record r = record(index);
+    MediaMetadata meta;
+    meta.title = std::string(string(r.title));
+    meta.artist = std::string(string(r.artist));
+    meta.album = std::string(string(r.album));
+    meta.genre = std::string(string(r.genre));
+    meta.codec = std::string(string(r.codec));
+    meta.year = r.year;
+    meta.track = r.track;
+    meta.duration = r.duration;
+    meta.bitrate = r.bitrate;
+    meta.sampleRate = r.sampleRate;
+    meta.channels = r.channels;
+    meta.hasAlbumArt = (r.flags & FLAG_HAS_ALBUM_ART) != 0;
+    meta.comment = std::string(string(r.comment));
+
+    std::string_view fields = string(r.customFields);
+    while (!fields.empty())
+    {
+        size_t keyEnd = fields.find('\0');
+        size_t valueEnd = keyEnd == std::string_view::npos ? keyEnd : fields.find('\0', keyEnd + 1);
+        if (valueEnd == std::string_view::npos)
+            break;
+        meta.customFields[std::string(fields.substr(0, keyEnd))] =
+            std::string(fields.substr(keyEnd + 1, valueEnd - keyEnd - 1));
+        fields.remove_prefix(valueEnd + 1);
+    }
+    return meta;
+}
+
+std::shared_ptr<MediaFile> LibrarySnapshot::materialize(size_t index) const
+{
+    Record r = record(index);
+    auto file = std::make_shared<MediaFile>(std::string(string(r.path)), metadata(index));
+    file->setInLibrary((r.flags & FLAG_IN_LIBRARY) != 0);
+
+    FileFingerprint fingerprint;
+    fingerprint.size = r.fileSize;
+    fingerprint.mtime = r.mtime;
+    fingerprint.inode = r.inode;
+    file->setFingerprint(fingerprint);
+    return file;
+}
+
+LibrarySnapshot::Record LibrarySnapshot::record(size_t index) const
+{
+    Record r{};
+    if (index < count_ && verify(index * sizeof(Record), sizeof(Record)))
+    {
+        // Records are not guaranteed to be aligned inside the mapping
+        std::memcpy(&r, body_ + index * sizeof(Record), sizeof(Record));
+    }
+    return r;
+}
+
+std::string_view LibrarySnapshot::string(const StringRef &ref) const
+{
+    if (static_cast<uint64_t>(ref.offset) + ref.length > stringBytes_)
+        return std::string_view();
+
+    size_t offset = count_ * sizeof(Record) + ref.offset;
+    if (!verify(offset, ref.length))
+        return std::string_view();
+    return std::string_view(body_ + offset, ref.length);
+}
+
+bool LibrarySnapshot::verify(size_t offset, size_t length) const
+{
+    if (length == 0)
+        return true;
+
+    for (size_t section = offset / SECTION_SIZE; section <= (offset + length - 1) / SECTION_SIZE; ++section)
+    {
+        if (sections_[section] == SECTION_UNCHECKED)
+        {
+            size_t start = section * SECTION_SIZE;
+            uint32_t expected;
+            std::memcpy(&expected, sectionSums_ + section * sizeof(uint32_t), sizeof(expected));
+            bool good = checksum(body_ + start, std::min(SECTION_SIZE, bodySize_ - start)) == expected;
+            sections_[section] = good ? SECTION_GOOD : SECTION_BAD;
+        }
+        if (sections_[section] == SECTION_BAD)
+        {
+            damaged_ = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t LibrarySnapshot::checksum(const char *data, size_t size, uint32_t hash)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
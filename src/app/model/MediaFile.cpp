@@ -6,25 +6,56 @@
 
 namespace fs = std::filesystem;
 
-MediaFile::MediaFile(const std::string &filepath) : filepath_(filepath), inLibrary_(false)
+MediaFile::MediaFile(const std::string &filepath)
+    : filepath_(filepath), inLibrary_(false), details_(std::make_shared<const Details>())
 {
     parseFilePath();
     determineMediaType();
 }
 
 MediaFile::MediaFile(const std::string &filepath, const MediaMetadata &metadata)
-    : filepath_(filepath), metadata_(metadata), inLibrary_(false)
+    : filepath_(filepath), inLibrary_(false), details_(std::make_shared<const Details>(Details{metadata, {}, 0}))
 {
     parseFilePath();
     determineMediaType();
 }
 
+void MediaFile::setMetadata(const MediaMetadata &metadata)
+{
+    Details next = *details();
+    next.metadata = metadata;
+    ++next.revision;
+    publish(std::move(next));
+}
+
+void MediaFile::setMetadata(const MediaMetadata &metadata, const FileFingerprint &fingerprint)
+{
+    Details next = *details();
+    next.metadata = metadata;
+    next.fingerprint = fingerprint;
+    ++next.revision;
+    publish(std::move(next));
+}
+
+void MediaFile::setFingerprint(const FileFingerprint &fingerprint)
+{
+    Details next = *details();
+    next.fingerprint = fingerprint;
+    publish(std::move(next));
+}
+
+void MediaFile::publish(Details details)
+{
+    std::atomic_store(&details_, std::shared_ptr<const Details>(std::make_shared<Details>(std::move(details))));
+}
+
 std::string MediaFile::getDisplayName() const
 {
     // Return title if available and not empty
-    if (!metadata_.title.empty())
+    auto current = details();
+    if (!current->metadata.title.empty())
     {
-        return metadata_.title;
+        return current->metadata.title;
     }
 
     // Otherwise return filename without extension
@@ -113,16 +144,31 @@ void MediaFile::determineMediaType()
 // JSON Serialization
 void to_json(nlohmann::json &j, const MediaFile &m)
 {
+    auto details = m.details();
+    const MediaMetadata &meta = details->metadata;
     j = nlohmann::json{{"path", m.filepath_},
                        {"metadata",
-                        {{"title", m.metadata_.title},
-                         {"artist", m.metadata_.artist},
-                         {"album", m.metadata_.album},
-                         {"genre", m.metadata_.genre},
-                         {"year", m.metadata_.year},
-                         {"track", m.metadata_.track},
-                         {"duration", m.metadata_.duration}}},
+                        {{"title", meta.title},
+                         {"artist", meta.artist},
+                         {"album", meta.album},
+                         {"genre", meta.genre},
+                         {"year", meta.year},
+                         {"track", meta.track},
+                         {"duration", meta.duration},
+                         {"bitrate", meta.bitrate},
+                         {"sampleRate", meta.sampleRate},
+                         {"channels", meta.channels},
+                         {"hasAlbumArt", meta.hasAlbumArt},
+                         {"codec", meta.codec},
+                         {"comment", meta.comment},
+                         {"customFields", meta.customFields}}},
                        {"inLibrary", m.inLibrary_}};
+    const FileFingerprint &fingerprint = details->fingerprint;
+    if (fingerprint.isValid())
+    {
+        j["fingerprint"] = {
+            {"size", fingerprint.size}, {"mtime", fingerprint.mtime}, {"inode", fingerprint.inode}};
+    }
 }
 
 void from_json(const nlohmann::json &j, MediaFile &m)
@@ -136,22 +182,50 @@ void from_json(const nlohmann::json &j, MediaFile &m)
     if (j.contains("inLibrary"))
         m.inLibrary_ = j.at("inLibrary").get<bool>();
 
+    MediaFile::Details details = *m.details();
     if (j.contains("metadata"))
     {
         const auto &meta = j.at("metadata");
         if (meta.contains("title"))
-            m.metadata_.title = meta.at("title").get<std::string>();
+            details.metadata.title = meta.at("title").get<std::string>();
         if (meta.contains("artist"))
-            m.metadata_.artist = meta.at("artist").get<std::string>();
+            details.metadata.artist = meta.at("artist").get<std::string>();
         if (meta.contains("album"))
-            m.metadata_.album = meta.at("album").get<std::string>();
+            details.metadata.album = meta.at("album").get<std::string>();
         if (meta.contains("genre"))
-            m.metadata_.genre = meta.at("genre").get<std::string>();
+            details.metadata.genre = meta.at("genre").get<std::string>();
         if (meta.contains("year"))
-            m.metadata_.year = meta.at("year").get<int>();
+            details.metadata.year = meta.at("year").get<int>();
         if (meta.contains("track"))
-            m.metadata_.track = meta.at("track").get<int>();
+            details.metadata.track = meta.at("track").get<int>();
         if (meta.contains("duration"))
-            m.metadata_.duration = meta.at("duration").get<int>();
+            details.metadata.duration = meta.at("duration").get<int>();
+        if (meta.contains("bitrate"))
+            details.metadata.bitrate = meta.at("bitrate").get<int>();
+        if (meta.contains("sampleRate"))
+            details.metadata.sampleRate = meta.at("sampleRate").get<int>();
+        if (meta.contains("channels"))
+            details.metadata.channels = meta.at("channels").get<int>();
+        if (meta.contains("hasAlbumArt"))
+            details.metadata.hasAlbumArt = meta.at("hasAlbumArt").get<bool>();
+        if (meta.contains("codec"))
+            details.metadata.codec = meta.at("codec").get<std::string>();
+        if (meta.contains("comment"))
+            details.metadata.comment = meta.at("comment").get<std::string>();
+        if (meta.contains("customFields") && meta.at("customFields").is_object())
+            details.metadata.customFields = meta.at("customFields").get<std::map<std::string, std::string>>();
+        ++details.revision;
+    }
+
+    // Records written before the full metadata was saved lack hasAlbumArt and the
+    // stream fields; without a fingerprint the next refresh reads them again
+    bool complete = j.contains("metadata") && j.at("metadata").contains("hasAlbumArt");
+    if (complete && j.contains("fingerprint"))
+    {
+        const auto &fp = j.at("fingerprint");
+        details.fingerprint.size = fp.value("size", uint64_t(0));
+        details.fingerprint.mtime = fp.value("mtime", int64_t(0));
+        details.fingerprint.inode = fp.value("inode", uint64_t(0));
     }
+    m.publish(std::move(details));
 }
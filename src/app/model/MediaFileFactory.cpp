@@ -27,6 +27,20 @@ std::unique_ptr<MediaFile> MediaFileFactory::createMediaFile(const std::string &
     return mediaFile;
 }
 
+std::unique_ptr<MediaFile> MediaFileFactory::createMediaFile(const std::string &filepath,
+                                                             IMetadataReader *metadataReader, IFileSystem *fileSystem)
+{
+    FileFingerprint fingerprint;
+    bool statted = fileSystem && fileSystem->getFingerprint(filepath, fingerprint);
+
+    auto mediaFile = createMediaFile(filepath, metadataReader);
+    if (statted)
+    {
+        mediaFile->setFingerprint(fingerprint);
+    }
+    return mediaFile;
+}
+
 std::unique_ptr<MediaFile> MediaFileFactory::createMediaFileWithMetadata(const std::string &filepath,
                                                                          const MediaMetadata &metadata)
 {
@@ -124,11 +124,42 @@ void PlaybackState::removeTrackFromBackStack(const std::string &path)
         notify();
     }
 }
+
+void PlaybackState::removeTrackFromQueue(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    size_t kept = 0;
+    size_t keptBeforeIndex = 0;
+    for (size_t i = 0; i < playQueue_.size(); ++i)
+    {
+        if (playQueue_[i] && playQueue_[i]->getPath() == path)
+        {
+            continue;
+        }
+        if (i < queueIndex_)
+        {
+            ++keptBeforeIndex;
+        }
+        playQueue_[kept++] = playQueue_[i];
+    }
+
+    if (kept == playQueue_.size())
+    {
+        return;
+    }
+    playQueue_.resize(kept);
+    queueIndex_ = keptBeforeIndex;
+    ++queueRevision_;
+    notify();
+}
+
 void PlaybackState::setPlayQueue(const std::vector<std::shared_ptr<MediaFile>> &queue)
 {
     std::lock_guard<std::mutex> lock(dataMutex_);
     playQueue_ = queue;
     queueIndex_ = 0;
+    ++queueRevision_;
     Subject::notify();
 }
 
@@ -175,17 +206,36 @@ std::shared_ptr<MediaFile> PlaybackState::getNextTrack()
     return playQueue_[queueIndex_++];
 }
 
+std::shared_ptr<MediaFile> PlaybackState::peekNextTrack() const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    if (queueIndex_ >= playQueue_.size())
+    {
+        return nullptr;
+    }
+
+    return playQueue_[queueIndex_];
+}
+
 bool PlaybackState::hasNextTrack() const
 {
     std::lock_guard<std::mutex> lock(dataMutex_);
     return queueIndex_ < playQueue_.size();
 }
 
+size_t PlaybackState::getQueueRevision() const
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return queueRevision_;
+}
+
 void PlaybackState::clearPlayQueue()
 {
     std::lock_guard<std::mutex> lock(dataMutex_);
     playQueue_.clear();
     queueIndex_ = 0;
+    ++queueRevision_;
     Subject::notify();
 }
 
@@ -202,6 +252,7 @@ void PlaybackState::reset()
     while (!backStack_.empty())
         backStack_.pop();
     playQueue_.clear();
+    ++queueRevision_;
 
     Subject::notify();
 }
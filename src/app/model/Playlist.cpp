@@ -23,6 +23,7 @@ bool Playlist::addTrack(std::shared_ptr<MediaFile> track)
 
     std::lock_guard<std::mutex> lock(dataMutex_);
     tracks_.push_back(track);
+    ++revision_;
 
     Logger::info("Added track to playlist '" + name_ + "': " + track->getPath());
     Subject::notify();
@@ -44,6 +45,7 @@ bool Playlist::insertTrack(std::shared_ptr<MediaFile> track, size_t position)
     }
 
     tracks_.insert(tracks_.begin() + position, track);
+    ++revision_;
     Subject::notify();
     return true;
 }
@@ -58,6 +60,7 @@ bool Playlist::removeTrack(size_t index)
     }
 
     tracks_.erase(tracks_.begin() + index);
+    ++revision_;
     Logger::info("Removed track at index " + std::to_string(index) + " from playlist '" + name_ + "'");
     Subject::notify();
     return true;
@@ -74,6 +77,7 @@ bool Playlist::removeTrackByPath(const std::string &filepath)
     if (it != tracks_.end())
     {
         tracks_.erase(it);
+        ++revision_;
         Logger::info("Removed track from playlist '" + name_ + "': " + filepath);
         Subject::notify();
         return true;
@@ -98,6 +102,7 @@ void Playlist::clear()
 {
     std::lock_guard<std::mutex> lock(dataMutex_);
     tracks_.clear();
+    ++revision_;
 
     Logger::info("Cleared playlist '" + name_ + "'");
     Subject::notify();
@@ -122,6 +127,7 @@ void Playlist::shuffle()
         size_t j = dis(gen);
         std::swap(tracks_[i], tracks_[j]);
     }
+    ++revision_;
 
     Logger::info("Shuffled playlist '" + name_ + "'");
     Subject::notify();
@@ -167,6 +173,7 @@ void from_json(const nlohmann::json &j, Playlist &p)
             item.get_to(*track);
             p.tracks_.push_back(track);
         }
+        ++p.revision_;
     }
 }
 
@@ -2,6 +2,7 @@
 #include "service/TagLibMetadataReader.h"
 #include "utils/Logger.h"
 #include <json.hpp>
+#include <limits>
 
 PlaylistManager::PlaylistManager(IPersistence *persistence) : persistence_(persistence)
 {
@@ -21,6 +22,7 @@ std::shared_ptr<Playlist> PlaylistManager::createPlaylist(const std::string &nam
 
     auto playlist = std::make_shared<Playlist>(name);
     playlists_[name] = playlist;
+    journalLocked({{"op", "create"}, {"name", name}});
 
     Logger::info("Created playlist: " + name);
     Subject::notify();
@@ -45,6 +47,7 @@ bool PlaylistManager::deletePlaylist(const std::string &name)
     }
 
     playlists_.erase(it);
+    journalLocked({{"op", "delete"}, {"name", name}});
     Logger::info("Deleted playlist: " + name);
     Subject::notify();
     return true;
@@ -78,12 +81,160 @@ std::shared_ptr<Playlist> PlaylistManager::getNowPlayingPlaylist() const
     return getPlaylist(NOW_PLAYING_NAME);
 }
 
+bool PlaylistManager::addTrackTo(const std::string &name, std::shared_ptr<MediaFile> track)
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    auto it = playlists_.find(name);
+    if (it == playlists_.end() || !track || !it->second->addTrack(track))
+    {
+        return false;
+    }
+
+    journalLocked({{"op", "add"}, {"playlist", name}, {"track", *track}});
+    return true;
+}
+
+bool PlaylistManager::removeTrackAt(const std::string &name, size_t index)
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    auto it = playlists_.find(name);
+    if (it == playlists_.end())
+    {
+        return false;
+    }
+
+    auto track = it->second->getTrack(index);
+    if (!track || !it->second->removeTrack(index))
+    {
+        return false;
+    }
+
+    // The path guards replay against a base that already lacks the track
+    journalLocked({{"op", "remove"}, {"playlist", name}, {"index", index}, {"path", track->getPath()}});
+    return true;
+}
+
+bool PlaylistManager::removeTrackFrom(const std::string &name, const std::string &filepath)
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    auto it = playlists_.find(name);
+    if (it == playlists_.end() || !it->second->removeTrackByPath(filepath))
+    {
+        return false;
+    }
+
+    journalLocked({{"op", "remove"}, {"playlist", name}, {"path", filepath}});
+    return true;
+}
+
+int PlaylistManager::removeTrackFromAll(const std::string &filepath)
+{
+    std::lock_guard<std::mutex> lock(dataMutex_);
+
+    int affectedCount = 0;
+    for (const auto &[name, playlist] : playlists_)
+    {
+        if (playlist->removeTrackByPath(filepath))
+        {
+            journalLocked({{"op", "remove"}, {"playlist", name}, {"path", filepath}});
+            affectedCount++;
+        }
+    }
+
+    // Without a journal the only way to persist this is a full rewrite
+    if (affectedCount > 0 && !journal_)
+    {
+        saveAllInternal();
+    }
+    return affectedCount;
+}
+
 bool PlaylistManager::saveAll()
 {
+    // With a journal, saving folds it into playlists.json
+    if (journal_)
+        return journal_->compact();
+
     std::lock_guard<std::mutex> lock(dataMutex_);
     return saveAllInternal();
 }
 
+void PlaylistManager::enableJournal(size_t compactThreshold)
+{
+    if (!persistence_ || journal_)
+        return;
+
+    journal_ = std::make_unique<Journal>(persistence_, "data/playlists.journal",
+                                         [this]()
+                                         {
+                                             std::lock_guard<std::mutex> lock(dataMutex_);
+                                             return saveAllInternal();
+                                         },
+                                         compactThreshold);
+}
+
+void PlaylistManager::journalLocked(const nlohmann::json &record)
+{
+    if (journal_)
+        journal_->append(record);
+}
+
+void PlaylistManager::applyRecordLocked(const nlohmann::json &record)
+{
+    // Records are idempotent: replaying one the base already reflects is a no-op
+    const std::string op = record.value("op", "");
+    if (op == "create")
+    {
+        std::string name = record.at("name").get<std::string>();
+        if (playlists_.find(name) == playlists_.end())
+            playlists_[name] = std::make_shared<Playlist>(name);
+    }
+    else if (op == "delete")
+    {
+        playlists_.erase(record.at("name").get<std::string>());
+    }
+    else if (op == "rename")
+    {
+        auto it = playlists_.find(record.at("from").get<std::string>());
+        std::string newName = record.at("to").get<std::string>();
+        if (it != playlists_.end() && playlists_.find(newName) == playlists_.end())
+        {
+            auto playlist = it->second;
+            playlist->rename(newName);
+            playlists_.erase(it);
+            playlists_[newName] = playlist;
+        }
+    }
+    else if (op == "add" || op == "remove")
+    {
+        auto it = playlists_.find(record.at("playlist").get<std::string>());
+        if (it == playlists_.end())
+            return;
+
+        if (op == "add")
+        {
+            auto track = std::make_shared<MediaFile>("");
+            record.at("track").get_to(*track);
+            if (!it->second->contains(track->getPath()))
+                it->second->addTrack(track);
+        }
+        else
+        {
+            // Records from removeTrackAt() name the position; it only misses if the base already moved on
+            const std::string path = record.at("path").get<std::string>();
+            size_t index = record.value("index", std::numeric_limits<size_t>::max());
+            auto track = it->second->getTrack(index);
+            if (track && track->getPath() == path)
+                it->second->removeTrack(index);
+            else
+                it->second->removeTrackByPath(path);
+        }
+    }
+}
+
 bool PlaylistManager::saveAllInternal()
 {
     if (!persistence_)
@@ -132,6 +283,20 @@ bool PlaylistManager::loadAll()
         return false;
 
     std::lock_guard<std::mutex> lock(dataMutex_);
+    bool loaded = loadBaseLocked();
+
+    // Changes made after playlists.json was last written
+    if (journal_ && journal_->replay([this](const nlohmann::json &record) { applyRecordLocked(record); }) > 0)
+    {
+        initializeNowPlayingPlaylist();
+        initializeFavoritesPlaylist();
+        loaded = true;
+    }
+    return loaded;
+}
+
+bool PlaylistManager::loadBaseLocked()
+{
     playlists_.clear();
 
     bool migrationNeeded = false;
@@ -297,6 +462,7 @@ bool PlaylistManager::renamePlaylist(const std::string &oldName, const std::stri
     playlist->rename(newName);
     playlists_.erase(it);
     playlists_[newName] = playlist;
+    journalLocked({{"op", "rename"}, {"from", oldName}, {"to", newName}});
 
     Logger::info("Renamed playlist from '" + oldName + "' to '" + newName + "'");
     Subject::notify();
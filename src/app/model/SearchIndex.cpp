@@ -0,0 +1,306 @@
+#include "app/model/SearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace
+{
+std::string toLower(const std::string &value)
+{
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    return lower;
+}
+
+// Case-insensitive substring test; lowerNeedle is already lowercased
+bool containsLower(const std::string &haystack, const std::string &lowerNeedle)
+{
+    auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                          [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+    return it != haystack.end();
+}
+
+// Below this many documents compaction is not worth the rebuild
+const size_t kMinCompactionSize = 1024;
+} // namespace
+
+void SearchIndex::add(const std::shared_ptr<MediaFile> &file)
+{
+    if (!file || docIds_.count(file.get()))
+        return;
+
+    DocId id = static_cast<DocId>(documents_.size());
+    Document doc;
+    doc.file = file;
+    extractText(doc);
+    documents_.push_back(std::move(doc));
+    docIds_[file.get()] = id;
+
+    // New ids are always the largest, so postings stay sorted with a plain append
+    indexDocument(id, true);
+}
+
+bool SearchIndex::remove(const MediaFile *file)
+{
+    auto it = docIds_.find(file);
+    if (it == docIds_.end())
+        return false;
+
+    DocId id = it->second;
+    unindexDocument(id);
+    documents_[id] = Document();
+    docIds_.erase(it);
+    ++tombstones_;
+
+    compactIfNeeded();
+    return true;
+}
+
+bool SearchIndex::update(const MediaFile *file)
+{
+    auto it = docIds_.find(file);
+    if (it == docIds_.end())
+        return false;
+
+    DocId id = it->second;
+    unindexDocument(id);
+
+    extractText(documents_[id]);
+    indexDocument(id, false);
+    return true;
+}
+
+void SearchIndex::clear()
+{
+    documents_.clear();
+    docIds_.clear();
+    postings_.clear();
+    tombstones_ = 0;
+}
+
+std::vector<std::shared_ptr<MediaFile>> SearchIndex::search(const std::string &query,
+                                                            const std::vector<std::string> &searchFields) const
+{
+    std::vector<std::shared_ptr<MediaFile>> results;
+    if (query.empty())
+        return results;
+
+    std::string lowerQuery = toLower(query);
+    std::vector<DocId> matches;
+
+    for (const auto &name : searchFields)
+    {
+        Field field;
+        if (!fieldFromName(name, field))
+            continue;
+
+        if (lowerQuery.size() < 3)
+        {
+            // Too short to have a trigram; scan the pre-lowercased text instead
+            for (DocId id = 0; id < documents_.size(); ++id)
+            {
+                const Document &doc = documents_[id];
+                if (doc.file && doc.text[field].find(lowerQuery) != std::string::npos)
+                    matches.push_back(id);
+            }
+            continue;
+        }
+
+        // Gather posting lists; any missing trigram means no match in this field
+        std::vector<const std::vector<DocId> *> lists;
+        bool missing = false;
+        for (uint32_t key : trigramKeys(field, lowerQuery))
+        {
+            auto it = postings_.find(key);
+            if (it == postings_.end())
+            {
+                missing = true;
+                break;
+            }
+            lists.push_back(&it->second);
+        }
+        if (missing || lists.empty())
+            continue;
+
+        // Intersect starting from the shortest list
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<DocId> *a, const std::vector<DocId> *b) { return a->size() < b->size(); });
+
+        std::vector<DocId> candidates = *lists[0];
+        std::vector<DocId> scratch;
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+        {
+            scratch.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                                  std::back_inserter(scratch));
+            candidates.swap(scratch);
+        }
+
+        // Trigram overlap is necessary but not sufficient for a substring match
+        for (DocId id : candidates)
+        {
+            if (documents_[id].text[field].find(lowerQuery) != std::string::npos)
+                matches.push_back(id);
+        }
+    }
+
+    // A track matching several fields must appear only once
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    results.reserve(matches.size());
+    for (DocId id : matches)
+    {
+        results.push_back(documents_[id].file);
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<MediaFile>> SearchIndex::scan(const std::vector<std::shared_ptr<MediaFile>> &tracks,
+                                                          const std::string &query,
+                                                          const std::vector<std::string> &searchFields)
+{
+    std::vector<std::shared_ptr<MediaFile>> results;
+    std::vector<Field> fields;
+    for (const auto &name : searchFields)
+    {
+        Field field;
+        if (fieldFromName(name, field))
+            fields.push_back(field);
+    }
+    if (query.empty() || fields.empty())
+        return results;
+
+    std::string lowerQuery = toLower(query);
+    for (const auto &file : tracks)
+    {
+        if (!file)
+            continue;
+        auto snapshot = file->getMetadataSnapshot();
+        const MediaMetadata &meta = *snapshot;
+        for (Field field : fields)
+        {
+            const std::string &text = field == FIELD_TITLE    ? meta.title
+                                      : field == FIELD_ARTIST ? meta.artist
+                                      : field == FIELD_ALBUM  ? meta.album
+                                                              : meta.genre;
+            if (containsLower(text, lowerQuery))
+            {
+                results.push_back(file);
+                break;
+            }
+        }
+    }
+    return results;
+}
+
+void SearchIndex::indexDocument(DocId id, bool appendOnly)
+{
+    const Document &doc = documents_[id];
+    for (uint32_t f = 0; f < FIELD_COUNT; ++f)
+    {
+        for (uint32_t key : trigramKeys(static_cast<Field>(f), doc.text[f]))
+        {
+            auto &list = postings_[key];
+            if (appendOnly || list.empty() || list.back() < id)
+            {
+                list.push_back(id);
+            }
+            else
+            {
+                list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+            }
+        }
+    }
+}
+
+void SearchIndex::unindexDocument(DocId id)
+{
+    const Document &doc = documents_[id];
+    for (uint32_t f = 0; f < FIELD_COUNT; ++f)
+    {
+        for (uint32_t key : trigramKeys(static_cast<Field>(f), doc.text[f]))
+        {
+            auto it = postings_.find(key);
+            if (it == postings_.end())
+                continue;
+
+            auto &list = it->second;
+            auto pos = std::lower_bound(list.begin(), list.end(), id);
+            if (pos != list.end() && *pos == id)
+                list.erase(pos);
+            if (list.empty())
+                postings_.erase(it);
+        }
+    }
+}
+
+void SearchIndex::compactIfNeeded()
+{
+    if (documents_.size() < kMinCompactionSize || tombstones_ * 2 < documents_.size())
+        return;
+
+    std::vector<Document> live;
+    live.reserve(docIds_.size());
+    for (auto &doc : documents_)
+    {
+        if (doc.file)
+            live.push_back(std::move(doc));
+    }
+
+    documents_.swap(live);
+    docIds_.clear();
+    postings_.clear();
+    tombstones_ = 0;
+
+    for (DocId id = 0; id < documents_.size(); ++id)
+    {
+        docIds_[documents_[id].file.get()] = id;
+        indexDocument(id, true);
+    }
+}
+
+void SearchIndex::extractText(Document &doc)
+{
+    auto snapshot = doc.file->getMetadataSnapshot();
+    const MediaMetadata &meta = *snapshot;
+    doc.text[FIELD_TITLE] = toLower(meta.title);
+    doc.text[FIELD_ARTIST] = toLower(meta.artist);
+    doc.text[FIELD_ALBUM] = toLower(meta.album);
+    doc.text[FIELD_GENRE] = toLower(meta.genre);
+}
+
+bool SearchIndex::fieldFromName(const std::string &name, Field &field)
+{
+    if (name == "title")
+        field = FIELD_TITLE;
+    else if (name == "artist")
+        field = FIELD_ARTIST;
+    else if (name == "album")
+        field = FIELD_ALBUM;
+    else if (name == "genre")
+        field = FIELD_GENRE;
+    else
+        return false;
+    return true;
+}
+
+std::vector<uint32_t> SearchIndex::trigramKeys(Field field, const std::string &text)
+{
+    std::vector<uint32_t> keys;
+    if (text.size() < 3)
+        return keys;
+
+    keys.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); ++i)
+    {
+        uint32_t gram = (static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16) |
+                        (static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8) |
+                        static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2]));
+        keys.push_back((static_cast<uint32_t>(field) << 24) | gram);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
@@ -22,14 +22,14 @@ FileBrowserView::FileBrowserView(IFileSystem *fileSystem, LibraryController *lib
     // Increase density for File Browser as requested ("increase selector height")
     fileSelector_.setItemsPerPage(25);
 
-    refreshCurrentDirectory();
+    // Listing starts on show(); a cached folder comes back without a rescan
+    loader_ = std::make_unique<DirectoryLoader>(fileSystem_, MediaFileFactory::getAllSupportedFormats(), 3);
 }
 
 void FileBrowserView::show()
 {
     // Refresh to ensure we have latest library state (important if library loaded after view init)
     refreshCurrentDirectory();
-    fileSelector_.clearSelection();
     BaseView::show();
 }
 
@@ -89,8 +89,15 @@ void FileBrowserView::renderPopup()
 
 void FileBrowserView::renderContent()
 {
+    pollDirectory();
+
     // Current path info at the very top (optional but good for context)
     ImGui::TextDisabled("Location: %s", currentPath_.c_str());
+    if (loading_)
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(scanning... %zu files)", allMediaFiles_.size());
+    }
     ImGui::Separator();
 
     // Get available content size
@@ -119,6 +126,23 @@ void FileBrowserView::renderContent()
         if (ImGui::Button("Home", ImVec2(navBtnWidth, 0)))
             onHomeClicked();
 
+        // Whole-folder import runs in the background; show its progress while it lasts
+        if (libController_ && mode_ != BrowserMode::PLAYLIST_SELECTION)
+        {
+            ImportProgress progress = libController_->getImportProgress();
+            if (progress.running)
+            {
+                ImGui::Text("Importing: %zu added, %zu/%zu read", progress.added, progress.processed,
+                            progress.discovered);
+                if (ImGui::Button("Cancel Import", ImVec2(-1, 0)))
+                    libController_->cancelDirectoryImport();
+            }
+            else if (ImGui::Button("Import Folder", ImVec2(-1, 0)))
+            {
+                onImportFolderClicked();
+            }
+        }
+
         ImGui::Separator();
         ImGui::Text("Folders (%d tracks)", currentTrackCount_);
         ImGui::Separator();
@@ -185,6 +209,7 @@ void FileBrowserView::renderContent()
                     if (ImGui::Selectable(label.c_str(), isSelected))
                     {
                         selectedExtension_ = ext;
+                        fileSelector_.clearSelection();
                         applyFilter();
                     }
                     if (isSelected)
@@ -258,135 +283,126 @@ void FileBrowserView::navigateTo(const std::string &path)
     }
 }
 
-void FileBrowserView::refreshCurrentDirectory()
+void FileBrowserView::refreshCurrentDirectory(bool force)
 {
-    // 1. Get directories for navigation (Left Panel)
-    auto allFiles = fileSystem_->browse(currentPath_);
+    // Drop the old folder's lists straight away; the new ones stream in from the loader
     currentFiles_.clear();
-    for (const auto &file : allFiles)
-    {
-        if (file.isDirectory)
-        {
-            currentFiles_.push_back(file);
-        }
-    }
-
-    // 2. Get recursive media files with max depth (Right Panel)
     allMediaFiles_.clear();
+    canonicalPaths_.clear();
     availableExtensions_.clear();
     availableExtensions_.insert("All");
-
-    std::vector<FileInfo> mediaFiles; // Temporary scan result container
-
-    // Get all supported extensions
-    std::vector<std::string> extensions = MediaFileFactory::getAllSupportedFormats();
-
-    // Scan recursively with max depth of 3
-    std::vector<std::string> mediaPaths = fileSystem_->getMediaFiles(currentPath_, extensions, 3);
-
-    // Convert to FileInfo
-    for (const auto &path : mediaPaths)
+    fileSelector_.clearSelection();
+    libraryPaths_.clear();
+    if (libController_)
     {
-        FileInfo info;
-        info.path = path;
-
-        // Extract filename and extension manually
-        size_t lastSlash = path.find_last_of("/\\");
-        info.name = (lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path;
-
-        size_t lastDot = info.name.find_last_of('.');
-        info.extension = (lastDot != std::string::npos) ? info.name.substr(lastDot) : "";
-        info.isDirectory = false;
-        info.size = 0;
-
-        if (!info.extension.empty())
-        {
-            availableExtensions_.insert(info.extension);
-        }
-
-        allMediaFiles_.push_back(info);
+        libraryPaths_ = libController_->getAllTrackPaths();
     }
-
     applyFilter();
+
+    loading_ = true;
+    loader_->load(currentPath_, force);
 }
 
-void FileBrowserView::applyFilter()
+bool FileBrowserView::pollDirectory()
 {
-    // 3. Filter and Sort logic
-    std::vector<FileInfo> filteredFiles;
-    if (selectedExtension_ == "All")
-    {
-        filteredFiles = allMediaFiles_;
-    }
-    else
+    DirectoryLoader::Update update;
+    if (!loader_->poll(update))
     {
-        for (const auto &file : allMediaFiles_)
-        {
-            if (file.extension == selectedExtension_)
-            {
-                filteredFiles.push_back(file);
-            }
-        }
+        return false;
     }
-    
-    std::vector<FileInfo> &mediaFiles = filteredFiles; // Ref for sorting code block compatibility
-    std::unordered_set<std::string> libraryPaths;
-    if (libController_)
+
+    if (update.reset)
     {
-        libraryPaths = libController_->getAllTrackPaths();
+        currentFiles_ = std::move(update.folders);
+        allMediaFiles_.clear();
+        canonicalPaths_.clear();
+        availableExtensions_.clear();
+        availableExtensions_.insert("All");
+        fileSelector_.setItems({});
+        fileSelector_.setDisabledItems({});
+        currentTrackCount_ = 0;
     }
-    
-    std::set<std::string> disabledPaths;
 
-    // Identify disabled files
-    for (const auto &file : mediaFiles)
+    // Only the new files are classified and merged in; the rest of the list stays sorted as it is
+    std::vector<FileInfo> shown;
+    for (auto &entry : update.media)
     {
-        bool found = false;
-        if (libraryPaths.count(file.path))
+        if (!entry.info.extension.empty())
+        {
+            availableExtensions_.insert(entry.info.extension);
+        }
+        if (!entry.canonicalPath.empty())
         {
-            found = true;
+            canonicalPaths_[entry.info.path] = std::move(entry.canonicalPath);
         }
-        else
+        if (selectedExtension_ == "All" || entry.info.extension == selectedExtension_)
         {
-            // Try canonical path match in case of symlinks/normalization differences
-            try
+            if (isInLibrary(entry.info))
             {
-                std::error_code ec;
-                std::string avgCanonical = std::filesystem::canonical(file.path, ec).string();
-                if (!ec && libraryPaths.count(avgCanonical))
-                {
-                    found = true;
-                }
+                fileSelector_.addDisabledItem(entry.info.path);
             }
-            catch (...) {}
+            shown.push_back(entry.info);
         }
+        allMediaFiles_.push_back(std::move(entry.info));
+    }
+    currentTrackCount_ += (int)shown.size();
+    fileSelector_.mergeItems(std::move(shown),
+                             [this](const FileInfo &a, const FileInfo &b) { return listedBefore(a, b); });
+    loading_ = !update.complete;
+
+    return true;
+}
 
-        if (found)
+void FileBrowserView::applyFilter()
+{
+    // Full rebuild; only needed when the filter changes, new files are merged in by pollDirectory()
+    std::vector<FileInfo> mediaFiles;
+    std::set<std::string> disabledPaths;
+    for (const auto &file : allMediaFiles_)
+    {
+        if (selectedExtension_ != "All" && file.extension != selectedExtension_)
+        {
+            continue;
+        }
+        if (isInLibrary(file))
         {
             disabledPaths.insert(file.path);
         }
+        mediaFiles.push_back(file);
     }
 
-    // Sort: Unadded first, then Added. Tie-break with name.
-    std::sort(mediaFiles.begin(), mediaFiles.end(), [&](const FileInfo &a, const FileInfo &b) {
-        bool aInLib = disabledPaths.count(a.path); // Use disabledPaths set which is already resolved
-        bool bInLib = disabledPaths.count(b.path);
-        
-        if (aInLib != bInLib)
-        {
-            return aInLib < bInLib; 
-        }
-        return a.name < b.name;
-    });
+    fileSelector_.setDisabledItems(disabledPaths);
+    std::sort(mediaFiles.begin(), mediaFiles.end(),
+              [this](const FileInfo &a, const FileInfo &b) { return listedBefore(a, b); });
 
     currentTrackCount_ = (int)mediaFiles.size();
-
     fileSelector_.setItems(mediaFiles);
-    fileSelector_.setDisabledItems(disabledPaths); // Pass disabled items
-    
-    // fileSelector_.clearSelection(); // Optional: clear when valid path changes?
-    // Usually navigating to a new folder implies new context, so clearing is safer to avoid confusion.
-    fileSelector_.clearSelection();
+
+    // Selection survives files streaming in; refreshCurrentDirectory() clears it on navigation
+}
+
+bool FileBrowserView::isInLibrary(const FileInfo &file) const
+{
+    if (libraryPaths_.count(file.path))
+    {
+        return true;
+    }
+    // Also try the resolved path in case of symlinks/normalization differences
+    auto canonical = canonicalPaths_.find(file.path);
+    return canonical != canonicalPaths_.end() && libraryPaths_.count(canonical->second);
+}
+
+bool FileBrowserView::listedBefore(const FileInfo &a, const FileInfo &b) const
+{
+    // Sort: Unadded first, then Added. Tie-break with name.
+    const auto &disabledPaths = fileSelector_.getDisabledItems();
+    bool aInLib = disabledPaths.count(a.path);
+    bool bInLib = disabledPaths.count(b.path);
+    if (aInLib != bInLib)
+    {
+        return aInLib < bInLib;
+    }
+    return a.name < b.name;
 }
 
 // Pagination methods removed - delegated to PagedFileSelector
@@ -398,7 +414,7 @@ void FileBrowserView::onNavigateUpClicked()
 
 void FileBrowserView::onRefreshClicked()
 {
-    refreshCurrentDirectory();
+    refreshCurrentDirectory(true);
 }
 
 void FileBrowserView::onHomeClicked()
@@ -424,6 +440,14 @@ void FileBrowserView::onAddRandomClicked()
     processFiles(fileSelector_.getSelectedPaths());
 }
 
+void FileBrowserView::onImportFolderClicked()
+{
+    if (libController_ && libController_->startDirectoryImport(currentPath_))
+    {
+        Logger::info("Importing folder " + currentPath_);
+    }
+}
+
 void FileBrowserView::processFiles(const std::vector<std::string> &paths)
 {
     if (paths.empty())
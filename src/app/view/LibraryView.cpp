@@ -127,12 +127,21 @@ void LibraryView::refreshDisplay()
     // but we can use this to cache or force a refresh if needed.
     if (library_)
     {
-        auto allFiles = searchQuery_.empty() ? library_->getAll() : library_->search(searchQuery_);
+        // The snapshot is shared with the model and stays valid while an import keeps writing
+        Library::TrackSnapshot allFiles;
+        if (searchQuery_.empty())
+            allFiles = library_->snapshot();
+        else
+            allFiles = std::make_shared<std::vector<std::shared_ptr<MediaFile>>>(library_->search(searchQuery_));
+
+        // A writer held the lock; pick up its changes on the next frame
+        if (library_->hasPendingSnapshot())
+            needsRefresh_ = true;
 
         // 1. Populate extensions
         availableExtensions_.clear();
         availableExtensions_.insert("All");
-        for (const auto &file : allFiles)
+        for (const auto &file : *allFiles)
         {
             std::string ext = file->getExtension();
             if (!ext.empty() && ext[0] == '.') ext = ext.substr(1);
@@ -143,12 +152,12 @@ void LibraryView::refreshDisplay()
         // 2. Filter
         if (selectedExtension_ == "All")
         {
-            displayedFiles_ = allFiles;
+            displayedFiles_ = *allFiles;
         }
         else
         {
             displayedFiles_.clear();
-            for (const auto &file : allFiles)
+            for (const auto &file : *allFiles)
             {
                 std::string ext = file->getExtension();
                 if (!ext.empty() && ext[0] == '.') ext = ext.substr(1);
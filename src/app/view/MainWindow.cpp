@@ -316,13 +316,17 @@ void MainWindow::renderAlbumArt()
                 albumArtTexture_ = 0;
             }
 
-            // Load mới
-            if (meta.hasAlbumArt && !meta.albumArtData.empty())
+            // Load mới (the store reads the cover on first use and caches it)
+            std::shared_ptr<const AlbumArt> art;
+            if (meta.hasAlbumArt && albumArtStore_)
+            {
+                art = albumArtStore_->get(track->getPath());
+            }
+            if (art && !art->data.empty())
             {
                 int width, height, channels;
-                unsigned char *imageData =
-                    stbi_load_from_memory(meta.albumArtData.data(), static_cast<int>(meta.albumArtData.size()), &width,
-                                          &height, &channels, 4);
+                unsigned char *imageData = stbi_load_from_memory(art->data.data(), static_cast<int>(art->data.size()),
+                                                                 &width, &height, &channels, 4);
 
                 if (imageData)
                 {
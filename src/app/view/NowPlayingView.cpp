@@ -188,13 +188,13 @@ void NowPlayingView::renderPlaybackControls()
 
     auto set_icon_pos = [&]() { ImGui::SetCursorPosY(baseLineY + iconOffset); };
 
-    if (state_ && playlistManager_)
+    if (state_ && playlistController_)
     {
         set_icon_pos();
         auto track = state_->getCurrentTrack();
         if (track)
         {
-            auto favPlaylist = playlistManager_->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME);
+            auto favPlaylist = playlistController_->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME);
             if (favPlaylist)
             {
                 bool isFavorite = favPlaylist->contains(track->getPath());
@@ -344,19 +344,17 @@ void NowPlayingView::onRepeatClicked()
 
 void NowPlayingView::onFavoriteClicked(bool currentlyFavorite)
 {
-    if (state_ && playlistManager_)
+    if (state_ && playlistController_)
     {
         auto track = state_->getCurrentTrack();
         if (track)
         {
-            auto favPlaylist = playlistManager_->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME);
-            if (favPlaylist)
-            {
-                if (currentlyFavorite)
-                    favPlaylist->removeTrackByPath(track->getPath());
-                else
-                    favPlaylist->addTrack(track);
-            }
+            // Through the controller, so the change is journaled like any other playlist edit
+            const std::string favorites = PlaylistManager::FAVORITES_PLAYLIST_NAME;
+            if (currentlyFavorite)
+                playlistController_->removeFromPlaylistByPath(favorites, track->getPath());
+            else
+                playlistController_->addTrackToPlaylist(favorites, track);
         }
     }
 }
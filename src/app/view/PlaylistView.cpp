@@ -10,12 +10,13 @@
 
 PlaylistView::PlaylistView(PlaylistController *controller, PlaylistManager *manager,
                            PlaybackController *playbackController)
-    : playlistController_(controller), selectedTrackIndex_(-1), showCreateDialog_(false), showRenameDialog_(false)
+    : selectedTrackIndex_(-1), showCreateDialog_(false), showRenameDialog_(false)
 {
 
     // Initialize TrackListView base members
     playbackController_ = playbackController;
     playlistManager_ = manager;
+    playlistController_ = controller;
     // listController_ will be set dynamically when a playlist is selected
 
     // Attach as observer to playlistManager_
@@ -284,7 +285,8 @@ void PlaylistView::renderAddSongsPopup()
         auto *lib = playlistController_->getLibrary();
         if (lib)
         {
-            auto allTracks = lib->getAll();
+            // Refcounted snapshot: no copy and no waiting on an import in progress
+            auto allTracks = lib->snapshot();
 
             // Filter and Convert to FileInfo
             std::vector<FileInfo> displayTracks;
@@ -292,7 +294,7 @@ void PlaylistView::renderAddSongsPopup()
             std::string queryLower = searchQuery_;
             std::transform(queryLower.begin(), queryLower.end(), queryLower.begin(), ::tolower);
 
-            for (const auto &t : allTracks)
+            for (const auto &t : *allTracks)
             {
                 std::string title = t->getDisplayName();
                 std::string artist = t->getMetadata().artist;
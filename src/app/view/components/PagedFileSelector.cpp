@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstdio>
 #include <imgui.h>
+#include <iterator>
 #include <numeric>
 #include <random>
 
@@ -18,6 +19,16 @@ void PagedFileSelector::setItems(const std::vector<FileInfo> &items)
     updatePagination();
 }
 
+void PagedFileSelector::mergeItems(std::vector<FileInfo> items,
+                                   const std::function<bool(const FileInfo &, const FileInfo &)> &before)
+{
+    std::sort(items.begin(), items.end(), before);
+    auto middle = static_cast<std::ptrdiff_t>(items_.size());
+    items_.insert(items_.end(), std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+    std::inplace_merge(items_.begin(), items_.begin() + middle, items_.end(), before);
+    updatePagination();
+}
+
 void PagedFileSelector::setCustomLabels(const std::string &nameLabel, const std::string &typeLabel)
 {
     labelName_ = nameLabel;
@@ -0,0 +1,91 @@
+#include "app/view/components/TrackRowCache.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+TrackRowCache::TrackRowCache(size_t capacity) : capacity_(capacity)
+{
+}
+
+TrackRowCache::Row &TrackRowCache::get(const std::shared_ptr<MediaFile> &file)
+{
+    auto it = rows_.find(file.get());
+    if (it != rows_.end())
+    {
+        Row &row = it->second;
+        // A different track may have been allocated where a deleted one was
+        if (row.file_.lock() != file || row.revision_ != file->getMetadataRevision())
+        {
+            build(*file, row);
+            row.file_ = file;
+        }
+        return row;
+    }
+
+    if (rows_.size() >= capacity_)
+    {
+        trim();
+    }
+    Row &row = rows_[file.get()];
+    build(*file, row);
+    row.file_ = file;
+    return row;
+}
+
+void TrackRowCache::clear()
+{
+    rows_.clear();
+}
+
+void TrackRowCache::build(const MediaFile &file, Row &row)
+{
+    const auto &meta = file.getMetadata();
+    row.title = file.getDisplayName();
+    row.artist = meta.artist.empty() ? "Unknown Artist" : meta.artist;
+    row.album = meta.album.empty() ? "Unknown Album" : meta.album;
+    row.subtitle = row.artist + " • " + row.album;
+
+    row.format = file.getExtension();
+    if (!row.format.empty() && row.format[0] == '.')
+        row.format = row.format.substr(1);
+    std::transform(row.format.begin(), row.format.end(), row.format.begin(), ::toupper);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%d:%02d", meta.duration / 60, meta.duration % 60);
+    row.durationText = buffer;
+
+    // The fingerprint already holds the size once the library has stat'ed the file
+    size_t sizeBytes = file.getFingerprint().isValid() ? file.getFingerprint().size : file.getFileSize();
+    row.sizeText.clear();
+    if (sizeBytes > 0)
+    {
+        const char *units[] = {"B", "KB", "MB", "GB"};
+        int i = 0;
+        double size = static_cast<double>(sizeBytes);
+        while (size > 1024 && i < 3)
+        {
+            size /= 1024;
+            i++;
+        }
+        std::snprintf(buffer, sizeof(buffer), "%.2f %s", size, units[i]);
+        row.sizeText = buffer;
+    }
+
+    row.titleFont = nullptr; // Measure the new title
+    row.revision_ = file.getMetadataRevision();
+}
+
+void TrackRowCache::trim()
+{
+    for (auto it = rows_.begin(); it != rows_.end();)
+    {
+        if (it->second.file_.expired())
+            it = rows_.erase(it);
+        else
+            ++it;
+    }
+    if (rows_.size() >= capacity_)
+    {
+        rows_.clear();
+    }
+}
@@ -0,0 +1,286 @@
+#include "service/BatchStat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sys/stat.h>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BATCH_STAT_HAS_IO_URING 1
+#endif
+
+namespace
+{
+#ifdef BATCH_STAT_HAS_IO_URING
+/**
+ * Minimal io_uring setup for STATX requests, straight on the syscalls so no
+ * liburing is needed. Rings are mapped once per run and torn down after.
+ */
+class StatxRing
+{
+  public:
+    ~StatxRing()
+    {
+        if (sqes_ != MAP_FAILED && sqes_)
+            munmap(sqes_, sqesSize_);
+        if (cqRing_ != MAP_FAILED && cqRing_ && cqRing_ != sqRing_)
+            munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != MAP_FAILED && sqRing_)
+            munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    /**
+     * @return false if io_uring is missing or blocked (old kernel, seccomp, sysctl)
+     */
+    bool init(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+            return false;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                       IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED)
+            return false;
+        cqRing_ = singleMap ? sqRing_
+                            : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                   IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED)
+            return false;
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED)
+            return false;
+
+        auto *sq = static_cast<char *>(sqRing_);
+        auto *cq = static_cast<char *>(cqRing_);
+        sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        capacity_ = params.sq_entries;
+        return true;
+    }
+
+    unsigned capacity() const
+    {
+        return capacity_;
+    }
+
+    /**
+     * @brief Stat paths[first, first + count) and fill the matching entries
+     * @return false if the kernel does not know IORING_OP_STATX
+     */
+    bool statBatch(const std::vector<std::string> &paths, size_t first, unsigned count,
+                   std::vector<BatchStat::Entry> &entries)
+    {
+        std::vector<struct statx> buffers(count);
+        unsigned tail = *sqTail_; // Only this thread writes the tail
+        for (unsigned i = 0; i < count; ++i)
+        {
+            unsigned index = tail & sqMask_;
+            io_uring_sqe &sqe = static_cast<io_uring_sqe *>(sqes_)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_STATX;
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uint64_t>(paths[first + i].c_str());
+            sqe.len = STATX_SIZE | STATX_MTIME | STATX_INO;
+            sqe.off = reinterpret_cast<uint64_t>(&buffers[i]);
+            sqe.user_data = i;
+            sqArray_[index] = index;
+            ++tail;
+        }
+        __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+
+        unsigned submitted = 0;
+        unsigned completed = 0;
+        bool supported = true;
+        while (completed < count)
+        {
+            unsigned toSubmit = count - submitted;
+            long ret = syscall(__NR_io_uring_enter, fd_, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    continue;
+                // Requests already submitted still write into buffers and read the paths
+                drain(submitted - completed);
+                return false;
+            }
+            submitted += static_cast<unsigned>(ret);
+
+            unsigned head = *cqHead_;
+            unsigned cqTail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            for (; head != cqTail; ++head, ++completed)
+            {
+                const io_uring_cqe &cqe = cqes_[head & cqMask_];
+                unsigned i = static_cast<unsigned>(cqe.user_data);
+                if (cqe.res == -EINVAL)
+                {
+                    supported = false; // Ring works but predates STATX (kernel < 5.6)
+                }
+                else if (cqe.res == 0)
+                {
+                    const struct statx &st = buffers[i];
+                    BatchStat::Entry &entry = entries[first + i];
+                    entry.found = true;
+                    entry.fingerprint.size = st.stx_size;
+                    entry.fingerprint.mtime = static_cast<int64_t>(st.stx_mtime.tv_sec) * 1000000000 +
+                                              st.stx_mtime.tv_nsec;
+                    entry.fingerprint.inode = st.stx_ino;
+                }
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        }
+        return supported;
+    }
+
+    /**
+     * @brief Wait for and discard the completions of requests still in flight
+     * Closing the ring does not wait for them, so the memory they use must
+     * outlive them. If waiting in the kernel fails too, the completion queue
+     * is polled; the kernel fills it in either way.
+     */
+    void drain(unsigned outstanding)
+    {
+        while (outstanding > 0)
+        {
+            if (syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            unsigned head = *cqHead_;
+            unsigned cqTail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            outstanding -= std::min(outstanding, cqTail - head);
+            __atomic_store_n(cqHead_, cqTail, __ATOMIC_RELEASE);
+        }
+    }
+
+  private:
+    int fd_ = -1;
+    void *sqRing_ = nullptr;
+    void *cqRing_ = nullptr;
+    void *sqes_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    unsigned capacity_ = 0;
+
+    unsigned *sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned *sqArray_ = nullptr;
+    unsigned *cqHead_ = nullptr;
+    unsigned *cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+bool runUring(const std::vector<std::string> &paths, std::vector<BatchStat::Entry> &entries)
+{
+    StatxRing ring;
+    if (!ring.init(BatchStat::RING_ENTRIES))
+        return false;
+
+    for (size_t first = 0; first < paths.size(); first += ring.capacity())
+    {
+        unsigned count = static_cast<unsigned>(std::min<size_t>(ring.capacity(), paths.size() - first));
+        if (!ring.statBatch(paths, first, count, entries))
+            return false;
+    }
+    return true;
+}
+#endif
+
+bool statPath(const std::string &path, BatchStat::Entry &entry)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+        return false;
+
+    entry.found = true;
+    entry.fingerprint.size = static_cast<uint64_t>(st.st_size);
+    entry.fingerprint.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    entry.fingerprint.inode = static_cast<uint64_t>(st.st_ino);
+    return true;
+}
+} // namespace
+
+BatchStat::BatchStat(Backend preferred, unsigned threads)
+    : preferred_(preferred), lastBackend_(preferred), threads_(threads)
+{
+    if (threads_ == 0)
+    {
+        threads_ = std::max(4u, 2 * std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<BatchStat::Entry> BatchStat::run(const std::vector<std::string> &paths)
+{
+    std::vector<Entry> entries(paths.size());
+    if (paths.empty())
+    {
+        return entries;
+    }
+
+#ifdef BATCH_STAT_HAS_IO_URING
+    if (preferred_ == Backend::IO_URING)
+    {
+        if (runUring(paths, entries))
+        {
+            lastBackend_ = Backend::IO_URING;
+            return entries;
+        }
+        entries.assign(paths.size(), Entry()); // Start over from a clean slate
+    }
+#endif
+
+    lastBackend_ = Backend::THREADS;
+    runThreads(paths, entries);
+    return entries;
+}
+
+void BatchStat::runThreads(const std::vector<std::string> &paths, std::vector<Entry> &entries) const
+{
+    // Small batches are not worth a thread each
+    const size_t kPerThread = 32;
+    size_t workers = std::min<size_t>(threads_, (paths.size() + kPerThread - 1) / kPerThread);
+    std::atomic<size_t> next{0};
+    auto work = [&]()
+    {
+        for (size_t i = next++; i < paths.size(); i = next++)
+        {
+            statPath(paths[i], entries[i]);
+        }
+    };
+
+    // The calling thread works too
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
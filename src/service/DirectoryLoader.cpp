@@ -0,0 +1,326 @@
+#include "service/DirectoryLoader.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+
+DirectoryLoader::DirectoryLoader(IFileSystem *fileSystem, std::vector<std::string> extensions, int maxDepth,
+                                 size_t cacheSize)
+    : fileSystem_(fileSystem), extensions_(std::move(extensions)), maxDepth_(maxDepth), cacheSize_(cacheSize)
+{
+    worker_ = std::thread(&DirectoryLoader::run, this);
+}
+
+DirectoryLoader::~DirectoryLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        ++generation_; // Stops a scan in progress
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+void DirectoryLoader::load(const std::string &path, bool force)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        requested_ = true;
+        requestPath_ = path;
+        requestForce_ = force;
+        loading_ = true;
+        // Whatever the previous load left unpolled is stale now
+        update_ = Update();
+        hasUpdate_ = false;
+    }
+    wake_.notify_all();
+}
+
+bool DirectoryLoader::poll(Update &update)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasUpdate_)
+    {
+        return false;
+    }
+    update = std::move(update_);
+    update_ = Update();
+    hasUpdate_ = false;
+    return true;
+}
+
+bool DirectoryLoader::isLoading() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loading_;
+}
+
+void DirectoryLoader::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return !loading_; });
+}
+
+size_t DirectoryLoader::getCachedCount() const
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cache_.size();
+}
+
+void DirectoryLoader::run()
+{
+    for (;;)
+    {
+        std::string path;
+        bool force;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || requested_; });
+            if (stopping_)
+            {
+                return;
+            }
+            requested_ = false;
+            path = requestPath_;
+            force = requestForce_;
+            generation = generation_;
+        }
+
+        try
+        {
+            list(path, force, generation);
+        }
+        catch (const std::exception &e)
+        {
+            Logger::error("Failed to list '" + path + "': " + e.what());
+            Update failed;
+            failed.reset = true;
+            failed.path = path;
+            failed.complete = true;
+            publish(generation, std::move(failed));
+        }
+    }
+}
+
+void DirectoryLoader::list(const std::string &path, bool force, uint64_t generation)
+{
+    auto cancelled = [this, generation]() { return generation_ != generation; };
+
+    Listing listing;
+    if (!force && lookup(path, listing) && isFresh(listing))
+    {
+        Update cached;
+        cached.reset = true;
+        cached.path = path;
+        cached.folders = std::move(listing.folders);
+        cached.media = std::move(listing.media);
+        cached.complete = true;
+        cached.fromCache = true;
+        publish(generation, std::move(cached));
+        return;
+    }
+    listing = Listing();
+
+    // Stamp before reading, so a change made during the scan invalidates the result
+    bool cacheable = cacheSize_ > 0 && stamp(path, listing.stamps);
+    for (const auto &directory : fileSystem_->listDirectories(path))
+    {
+        FileInfo folder;
+        folder.path = directory;
+        size_t lastSlash = directory.find_last_of("/\\");
+        folder.name = lastSlash != std::string::npos ? directory.substr(lastSlash + 1) : directory;
+        folder.isDirectory = true;
+        listing.folders.push_back(std::move(folder));
+    }
+    std::sort(listing.folders.begin(), listing.folders.end(),
+              [](const FileInfo &a, const FileInfo &b) { return a.name < b.name; });
+    if (cancelled())
+    {
+        return;
+    }
+
+    // The folders show up before anything below them is walked
+    Update first;
+    first.reset = true;
+    first.path = path;
+    first.folders = listing.folders;
+    publish(generation, std::move(first));
+
+    // Only directories are listed and stat'ed for the stamps, so this costs far less than the scan
+    for (const auto &folder : listing.folders)
+    {
+        cacheable = cacheable && stampTree(folder.path, 1, generation, listing.stamps);
+    }
+
+    // The scan may call back from several threads
+    std::mutex batchMutex;
+    std::vector<MediaEntry> batch;
+    auto lastPublish = std::chrono::steady_clock::now();
+    auto flush = [&]()
+    {
+        Update more;
+        more.path = path;
+        more.media = std::move(batch);
+        batch.clear();
+        lastPublish = std::chrono::steady_clock::now();
+        publish(generation, std::move(more));
+    };
+
+    fileSystem_->scanDirectoryStreaming(path, extensions_, maxDepth_,
+                                        [&](const std::string &file)
+                                        {
+                                            if (cancelled())
+                                            {
+                                                return false;
+                                            }
+                                            MediaEntry entry = makeEntry(file);
+                                            std::lock_guard<std::mutex> lock(batchMutex);
+                                            listing.media.push_back(entry);
+                                            batch.push_back(std::move(entry));
+                                            if (batch.size() >= PUBLISH_BATCH ||
+                                                std::chrono::steady_clock::now() - lastPublish >
+                                                    std::chrono::milliseconds(100))
+                                            {
+                                                flush();
+                                            }
+                                            return true;
+                                        });
+    if (cancelled())
+    {
+        return;
+    }
+
+    Update last;
+    last.path = path;
+    last.media = std::move(batch);
+    last.complete = true;
+    if (cacheable)
+    {
+        store(path, std::move(listing));
+    }
+    publish(generation, std::move(last));
+}
+
+void DirectoryLoader::publish(uint64_t generation, Update &&update)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_)
+        {
+            return; // A newer load() took over
+        }
+
+        if (update.reset || !hasUpdate_)
+        {
+            update_ = std::move(update);
+        }
+        else
+        {
+            std::move(update.media.begin(), update.media.end(), std::back_inserter(update_.media));
+            update_.complete = update.complete;
+        }
+        hasUpdate_ = true;
+        if (update_.complete)
+        {
+            loading_ = false;
+        }
+    }
+    idle_.notify_all();
+}
+
+bool DirectoryLoader::lookup(const std::string &path, Listing &listing)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cache_.find(path);
+    if (it == cache_.end())
+    {
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.second);
+    listing = it->second.first;
+    return true;
+}
+
+void DirectoryLoader::store(const std::string &path, Listing listing)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cache_.find(path);
+    if (it != cache_.end())
+    {
+        lru_.erase(it->second.second);
+        cache_.erase(it);
+    }
+    lru_.push_front(path);
+    cache_.emplace(path, std::make_pair(std::move(listing), lru_.begin()));
+
+    while (cache_.size() > cacheSize_)
+    {
+        cache_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+bool DirectoryLoader::isFresh(const Listing &listing)
+{
+    // One batched stat for every folder the listing depends on
+    VerifyResult result = fileSystem_->verifyFiles(listing.stamps);
+    return result.missing.empty() && result.changed.empty();
+}
+
+bool DirectoryLoader::stamp(const std::string &directory, std::vector<FileCheck> &stamps)
+{
+    FileFingerprint fingerprint;
+    if (!fileSystem_->getFingerprint(directory, fingerprint))
+    {
+        return false;
+    }
+    stamps.push_back(FileCheck{directory, fingerprint});
+    return true;
+}
+
+bool DirectoryLoader::stampTree(const std::string &directory, int depth, uint64_t generation,
+                                std::vector<FileCheck> &stamps)
+{
+    if (generation_ != generation || !stamp(directory, stamps))
+    {
+        return false;
+    }
+    // Same limit as the scan: it lists folders down to maxDepth_
+    if (maxDepth_ >= 0 && depth >= maxDepth_)
+    {
+        return true;
+    }
+    for (const auto &subdirectory : fileSystem_->listDirectories(directory))
+    {
+        if (!stampTree(subdirectory, depth + 1, generation, stamps))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+DirectoryLoader::MediaEntry DirectoryLoader::makeEntry(const std::string &path)
+{
+    MediaEntry entry;
+    entry.info.path = path;
+    size_t lastSlash = path.find_last_of("/\\");
+    entry.info.name = (lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path;
+    size_t lastDot = entry.info.name.find_last_of('.');
+    entry.info.extension = (lastDot != std::string::npos) ? entry.info.name.substr(lastDot) : "";
+    entry.info.isDirectory = false;
+    entry.info.size = 0;
+
+    // Resolved here rather than on the UI thread: the library may store the real path
+    std::error_code ec;
+    std::string canonical = std::filesystem::canonical(path, ec).string();
+    if (!ec && canonical != path)
+    {
+        entry.canonicalPath = canonical;
+    }
+    return entry;
+}
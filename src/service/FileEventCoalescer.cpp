@@ -0,0 +1,66 @@
+#include "service/FileEventCoalescer.h"
+#include <algorithm>
+
+FileEventCoalescer::FileEventCoalescer(std::chrono::milliseconds quietPeriod, std::chrono::milliseconds maxDelay)
+    : quietPeriod_(quietPeriod), maxDelay_(std::max(maxDelay, quietPeriod))
+{
+}
+
+void FileEventCoalescer::add(const FileEvent &event, Clock::time_point now)
+{
+    if (empty())
+    {
+        first_ = now;
+    }
+    last_ = now;
+
+    if (event.kind == FileEvent::Kind::RESCAN)
+    {
+        rescans_.insert(event.path);
+        return;
+    }
+
+    if (event.kind == FileEvent::Kind::REMOVED && event.directory)
+    {
+        // Whatever happened below a removed directory no longer matters
+        std::string prefix = event.path + "/";
+        auto it = pending_.lower_bound(prefix);
+        while (it != pending_.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+        {
+            it = pending_.erase(it);
+        }
+    }
+    pending_[event.path] = Pending{event.kind, event.directory};
+}
+
+bool FileEventCoalescer::ready(Clock::time_point now) const
+{
+    return !empty() && now >= deadline();
+}
+
+FileEventCoalescer::Clock::time_point FileEventCoalescer::deadline() const
+{
+    return std::min(last_ + quietPeriod_, first_ + maxDelay_);
+}
+
+std::vector<FileEvent> FileEventCoalescer::take()
+{
+    std::vector<FileEvent> batch;
+    batch.reserve(rescans_.size() + pending_.size());
+    for (const auto &path : rescans_)
+    {
+        batch.push_back(FileEvent{FileEvent::Kind::RESCAN, path, true});
+    }
+    for (auto kind : {FileEvent::Kind::REMOVED, FileEvent::Kind::CHANGED})
+    {
+        for (const auto &entry : pending_)
+        {
+            if (entry.second.kind == kind)
+                batch.push_back(FileEvent{kind, entry.first, entry.second.directory});
+        }
+    }
+
+    pending_.clear();
+    rescans_.clear();
+    return batch;
+}
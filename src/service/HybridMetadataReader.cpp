@@ -1,28 +1,88 @@
 #include "service/HybridMetadataReader.h"
 #include "utils/Logger.h"
+#include <algorithm>
+#include <chrono>
 
 HybridMetadataReader::HybridMetadataReader(std::unique_ptr<IMetadataReader> primary, 
-                                           std::unique_ptr<IMetadataReader> secondary)
-    : primary_(std::move(primary)), secondary_(std::move(secondary))
+                                           std::shared_ptr<IMetadataReader> secondary)
+    : primary_(std::move(primary)), secondary_(std::move(secondary)), stats_(std::make_shared<HybridReaderStats>())
 {
 }
 
+HybridMetadataReader::HybridMetadataReader(std::unique_ptr<IMetadataReader> fast,
+                                           std::unique_ptr<IMetadataReader> primary,
+                                           std::shared_ptr<IMetadataReader> secondary)
+    : fast_(std::move(fast)), primary_(std::move(primary)), secondary_(std::move(secondary)),
+      stats_(std::make_shared<HybridReaderStats>())
+{
+}
+
+namespace
+{
+bool readNothing(const MediaMetadata &metadata)
+{
+    return metadata.duration == 0 && metadata.title.empty() && metadata.artist.empty() && metadata.album.empty() &&
+           metadata.genre.empty() && metadata.year == 0 && metadata.track == 0 && metadata.bitrate == 0 &&
+           metadata.sampleRate == 0 && metadata.channels == 0 && !metadata.hasAlbumArt && metadata.codec.empty() &&
+           metadata.comment.empty() && metadata.customFields.empty();
+}
+} // namespace
+
 MediaMetadata HybridMetadataReader::readMetadata(const std::string &filepath)
 {
-    MediaMetadata metadata = primary_->readMetadata(filepath);
+    if (unreadableCache_ && unreadableCache_->isKnownUnreadable(filepath))
+    {
+        stats_->knownUnreadable++;
+        return MediaMetadata();
+    }
+
+    MediaMetadata metadata;
+    if (isSecondaryOnly(filepath))
+    {
+        // TagLib cannot time a video, so asking it first only adds a failed open
+        stats_->routed++;
+        metadata = timedRead(*secondary_, stats_->secondary, filepath);
+    }
+    else
+    {
+        metadata = readTiers(filepath);
+    }
+
+    // Only a file every tier looked at and got nothing from is worth remembering: a short clip
+    // or a file mpv cannot time may still carry tags, and a cache hit would blank them
+    if (unreadableCache_ && !metadata.retryable && readNothing(metadata))
+    {
+        unreadableCache_->markUnreadable(filepath);
+    }
+    return metadata;
+}
+
+MediaMetadata HybridMetadataReader::readTiers(const std::string &filepath)
+{
+    if (fast_)
+    {
+        MediaMetadata fastMetadata = timedRead(*fast_, stats_->fast, filepath);
+        if (fastMetadata.duration > 0)
+        {
+            return fastMetadata;
+        }
+    }
+
+    MediaMetadata metadata = timedRead(*primary_, stats_->primary, filepath);
 
     // Heuristic: If duration is 0, primary failed or file is unsupported (like video).
     // Or if extension is a known video format (could check extension, but duration 0 is a good signal).
     if (metadata.duration == 0)
     {
         Logger::info("Primary metadata reader incomplete for " + filepath + ", falling back to secondary.");
-        MediaMetadata mpvMetadata = secondary_->readMetadata(filepath);
+        MediaMetadata mpvMetadata = timedRead(*secondary_, stats_->secondary, filepath);
         
         // Merge - prioritize mpv if TagLib failed
         if (mpvMetadata.duration > 0)
         {
             metadata.duration = mpvMetadata.duration;
         }
+        metadata.retryable = mpvMetadata.retryable;
         
         // Use mpv strings if TagLib strings are empty
         if (metadata.title.empty() && !mpvMetadata.title.empty())
@@ -34,7 +94,7 @@ MediaMetadata HybridMetadataReader::readMetadata(const std::string &filepath)
         if (metadata.album.empty() && !mpvMetadata.album.empty())
             metadata.album = mpvMetadata.album;
             
-        // Currently MpvMetadataReader doesn't extract album art, so keep TagLib's (if any)
+        // Currently MpvMetadataReader doesn't extract album art, so keep TagLib's flag (if any)
     }
 
     return metadata;
@@ -52,7 +112,15 @@ bool HybridMetadataReader::writeMetadata(const std::string &filepath, const Medi
 std::map<std::string, std::string> HybridMetadataReader::extractTags(const std::string &filepath,
                                                                      const std::vector<std::string> &tags)
 {
-    auto result = primary_->extractTags(filepath, tags);
+    std::map<std::string, std::string> result;
+    if (fast_)
+    {
+        result = fast_->extractTags(filepath, tags);
+    }
+    if (result.empty())
+    {
+        result = primary_->extractTags(filepath, tags);
+    }
     if (result.empty())
     {
         return secondary_->extractTags(filepath, tags);
@@ -64,3 +132,51 @@ bool HybridMetadataReader::supportsEditing(const std::string &filepath)
 {
     return primary_->supportsEditing(filepath) || secondary_->supportsEditing(filepath);
 }
+
+bool HybridMetadataReader::readAlbumArt(const std::string &filepath, AlbumArt &art)
+{
+    return primary_->readAlbumArt(filepath, art) || secondary_->readAlbumArt(filepath, art);
+}
+
+void HybridMetadataReader::setSecondaryOnlyFormats(std::vector<std::string> extensions)
+{
+    secondaryOnlyFormats_ = std::move(extensions);
+}
+
+void HybridMetadataReader::setUnreadableCache(std::shared_ptr<UnreadableFileCache> cache)
+{
+    unreadableCache_ = std::move(cache);
+}
+
+void HybridMetadataReader::setStats(std::shared_ptr<HybridReaderStats> stats)
+{
+    if (stats)
+    {
+        stats_ = std::move(stats);
+    }
+}
+
+bool HybridMetadataReader::isSecondaryOnly(const std::string &filepath) const
+{
+    size_t dot = filepath.find_last_of('.');
+    if (secondaryOnlyFormats_.empty() || dot == std::string::npos)
+    {
+        return false;
+    }
+
+    std::string ext = filepath.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return std::find(secondaryOnlyFormats_.begin(), secondaryOnlyFormats_.end(), ext) != secondaryOnlyFormats_.end();
+}
+
+MediaMetadata HybridMetadataReader::timedRead(IMetadataReader &reader, ReaderTierStats &stats,
+                                              const std::string &filepath)
+{
+    auto start = std::chrono::steady_clock::now();
+    MediaMetadata metadata = reader.readMetadata(filepath);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    stats.totalMicros += static_cast<uint64_t>(elapsed.count());
+    (metadata.duration > 0 ? stats.hits : stats.misses)++;
+    return metadata;
+}
@@ -0,0 +1,415 @@
+#include "service/InotifyWatcher.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+#ifdef __linux__
+// IN_CREATE is only needed for directories: files are reported once written (IN_CLOSE_WRITE)
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+#endif
+
+std::string trimSlashes(std::string path)
+{
+    while (path.size() > 1 && path.back() == '/')
+    {
+        path.pop_back();
+    }
+    return path;
+}
+
+bool isUnder(const std::string &path, const std::string &dir)
+{
+    return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+}
+} // namespace
+
+InotifyWatcher::InotifyWatcher(const std::vector<std::string> &extensions, std::chrono::milliseconds quietPeriod,
+                               std::chrono::milliseconds maxDelay)
+    : quietPeriod_(quietPeriod), maxDelay_(maxDelay)
+{
+    for (std::string ext : extensions)
+    {
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        extensions_.insert(std::move(ext));
+    }
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+    stop();
+}
+
+bool InotifyWatcher::start(Callback callback)
+{
+#ifdef __linux__
+    if (running_)
+    {
+        return false;
+    }
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0)
+    {
+        Logger::error(std::string("inotify unavailable: ") + std::strerror(errno));
+        return false;
+    }
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0)
+    {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+
+    // The roots queued so far are walked first thing on the watcher thread
+    callback_ = std::move(callback);
+    running_ = true;
+    thread_ = std::thread(&InotifyWatcher::run, this);
+    return true;
+#else
+    (void)callback;
+    return false;
+#endif
+}
+
+bool InotifyWatcher::addRoot(const std::string &path)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pendingRoots_.push_back(trimSlashes(path));
+    }
+    if (running_)
+    {
+        wake();
+    }
+    return true;
+}
+
+void InotifyWatcher::stop()
+{
+#ifdef __linux__
+    if (thread_.joinable())
+    {
+        running_ = false;
+        wake();
+        thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    {
+        // A later start() walks them again
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        pendingRoots_.insert(pendingRoots_.begin(), roots_.begin(), roots_.end());
+        roots_.clear();
+    }
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_); // Drops every watch with it
+        inotifyFd_ = -1;
+    }
+    if (wakeFd_ >= 0)
+    {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+    watchPaths_.clear();
+    watchDescriptors_.clear();
+#endif
+}
+
+size_t InotifyWatcher::getWatchCount() const
+{
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    return watchPaths_.size();
+}
+
+void InotifyWatcher::wake()
+{
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd_, &one, sizeof(one));
+    (void)written;
+#endif
+}
+
+void InotifyWatcher::watchPendingRoots()
+{
+    std::vector<std::string> pending;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending.swap(pendingRoots_);
+    }
+    if (pending.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        if (!running_)
+        {
+            // Stopping: keep the rest for the next start()
+            std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+            pendingRoots_.insert(pendingRoots_.begin(), pending.begin() + i, pending.end());
+            return;
+        }
+        const std::string &root = pending[i];
+        bool covered = std::any_of(roots_.begin(), roots_.end(), [&root](const std::string &existing)
+                                   { return existing == root || isUnder(root, existing); });
+        if (!covered)
+        {
+            roots_.push_back(root);
+            watchTree(root);
+        }
+    }
+    Logger::info("Watching " + std::to_string(watchPaths_.size()) + " library folders for changes");
+}
+
+void InotifyWatcher::run()
+{
+#ifdef __linux__
+    FileEventCoalescer coalescer(quietPeriod_, maxDelay_);
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    watchPendingRoots();
+    while (running_)
+    {
+        int timeout = -1;
+        if (!coalescer.empty())
+        {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(coalescer.deadline() -
+                                                                              FileEventCoalescer::Clock::now());
+            timeout = static_cast<int>(std::max<int64_t>(0, wait.count() + 1));
+        }
+
+        pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+        int ready = poll(fds, 2, timeout);
+        if (ready < 0 && errno != EINTR)
+        {
+            Logger::error(std::string("Directory watcher stopped: ") + std::strerror(errno));
+            break;
+        }
+        if (!running_)
+        {
+            break;
+        }
+        if (ready > 0 && (fds[1].revents & POLLIN))
+        {
+            uint64_t count;
+            ssize_t drained = read(wakeFd_, &count, sizeof(count));
+            (void)drained;
+            watchPendingRoots(); // Not stopping, so addRoot() woke us
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN))
+        {
+            ssize_t length;
+            while ((length = read(inotifyFd_, buffer, sizeof(buffer))) > 0)
+            {
+                dispatch(buffer, static_cast<size_t>(length), coalescer);
+            }
+        }
+
+        if (coalescer.ready())
+        {
+            std::vector<FileEvent> batch = coalescer.take();
+            if (callback_ && running_)
+            {
+                callback_(batch);
+            }
+        }
+    }
+#endif
+}
+
+void InotifyWatcher::dispatch(const char *buffer, size_t length, FileEventCoalescer &coalescer)
+{
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    for (size_t offset = 0; offset < length;)
+    {
+        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+            // Some events were lost: every root has to be compared again
+            Logger::warn("Directory watcher queue overflowed; rescanning library folders");
+            for (const auto &root : roots_)
+            {
+                coalescer.add(FileEvent{FileEvent::Kind::RESCAN, root, true});
+            }
+            continue;
+        }
+
+        auto it = watchPaths_.find(event->wd);
+        if (it == watchPaths_.end())
+        {
+            continue; // Already unwatched
+        }
+        const std::string dir = it->second;
+
+        if (event->mask & IN_IGNORED)
+        {
+            watchDescriptors_.erase(dir);
+            watchPaths_.erase(it);
+            continue;
+        }
+        if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+        {
+            // Below a root, the parent's IN_DELETE / IN_MOVED_FROM reports it
+            if (std::find(roots_.begin(), roots_.end(), dir) != roots_.end())
+            {
+                coalescer.add(FileEvent{FileEvent::Kind::REMOVED, dir, true});
+                unwatchTree(dir);
+            }
+            continue;
+        }
+        if (event->len == 0)
+        {
+            continue;
+        }
+
+        std::string path = dir + "/" + event->name;
+        if (event->mask & IN_ISDIR)
+        {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                watchTree(path);
+                coalescer.add(FileEvent{FileEvent::Kind::CHANGED, path, true});
+            }
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                unwatchTree(path);
+                coalescer.add(FileEvent{FileEvent::Kind::REMOVED, path, true});
+            }
+        }
+        else if (accepts(event->name))
+        {
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                coalescer.add(FileEvent{FileEvent::Kind::CHANGED, path, false});
+            }
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                coalescer.add(FileEvent{FileEvent::Kind::REMOVED, path, false});
+            }
+        }
+    }
+#else
+    (void)buffer;
+    (void)length;
+    (void)coalescer;
+#endif
+}
+
+bool InotifyWatcher::watchTree(const std::string &path)
+{
+    if (!watchDirectory(path))
+    {
+        return false;
+    }
+
+    std::error_code ec;
+    fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && running_ && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        // Symlinks are not followed, so a link loop cannot recurse forever
+        if (it->is_directory(ec) && !it->is_symlink(ec))
+        {
+            watchDirectory(it->path().string());
+        }
+    }
+    return true;
+}
+
+bool InotifyWatcher::watchDirectory(const std::string &path)
+{
+#ifdef __linux__
+    int wd = inotify_add_watch(inotifyFd_, path.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+        if (errno == ENOSPC && !limitWarned_)
+        {
+            limitWarned_ = true;
+            Logger::warn("inotify watch limit reached; raise fs.inotify.max_user_watches to watch " + path +
+                         " and the folders after it");
+        }
+        else if (errno != ENOSPC)
+        {
+            Logger::warn("Cannot watch '" + path + "': " + std::strerror(errno));
+        }
+        return false;
+    }
+
+    // A directory moved within the tree keeps its descriptor under a new path
+    auto previous = watchPaths_.find(wd);
+    if (previous != watchPaths_.end())
+    {
+        watchDescriptors_.erase(previous->second);
+    }
+    watchPaths_[wd] = path;
+    watchDescriptors_[path] = wd;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void InotifyWatcher::unwatchTree(const std::string &path)
+{
+#ifdef __linux__
+    auto unwatch = [this](std::map<std::string, int>::iterator it)
+    {
+        inotify_rm_watch(inotifyFd_, it->second);
+        watchPaths_.erase(it->second);
+        return watchDescriptors_.erase(it);
+    };
+
+    auto self = watchDescriptors_.find(path);
+    if (self != watchDescriptors_.end())
+    {
+        unwatch(self);
+    }
+    // Everything below sorts contiguously after "path/"
+    auto it = watchDescriptors_.lower_bound(path + "/");
+    while (it != watchDescriptors_.end() && isUnder(it->first, path))
+    {
+        it = unwatch(it);
+    }
+#else
+    (void)path;
+#endif
+}
+
+bool InotifyWatcher::accepts(const std::string &filename) const
+{
+    if (extensions_.empty())
+    {
+        return true;
+    }
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos || dot == 0)
+    {
+        return false;
+    }
+    std::string ext = filename.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extensions_.count(ext) > 0;
+}
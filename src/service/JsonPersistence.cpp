@@ -1,13 +1,72 @@
 #include "service/JsonPersistence.h"
 #include "utils/Config.h" // For AppConfig definition
 #include "utils/Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
 #include <filesystem>
 #include <fstream>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 // using json = nlohmann::json; // Removed for stubbing
 
+JsonPersistence::JsonPersistence(WriteMode mode) : mode_(mode)
+{
+    if (mode_ == WriteMode::ASYNC)
+    {
+        writer_ = std::thread(&JsonPersistence::writerLoop, this);
+    }
+}
+
+JsonPersistence::~JsonPersistence()
+{
+    if (writer_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopping_ = true;
+        }
+        workReady_.notify_one();
+        // The writer drains the queue before it exits
+        writer_.join();
+    }
+}
+
 bool JsonPersistence::saveToFile(const std::string &filepath, const std::string &data)
+{
+    if (mode_ == WriteMode::SYNC)
+    {
+        return writeAtomically(filepath, data);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        // A newer save of the same path replaces the queued one
+        QueuedWrite &entry = queue_[filepath];
+        entry.data = data;
+        entry.sequence = ++nextSequence_;
+        if (!entry.queued)
+        {
+            entry.queued = true;
+            order_.push_back(filepath);
+        }
+    }
+    workReady_.notify_one();
+    return true;
+}
+
+bool JsonPersistence::flush()
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    drained_.wait(lock, [this]() { return queue_.empty(); });
+
+    bool ok = !writeFailed_;
+    writeFailed_ = false;
+    return ok;
+}
+
+bool JsonPersistence::writeAtomically(const std::string &filepath, const std::string &data)
 {
     try
     {
@@ -17,15 +76,49 @@ bool JsonPersistence::saveToFile(const std::string &filepath, const std::string
             ensureDirectoryExists(path.parent_path().string());
         }
 
-        std::ofstream file(filepath);
-        if (!file.is_open())
+        // Write a sibling temp file first so a crash never leaves the target half-written
+        std::string tempPath = filepath + ".tmp";
+        int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
         {
             Logger::error("Failed to open file for writing: " + filepath);
             return false;
         }
 
-        file << data;
-        file.close();
+        const char *cursor = data.data();
+        size_t remaining = data.size();
+        bool ok = true;
+        while (remaining > 0)
+        {
+            ssize_t written = ::write(fd, cursor, remaining);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ok = false;
+                break;
+            }
+            cursor += written;
+            remaining -= static_cast<size_t>(written);
+        }
+
+        ok = ok && ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        if (!ok || ::rename(tempPath.c_str(), filepath.c_str()) != 0)
+        {
+            Logger::error("Failed to write '" + filepath + "': " + std::strerror(errno));
+            ::unlink(tempPath.c_str());
+            return false;
+        }
+
+        // Persist the rename itself
+        std::string dir = path.has_parent_path() ? path.parent_path().string() : ".";
+        int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd >= 0)
+        {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
 
         Logger::info("Saved data to: " + filepath);
         return true;
@@ -37,8 +130,70 @@ bool JsonPersistence::saveToFile(const std::string &filepath, const std::string
     }
 }
 
+void JsonPersistence::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    while (true)
+    {
+        workReady_.wait(lock, [this]() { return stopping_ || !order_.empty(); });
+        if (order_.empty())
+        {
+            // stopping_ and nothing left to write
+            break;
+        }
+
+        std::string filepath = std::move(order_.front());
+        order_.pop_front();
+        QueuedWrite &entry = queue_[filepath];
+        entry.queued = false;
+        std::string data = entry.data;
+        uint64_t sequence = entry.sequence;
+
+        lock.unlock();
+        bool ok = writeAtomically(filepath, data);
+        lock.lock();
+
+        if (!ok)
+            writeFailed_ = true;
+
+        // Keep the entry if a newer save arrived while this one was being written
+        auto it = queue_.find(filepath);
+        if (it != queue_.end() && it->second.sequence == sequence)
+            queue_.erase(it);
+
+        drained_.notify_all();
+    }
+}
+
+bool JsonPersistence::findQueued(const std::string &filepath, std::string *data)
+{
+    if (mode_ == WriteMode::SYNC)
+        return false;
+
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    auto it = queue_.find(filepath);
+    if (it == queue_.end())
+        return false;
+    if (data)
+        *data = it->second.data;
+    return true;
+}
+
+void JsonPersistence::waitForPath(const std::string &filepath)
+{
+    if (mode_ == WriteMode::SYNC)
+        return;
+
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    drained_.wait(lock, [this, &filepath]() { return queue_.find(filepath) == queue_.end(); });
+}
+
 bool JsonPersistence::loadFromFile(const std::string &filepath, std::string &data)
 {
+    // Read-your-writes: a queued save is the current contents
+    if (findQueued(filepath, &data))
+        return true;
+
     try
     {
         if (!fs::exists(filepath))
@@ -68,13 +223,62 @@ bool JsonPersistence::loadFromFile(const std::string &filepath, std::string &dat
     }
 }
 
+bool JsonPersistence::appendToFile(const std::string &filepath, const std::string &data)
+{
+    // The append must land after any queued replacement of the same file
+    waitForPath(filepath);
+
+    try
+    {
+        fs::path path(filepath);
+        if (path.has_parent_path())
+        {
+            ensureDirectoryExists(path.parent_path().string());
+        }
+
+        std::ofstream file(filepath, std::ios::binary | std::ios::app);
+        if (!file.is_open())
+        {
+            Logger::error("Failed to open file for appending: " + filepath);
+            return false;
+        }
+
+        file << data;
+        file.flush();
+        return file.good();
+    }
+    catch (const std::exception &e)
+    {
+        Logger::error("Failed to append to file '" + filepath + "': " + e.what());
+        return false;
+    }
+}
+
+std::shared_ptr<MappedFile> JsonPersistence::mapFile(const std::string &filepath)
+{
+    std::string queued;
+    if (findQueued(filepath, &queued))
+        return MappedFile::fromString(std::move(queued));
+
+    auto file = MappedFile::open(filepath);
+    if (!file)
+    {
+        Logger::warn("Failed to map file: " + filepath);
+        return nullptr;
+    }
+    return file;
+}
+
 bool JsonPersistence::fileExists(const std::string &filepath)
 {
-    return fs::exists(filepath);
+    return findQueued(filepath, nullptr) || fs::exists(filepath);
 }
 
 bool JsonPersistence::deleteFile(const std::string &filepath)
 {
+    // Let a queued save finish first so it cannot recreate the file afterwards
+    waitForPath(filepath);
+
     try
     {
         if (!fs::exists(filepath))
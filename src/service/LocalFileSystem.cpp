@@ -1,10 +1,237 @@
 #include "service/LocalFileSystem.h"
+#include "service/BatchStat.h"
 #include "utils/Logger.h"
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sys/stat.h>
+#include <thread>
+#include <utility>
 
 namespace fs = std::filesystem;
 
+namespace
+{
+struct ScanTask
+{
+    std::string path;
+    int depth;
+};
+
+/**
+ * Work-stealing directory walk. Each worker owns a deque: it pushes the
+ * subdirectories it finds and pops its own newest task, so it stays
+ * depth-first in a warm part of the tree. Idle workers steal the oldest
+ * task of another worker, which tends to be a large untouched subtree.
+ *
+ * Matches are either collected per worker and returned by run(), or handed
+ * to a sink as they are found; a sink returning false stops the walk.
+ */
+class ParallelWalker
+{
+  public:
+    using Sink = std::function<bool(const std::string &)>;
+
+    ParallelWalker(unsigned threads, int maxDepth, std::function<bool(const char *)> accept, Sink sink = nullptr)
+        : maxDepth_(maxDepth), accept_(std::move(accept)), sink_(std::move(sink))
+    {
+        for (unsigned i = 0; i < std::max(1u, threads); ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    std::vector<std::string> run(const std::string &root)
+    {
+        push(*workers_[0], ScanTask{root, 0});
+
+        // The calling thread works as worker 0
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers_.size(); ++i)
+        {
+            threads.emplace_back(&ParallelWalker::workerLoop, this, i);
+        }
+        workerLoop(0);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<std::string> results;
+        for (auto &worker : workers_)
+        {
+            std::move(worker->found.begin(), worker->found.end(), std::back_inserter(results));
+        }
+        std::sort(results.begin(), results.end());
+        return results;
+    }
+
+  private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<ScanTask> tasks;
+        std::vector<std::string> found; ///< Only touched by the owning thread
+    };
+
+    const int maxDepth_;
+    const std::function<bool(const char *)> accept_;
+    const Sink sink_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stop_{false};
+
+    std::atomic<size_t> pending_{0}; ///< Tasks queued or being listed
+    std::atomic<size_t> queued_{0};  ///< Tasks sitting in some deque
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+
+    // Directories reached through symlinks, to break cycles
+    std::mutex visitedMutex_;
+    std::set<std::pair<dev_t, ino_t>> visited_;
+
+    void push(Worker &worker, ScanTask task)
+    {
+        pending_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+        }
+        idle_.notify_one();
+    }
+
+    bool take(size_t self, ScanTask &task)
+    {
+        for (size_t k = 0; k < workers_.size(); ++k)
+        {
+            Worker &victim = *workers_[(self + k) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty())
+                continue;
+
+            if (k == 0)
+            {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+            queued_.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t self)
+    {
+        ScanTask task;
+        while (true)
+        {
+            if (take(self, task))
+            {
+                // After a stop, queued tasks are only drained
+                if (!stop_.load(std::memory_order_relaxed))
+                    listDirectory(task, *workers_[self]);
+                if (pending_.fetch_sub(1) == 1)
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex_);
+                    idle_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            idle_.wait(lock, [this]() { return pending_.load() == 0 || queued_.load() > 0; });
+            if (pending_.load() == 0)
+                return;
+        }
+    }
+
+    bool firstVisit(const struct stat &st)
+    {
+        std::lock_guard<std::mutex> lock(visitedMutex_);
+        return visited_.emplace(st.st_dev, st.st_ino).second;
+    }
+
+    void listDirectory(const ScanTask &task, Worker &worker)
+    {
+        DIR *dir = ::opendir(task.path.c_str());
+        if (!dir)
+        {
+            Logger::error("Error scanning directory '" + task.path + "': " + std::strerror(errno));
+            return;
+        }
+
+        std::string prefix = task.path;
+        if (prefix.empty() || prefix.back() != '/')
+            prefix += '/';
+
+        dirent *entry;
+        while (!stop_.load(std::memory_order_relaxed) && (entry = ::readdir(dir)) != nullptr)
+        {
+            const char *name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+
+            std::string full = prefix + name;
+            bool isDir = entry->d_type == DT_DIR;
+            bool isFile = entry->d_type == DT_REG;
+
+            // Only symlinks and file systems that leave d_type empty need a stat
+            if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+            {
+                struct stat st;
+                if (::stat(full.c_str(), &st) != 0)
+                    continue;
+                isDir = S_ISDIR(st.st_mode);
+                isFile = S_ISREG(st.st_mode);
+                if (isDir && entry->d_type == DT_LNK && !firstVisit(st))
+                    continue;
+            }
+
+            if (isDir)
+            {
+                if (maxDepth_ < 0 || task.depth < maxDepth_)
+                    push(worker, ScanTask{std::move(full), task.depth + 1});
+            }
+            else if (isFile && accept_(name))
+            {
+                if (!sink_)
+                    worker.found.push_back(std::move(full));
+                else if (!sink_(full))
+                    stop_.store(true);
+            }
+        }
+        ::closedir(dir);
+    }
+};
+} // namespace
+
+LocalFileSystem::LocalFileSystem(ScanMode mode, unsigned scanThreads) : scanMode_(mode), scanThreads_(scanThreads)
+{
+    if (scanThreads_ == 0)
+    {
+        // Directory listing mostly waits on I/O, so oversubscribe the cores
+        scanThreads_ = std::max(4u, 2 * std::thread::hardware_concurrency());
+    }
+}
+
 std::vector<FileInfo> LocalFileSystem::browse(const std::string &path)
 {
     std::vector<FileInfo> files;
@@ -48,15 +275,74 @@ std::vector<FileInfo> LocalFileSystem::browse(const std::string &path)
     return files;
 }
 
+std::vector<std::string> LocalFileSystem::listDirectories(const std::string &path)
+{
+    std::vector<std::string> directories;
+    std::error_code ec;
+    for (fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec))
+    {
+        std::error_code typeError;
+        if (it->is_directory(typeError))
+        {
+            directories.push_back(it->path().string());
+        }
+    }
+    if (ec)
+    {
+        Logger::error("Failed to list directories in '" + path + "': " + ec.message());
+    }
+    return directories;
+}
+
 std::vector<std::string> LocalFileSystem::scanDirectory(const std::string &path,
                                                         const std::vector<std::string> &extensions, int maxDepth)
 {
 
     std::vector<std::string> results;
-    scanDirectoryRecursive(path, extensions, results, maxDepth, 0);
+    if (!isDirectory(path))
+    {
+        return results;
+    }
+
+    ExtensionSet extensionSet = makeExtensionSet(extensions);
+    if (scanMode_ == ScanMode::PARALLEL)
+    {
+        ParallelWalker walker(scanThreads_, maxDepth,
+                              [&extensionSet](const char *name) { return hasExtension(name, extensionSet); });
+        return walker.run(path);
+    }
+
+    scanDirectoryRecursive(path, extensionSet,
+                           [&results](const std::string &file)
+                           {
+                               results.push_back(file);
+                               return true;
+                           },
+                           maxDepth, 0);
     return results;
 }
 
+void LocalFileSystem::scanDirectoryStreaming(const std::string &path, const std::vector<std::string> &extensions,
+                                             int maxDepth, const std::function<bool(const std::string &)> &onFile)
+{
+    if (!isDirectory(path))
+    {
+        return;
+    }
+
+    ExtensionSet extensionSet = makeExtensionSet(extensions);
+    if (scanMode_ == ScanMode::PARALLEL)
+    {
+        ParallelWalker walker(
+            scanThreads_, maxDepth, [&extensionSet](const char *name) { return hasExtension(name, extensionSet); },
+            onFile);
+        walker.run(path);
+        return;
+    }
+
+    scanDirectoryRecursive(path, extensionSet, onFile, maxDepth, 0);
+}
+
 std::vector<std::string> LocalFileSystem::getMediaFiles(const std::string &path,
                                                         const std::vector<std::string> &extensions, int maxDepth)
 {
@@ -99,38 +385,81 @@ bool LocalFileSystem::isDirectory(const std::string &path)
     }
 }
 
-void LocalFileSystem::scanDirectoryRecursive(const std::string &path, const std::vector<std::string> &extensions,
-                                             std::vector<std::string> &results, int maxDepth, int currentDepth)
+bool LocalFileSystem::getFingerprint(const std::string &path, FileFingerprint &fingerprint)
 {
+    // One stat() call; std::filesystem would need three and has no inode
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+    {
+        return false;
+    }
 
-    try
+    fingerprint.size = static_cast<uint64_t>(st.st_size);
+    fingerprint.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    fingerprint.inode = static_cast<uint64_t>(st.st_ino);
+    return true;
+}
+
+VerifyResult LocalFileSystem::verifyFiles(const std::vector<FileCheck> &files)
+{
+    std::vector<std::string> paths;
+    paths.reserve(files.size());
+    for (const auto &file : files)
     {
-        if (!fs::exists(path) || !fs::is_directory(path))
+        paths.push_back(file.path);
+    }
+
+    BatchStat batch(BatchStat::Backend::IO_URING, scanThreads_);
+    std::vector<BatchStat::Entry> entries = batch.run(paths);
+
+    VerifyResult result;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!entries[i].found)
         {
-            return;
+            // Unreadable is not gone: a permission or I/O error keeps the track
+            std::error_code ec;
+            if (!fs::exists(files[i].path, ec) && !ec)
+                result.missing.push_back(files[i].path);
+        }
+        else if (entries[i].fingerprint != files[i].expected)
+        {
+            result.changed.emplace_back(files[i].path, entries[i].fingerprint);
         }
+    }
+    return result;
+}
+
+bool LocalFileSystem::scanDirectoryRecursive(const std::string &path, const ExtensionSet &extensions,
+                                             const std::function<bool(const std::string &)> &onFile, int maxDepth,
+                                             int currentDepth)
+{
 
+    try
+    {
         // Check depth limit if maxDepth is set (>= 0)
         if (maxDepth >= 0 && currentDepth > maxDepth)
         {
-            return;
+            return true;
         }
 
+        // Entries come from the parent's iterator, so they are known to exist
         for (const auto &entry : fs::directory_iterator(path))
         {
             if (entry.is_directory())
             {
                 // Determine if we should recurse
-                if (maxDepth < 0 || currentDepth < maxDepth)
+                if ((maxDepth < 0 || currentDepth < maxDepth) &&
+                    !scanDirectoryRecursive(entry.path().string(), extensions, onFile, maxDepth, currentDepth + 1))
                 {
-                    scanDirectoryRecursive(entry.path().string(), extensions, results, maxDepth, currentDepth + 1);
+                    return false;
                 }
             }
             else if (entry.is_regular_file())
             {
-                if (hasExtension(entry.path().string(), extensions))
+                if (hasExtension(entry.path().filename().string(), extensions) && !onFile(entry.path().string()))
                 {
-                    results.push_back(entry.path().string());
+                    return false;
                 }
             }
         }
@@ -139,26 +468,27 @@ void LocalFileSystem::scanDirectoryRecursive(const std::string &path, const std:
     {
         Logger::error("Error scanning directory '" + path + "': " + e.what());
     }
+    return true;
 }
 
-bool LocalFileSystem::hasExtension(const std::string &filepath, const std::vector<std::string> &extensions)
+LocalFileSystem::ExtensionSet LocalFileSystem::makeExtensionSet(const std::vector<std::string> &extensions)
 {
-
-    fs::path p(filepath);
-    std::string ext = p.extension().string();
-
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-
-    for (const auto &validExt : extensions)
+    ExtensionSet set;
+    for (std::string ext : extensions)
     {
-        std::string lowerValidExt = validExt;
-        std::transform(lowerValidExt.begin(), lowerValidExt.end(), lowerValidExt.begin(), ::tolower);
-
-        if (ext == lowerValidExt)
-        {
-            return true;
-        }
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        set.insert(std::move(ext));
     }
+    return set;
+}
 
-    return false;
+bool LocalFileSystem::hasExtension(const std::string &filename, const ExtensionSet &extensions)
+{
+    // Same rule as fs::path::extension(): the last dot, but not a leading one
+    size_t start = filename.find_last_of('/');
+    start = (start == std::string::npos) ? 0 : start + 1;
+    size_t dot = filename.find_last_of('.');
+    std::string ext = (dot == std::string::npos || dot <= start) ? std::string() : filename.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extensions.count(ext) > 0;
 }
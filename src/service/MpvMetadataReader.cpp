@@ -1,143 +1,294 @@
 #include "service/MpvMetadataReader.h"
 #include "utils/Logger.h"
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include <cstring>
 #include <cmath>
 
-MpvMetadataReader::MpvMetadataReader()
+namespace
 {
-    mpv_ = mpv_create();
-    if (!mpv_)
+// Time a timed-out probe gets to stop before its context is replaced
+constexpr std::chrono::milliseconds kStopGrace(500);
+
+double secondsUntil(std::chrono::steady_clock::time_point deadline)
+{
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(remaining).count();
+}
+} // namespace
+
+MpvMetadataReader::MpvMetadataReader(size_t contexts, std::chrono::milliseconds timeout) : timeout_(timeout)
+{
+    contexts = std::max<size_t>(1, contexts);
+    for (size_t i = 0; i < contexts; ++i)
     {
-        throw std::runtime_error("Failed to create mpv context for metadata reading");
+        mpv_handle *mpv = createContext();
+        if (!mpv)
+        {
+            Logger::warn("Created " + std::to_string(i) + " of " + std::to_string(contexts) +
+                         " mpv probe contexts");
+            break;
+        }
+        idle_.push_back(mpv);
     }
+    contextCount_ = idle_.size();
 
-    mpv_set_option_string(mpv_, "vo", "null");
-    mpv_set_option_string(mpv_, "ao", "null");
-    mpv_set_option_string(mpv_, "ytdl", "no"); // Disable ytdl for speed/safety
-    
-    if (mpv_initialize(mpv_) < 0)
+    if (contextCount_ == 0)
     {
-        throw std::runtime_error("Failed to initialize mpv for metadata reading");
+        throw std::runtime_error("Failed to create mpv context for metadata reading");
     }
 }
 
 MpvMetadataReader::~MpvMetadataReader()
 {
-    if (mpv_)
+    // Owners stop reading before destroying the reader, so every context is idle
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    for (mpv_handle *mpv : idle_)
+    {
+        mpv_terminate_destroy(mpv);
+    }
+    idle_.clear();
+}
+
+size_t MpvMetadataReader::getContextCount() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    return contextCount_;
+}
+
+mpv_handle *MpvMetadataReader::createContext()
+{
+    mpv_handle *mpv = mpv_create();
+    if (!mpv)
+    {
+        return nullptr;
+    }
+
+    mpv_set_option_string(mpv, "vo", "null");
+    mpv_set_option_string(mpv, "ao", "null");
+    mpv_set_option_string(mpv, "ytdl", "no"); // Disable ytdl for speed/safety
+    mpv_set_option_string(mpv, "pause", "yes"); // Probes only need the headers, never decoded frames
+
+    if (mpv_initialize(mpv) < 0)
+    {
+        mpv_terminate_destroy(mpv);
+        return nullptr;
+    }
+    return mpv;
+}
+
+mpv_handle *MpvMetadataReader::acquire()
+{
+    std::unique_lock<std::mutex> lock(poolMutex_);
+    available_.wait(lock, [this]() { return !idle_.empty() || contextCount_ == 0; });
+    if (idle_.empty())
     {
-        mpv_terminate_destroy(mpv_);
+        return nullptr;
     }
+
+    mpv_handle *mpv = idle_.back();
+    idle_.pop_back();
+    return mpv;
+}
+
+void MpvMetadataReader::release(mpv_handle *mpv)
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        if (mpv)
+        {
+            idle_.push_back(mpv);
+        }
+        else
+        {
+            contextCount_--;
+        }
+    }
+    // A lost context may leave waiters with nothing to wait for
+    mpv ? available_.notify_one() : available_.notify_all();
 }
 
 MediaMetadata MpvMetadataReader::readMetadata(const std::string &filepath)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     MediaMetadata metadata;
 
-    
-    if (!mpv_) return metadata;
+    // Only waits when every context is busy; probes on other contexts keep running
+    mpv_handle *mpv = acquire();
+    if (!mpv)
+    {
+        metadata.retryable = true; // Every context was lost
+        return metadata;
+    }
+
+    switch (load(mpv, filepath))
+    {
+    case ProbeResult::LOADED:
+        extract(mpv, metadata);
+        if (!settle(mpv, std::chrono::steady_clock::now() + timeout_))
+        {
+            mpv = recycle(mpv);
+        }
+        break;
+    case ProbeResult::TIMEOUT:
+        Logger::warn("Timeout waiting for metadata probe: " + filepath);
+        metadata.retryable = true; // Slow media, not necessarily a broken file
+        if (!settle(mpv, std::chrono::steady_clock::now() + kStopGrace))
+        {
+            mpv = recycle(mpv);
+        }
+        break;
+    case ProbeResult::FAILED:
+        break;
+    }
+
+    release(mpv);
+    return metadata;
+}
+
+MpvMetadataReader::ProbeResult MpvMetadataReader::load(mpv_handle *mpv, const std::string &filepath)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+    // Drop anything left over from the previous file so it cannot be mistaken for this one
+    while (mpv_wait_event(mpv, 0)->event_id != MPV_EVENT_NONE)
+    {
+    }
 
     const char *cmd[] = {"loadfile", filepath.c_str(), NULL};
-    mpv_command(mpv_, cmd);
+    if (mpv_command(mpv, cmd) < 0)
+    {
+        Logger::warn("Failed to load file for metadata: " + filepath);
+        return ProbeResult::FAILED;
+    }
 
-    bool done = false;
-    bool error = false;
-    
-    int timeoutMs = 2000;
-    while (!done)
+    // Sleep until mpv reports progress or the deadline passes, whichever is first
+    while (true)
     {
-        mpv_event *event = mpv_wait_event(mpv_, 0.1); // 100ms wait
-        
-        if (event->event_id == MPV_EVENT_NONE)
+        double remaining = secondsUntil(deadline);
+        if (remaining <= 0)
         {
-            timeoutMs -= 100;
-            if (timeoutMs <= 0) 
-            {
-                Logger::warn("Timeout waiting for metadata probe: " + filepath);
-                done = true;
-                error = true;
-            }
-            continue;
+            return ProbeResult::TIMEOUT;
         }
 
+        mpv_event *event = mpv_wait_event(mpv, remaining);
         if (event->event_id == MPV_EVENT_FILE_LOADED)
         {
-            done = true;
+            return ProbeResult::LOADED;
         }
-        else if (event->event_id == MPV_EVENT_END_FILE)
+        if (event->event_id == MPV_EVENT_END_FILE)
         {
             mpv_event_end_file *endFile = (mpv_event_end_file *)event->data;
             if (endFile->reason == MPV_END_FILE_REASON_ERROR)
             {
                 Logger::warn("Failed to load file for metadata: " + filepath);
-                error = true;
             }
-            done = true;
+            return ProbeResult::FAILED;
+        }
+        if (event->event_id == MPV_EVENT_SHUTDOWN)
+        {
+            return ProbeResult::FAILED;
         }
     }
+}
 
-    if (!error)
+bool MpvMetadataReader::settle(mpv_handle *mpv, std::chrono::steady_clock::time_point deadline)
+{
+    const char *stopCmd[] = {"stop", NULL};
+    if (mpv_command(mpv, stopCmd) < 0)
+    {
+        return false;
+    }
+
+    // The context is reusable once the file has ended
+    while (true)
     {
-        // Extract Duration
-        double durationFunc = 0;
-        if (mpv_get_property(mpv_, "duration", MPV_FORMAT_DOUBLE, &durationFunc) >= 0)
+        double remaining = secondsUntil(deadline);
+        if (remaining <= 0)
         {
-            metadata.duration = static_cast<int>(std::round(durationFunc));
+            return false;
         }
 
-        // "media-title" is often the most reliable "Title" fallback
-        
-        char* value = nullptr;
-        if (mpv_get_property(mpv_, "media-title", MPV_FORMAT_STRING, &value) >= 0)
+        mpv_event *event = mpv_wait_event(mpv, remaining);
+        if (event->event_id == MPV_EVENT_END_FILE)
         {
-            if (value) 
-            {
-                metadata.title = value;
-                mpv_free(value);
-            }
+            return true;
         }
-        
-        // Try specific metadata tags using mpv property "metadata" is harder directly via C API get_property without iterating node map.
-        
-        auto readTag = [&](const char* key) -> std::string {
-            char* val = nullptr;
-            std::string prop = std::string("metadata/by-key/") + key;
-            if (mpv_get_property(mpv_, prop.c_str(), MPV_FORMAT_STRING, &val) >= 0 && val)
-            {
-                std::string result = val;
-                mpv_free(val);
-                return result;
-            }
-            return "";
-        };
-
-        std::string artist = readTag("Artist");
-        if (artist.empty()) artist = readTag("artist"); // Case sensitivity varies
-        if (!artist.empty()) metadata.artist = artist;
-
-        std::string album = readTag("Album");
-        if (album.empty()) album = readTag("album");
-        if (!album.empty()) metadata.album = album;
-        
-        std::string genre = readTag("Genre");
-        if (genre.empty()) genre = readTag("genre");
-        if (!genre.empty()) metadata.genre = genre;
-        
-        std::string date = readTag("Date");
-        if (date.empty()) date = readTag("date");
-        if (date.empty()) date = readTag("Year");
-        if (!date.empty()) 
+        if (event->event_id == MPV_EVENT_SHUTDOWN)
         {
-            try { metadata.year = std::stoi(date); } catch (...) {}
+            return false;
         }
     }
+}
+
+mpv_handle *MpvMetadataReader::recycle(mpv_handle *mpv)
+{
+    // Blocks this caller only; the other contexts are independent mpv instances
+    Logger::warn("Replacing a stuck mpv probe context");
+    mpv_terminate_destroy(mpv);
+
+    mpv_handle *fresh = createContext();
+    if (!fresh)
+    {
+        Logger::error("Failed to replace mpv probe context");
+    }
+    return fresh;
+}
+
+void MpvMetadataReader::extract(mpv_handle *mpv, MediaMetadata &metadata)
+{
+    // Extract Duration
+    double durationFunc = 0;
+    if (mpv_get_property(mpv, "duration", MPV_FORMAT_DOUBLE, &durationFunc) >= 0)
+    {
+        metadata.duration = static_cast<int>(std::round(durationFunc));
+    }
+
+    // "media-title" is often the most reliable "Title" fallback
     
-    const char *stopCmd[] = {"stop", NULL};
-    mpv_command(mpv_, stopCmd);
+    char* value = nullptr;
+    if (mpv_get_property(mpv, "media-title", MPV_FORMAT_STRING, &value) >= 0)
+    {
+        if (value) 
+        {
+            metadata.title = value;
+            mpv_free(value);
+        }
+    }
+    
+    // Try specific metadata tags using mpv property "metadata" is harder directly via C API get_property without iterating node map.
+    
+    auto readTag = [&](const char* key) -> std::string {
+        char* val = nullptr;
+        std::string prop = std::string("metadata/by-key/") + key;
+        if (mpv_get_property(mpv, prop.c_str(), MPV_FORMAT_STRING, &val) >= 0 && val)
+        {
+            std::string result = val;
+            mpv_free(val);
+            return result;
+        }
+        return "";
+    };
 
-    return metadata;
+    std::string artist = readTag("Artist");
+    if (artist.empty()) artist = readTag("artist"); // Case sensitivity varies
+    if (!artist.empty()) metadata.artist = artist;
+
+    std::string album = readTag("Album");
+    if (album.empty()) album = readTag("album");
+    if (!album.empty()) metadata.album = album;
+    
+    std::string genre = readTag("Genre");
+    if (genre.empty()) genre = readTag("genre");
+    if (!genre.empty()) metadata.genre = genre;
+    
+    std::string date = readTag("Date");
+    if (date.empty()) date = readTag("date");
+    if (date.empty()) date = readTag("Year");
+    if (!date.empty()) 
+    {
+        try { metadata.year = std::stoi(date); } catch (...) {}
+    }
 }
 
 bool MpvMetadataReader::writeMetadata(const std::string &filepath, const MediaMetadata &metadata)
@@ -20,16 +20,11 @@ static void *get_proc_address(void *ctx, const char *name)
     return (void *)SDL_GL_GetProcAddress(name);
 }
 
-static void on_mpv_wakeup(void *ctx)
-{
-    // Thread-safe wakeup - could push an event to SDL event loop,
-    // but here we poll in updateVideo() so this might just signal a flag
-}
-
 MpvPlaybackEngine::MpvPlaybackEngine() : impl_(std::make_unique<Impl>())
 {
     initMpv();
     initGL();
+    startEventThread();
 }
 
 MpvPlaybackEngine::~MpvPlaybackEngine()
@@ -54,6 +49,11 @@ void MpvPlaybackEngine::initMpv()
     mpv_set_option_string(mpv_, "audio-client-name", "MusicPlayer");
     mpv_set_option_string(mpv_, "audio-buffer", "2.0");
 
+    // Open the next playlist entry while the current one plays, and keep the
+    // audio output running across files of the same format
+    mpv_set_option_string(mpv_, "prefetch-playlist", "yes");
+    mpv_set_option_string(mpv_, "gapless-audio", "weak");
+
     mpv_set_option_string(mpv_, "vo", "libmpv");
 
     Logger::info("Calling mpv_initialize...");
@@ -63,10 +63,20 @@ void MpvPlaybackEngine::initMpv()
     }
     Logger::info("mpv_initialize success");
 
-    mpv_set_wakeup_callback(mpv_, on_mpv_wakeup, this);
+    observeProperties();
     Logger::info("MpvPlaybackEngine initialized");
 }
 
+void MpvPlaybackEngine::observeProperties()
+{
+    // mpv sends the current value right away, then one event per change
+    mpv_observe_property(mpv_, PROP_PAUSE, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(mpv_, PROP_IDLE_ACTIVE, "idle-active", MPV_FORMAT_FLAG);
+    mpv_observe_property(mpv_, PROP_TIME_POS, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv_, PROP_DURATION, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv_, PROP_VOLUME, "volume", MPV_FORMAT_DOUBLE);
+}
+
 void MpvPlaybackEngine::initGL()
 {
     // For software rendering, we don't need GL init params
@@ -84,8 +94,75 @@ void MpvPlaybackEngine::initGL()
     Logger::info("Mpv SW render context initialized");
 }
 
+void MpvPlaybackEngine::startEventThread()
+{
+    eventThread_ = std::thread(&MpvPlaybackEngine::eventLoop, this);
+    // Events queued before this point are picked up by the first wakeup
+    mpv_set_wakeup_callback(mpv_, &MpvPlaybackEngine::wakeupCallback, this);
+}
+
+void MpvPlaybackEngine::stopEventThread()
+{
+    if (mpv_)
+        mpv_set_wakeup_callback(mpv_, nullptr, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopEvents_ = true;
+    }
+    wakeCondition_.notify_one();
+    if (eventThread_.joinable())
+        eventThread_.join();
+}
+
+void MpvPlaybackEngine::wakeupCallback(void *ctx)
+{
+    // Called from an mpv thread; calling back into mpv here is not allowed
+    auto *engine = static_cast<MpvPlaybackEngine *>(ctx);
+    {
+        std::lock_guard<std::mutex> lock(engine->wakeMutex_);
+        engine->wakePending_ = true;
+    }
+    engine->wakeCondition_.notify_one();
+}
+
+void MpvPlaybackEngine::eventLoop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait(lock, [this]() { return wakePending_ || stopEvents_; });
+            if (stopEvents_)
+                return;
+            wakePending_ = false;
+        }
+        handleEvents();
+    }
+}
+
+void MpvPlaybackEngine::post(EngineEvent event)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pendingEvents_.push_back(event);
+}
+
+void MpvPlaybackEngine::dispatchEvents()
+{
+    std::vector<EngineEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        events.swap(pendingEvents_);
+    }
+    // Observers read the new state from the engine; one notification per change
+    for (size_t i = 0; i < events.size(); ++i)
+        notify();
+}
+
 void MpvPlaybackEngine::cleanup()
 {
+    // Joined before the handle goes away; the thread is what reads its events
+    stopEventThread();
+
     // Release GL resources on main thread (must be done here)
     if (texture_ != 0)
     {
@@ -128,12 +205,11 @@ void MpvPlaybackEngine::cleanup()
     Logger::info("MpvPlaybackEngine::cleanup finished (main thread)");
 }
 
-void MpvPlaybackEngine::updateVideo()
+void MpvPlaybackEngine::handleEvents()
 {
-    if (!mpv_gl_)
+    if (!mpv_)
         return;
 
-    // Process events
     while (true)
     {
         mpv_event *event = mpv_wait_event(mpv_, 0);
@@ -148,15 +224,24 @@ void MpvPlaybackEngine::updateVideo()
             if (end_file->reason == MPV_END_FILE_REASON_EOF)
             {
                 // Only auto-advance if file ended naturally
+                {
+                    std::lock_guard<std::mutex> lock(preloadMutex_);
+                    if (!preloadPath_.empty())
+                    {
+                        // mpv goes on to the preloaded entry by itself
+                        advancedPath_ = preloadPath_;
+                        preloadPath_.clear();
+                    }
+                }
                 eofReached_ = true;
                 Logger::info("MPV_EVENT_END_FILE (EOF) detected");
-                notify();
+                post(EngineEvent::END_OF_FILE);
             }
             else if (end_file->reason == MPV_END_FILE_REASON_ERROR)
             {
                 Logger::error("MPV_EVENT_END_FILE (Error) detected");
                 errorOccurred_ = true;
-                notify();
+                post(EngineEvent::ERROR);
             }
             else
             {
@@ -165,11 +250,48 @@ void MpvPlaybackEngine::updateVideo()
             break;
         }
         case MPV_EVENT_PROPERTY_CHANGE:
+            onPropertyChange(event->reply_userdata, (mpv_event_property *)event->data);
             break;
         default:
             break;
         }
     }
+}
+
+void MpvPlaybackEngine::onPropertyChange(uint64_t id, const mpv_event_property *property)
+{
+    // MPV_FORMAT_NONE means the property is unavailable, e.g. time-pos with no file loaded
+    bool available = property->format != MPV_FORMAT_NONE && property->data;
+    int flag = (available && property->format == MPV_FORMAT_FLAG) ? *(int *)property->data : 0;
+    double value = (available && property->format == MPV_FORMAT_DOUBLE) ? *(double *)property->data : 0.0;
+
+    switch (id)
+    {
+    case PROP_PAUSE:
+        paused_ = flag != 0;
+        break;
+    case PROP_IDLE_ACTIVE:
+        idle_ = flag != 0;
+        break;
+    case PROP_TIME_POS:
+        position_ = value;
+        break;
+    case PROP_DURATION:
+        duration_ = value;
+        break;
+    case PROP_VOLUME:
+        if (available)
+            volume_ = value;
+        break;
+    default:
+        break;
+    }
+}
+
+void MpvPlaybackEngine::updateVideo()
+{
+    if (!mpv_gl_)
+        return;
 
     // Check if we need to redraw
     uint64_t flags = mpv_render_context_update(mpv_gl_);
@@ -272,6 +394,33 @@ void MpvPlaybackEngine::getVideoSize(int &width, int &height)
 // Implement standard IPlaybackEngine methods
 bool MpvPlaybackEngine::play(const std::string &filepath)
 {
+    {
+        std::lock_guard<std::mutex> lock(preloadMutex_);
+        if (!advancedPath_.empty() && filepath == advancedPath_)
+        {
+            // Already playing since the previous file ended; an error it ran into since is kept
+            advancedPath_.clear();
+            eofReached_ = false;
+            return true;
+        }
+        advancedPath_.clear();
+
+        if (!preloadPath_.empty() && filepath == preloadPath_)
+        {
+            // Skipped to it early: the prefetched entry is still faster than a new load
+            preloadPath_.clear();
+            eofReached_ = false;
+            errorOccurred_ = false;
+            const char *cmd[] = {"playlist-next", "force", NULL};
+            mpv_command_async(mpv_, 0, cmd);
+            int flag = 0;
+            mpv_set_property_async(mpv_, 0, "pause", MPV_FORMAT_FLAG, &flag);
+            paused_ = false;
+            return true;
+        }
+        preloadPath_.clear(); // loadfile replaces the whole playlist
+    }
+
     // Reset EOF and Error flags when starting new file
     eofReached_ = false;
     errorOccurred_ = false;
@@ -288,6 +437,7 @@ bool MpvPlaybackEngine::play(const std::string &filepath)
     // Resume if was paused
     int flag = 0;
     mpv_set_property_async(mpv_, 0, "pause", MPV_FORMAT_FLAG, &flag);
+    paused_ = false;
     return true;
 }
 
@@ -295,22 +445,60 @@ void MpvPlaybackEngine::pause()
 {
     int flag = 1;
     mpv_set_property_async(mpv_, 0, "pause", MPV_FORMAT_FLAG, &flag);
+    paused_ = true; // The property event confirms it later
 }
 
 void MpvPlaybackEngine::resume()
 {
     int flag = 0;
     mpv_set_property_async(mpv_, 0, "pause", MPV_FORMAT_FLAG, &flag);
+    paused_ = false;
     notify();
 }
 
 void MpvPlaybackEngine::stop()
 {
+    {
+        // stop also clears mpv's playlist
+        std::lock_guard<std::mutex> lock(preloadMutex_);
+        preloadPath_.clear();
+        advancedPath_.clear();
+    }
     const char *cmd[] = {"stop", NULL};
     mpv_command_async(mpv_, 0, cmd);
     notify();
 }
 
+bool MpvPlaybackEngine::preloadNext(const std::string &filepath)
+{
+    std::lock_guard<std::mutex> lock(preloadMutex_);
+    if (filepath == preloadPath_)
+        return true;
+
+    // Keep at most one entry after the current file
+    const char *clear[] = {"playlist-clear", NULL};
+    mpv_command_async(mpv_, 0, clear);
+    const char *append[] = {"loadfile", filepath.c_str(), "append", NULL};
+    if (mpv_command_async(mpv_, 0, append) < 0)
+    {
+        Logger::warn("mpv failed to preload " + filepath);
+        preloadPath_.clear();
+        return false;
+    }
+    preloadPath_ = filepath;
+    return true;
+}
+
+void MpvPlaybackEngine::clearPreload()
+{
+    std::lock_guard<std::mutex> lock(preloadMutex_);
+    if (preloadPath_.empty())
+        return;
+    const char *cmd[] = {"playlist-clear", NULL};
+    mpv_command_async(mpv_, 0, cmd);
+    preloadPath_.clear();
+}
+
 void MpvPlaybackEngine::seek(double seconds)
 {
     std::string secStr = std::to_string(seconds);
@@ -322,6 +510,7 @@ void MpvPlaybackEngine::setVolume(float volume)
 {
     double vol = volume * 100.0;
     mpv_set_property(mpv_, "volume", MPV_FORMAT_DOUBLE, &vol);
+    volume_ = vol;
 }
 
 PlaybackStatus MpvPlaybackEngine::getState() const
@@ -332,36 +521,24 @@ PlaybackStatus MpvPlaybackEngine::getState() const
     if (errorOccurred_)
         return PlaybackStatus::ERROR;
 
-    int paused = 0;
-    mpv_get_property(mpv_, "pause", MPV_FORMAT_FLAG, &paused);
-
-    int idle = 0;
-    mpv_get_property(mpv_, "idle-active", MPV_FORMAT_FLAG, &idle);
-
-    if (idle)
+    if (idle_)
         return PlaybackStatus::STOPPED;
-    return paused ? PlaybackStatus::PAUSED : PlaybackStatus::PLAYING;
+    return paused_ ? PlaybackStatus::PAUSED : PlaybackStatus::PLAYING;
 }
 
 double MpvPlaybackEngine::getCurrentPosition() const
 {
-    double pos = 0;
-    mpv_get_property(mpv_, "time-pos", MPV_FORMAT_DOUBLE, &pos);
-    return pos;
+    return position_;
 }
 
 double MpvPlaybackEngine::getDuration() const
 {
-    double dur = 0;
-    mpv_get_property(mpv_, "duration", MPV_FORMAT_DOUBLE, &dur);
-    return dur;
+    return duration_;
 }
 
 float MpvPlaybackEngine::getVolume() const
 {
-    double vol = 0;
-    mpv_get_property(mpv_, "volume", MPV_FORMAT_DOUBLE, &vol);
-    return (float)(vol / 100.0);
+    return (float)(volume_ / 100.0);
 }
 
 bool MpvPlaybackEngine::isFinished() const
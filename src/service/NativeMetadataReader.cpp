@@ -0,0 +1,1152 @@
+#include "service/NativeMetadataReader.h"
+#include "utils/MappedFile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+// Bounds-checked big/little-endian reads over a byte range
+struct ByteView
+{
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+
+    ByteView() = default;
+    ByteView(const unsigned char *bytes, size_t length) : data(bytes), size(length)
+    {
+    }
+    explicit ByteView(const std::string &bytes)
+        : data(reinterpret_cast<const unsigned char *>(bytes.data())), size(bytes.size())
+    {
+    }
+
+    bool has(size_t offset, size_t length) const
+    {
+        return offset <= size && length <= size - offset;
+    }
+
+    ByteView sub(size_t offset, size_t length) const
+    {
+        if (offset > size)
+            return ByteView();
+        return ByteView(data + offset, std::min(length, size - offset));
+    }
+
+    bool matches(size_t offset, const char *magic, size_t length) const
+    {
+        return has(offset, length) && std::memcmp(data + offset, magic, length) == 0;
+    }
+
+    uint8_t u8(size_t offset) const
+    {
+        return data[offset];
+    }
+
+    uint16_t be16(size_t offset) const
+    {
+        return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+    }
+
+    uint32_t be24(size_t offset) const
+    {
+        return (uint32_t(data[offset]) << 16) | (uint32_t(data[offset + 1]) << 8) | data[offset + 2];
+    }
+
+    uint32_t be32(size_t offset) const
+    {
+        return (uint32_t(data[offset]) << 24) | be24(offset + 1);
+    }
+
+    uint64_t be64(size_t offset) const
+    {
+        return (uint64_t(be32(offset)) << 32) | be32(offset + 4);
+    }
+
+    uint16_t le16(size_t offset) const
+    {
+        return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    }
+
+    uint32_t le32(size_t offset) const
+    {
+        return uint32_t(le16(offset)) | (uint32_t(le16(offset + 2)) << 16);
+    }
+
+    uint64_t le64(size_t offset) const
+    {
+        return uint64_t(le32(offset)) | (uint64_t(le32(offset + 4)) << 32);
+    }
+
+    std::string text(size_t offset, size_t length) const
+    {
+        ByteView part = sub(offset, length);
+        return std::string(reinterpret_cast<const char *>(part.data), part.size);
+    }
+};
+
+// Duration and stream parameters gathered while parsing
+struct StreamInfo
+{
+    uint64_t lengthMs = 0;
+    int bitrate = 0;
+    int sampleRate = 0;
+    int channels = 0;
+};
+
+void finish(const StreamInfo &stream, MediaMetadata &metadata)
+{
+    // Whole seconds, truncated like TagLib's lengthInSeconds()
+    metadata.duration = static_cast<int>(stream.lengthMs / 1000);
+    metadata.bitrate = stream.bitrate;
+    metadata.sampleRate = stream.sampleRate;
+    metadata.channels = stream.channels;
+}
+
+int bitrateFor(uint64_t bytes, uint64_t lengthMs)
+{
+    // bits per millisecond == kbit/s
+    return lengthMs > 0 ? static_cast<int>(bytes * 8 / lengthMs) : 0;
+}
+
+// Text helpers
+
+void appendUtf8(std::string &out, uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        out += static_cast<char>(codepoint);
+    }
+    else if (codepoint < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+std::string latin1ToUtf8(ByteView bytes)
+{
+    std::string out;
+    for (size_t i = 0; i < bytes.size && bytes.data[i] != 0; ++i)
+    {
+        appendUtf8(out, bytes.data[i]);
+    }
+    return out;
+}
+
+std::string utf16ToUtf8(ByteView bytes, bool bigEndian)
+{
+    std::string out;
+    for (size_t i = 0; i + 1 < bytes.size; i += 2)
+    {
+        uint32_t unit = bigEndian ? bytes.be16(i) : bytes.le16(i);
+        if (unit == 0)
+            break;
+        if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < bytes.size)
+        {
+            uint32_t low = bigEndian ? bytes.be16(i + 2) : bytes.le16(i + 2);
+            if (low >= 0xDC00 && low < 0xE000)
+            {
+                unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                i += 2;
+            }
+        }
+        appendUtf8(out, unit);
+    }
+    return out;
+}
+
+std::string trimmed(std::string value)
+{
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\0'))
+        value.pop_back();
+    return value;
+}
+
+int leadingInt(const std::string &value)
+{
+    int result = 0;
+    size_t i = 0;
+    while (i < value.size() && value[i] == ' ')
+        ++i;
+    for (; i < value.size() && std::isdigit(static_cast<unsigned char>(value[i])) && result < 100000; ++i)
+    {
+        result = result * 10 + (value[i] - '0');
+    }
+    return result;
+}
+
+bool equalsIgnoreCase(const std::string &a, const char *b)
+{
+    size_t length = std::strlen(b);
+    if (a.size() != length)
+        return false;
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (std::toupper(static_cast<unsigned char>(a[i])) != b[i])
+            return false;
+    }
+    return true;
+}
+
+void setIfEmpty(std::string &field, const std::string &value)
+{
+    if (field.empty() && !value.empty())
+        field = value;
+}
+
+void setIfZero(int &field, int value)
+{
+    if (field == 0 && value > 0)
+        field = value;
+}
+
+// ID3v1 genre list (the 80 standard entries plus the common Winamp extensions)
+const char *const kGenres[] = {
+    "Blues", "Classic Rock", "Country", "Dance", "Disco", "Funk", "Grunge", "Hip-Hop", "Jazz", "Metal", "New Age",
+    "Oldies", "Other", "Pop", "R&B", "Rap", "Reggae", "Rock", "Techno", "Industrial", "Alternative", "Ska",
+    "Death Metal", "Pranks", "Soundtrack", "Euro-Techno", "Ambient", "Trip-Hop", "Vocal", "Jazz+Funk", "Fusion",
+    "Trance", "Classical", "Instrumental", "Acid", "House", "Game", "Sound Clip", "Gospel", "Noise",
+    "Alternative Rock", "Bass", "Soul", "Punk", "Space", "Meditative", "Instrumental Pop", "Instrumental Rock",
+    "Ethnic", "Gothic", "Darkwave", "Techno-Industrial", "Electronic", "Pop-Folk", "Eurodance", "Dream",
+    "Southern Rock", "Comedy", "Cult", "Gangsta", "Top 40", "Christian Rap", "Pop/Funk", "Jungle",
+    "Native American", "Cabaret", "New Wave", "Psychedelic", "Rave", "Showtunes", "Trailer", "Lo-Fi", "Tribal",
+    "Acid Punk", "Acid Jazz", "Polka", "Retro", "Musical", "Rock & Roll", "Hard Rock", "Folk", "Folk/Rock",
+    "National Folk", "Swing", "Fusion", "Bebob", "Latin", "Revival", "Celtic", "Bluegrass", "Avantgarde",
+    "Gothic Rock", "Progressive Rock", "Psychedelic Rock", "Symphonic Rock", "Slow Rock", "Big Band", "Chorus",
+    "Easy Listening", "Acoustic", "Humour", "Speech", "Chanson", "Opera", "Chamber Music", "Sonata", "Symphony",
+    "Booty Bass", "Primus", "Porn Groove", "Satire", "Slow Jam", "Club", "Tango", "Samba", "Folklore", "Ballad",
+    "Power Ballad", "Rhythmic Soul", "Freestyle", "Duet", "Punk Rock", "Drum Solo", "A Cappella", "Euro-House",
+    "Dance Hall"};
+
+std::string genreName(int index)
+{
+    if (index < 0 || index >= static_cast<int>(sizeof(kGenres) / sizeof(kGenres[0])))
+        return "";
+    return kGenres[index];
+}
+
+// Vorbis comments (FLAC, Ogg Vorbis, Opus)
+
+void parseVorbisComments(ByteView block, MediaMetadata &metadata)
+{
+    if (!block.has(0, 4))
+        return;
+    size_t pos = 4 + static_cast<size_t>(block.le32(0)); // Skip the vendor string
+    if (!block.has(pos, 4))
+        return;
+    uint32_t count = block.le32(pos);
+    pos += 4;
+
+    for (uint32_t i = 0; i < count && block.has(pos, 4); ++i)
+    {
+        size_t length = block.le32(pos);
+        pos += 4;
+        if (!block.has(pos, length))
+            break;
+
+        const char *entry = reinterpret_cast<const char *>(block.data + pos);
+        pos += length;
+        const char *equals = static_cast<const char *>(std::memchr(entry, '=', length));
+        if (!equals)
+            continue;
+
+        std::string key(entry, equals);
+        std::string value(equals + 1, entry + length);
+        if (equalsIgnoreCase(key, "TITLE"))
+            setIfEmpty(metadata.title, value);
+        else if (equalsIgnoreCase(key, "ARTIST"))
+            setIfEmpty(metadata.artist, value);
+        else if (equalsIgnoreCase(key, "ALBUM"))
+            setIfEmpty(metadata.album, value);
+        else if (equalsIgnoreCase(key, "GENRE"))
+            setIfEmpty(metadata.genre, value);
+        else if (equalsIgnoreCase(key, "DATE") || equalsIgnoreCase(key, "YEAR"))
+            setIfZero(metadata.year, leadingInt(value));
+        else if (equalsIgnoreCase(key, "TRACKNUMBER"))
+            setIfZero(metadata.track, leadingInt(value));
+        else if (equalsIgnoreCase(key, "COMMENT") || equalsIgnoreCase(key, "DESCRIPTION"))
+            setIfEmpty(metadata.comment, value);
+        else if (equalsIgnoreCase(key, "METADATA_BLOCK_PICTURE") || equalsIgnoreCase(key, "COVERART"))
+            metadata.hasAlbumArt = true;
+    }
+}
+
+// ID3v2
+
+uint32_t syncsafe(ByteView bytes, size_t offset)
+{
+    return (uint32_t(bytes.u8(offset) & 0x7F) << 21) | (uint32_t(bytes.u8(offset + 1) & 0x7F) << 14) |
+           (uint32_t(bytes.u8(offset + 2) & 0x7F) << 7) | (bytes.u8(offset + 3) & 0x7F);
+}
+
+/**
+ * Total bytes of an ID3v2 tag at the start of the file (0 if there is none)
+ */
+size_t id3v2Length(ByteView file)
+{
+    if (!file.matches(0, "ID3", 3) || !file.has(0, 10))
+        return 0;
+    size_t length = 10 + syncsafe(file, 6);
+    if (file.u8(5) & 0x10)
+        length += 10; // Footer
+    return length;
+}
+
+std::string removeUnsynchronisation(ByteView bytes)
+{
+    std::string out;
+    out.reserve(bytes.size);
+    for (size_t i = 0; i < bytes.size; ++i)
+    {
+        out += static_cast<char>(bytes.data[i]);
+        if (bytes.data[i] == 0xFF && i + 1 < bytes.size && bytes.data[i + 1] == 0x00)
+            ++i;
+    }
+    return out;
+}
+
+/**
+ * Decode ID3v2 text in the given encoding; returns the first of several values
+ */
+std::string decodeId3Text(uint8_t encoding, ByteView bytes)
+{
+    switch (encoding)
+    {
+    case 0:
+        return latin1ToUtf8(bytes);
+    case 1:
+        if (bytes.matches(0, "\xFE\xFF", 2))
+            return utf16ToUtf8(bytes.sub(2, bytes.size), true);
+        if (bytes.matches(0, "\xFF\xFE", 2))
+            return utf16ToUtf8(bytes.sub(2, bytes.size), false);
+        return utf16ToUtf8(bytes, false);
+    case 2:
+        return utf16ToUtf8(bytes, true);
+    default:
+    {
+        const void *end = std::memchr(bytes.data, 0, bytes.size);
+        size_t length = end ? static_cast<size_t>(static_cast<const unsigned char *>(end) - bytes.data) : bytes.size;
+        return std::string(reinterpret_cast<const char *>(bytes.data), length);
+    }
+    }
+}
+
+/**
+ * Offset just past a terminated string in the given encoding
+ */
+size_t skipTerminated(uint8_t encoding, ByteView bytes, size_t offset)
+{
+    bool wide = encoding == 1 || encoding == 2;
+    size_t step = wide ? 2 : 1;
+    for (size_t i = offset; i + step <= bytes.size; i += step)
+    {
+        if (bytes.data[i] == 0 && (!wide || bytes.data[i + 1] == 0))
+            return i + step;
+    }
+    return bytes.size;
+}
+
+std::string id3Genre(const std::string &value)
+{
+    // "(17)", "(17)Rock", "17" or plain text
+    if (!value.empty() && value[0] == '(')
+    {
+        size_t close = value.find(')');
+        if (close != std::string::npos)
+        {
+            std::string rest = value.substr(close + 1);
+            return rest.empty() ? genreName(leadingInt(value.substr(1))) : rest;
+        }
+    }
+    if (!value.empty() && std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); }))
+        return genreName(leadingInt(value));
+    return value;
+}
+
+struct Id3State
+{
+    uint64_t lengthMs = 0;    ///< TLEN, used if the audio stream gives no length
+    std::string comment;      ///< First COMM with an empty description
+    std::string otherComment; ///< First COMM of any kind
+};
+
+void parseId3Frame(const std::string &id, ByteView body, MediaMetadata &metadata, Id3State &state)
+{
+    if (id == "APIC")
+    {
+        metadata.hasAlbumArt = true;
+        return;
+    }
+    if (body.size < 1)
+        return;
+
+    uint8_t encoding = body.u8(0);
+    if (id == "COMM")
+    {
+        if (body.size < 4)
+            return;
+        size_t textStart = skipTerminated(encoding, body, 4);
+        bool plain = textStart == 4 + ((encoding == 1 || encoding == 2) ? 2 : 1);
+        std::string text = decodeId3Text(encoding, body.sub(textStart, body.size));
+        if (plain)
+            setIfEmpty(state.comment, text);
+        setIfEmpty(state.otherComment, text);
+        return;
+    }
+    if (id[0] != 'T')
+        return;
+
+    std::string value = decodeId3Text(encoding, body.sub(1, body.size));
+    if (id == "TIT2")
+        setIfEmpty(metadata.title, value);
+    else if (id == "TPE1")
+        setIfEmpty(metadata.artist, value);
+    else if (id == "TALB")
+        setIfEmpty(metadata.album, value);
+    else if (id == "TCON")
+        setIfEmpty(metadata.genre, id3Genre(value));
+    else if (id == "TYER" || id == "TDRC")
+        setIfZero(metadata.year, leadingInt(value));
+    else if (id == "TRCK")
+        setIfZero(metadata.track, leadingInt(value));
+    else if (id == "TLEN")
+        state.lengthMs = static_cast<uint64_t>(leadingInt(value));
+}
+
+std::string frameIdV22(const std::string &id)
+{
+    static const std::map<std::string, std::string> ids = {{"TT2", "TIT2"}, {"TP1", "TPE1"}, {"TAL", "TALB"},
+                                                           {"TCO", "TCON"}, {"TYE", "TYER"}, {"TRK", "TRCK"},
+                                                           {"COM", "COMM"}, {"PIC", "APIC"}, {"TLE", "TLEN"}};
+    auto it = ids.find(id);
+    return it != ids.end() ? it->second : id;
+}
+
+void parseId3v2(ByteView file, MediaMetadata &metadata, Id3State &state)
+{
+    int major = file.u8(3);
+    uint8_t flags = file.u8(5);
+    if (major < 2 || major > 4)
+        return;
+
+    ByteView tag = file.sub(10, syncsafe(file, 6));
+    std::string unsynchronised;
+    if ((flags & 0x80) && major < 4)
+    {
+        // v2.2/2.3 unsynchronise the whole tag
+        unsynchronised = removeUnsynchronisation(tag);
+        tag = ByteView(unsynchronised);
+    }
+
+    size_t pos = 0;
+    if ((flags & 0x40) && major >= 3 && tag.has(0, 4))
+    {
+        pos = major == 3 ? 4 + tag.be32(0) : syncsafe(tag, 0);
+    }
+
+    const size_t idLength = major == 2 ? 3 : 4;
+    const size_t headerLength = major == 2 ? 6 : 10;
+    while (tag.has(pos, headerLength) && tag.u8(pos) != 0)
+    {
+        std::string id = tag.text(pos, idLength);
+        size_t size = major == 2 ? tag.be24(pos + 3) : major == 4 ? syncsafe(tag, pos + 4) : tag.be32(pos + 4);
+        uint16_t frameFlags = major == 2 ? 0 : tag.be16(pos + 8);
+        pos += headerLength;
+        if (!tag.has(pos, size))
+            break;
+        ByteView body = tag.sub(pos, size);
+        pos += size;
+
+        if (major == 2)
+            id = frameIdV22(id);
+
+        std::string frameCopy;
+        if (major == 3)
+        {
+            if (frameFlags & 0x00C0) // Compressed or encrypted
+                continue;
+            if (frameFlags & 0x0020) // Grouping id
+                body = body.sub(1, body.size);
+        }
+        else if (major == 4)
+        {
+            if (frameFlags & 0x000C)
+                continue;
+            if (frameFlags & 0x0040)
+                body = body.sub(1, body.size);
+            if (frameFlags & 0x0001) // Data length indicator
+                body = body.sub(4, body.size);
+            if (frameFlags & 0x0002)
+            {
+                frameCopy = removeUnsynchronisation(body);
+                body = ByteView(frameCopy);
+            }
+        }
+        parseId3Frame(id, body, metadata, state);
+    }
+}
+
+void parseId3v1(ByteView tag, MediaMetadata &metadata)
+{
+    // "TAG", title 30, artist 30, album 30, year 4, comment 30, genre 1
+    setIfEmpty(metadata.title, trimmed(latin1ToUtf8(tag.sub(3, 30))));
+    setIfEmpty(metadata.artist, trimmed(latin1ToUtf8(tag.sub(33, 30))));
+    setIfEmpty(metadata.album, trimmed(latin1ToUtf8(tag.sub(63, 30))));
+    setIfZero(metadata.year, leadingInt(tag.text(93, 4)));
+    setIfEmpty(metadata.comment, trimmed(latin1ToUtf8(tag.sub(97, 28))));
+    if (tag.u8(125) == 0 && tag.u8(126) != 0)
+        setIfZero(metadata.track, tag.u8(126)); // ID3v1.1
+    setIfEmpty(metadata.genre, genreName(tag.u8(127)));
+}
+
+// MPEG audio
+
+struct MpegFrame
+{
+    int version = 0; // 1, 2 or 25 (MPEG 2.5)
+    int layer = 0;
+    int bitrate = 0; // kbit/s
+    int sampleRate = 0;
+    int channels = 0;
+    int samplesPerFrame = 0;
+    size_t length = 0;
+};
+
+bool parseMpegHeader(ByteView bytes, size_t offset, MpegFrame &frame)
+{
+    static const int kBitrates[5][14] = {
+        {32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448}, // V1 L1
+        {32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},    // V1 L2
+        {32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},     // V1 L3
+        {32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},    // V2 L1
+        {8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}};        // V2 L2/L3
+    static const int kSampleRates[3][3] = {{44100, 48000, 32000}, {22050, 24000, 16000}, {11025, 12000, 8000}};
+
+    if (!bytes.has(offset, 4) || bytes.u8(offset) != 0xFF || (bytes.u8(offset + 1) & 0xE0) != 0xE0)
+        return false;
+
+    int versionBits = (bytes.u8(offset + 1) >> 3) & 3;
+    int layerBits = (bytes.u8(offset + 1) >> 1) & 3;
+    int bitrateIndex = bytes.u8(offset + 2) >> 4;
+    int rateIndex = (bytes.u8(offset + 2) >> 2) & 3;
+    int padding = (bytes.u8(offset + 2) >> 1) & 1;
+    int channelMode = bytes.u8(offset + 3) >> 6;
+    if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+        return false;
+
+    frame.version = versionBits == 3 ? 1 : versionBits == 2 ? 2 : 25;
+    frame.layer = 4 - layerBits;
+    int table = frame.version == 1 ? frame.layer - 1 : (frame.layer == 1 ? 3 : 4);
+    frame.bitrate = kBitrates[table][bitrateIndex - 1];
+    frame.sampleRate = kSampleRates[frame.version == 1 ? 0 : frame.version == 2 ? 1 : 2][rateIndex];
+    frame.channels = channelMode == 3 ? 1 : 2;
+    frame.samplesPerFrame = frame.layer == 1 ? 384 : (frame.layer == 3 && frame.version != 1) ? 576 : 1152;
+    if (frame.layer == 1)
+        frame.length = (12 * frame.bitrate * 1000 / frame.sampleRate + padding) * 4;
+    else
+        frame.length = frame.samplesPerFrame / 8 * frame.bitrate * 1000 / frame.sampleRate + padding;
+    return frame.length > 4;
+}
+
+/**
+ * Find the first real frame: a valid header followed by another one
+ */
+bool findFirstFrame(ByteView file, size_t start, size_t end, size_t &offset, MpegFrame &frame)
+{
+    const size_t limit = std::min(end, start + 256 * 1024);
+    for (size_t pos = start; pos + 4 <= limit; ++pos)
+    {
+        if (file.u8(pos) != 0xFF || !parseMpegHeader(file, pos, frame))
+            continue;
+
+        MpegFrame next;
+        size_t nextPos = pos + frame.length;
+        if (nextPos + 4 > end ||
+            (parseMpegHeader(file, nextPos, next) && next.version == frame.version && next.layer == frame.layer &&
+             next.sampleRate == frame.sampleRate))
+        {
+            offset = pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseMp3(ByteView file, MediaMetadata &metadata)
+{
+    Id3State id3;
+    size_t audioStart = id3v2Length(file);
+    if (audioStart > 0)
+        parseId3v2(file, metadata, id3);
+
+    size_t audioEnd = file.size;
+    if (file.size >= 128 && file.matches(file.size - 128, "TAG", 3))
+    {
+        parseId3v1(file.sub(file.size - 128, 128), metadata);
+        audioEnd -= 128;
+    }
+    setIfEmpty(metadata.comment, id3.comment.empty() ? id3.otherComment : id3.comment);
+
+    size_t first = 0;
+    MpegFrame frame;
+    if (audioStart >= audioEnd || !findFirstFrame(file, audioStart, audioEnd, first, frame))
+        return false;
+
+    StreamInfo stream;
+    stream.sampleRate = frame.sampleRate;
+    stream.channels = frame.channels;
+
+    // Xing/Info (written by LAME and most encoders) sits after the side information
+    size_t sideInfo = frame.version == 1 ? (frame.channels == 1 ? 17 : 32) : (frame.channels == 1 ? 9 : 17);
+    size_t xing = first + 4 + sideInfo;
+    uint64_t frames = 0;
+    uint64_t streamBytes = 0;
+    if (file.matches(xing, "Xing", 4) || file.matches(xing, "Info", 4))
+    {
+        if (file.has(xing, 8))
+        {
+            uint32_t flags = file.be32(xing + 4);
+            size_t field = xing + 8;
+            if ((flags & 1) && file.has(field, 4))
+            {
+                frames = file.be32(field);
+                field += 4;
+            }
+            if ((flags & 2) && file.has(field, 4))
+                streamBytes = file.be32(field);
+        }
+    }
+    else if (file.matches(first + 36, "VBRI", 4) && file.has(first + 36, 18))
+    {
+        streamBytes = file.be32(first + 36 + 10);
+        frames = file.be32(first + 36 + 14);
+    }
+
+    if (frames > 0)
+    {
+        stream.lengthMs = frames * frame.samplesPerFrame * 1000 / frame.sampleRate;
+        stream.bitrate = bitrateFor(streamBytes > 0 ? streamBytes : audioEnd - first, stream.lengthMs);
+    }
+    else
+    {
+        // Constant bitrate: the stream size fixes the length
+        stream.bitrate = frame.bitrate;
+        stream.lengthMs = uint64_t(audioEnd - first) * 8 / frame.bitrate;
+    }
+    if (stream.lengthMs == 0)
+        stream.lengthMs = id3.lengthMs;
+
+    finish(stream, metadata);
+    return stream.lengthMs > 0;
+}
+
+// FLAC
+
+bool parseFlac(ByteView file, MediaMetadata &metadata)
+{
+    size_t pos = id3v2Length(file);
+    if (!file.matches(pos, "fLaC", 4))
+        return false;
+    pos += 4;
+
+    StreamInfo stream;
+    uint64_t totalSamples = 0;
+    bool last = false;
+    while (!last && file.has(pos, 4))
+    {
+        uint8_t header = file.u8(pos);
+        last = (header & 0x80) != 0;
+        size_t length = file.be24(pos + 1);
+        ByteView block = file.sub(pos + 4, length);
+        pos += 4 + length;
+
+        switch (header & 0x7F)
+        {
+        case 0: // STREAMINFO
+            if (block.size >= 18)
+            {
+                stream.sampleRate = static_cast<int>(block.be24(10) >> 4);
+                stream.channels = ((block.u8(12) >> 1) & 0x07) + 1;
+                totalSamples = (uint64_t(block.u8(13) & 0x0F) << 32) | block.be32(14);
+            }
+            break;
+        case 4: // VORBIS_COMMENT
+            parseVorbisComments(block, metadata);
+            break;
+        case 6: // PICTURE
+            metadata.hasAlbumArt = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (stream.sampleRate <= 0 || totalSamples == 0)
+        return false;
+
+    stream.lengthMs = totalSamples * 1000 / stream.sampleRate;
+    stream.bitrate = bitrateFor(file.size > pos ? file.size - pos : 0, stream.lengthMs);
+    metadata.codec = "FLAC";
+    finish(stream, metadata);
+    return stream.lengthMs > 0;
+}
+
+// Ogg
+
+struct OggPage
+{
+    uint64_t granule = 0;
+    uint32_t serial = 0;
+    size_t headerLength = 0;
+    size_t bodyLength = 0;
+};
+
+bool readOggPage(ByteView file, size_t offset, OggPage &page)
+{
+    if (!file.matches(offset, "OggS", 4) || !file.has(offset, 27))
+        return false;
+    size_t segments = file.u8(offset + 26);
+    if (!file.has(offset + 27, segments))
+        return false;
+
+    page.granule = file.le64(offset + 6);
+    page.serial = file.le32(offset + 14);
+    page.headerLength = 27 + segments;
+    page.bodyLength = 0;
+    for (size_t i = 0; i < segments; ++i)
+        page.bodyLength += file.u8(offset + 27 + i);
+    return true;
+}
+
+/**
+ * Reassemble the first packets of the stream starting at the first page
+ */
+std::vector<std::string> readOggPackets(ByteView file, size_t wanted, uint32_t &serial)
+{
+    const size_t kMaxPacket = 16 * 1024 * 1024;
+    std::vector<std::string> packets;
+    std::string current;
+    size_t pos = 0;
+    bool first = true;
+
+    OggPage page;
+    while (packets.size() < wanted && readOggPage(file, pos, page))
+    {
+        if (first)
+            serial = page.serial;
+        first = false;
+
+        size_t lacing = pos + 27;
+        size_t segments = file.u8(pos + 26);
+        size_t segmentStart = pos + page.headerLength;
+        pos = segmentStart + page.bodyLength;
+        if (page.serial != serial)
+            continue; // Another logical stream interleaved with ours
+
+        for (size_t i = 0; i < segments && packets.size() < wanted; ++i)
+        {
+            size_t lace = file.u8(lacing + i);
+            ByteView segment = file.sub(segmentStart, lace);
+            segmentStart += lace;
+            if (current.size() + segment.size > kMaxPacket)
+                return packets;
+            current.append(reinterpret_cast<const char *>(segment.data), segment.size);
+            if (lace < 255)
+            {
+                packets.push_back(std::move(current));
+                current.clear();
+            }
+        }
+    }
+    return packets;
+}
+
+/**
+ * Granule position of the last page of the stream (searching back from the end)
+ */
+uint64_t lastGranule(ByteView file, uint32_t serial)
+{
+    if (file.size < 27)
+        return 0;
+    const size_t stop = file.size > 128 * 1024 ? file.size - 128 * 1024 : 0;
+    for (size_t pos = file.size - 27 + 1; pos-- > stop;)
+    {
+        OggPage page;
+        if (file.u8(pos) == 'O' && readOggPage(file, pos, page) && page.serial == serial &&
+            page.granule != ~uint64_t(0))
+        {
+            return page.granule;
+        }
+    }
+    return 0;
+}
+
+bool parseOgg(ByteView file, MediaMetadata &metadata)
+{
+    uint32_t serial = 0;
+    std::vector<std::string> packets = readOggPackets(file, 2, serial);
+    if (packets.empty())
+        return false;
+
+    ByteView ident(packets[0]);
+    StreamInfo stream;
+    uint64_t granule = lastGranule(file, serial);
+    if (ident.matches(0, "\x01vorbis", 7) && ident.has(0, 28))
+    {
+        stream.channels = ident.u8(11);
+        stream.sampleRate = static_cast<int>(ident.le32(12));
+        int nominal = static_cast<int32_t>(ident.le32(20));
+        if (stream.sampleRate > 0)
+            stream.lengthMs = granule * 1000 / stream.sampleRate;
+        stream.bitrate = nominal > 0 ? nominal / 1000 : bitrateFor(file.size, stream.lengthMs);
+        metadata.codec = "Vorbis";
+        if (packets.size() > 1 && ByteView(packets[1]).matches(0, "\x03vorbis", 7))
+            parseVorbisComments(ByteView(packets[1]).sub(7, packets[1].size()), metadata);
+    }
+    else if (ident.matches(0, "OpusHead", 8) && ident.has(0, 19))
+    {
+        // Opus always decodes at 48 kHz; granules count 48 kHz samples after the pre-skip
+        stream.channels = ident.u8(9);
+        stream.sampleRate = 48000;
+        uint64_t preSkip = ident.le16(10);
+        stream.lengthMs = granule > preSkip ? (granule - preSkip) * 1000 / 48000 : 0;
+        stream.bitrate = bitrateFor(file.size, stream.lengthMs);
+        metadata.codec = "Opus";
+        if (packets.size() > 1 && ByteView(packets[1]).matches(0, "OpusTags", 8))
+            parseVorbisComments(ByteView(packets[1]).sub(8, packets[1].size()), metadata);
+    }
+    else
+    {
+        return false;
+    }
+
+    finish(stream, metadata);
+    return stream.lengthMs > 0;
+}
+
+// MP4
+
+struct Mp4Box
+{
+    std::string type;
+    ByteView body;
+};
+
+/**
+ * Split a range into child boxes
+ */
+std::vector<Mp4Box> mp4Children(ByteView range)
+{
+    std::vector<Mp4Box> boxes;
+    size_t pos = 0;
+    while (range.has(pos, 8))
+    {
+        uint64_t size = range.be32(pos);
+        size_t header = 8;
+        if (size == 1)
+        {
+            if (!range.has(pos, 16))
+                break;
+            size = range.be64(pos + 8);
+            header = 16;
+        }
+        else if (size == 0)
+        {
+            size = range.size - pos;
+        }
+        if (size < header || size > range.size - pos)
+            break;
+
+        boxes.push_back({range.text(pos + 4, 4), range.sub(pos + header, static_cast<size_t>(size) - header)});
+        pos += static_cast<size_t>(size);
+    }
+    return boxes;
+}
+
+const Mp4Box *findBox(const std::vector<Mp4Box> &boxes, const char *type)
+{
+    for (const auto &box : boxes)
+    {
+        if (box.type == type)
+            return &box;
+    }
+    return nullptr;
+}
+
+// The result points into the vector, so it must outlive the call
+const Mp4Box *findBox(std::vector<Mp4Box> &&boxes, const char *type) = delete;
+
+/**
+ * Walk a path of nested boxes ("mdia/minf/stbl"); returns an empty view if absent
+ */
+ByteView mp4Path(ByteView range, const std::vector<const char *> &path)
+{
+    for (const char *type : path)
+    {
+        auto children = mp4Children(range);
+        const Mp4Box *box = findBox(children, type);
+        if (!box)
+            return ByteView();
+        range = box->body;
+    }
+    return range;
+}
+
+size_t descriptorLength(ByteView bytes, size_t &pos)
+{
+    size_t length = 0;
+    for (int i = 0; i < 4 && bytes.has(pos, 1); ++i)
+    {
+        uint8_t byte = bytes.u8(pos++);
+        length = (length << 7) | (byte & 0x7F);
+        if (!(byte & 0x80))
+            break;
+    }
+    return length;
+}
+
+/**
+ * Average bitrate from an esds box (kbit/s), or 0
+ */
+int esdsBitrate(ByteView esds)
+{
+    size_t pos = 4; // Version and flags
+    if (!esds.has(pos, 1) || esds.u8(pos++) != 0x03)
+        return 0;
+    descriptorLength(esds, pos);
+    if (!esds.has(pos, 3))
+        return 0;
+    uint8_t flags = esds.u8(pos + 2);
+    pos += 3;
+    if (flags & 0x80)
+        pos += 2;
+    if ((flags & 0x40) && esds.has(pos, 1))
+        pos += 1 + esds.u8(pos);
+    if (flags & 0x20)
+        pos += 2;
+    if (!esds.has(pos, 1) || esds.u8(pos++) != 0x04)
+        return 0;
+    descriptorLength(esds, pos);
+    if (!esds.has(pos, 13))
+        return 0;
+    return static_cast<int>(esds.be32(pos + 9) / 1000);
+}
+
+void parseMp4Track(ByteView trak, StreamInfo &stream, MediaMetadata &metadata)
+{
+    ByteView hdlr = mp4Path(trak, {"mdia", "hdlr"});
+    if (!hdlr.matches(8, "soun", 4) || stream.sampleRate != 0)
+        return; // Not audio, or an earlier sound track already answered
+
+    ByteView stsd = mp4Path(trak, {"mdia", "minf", "stbl", "stsd"});
+    auto entries = mp4Children(stsd.sub(8, stsd.size)); // Skip version, flags and entry count
+    if (entries.empty() || !entries[0].body.has(0, 28))
+        return;
+
+    const Mp4Box &entry = entries[0];
+    stream.channels = entry.body.be16(16);
+    stream.sampleRate = static_cast<int>(entry.body.be32(24) >> 16);
+    if (entry.type == "mp4a")
+        metadata.codec = "AAC";
+    else if (entry.type == "alac")
+        metadata.codec = "ALAC";
+    else
+        metadata.codec = entry.type;
+
+    auto codecBoxes = mp4Children(entry.body.sub(28, entry.body.size)); // After the sample entry fields
+    if (const Mp4Box *esds = findBox(codecBoxes, "esds"))
+        stream.bitrate = esdsBitrate(esds->body);
+}
+
+void parseIlst(ByteView ilst, MediaMetadata &metadata)
+{
+    for (const auto &item : mp4Children(ilst))
+    {
+        if (item.type == "covr")
+        {
+            metadata.hasAlbumArt = true;
+            continue;
+        }
+
+        auto itemBoxes = mp4Children(item.body);
+        const Mp4Box *data = findBox(itemBoxes, "data");
+        if (!data || !data->body.has(0, 8))
+            continue;
+        ByteView payload = data->body.sub(8, data->body.size); // Type indicator and locale
+        std::string text = payload.text(0, payload.size);
+
+        if (item.type == "\xA9nam")
+            setIfEmpty(metadata.title, text);
+        else if (item.type == "\xA9" "ART")
+            setIfEmpty(metadata.artist, text);
+        else if (item.type == "\xA9" "alb")
+            setIfEmpty(metadata.album, text);
+        else if (item.type == "\xA9gen")
+            setIfEmpty(metadata.genre, text);
+        else if (item.type == "gnre" && payload.has(0, 2))
+            setIfEmpty(metadata.genre, genreName(payload.be16(0) - 1));
+        else if (item.type == "\xA9" "day")
+            setIfZero(metadata.year, leadingInt(text));
+        else if (item.type == "trkn" && payload.has(0, 4))
+            setIfZero(metadata.track, payload.be16(2));
+        else if (item.type == "\xA9" "cmt")
+            setIfEmpty(metadata.comment, text);
+    }
+}
+
+bool parseMp4(ByteView file, MediaMetadata &metadata)
+{
+    auto top = mp4Children(file);
+    if (!findBox(top, "ftyp"))
+        return false;
+    const Mp4Box *moov = findBox(top, "moov");
+    if (!moov)
+        return false;
+
+    StreamInfo stream;
+    for (const auto &box : mp4Children(moov->body))
+    {
+        if (box.type == "mvhd")
+        {
+            ByteView mvhd = box.body;
+            uint64_t timescale = 0;
+            uint64_t duration = 0;
+            if (mvhd.has(0, 1) && mvhd.u8(0) == 1 && mvhd.has(0, 32))
+            {
+                timescale = mvhd.be32(20);
+                duration = mvhd.be64(24);
+            }
+            else if (mvhd.has(0, 20))
+            {
+                timescale = mvhd.be32(12);
+                duration = mvhd.be32(16);
+            }
+            if (timescale > 0)
+                stream.lengthMs = duration * 1000 / timescale;
+        }
+        else if (box.type == "trak")
+        {
+            parseMp4Track(box.body, stream, metadata);
+        }
+        else if (box.type == "udta")
+        {
+            // meta is a full box: skip version and flags before its children
+            ByteView meta = mp4Path(box.body, {"meta"});
+            ByteView ilst = mp4Path(meta.sub(4, meta.size), {"ilst"});
+            if (ilst.size == 0)
+                ilst = mp4Path(meta, {"ilst"}); // QuickTime writes meta without them
+            parseIlst(ilst, metadata);
+        }
+    }
+
+    if (stream.bitrate == 0)
+        stream.bitrate = bitrateFor(file.size, stream.lengthMs);
+    finish(stream, metadata);
+    return stream.lengthMs > 0;
+}
+} // namespace
+
+MediaMetadata NativeMetadataReader::readMetadata(const std::string &filepath)
+{
+    MediaMetadata metadata;
+
+    std::string ext;
+    size_t dot = filepath.find_last_of('.');
+    if (dot != std::string::npos)
+    {
+        ext = filepath.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    }
+    if (!isFormatSupported(ext))
+        return metadata;
+
+    auto file = MappedFile::open(filepath);
+    if (!file)
+        return metadata;
+
+    // Partial results are dropped so the fallback reader starts clean
+    if (!parse(ext, file->data(), file->size(), metadata))
+        return MediaMetadata();
+    return metadata;
+}
+
+bool NativeMetadataReader::parse(const std::string &extension, const char *data, size_t size,
+                                 MediaMetadata &metadata)
+{
+    ByteView file(reinterpret_cast<const unsigned char *>(data), size);
+    if (extension == ".mp3")
+    {
+        metadata.codec = "MP3";
+        return parseMp3(file, metadata);
+    }
+    if (extension == ".flac")
+        return parseFlac(file, metadata);
+    if (extension == ".ogg" || extension == ".oga" || extension == ".opus")
+        return parseOgg(file, metadata);
+    if (extension == ".m4a" || extension == ".m4b" || extension == ".mp4")
+        return parseMp4(file, metadata);
+    return false;
+}
+
+bool NativeMetadataReader::isFormatSupported(const std::string &extension)
+{
+    static const std::vector<std::string> formats = {".mp3", ".flac", ".ogg", ".oga", ".opus", ".m4a", ".m4b", ".mp4"};
+    return std::find(formats.begin(), formats.end(), extension) != formats.end();
+}
+
+bool NativeMetadataReader::writeMetadata(const std::string &filepath, const MediaMetadata &metadata)
+{
+    (void)filepath;
+    (void)metadata;
+    return false;
+}
+
+std::map<std::string, std::string> NativeMetadataReader::extractTags(const std::string &filepath,
+                                                                     const std::vector<std::string> &tags)
+{
+    std::map<std::string, std::string> result;
+    MediaMetadata metadata = readMetadata(filepath);
+    if (metadata.duration == 0)
+        return result;
+
+    for (const auto &tagName : tags)
+    {
+        std::string lowerTag = tagName;
+        std::transform(lowerTag.begin(), lowerTag.end(), lowerTag.begin(), ::tolower);
+
+        if (lowerTag == "title")
+            result[tagName] = metadata.title;
+        else if (lowerTag == "artist")
+            result[tagName] = metadata.artist;
+        else if (lowerTag == "album")
+            result[tagName] = metadata.album;
+        else if (lowerTag == "genre")
+            result[tagName] = metadata.genre;
+        else if (lowerTag == "year")
+            result[tagName] = std::to_string(metadata.year);
+        else if (lowerTag == "track")
+            result[tagName] = std::to_string(metadata.track);
+    }
+    return result;
+}
+
+bool NativeMetadataReader::supportsEditing(const std::string &filepath)
+{
+    (void)filepath;
+    return false;
+}
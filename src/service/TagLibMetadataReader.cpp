@@ -11,6 +11,49 @@
 #include <taglib/tag.h>
 #include <taglib/tpropertymap.h>
 
+namespace
+{
+void readTag(const TagLib::Tag *tag, MediaMetadata &metadata)
+{
+    metadata.title = tag->title().to8Bit(true);
+    metadata.artist = tag->artist().to8Bit(true);
+    metadata.album = tag->album().to8Bit(true);
+    metadata.genre = tag->genre().to8Bit(true);
+    metadata.year = tag->year();
+    metadata.track = tag->track();
+    metadata.comment = tag->comment().to8Bit(true);
+}
+
+void readProperties(const TagLib::AudioProperties *props, MediaMetadata &metadata)
+{
+    if (!props)
+        return;
+
+    metadata.duration = props->lengthInSeconds();
+    metadata.bitrate = props->bitrate();
+    metadata.sampleRate = props->sampleRate();
+    metadata.channels = props->channels();
+}
+
+TagLib::ID3v2::AttachedPictureFrame *firstPicture(TagLib::MPEG::File &file)
+{
+    TagLib::ID3v2::Tag *id3v2 = file.ID3v2Tag();
+    if (!id3v2)
+        return nullptr;
+
+    auto frames = id3v2->frameList("APIC");
+    if (frames.isEmpty())
+        return nullptr;
+    return dynamic_cast<TagLib::ID3v2::AttachedPictureFrame *>(frames.front());
+}
+
+void setAlbumArt(const TagLib::ByteVector &data, const TagLib::String &mimeType, AlbumArt &art)
+{
+    art.data.assign(data.begin(), data.end());
+    art.mimeType = mimeType.to8Bit(true);
+}
+} // namespace
+
 MediaMetadata TagLibMetadataReader::readMetadata(const std::string &filepath)
 {
     MediaMetadata metadata;
@@ -37,75 +80,96 @@ MediaMetadata TagLibMetadataReader::readMetadata(const std::string &filepath)
     else
         metadata.codec = "Unknown";
 
-    TagLib::FileRef file(filepath.c_str());
+    metadata.hasAlbumArt = false;
 
-    if (file.isNull() || !file.tag())
+    // Each file is opened and parsed once; MP3 and FLAC use their format classes
+    // directly so the same parse yields tags, properties and the picture flag.
+    // The picture bytes themselves are left for readAlbumArt().
+    bool ok = false;
+    if (ext == ".mp3")
+        ok = readMpeg(filepath, metadata);
+    else if (ext == ".flac")
+        ok = readFlac(filepath, metadata);
+    else
+        ok = readGeneric(filepath, metadata);
+
+    if (!ok)
     {
         Logger::warn("Failed to read detailed metadata from: " + filepath);
-        return metadata;
     }
+    return metadata;
+}
 
-    TagLib::Tag *tag = file.tag();
+bool TagLibMetadataReader::readMpeg(const std::string &filepath, MediaMetadata &metadata)
+{
+    bool full = mode_ == ReadMode::FULL;
+    TagLib::MPEG::File file(filepath.c_str(), full, TagLib::AudioProperties::Average);
+    if (!file.isValid() || !file.tag())
+        return false;
 
-    metadata.title = tag->title().to8Bit(true);
-    metadata.artist = tag->artist().to8Bit(true);
-    metadata.album = tag->album().to8Bit(true);
-    metadata.genre = tag->genre().to8Bit(true);
-    metadata.year = tag->year();
-    metadata.track = tag->track();
-    metadata.comment = tag->comment().to8Bit(true);
+    readTag(file.tag(), metadata);
+    if (!full)
+        return true;
 
-    if (file.audioProperties())
-    {
-        TagLib::AudioProperties *props = file.audioProperties();
-        metadata.duration = props->lengthInSeconds();
-        metadata.bitrate = props->bitrate();
-        metadata.sampleRate = props->sampleRate();
-        metadata.channels = props->channels();
-    }
+    readProperties(file.audioProperties(), metadata);
+    metadata.hasAlbumArt = firstPicture(file) != nullptr;
+    return true;
+}
 
-    metadata.hasAlbumArt = false;
+bool TagLibMetadataReader::readFlac(const std::string &filepath, MediaMetadata &metadata)
+{
+    bool full = mode_ == ReadMode::FULL;
+    TagLib::FLAC::File file(filepath.c_str(), full, TagLib::AudioProperties::Average);
+    if (!file.isValid() || !file.tag())
+        return false;
+
+    readTag(file.tag(), metadata);
+    if (!full)
+        return true;
+
+    readProperties(file.audioProperties(), metadata);
+    metadata.hasAlbumArt = !file.pictureList().isEmpty();
+    return true;
+}
 
-    // Try MP3 (ID3v2)
+bool TagLibMetadataReader::readGeneric(const std::string &filepath, MediaMetadata &metadata)
+{
+    bool full = mode_ == ReadMode::FULL;
+    TagLib::FileRef file(filepath.c_str(), full);
+    if (file.isNull() || !file.tag())
+        return false;
+
+    readTag(file.tag(), metadata);
+    if (full)
+        readProperties(file.audioProperties(), metadata);
+    return true;
+}
+
+bool TagLibMetadataReader::readAlbumArt(const std::string &filepath, AlbumArt &art)
+{
+    // Pictures only: no audio-property scan
+    std::string ext = getExtension(filepath);
     if (ext == ".mp3")
     {
-        TagLib::MPEG::File mpegFile(filepath.c_str());
-        if (mpegFile.isValid() && mpegFile.ID3v2Tag())
-        {
-            TagLib::ID3v2::Tag *id3v2 = mpegFile.ID3v2Tag();
-            auto frames = id3v2->frameList("APIC");
-            if (!frames.isEmpty())
-            {
-                auto *pictureFrame = dynamic_cast<TagLib::ID3v2::AttachedPictureFrame *>(frames.front());
-                if (pictureFrame)
-                {
-                    auto pictureData = pictureFrame->picture();
-                    metadata.albumArtData.assign(pictureData.begin(), pictureData.end());
-                    metadata.albumArtMimeType = pictureFrame->mimeType().to8Bit(true);
-                    metadata.hasAlbumArt = true;
-                }
-            }
-        }
+        TagLib::MPEG::File file(filepath.c_str(), false);
+        auto *pictureFrame = file.isValid() ? firstPicture(file) : nullptr;
+        if (!pictureFrame)
+            return false;
+        setAlbumArt(pictureFrame->picture(), pictureFrame->mimeType(), art);
+        return true;
     }
-    // Try FLAC
-    else if (ext == ".flac")
+    if (ext == ".flac")
     {
-        TagLib::FLAC::File flacFile(filepath.c_str());
-        if (flacFile.isValid())
-        {
-            auto pictures = flacFile.pictureList();
-            if (!pictures.isEmpty())
-            {
-                auto *picture = pictures.front();
-                auto pictureData = picture->data();
-                metadata.albumArtData.assign(pictureData.begin(), pictureData.end());
-                metadata.albumArtMimeType = picture->mimeType().to8Bit(true);
-                metadata.hasAlbumArt = true;
-            }
-        }
+        TagLib::FLAC::File file(filepath.c_str(), false);
+        if (!file.isValid())
+            return false;
+        auto pictures = file.pictureList();
+        if (pictures.isEmpty())
+            return false;
+        setAlbumArt(pictures.front()->data(), pictures.front()->mimeType(), art);
+        return true;
     }
-
-    return metadata;
+    return false;
 }
 
 bool TagLibMetadataReader::writeMetadata(const std::string &filepath, const MediaMetadata &metadata)
@@ -155,7 +219,8 @@ std::map<std::string, std::string> TagLibMetadataReader::extractTags(const std::
 
     std::map<std::string, std::string> result;
 
-    TagLib::FileRef file(filepath.c_str());
+    // Tags only: skip the audio-property scan
+    TagLib::FileRef file(filepath.c_str(), false);
     if (file.isNull() || !file.tag())
     {
         return result;
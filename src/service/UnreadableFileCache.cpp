@@ -0,0 +1,123 @@
+#include "service/UnreadableFileCache.h"
+#include "utils/Logger.h"
+#include <json.hpp>
+
+UnreadableFileCache::UnreadableFileCache(IPersistence *persistence, IFileSystem *fileSystem,
+                                         const std::string &filepath)
+    : persistence_(persistence), fileSystem_(fileSystem), filepath_(filepath)
+{
+}
+
+bool UnreadableFileCache::isKnownUnreadable(const std::string &path)
+{
+    FileFingerprint recorded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it == entries_.end())
+        {
+            return false;
+        }
+        recorded = it->second;
+    }
+
+    FileFingerprint current;
+    if (fileSystem_ && fileSystem_->getFingerprint(path, current) && current == recorded)
+    {
+        return true;
+    }
+
+    // Changed or gone: give the readers another chance
+    forget(path);
+    return false;
+}
+
+void UnreadableFileCache::markUnreadable(const std::string &path)
+{
+    FileFingerprint fingerprint;
+    if (!fileSystem_ || !fileSystem_->getFingerprint(path, fingerprint))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[path] = fingerprint;
+    dirty_ = true;
+}
+
+void UnreadableFileCache::forget(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.erase(path) > 0)
+    {
+        dirty_ = true;
+    }
+}
+
+size_t UnreadableFileCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+bool UnreadableFileCache::load()
+{
+    std::string content;
+    if (!persistence_ || !persistence_->fileExists(filepath_) || !persistence_->loadFromFile(filepath_, content))
+    {
+        return false;
+    }
+
+    std::unordered_map<std::string, FileFingerprint> entries;
+    try
+    {
+        nlohmann::json j = nlohmann::json::parse(content);
+        for (const auto &entry : j.at("files"))
+        {
+            FileFingerprint fingerprint;
+            fingerprint.size = entry.value("size", uint64_t(0));
+            fingerprint.mtime = entry.value("mtime", int64_t(0));
+            fingerprint.inode = entry.value("inode", uint64_t(0));
+            entries[entry.at("path").get<std::string>()] = fingerprint;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        Logger::warn("Ignoring unreadable-file list " + filepath_ + ": " + e.what());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_ = std::move(entries);
+    dirty_ = false;
+    return true;
+}
+
+bool UnreadableFileCache::save()
+{
+    nlohmann::json files = nlohmann::json::array();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_ || !persistence_)
+        {
+            return true;
+        }
+        for (const auto &entry : entries_)
+        {
+            files.push_back({{"path", entry.first},
+                             {"size", entry.second.size},
+                             {"mtime", entry.second.mtime},
+                             {"inode", entry.second.inode}});
+        }
+        dirty_ = false;
+    }
+
+    nlohmann::json j = {{"version", 1}, {"files", files}};
+    if (!persistence_->saveToFile(filepath_, j.dump()))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ = true;
+        return false;
+    }
+    return true;
+}
@@ -86,6 +86,16 @@ void to_json(nlohmann::json &j, const AppConfig &c)
                        {"baudRate", c.baudRate},
                        {"hardwareEnabled", c.hardwareEnabled},
                        {"maxHistorySize", c.maxHistorySize},
+                       {"binaryLibrary", c.binaryLibrary},
+                       {"journaledSaves", c.journaledSaves},
+                       {"parallelScan", c.parallelScan},
+                       {"metadataProbes", c.metadataProbes},
+                       {"metadataProbeTimeoutMs", c.metadataProbeTimeoutMs},
+                       {"albumArtCacheMB", c.albumArtCacheMB},
+                       {"nativeTagReader", c.nativeTagReader},
+                       {"watchLibrary", c.watchLibrary},
+                       {"gaplessPlayback", c.gaplessPlayback},
+                       {"libraryFolders", c.libraryFolders},
                        {"supportedAudioFormats", c.supportedAudioFormats},
                        {"supportedVideoFormats", c.supportedVideoFormats},
                        {"customSettings", c.customSettings}};
@@ -125,6 +135,26 @@ void from_json(const nlohmann::json &j, AppConfig &c)
         c.hardwareEnabled = j.at("hardwareEnabled").get<bool>();
     if (j.contains("maxHistorySize"))
         c.maxHistorySize = j.at("maxHistorySize").get<int>();
+    if (j.contains("binaryLibrary"))
+        c.binaryLibrary = j.at("binaryLibrary").get<bool>();
+    if (j.contains("journaledSaves"))
+        c.journaledSaves = j.at("journaledSaves").get<bool>();
+    if (j.contains("parallelScan"))
+        c.parallelScan = j.at("parallelScan").get<bool>();
+    if (j.contains("metadataProbes"))
+        c.metadataProbes = j.at("metadataProbes").get<int>();
+    if (j.contains("metadataProbeTimeoutMs"))
+        c.metadataProbeTimeoutMs = j.at("metadataProbeTimeoutMs").get<int>();
+    if (j.contains("albumArtCacheMB"))
+        c.albumArtCacheMB = j.at("albumArtCacheMB").get<int>();
+    if (j.contains("nativeTagReader"))
+        c.nativeTagReader = j.at("nativeTagReader").get<bool>();
+    if (j.contains("watchLibrary"))
+        c.watchLibrary = j.at("watchLibrary").get<bool>();
+    if (j.contains("gaplessPlayback"))
+        c.gaplessPlayback = j.at("gaplessPlayback").get<bool>();
+    if (j.contains("libraryFolders"))
+        c.libraryFolders = j.at("libraryFolders").get<std::vector<std::string>>();
     if (j.contains("supportedAudioFormats"))
         c.supportedAudioFormats = j.at("supportedAudioFormats").get<std::vector<std::string>>();
     if (j.contains("supportedVideoFormats"))
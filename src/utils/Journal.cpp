@@ -0,0 +1,142 @@
+#include "utils/Journal.h"
+#include "utils/Logger.h"
+#include <sstream>
+
+Journal::Journal(IPersistence *persistence, std::string filepath, BaseWriter writeBase, size_t compactThreshold)
+    : persistence_(persistence), filepath_(std::move(filepath)), writeBase_(std::move(writeBase)),
+      compactThreshold_(compactThreshold > 0 ? compactThreshold : 1)
+{
+}
+
+Journal::~Journal()
+{
+    waitForCompaction();
+}
+
+bool Journal::append(const nlohmann::json &record)
+{
+    if (!persistence_)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!persistence_->appendToFile(filepath_, record.dump() + "\n"))
+    {
+        Logger::error("Failed to append to journal " + filepath_);
+        return false;
+    }
+
+    pending_++;
+    appended_++;
+
+    // Retry at each further multiple if a compaction had to keep the journal
+    if (pending_ % compactThreshold_ == 0 && !compacting_)
+        startBackgroundCompaction();
+    return true;
+}
+
+size_t Journal::replay(const std::function<void(const nlohmann::json &)> &apply)
+{
+    if (!persistence_)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string content;
+    if (!persistence_->fileExists(filepath_) || !persistence_->loadFromFile(filepath_, content))
+        return 0;
+
+    std::istringstream lines(content);
+    std::string line;
+    size_t applied = 0;
+    while (std::getline(lines, line))
+    {
+        if (line.empty())
+            continue;
+
+        nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+        if (record.is_discarded())
+        {
+            // Only the last append can be torn; anything after it is unreliable
+            Logger::warn("Journal " + filepath_ + " ends with a partial record, ignoring the rest");
+            break;
+        }
+
+        try
+        {
+            apply(record);
+            applied++;
+        }
+        catch (const std::exception &e)
+        {
+            Logger::warn("Skipping bad journal record in " + filepath_ + ": " + e.what());
+        }
+    }
+
+    pending_ = applied;
+    if (applied > 0)
+        Logger::info("Replayed " + std::to_string(applied) + " records from " + filepath_);
+    return applied;
+}
+
+bool Journal::compact()
+{
+    if (!persistence_ || !writeBase_)
+        return false;
+
+    uint64_t watermark;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watermark = appended_;
+    }
+
+    if (!writeBase_())
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A record that landed while the base was written may be missing from it; keep the journal
+    if (appended_ != watermark)
+        return true;
+
+    if (persistence_->fileExists(filepath_) && !persistence_->saveToFile(filepath_, ""))
+    {
+        Logger::warn("Failed to truncate journal " + filepath_);
+        return true;
+    }
+    pending_ = 0;
+    return true;
+}
+
+void Journal::waitForCompaction()
+{
+    std::thread finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished = std::move(compactor_);
+    }
+    if (finished.joinable())
+        finished.join();
+}
+
+size_t Journal::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+void Journal::startBackgroundCompaction()
+{
+    // Called with mutex_ held. The previous thread has cleared compacting_, so
+    // it no longer needs any lock and joining it here cannot deadlock.
+    if (compactor_.joinable())
+        compactor_.join();
+
+    compacting_ = true;
+    compactor_ = std::thread(
+        [this]()
+        {
+            if (!compact())
+                Logger::warn("Background compaction of " + filepath_ + " failed");
+            compacting_ = false;
+        });
+}
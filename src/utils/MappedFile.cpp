@@ -0,0 +1,54 @@
+#include "utils/MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &filepath)
+{
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    if (st.st_size == 0)
+    {
+        // mmap rejects empty ranges; an empty buffer is equivalent
+        ::close(fd);
+        file->data_ = file->owned_.data();
+        return file;
+    }
+
+    void *base = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (base == MAP_FAILED)
+        return nullptr;
+
+    file->mapping_ = base;
+    file->data_ = static_cast<const char *>(base);
+    file->size_ = static_cast<size_t>(st.st_size);
+    return file;
+}
+
+std::shared_ptr<MappedFile> MappedFile::fromString(std::string bytes)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->owned_ = std::move(bytes);
+    file->data_ = file->owned_.data();
+    file->size_ = file->owned_.size();
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    if (mapping_)
+        ::munmap(mapping_, size_);
+}
@@ -0,0 +1,91 @@
+#ifndef MEMORY_PERSISTENCE_H
+#define MEMORY_PERSISTENCE_H
+
+#include "interfaces/IPersistence.h"
+#include <map>
+#include <mutex>
+
+/**
+ * @brief In-memory IPersistence fake for round-trip tests
+ *
+ * Keeps "files" in a map so tests can save, append, reload and inspect
+ * contents without touching the disk. Thread-safe for background writers.
+ */
+class MemoryPersistence : public IPersistence
+{
+  public:
+    bool saveToFile(const std::string &filepath, const std::string &data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        files_[filepath] = data;
+        saves_++;
+        return true;
+    }
+
+    bool loadFromFile(const std::string &filepath, std::string &data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = files_.find(filepath);
+        if (it == files_.end())
+            return false;
+        data = it->second;
+        return true;
+    }
+
+    bool appendToFile(const std::string &filepath, const std::string &data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        files_[filepath] += data;
+        appends_++;
+        return true;
+    }
+
+    bool fileExists(const std::string &filepath) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return files_.count(filepath) > 0;
+    }
+
+    bool deleteFile(const std::string &filepath) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return files_.erase(filepath) > 0;
+    }
+
+    std::string serialize(const void *) override
+    {
+        return "{}";
+    }
+
+    bool deserialize(const std::string &, void *) override
+    {
+        return false;
+    }
+
+    std::string contents(const std::string &filepath)
+    {
+        std::string data;
+        loadFromFile(filepath, data);
+        return data;
+    }
+
+    int saveCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return saves_;
+    }
+
+    int appendCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return appends_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::map<std::string, std::string> files_;
+    int saves_ = 0;
+    int appends_ = 0;
+};
+
+#endif // MEMORY_PERSISTENCE_H
@@ -0,0 +1,15 @@
+#ifndef MOCK_DIRECTORY_WATCHER_H
+#define MOCK_DIRECTORY_WATCHER_H
+
+#include "interfaces/IDirectoryWatcher.h"
+#include <gmock/gmock.h>
+
+class MockDirectoryWatcher : public IDirectoryWatcher
+{
+  public:
+    MOCK_METHOD(bool, start, (Callback), (override));
+    MOCK_METHOD(bool, addRoot, (const std::string &), (override));
+    MOCK_METHOD(void, stop, (), (override));
+};
+
+#endif // MOCK_DIRECTORY_WATCHER_H
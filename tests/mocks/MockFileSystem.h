@@ -17,6 +17,7 @@ class MockFileSystem : public IFileSystem
     MOCK_METHOD(bool, unmountUSB, (const std::string &), (override));
     MOCK_METHOD(bool, exists, (const std::string &), (override));
     MOCK_METHOD(bool, isDirectory, (const std::string &), (override));
+    MOCK_METHOD(bool, getFingerprint, (const std::string &, FileFingerprint &), (override));
 };
 
 #endif // MOCK_FILESYSTEM_H
@@ -12,6 +12,7 @@ class MockMetadataReader : public IMetadataReader
     MOCK_METHOD((std::map<std::string, std::string>), extractTags,
                 (const std::string &, const std::vector<std::string> &), (override));
     MOCK_METHOD(bool, supportsEditing, (const std::string &), (override));
+    MOCK_METHOD(bool, readAlbumArt, (const std::string &, AlbumArt &), (override));
 };
 
 #endif // MOCK_METADATA_READER_H
@@ -9,6 +9,7 @@ class MockPersistence : public IPersistence
   public:
     MOCK_METHOD(bool, saveToFile, (const std::string &, const std::string &), (override));
     MOCK_METHOD(bool, loadFromFile, (const std::string &, std::string &), (override));
+    MOCK_METHOD(bool, appendToFile, (const std::string &, const std::string &), (override));
     MOCK_METHOD(bool, fileExists, (const std::string &), (override));
     MOCK_METHOD(bool, deleteFile, (const std::string &), (override));
     MOCK_METHOD(std::string, serialize, (const void *), (override));
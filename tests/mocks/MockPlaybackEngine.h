@@ -26,4 +26,7 @@ class MockPlaybackEngine : public IPlaybackEngine
     MOCK_METHOD(void *, getVideoTexture, (), (override));
     MOCK_METHOD(void, getVideoSize, (int &, int &), (override));
     MOCK_METHOD(void, updateVideo, (), (override));
+
+    MOCK_METHOD(bool, preloadNext, (const std::string &), (override));
+    MOCK_METHOD(void, clearPreload, (), (override));
 };
@@ -0,0 +1,228 @@
+#ifndef SIMULATED_PLAYBACK_ENGINE_H
+#define SIMULATED_PLAYBACK_ENGINE_H
+
+#include "interfaces/IPlaybackEngine.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief IPlaybackEngine fake that plays tracks on a simulated clock
+ *
+ * advance() moves time forward. Opening a track takes loadLatency seconds
+ * of silence (demuxer and decoder start-up), unless it was preloaded: then
+ * it starts the moment the previous one ends, the way mpv continues into a
+ * prefetched playlist entry. Every silence between two tracks is recorded
+ * in getGaps(). The end of each track reaches observers on dispatchEvents().
+ */
+class SimulatedPlaybackEngine : public IPlaybackEngine
+{
+  public:
+    explicit SimulatedPlaybackEngine(double loadLatency) : loadLatency_(loadLatency)
+    {
+    }
+
+    void setTrackLength(const std::string &path, double seconds)
+    {
+        lengths_[path] = seconds;
+    }
+
+    /**
+     * @brief Let seconds of playback pass
+     */
+    void advance(double seconds)
+    {
+        double end = now_ + seconds;
+        while (now_ < end && !current_.empty() && !paused_)
+        {
+            double step = end - now_;
+            if (loading_ > 0)
+            {
+                step = std::min(step, loading_);
+                loading_ -= step;
+                now_ += step;
+                if (loading_ <= 0)
+                    startAudio();
+                continue;
+            }
+
+            double left = lengths_[current_] - position_;
+            if (left > step)
+            {
+                position_ += step;
+                break;
+            }
+            now_ += left;
+            finishTrack();
+        }
+        now_ = end;
+    }
+
+    const std::vector<double> &getGaps() const
+    {
+        return gaps_;
+    }
+
+    const std::vector<std::string> &getStarted() const
+    {
+        return started_;
+    }
+
+    bool play(const std::string &filepath) override
+    {
+        eof_ = false;
+        paused_ = false;
+        if (filepath == advancedPath_)
+        {
+            advancedPath_.clear(); // Already playing
+            return true;
+        }
+        advancedPath_.clear();
+        bool preloaded = filepath == preloadPath_;
+        preloadPath_.clear();
+        open(filepath, preloaded ? 0.0 : loadLatency_);
+        return true;
+    }
+
+    void pause() override
+    {
+        paused_ = true;
+    }
+
+    void resume() override
+    {
+        paused_ = false;
+    }
+
+    void stop() override
+    {
+        current_.clear();
+        preloadPath_.clear();
+        advancedPath_.clear();
+    }
+
+    void seek(double positionSeconds) override
+    {
+        position_ = positionSeconds;
+    }
+
+    void setVolume(float volume) override
+    {
+        volume_ = volume;
+    }
+
+    PlaybackStatus getState() const override
+    {
+        if (current_.empty())
+            return PlaybackStatus::STOPPED;
+        return paused_ ? PlaybackStatus::PAUSED : PlaybackStatus::PLAYING;
+    }
+
+    double getCurrentPosition() const override
+    {
+        return position_;
+    }
+
+    double getDuration() const override
+    {
+        auto it = lengths_.find(current_);
+        return it != lengths_.end() ? it->second : 0.0;
+    }
+
+    float getVolume() const override
+    {
+        return volume_;
+    }
+
+    bool isFinished() const override
+    {
+        return eof_;
+    }
+
+    bool preloadNext(const std::string &filepath) override
+    {
+        preloadPath_ = filepath;
+        return true;
+    }
+
+    void clearPreload() override
+    {
+        preloadPath_.clear();
+    }
+
+    void attach(IObserver *observer) override
+    {
+        observers_.push_back(observer);
+    }
+    void detach(IObserver *observer) override
+    {
+        observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+    }
+    void notify() override
+    {
+        for (auto *observer : observers_)
+            observer->update(this);
+    }
+
+    void dispatchEvents() override
+    {
+        for (; endsPending_ > 0; --endsPending_)
+            notify();
+    }
+
+  private:
+    double loadLatency_;
+    double now_ = 0.0;
+    std::map<std::string, double> lengths_;
+
+    std::string current_;
+    double position_ = 0.0;
+    double loading_ = 0.0; // Silence left before current_ is heard
+    bool paused_ = false;
+    bool eof_ = false;
+    int endsPending_ = 0;
+    std::vector<IObserver *> observers_;
+    float volume_ = 1.0f;
+
+    std::string preloadPath_;
+    std::string advancedPath_;
+
+    double lastEnd_ = -1.0; // When the previous track fell silent, -1 if none is pending
+    std::vector<double> gaps_;
+    std::vector<std::string> started_;
+
+    void open(const std::string &path, double latency)
+    {
+        current_ = path;
+        position_ = 0.0;
+        loading_ = latency;
+        if (loading_ <= 0)
+            startAudio();
+    }
+
+    void startAudio()
+    {
+        started_.push_back(current_);
+        if (lastEnd_ >= 0)
+            gaps_.push_back(now_ - lastEnd_);
+        lastEnd_ = -1.0;
+    }
+
+    void finishTrack()
+    {
+        lastEnd_ = now_;
+        eof_ = true;
+        endsPending_++; // Reported by the next dispatchEvents()
+        if (preloadPath_.empty())
+        {
+            current_.clear();
+            return;
+        }
+        advancedPath_ = preloadPath_;
+        preloadPath_.clear();
+        open(advancedPath_, 0.0);
+    }
+};
+
+#endif // SIMULATED_PLAYBACK_ENGINE_H
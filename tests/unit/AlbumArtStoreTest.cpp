@@ -0,0 +1,103 @@
+#include "app/model/AlbumArtStore.h"
+#include "tests/mocks/MockMetadataReader.h"
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+
+class AlbumArtStoreTest : public ::testing::Test
+{
+  protected:
+    NiceMock<MockMetadataReader> mockMeta;
+
+    static AlbumArt makeArt(unsigned char fill, size_t size)
+    {
+        AlbumArt art;
+        art.data.assign(size, fill);
+        art.mimeType = "image/jpeg";
+        return art;
+    }
+};
+
+TEST_F(AlbumArtStoreTest, ReadsOnFirstRequestOnly)
+{
+    AlbumArtStore store(&mockMeta);
+    EXPECT_CALL(mockMeta, readAlbumArt("/a.mp3", _)).WillOnce(DoAll(SetArgReferee<1>(makeArt(1, 100)), Return(true)));
+
+    auto first = store.get("/a.mp3");
+    auto second = store.get("/a.mp3");
+
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first->mimeType, "image/jpeg");
+    EXPECT_EQ(first->data.size(), 100u);
+}
+
+TEST_F(AlbumArtStoreTest, RemembersFilesWithoutArt)
+{
+    AlbumArtStore store(&mockMeta);
+    EXPECT_CALL(mockMeta, readAlbumArt("/bare.mp3", _)).WillOnce(Return(false));
+
+    EXPECT_EQ(store.get("/bare.mp3"), nullptr);
+    EXPECT_EQ(store.get("/bare.mp3"), nullptr);
+    EXPECT_EQ(store.size(), 0u);
+}
+
+TEST_F(AlbumArtStoreTest, SharesIdenticalCovers)
+{
+    AlbumArtStore store(&mockMeta);
+    EXPECT_CALL(mockMeta, readAlbumArt(_, _)).WillRepeatedly(DoAll(SetArgReferee<1>(makeArt(7, 1000)), Return(true)));
+
+    auto track1 = store.get("/album/1.mp3");
+    auto track2 = store.get("/album/2.mp3");
+    auto track3 = store.get("/album/3.mp3");
+
+    EXPECT_EQ(track1, track2);
+    EXPECT_EQ(track2, track3);
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_EQ(store.memoryUsage(), 1000u);
+}
+
+TEST_F(AlbumArtStoreTest, EvictsLeastRecentlyUsed)
+{
+    AlbumArtStore store(nullptr, 250);
+    store.put("/a.mp3", makeArt(1, 100));
+    store.put("/b.mp3", makeArt(2, 100));
+    store.get("/a.mp3"); // a is now newer than b
+    store.put("/c.mp3", makeArt(3, 100));
+
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_LE(store.memoryUsage(), store.capacity());
+    EXPECT_NE(store.get("/a.mp3"), nullptr);
+    EXPECT_NE(store.get("/c.mp3"), nullptr);
+    // No reader to fall back on, so the evicted image is gone
+    EXPECT_EQ(store.get("/b.mp3"), nullptr);
+}
+
+TEST_F(AlbumArtStoreTest, RereadsEvictedImages)
+{
+    AlbumArtStore store(&mockMeta, 150);
+    EXPECT_CALL(mockMeta, readAlbumArt("/a.mp3", _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgReferee<1>(makeArt(1, 100)), Return(true)));
+    EXPECT_CALL(mockMeta, readAlbumArt("/b.mp3", _)).WillOnce(DoAll(SetArgReferee<1>(makeArt(2, 100)), Return(true)));
+
+    auto held = store.get("/a.mp3");
+    store.get("/b.mp3"); // Pushes a out
+
+    // The caller's copy outlives the eviction
+    EXPECT_EQ(held->data.size(), 100u);
+    ASSERT_NE(store.get("/a.mp3"), nullptr);
+    EXPECT_EQ(store.size(), 1u);
+}
+
+TEST_F(AlbumArtStoreTest, KeepsAnOversizedImage)
+{
+    AlbumArtStore store(nullptr, 10);
+    ASSERT_NE(store.put("/big.mp3", makeArt(9, 100)), nullptr);
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_EQ(store.put("/empty.mp3", AlbumArt()), nullptr);
+}
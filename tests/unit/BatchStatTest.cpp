@@ -0,0 +1,67 @@
+#include "service/BatchStat.h"
+#include "service/LocalFileSystem.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+class BatchStatTest : public ::testing::Test
+{
+  protected:
+    std::string testDir = "tests/assets/temp_batch_stat";
+    std::vector<std::string> paths;
+
+    void SetUp() override
+    {
+        std::filesystem::create_directories(testDir);
+        // More than one ring's worth, with holes
+        for (int i = 0; i < 600; ++i)
+        {
+            std::string path = testDir + "/f" + std::to_string(i);
+            if (i % 7 != 0)
+                std::ofstream(path) << std::string(i, 'x');
+            paths.push_back(path);
+        }
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(testDir);
+    }
+
+    void expectMatchesStat(const std::vector<BatchStat::Entry> &entries)
+    {
+        LocalFileSystem fileSystem;
+        ASSERT_EQ(entries.size(), paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            FileFingerprint expected;
+            bool found = fileSystem.getFingerprint(paths[i], expected);
+            EXPECT_EQ(entries[i].found, found) << paths[i];
+            if (found)
+            {
+                EXPECT_EQ(entries[i].fingerprint, expected) << paths[i];
+                EXPECT_EQ(entries[i].fingerprint.size, i);
+            }
+        }
+    }
+};
+
+TEST_F(BatchStatTest, ThreadsMatchStat)
+{
+    BatchStat batch(BatchStat::Backend::THREADS, 4);
+    expectMatchesStat(batch.run(paths));
+    EXPECT_EQ(batch.getLastBackend(), BatchStat::Backend::THREADS);
+}
+
+TEST_F(BatchStatTest, PreferredBackendMatchesStat)
+{
+    // io_uring where the kernel allows it; either way the results must agree
+    BatchStat batch;
+    expectMatchesStat(batch.run(paths));
+}
+
+TEST_F(BatchStatTest, EmptyInput)
+{
+    BatchStat batch;
+    EXPECT_TRUE(batch.run({}).empty());
+}
@@ -0,0 +1,74 @@
+#include "utils/BoundedQueue.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(BoundedQueueTest, FifoOrder)
+{
+    BoundedQueue<int> queue(4);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_EQ(queue.size(), 2u);
+
+    int value = 0;
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 1);
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 2);
+}
+
+TEST(BoundedQueueTest, PushBlocksWhileFull)
+{
+    BoundedQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+
+    std::atomic<bool> pushed{false};
+    std::thread producer(
+        [&]()
+        {
+            queue.push(3);
+            pushed = true;
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(pushed);
+    EXPECT_EQ(queue.size(), 2u);
+
+    int value = 0;
+    queue.pop(value);
+    producer.join();
+    EXPECT_TRUE(pushed);
+    EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(BoundedQueueTest, CloseDrainsThenEnds)
+{
+    BoundedQueue<int> queue(4);
+    queue.push(7);
+    queue.close();
+
+    EXPECT_FALSE(queue.push(8));
+    int value = 0;
+    EXPECT_EQ(queue.popFor(value, std::chrono::milliseconds(10)), BoundedQueue<int>::PopResult::ITEM);
+    EXPECT_EQ(value, 7);
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_EQ(queue.popFor(value, std::chrono::milliseconds(10)), BoundedQueue<int>::PopResult::CLOSED);
+}
+
+TEST(BoundedQueueTest, PopForTimesOutWhileOpen)
+{
+    BoundedQueue<int> queue(1);
+    int value = 0;
+    EXPECT_EQ(queue.popFor(value, std::chrono::milliseconds(5)), BoundedQueue<int>::PopResult::TIMEOUT);
+}
+
+TEST(BoundedQueueTest, CloseWakesBlockedProducer)
+{
+    BoundedQueue<int> queue(1);
+    queue.push(1);
+    std::thread producer([&]() { EXPECT_FALSE(queue.push(2)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    producer.join();
+}
@@ -0,0 +1,228 @@
+#include "service/DirectoryLoader.h"
+#include "service/LocalFileSystem.h"
+#include "tests/mocks/MockFileSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace fs = std::filesystem;
+
+class DirectoryLoaderTest : public ::testing::Test
+{
+  protected:
+    std::string testDir = "tests/assets/temp_directory_loader";
+    LocalFileSystem fileSystem;
+
+    void SetUp() override
+    {
+        fs::create_directories(testDir + "/a");
+        fs::create_directories(testDir + "/b/c");
+        write(testDir + "/x.mp3");
+        write(testDir + "/a/y.flac");
+        write(testDir + "/a/cover.jpg");
+        write(testDir + "/b/c/z.mp3");
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(testDir);
+    }
+
+    void write(const std::string &path)
+    {
+        std::ofstream(path) << "data";
+    }
+
+    static std::vector<std::string> names(const std::vector<DirectoryLoader::MediaEntry> &media)
+    {
+        std::vector<std::string> result;
+        for (const auto &entry : media)
+        {
+            result.push_back(entry.info.name);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(DirectoryLoaderTest, ListsFoldersAndMediaInBackground)
+{
+    DirectoryLoader loader(&fileSystem, {".mp3", ".flac"});
+    loader.load(testDir);
+    loader.wait();
+    EXPECT_FALSE(loader.isLoading());
+
+    DirectoryLoader::Update update;
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_TRUE(update.reset);
+    EXPECT_TRUE(update.complete);
+    EXPECT_FALSE(update.fromCache);
+    EXPECT_EQ(update.path, testDir);
+    ASSERT_EQ(update.folders.size(), 2u);
+    EXPECT_EQ(names(update.media), (std::vector<std::string>{"x.mp3", "y.flac", "z.mp3"}));
+    EXPECT_EQ(update.media[0].info.extension, fs::path(update.media[0].info.path).extension().string());
+
+    // Nothing new until the next load
+    EXPECT_FALSE(loader.poll(update));
+}
+
+TEST_F(DirectoryLoaderTest, ReusesListingUntilAFolderChanges)
+{
+    DirectoryLoader loader(&fileSystem, {".mp3", ".flac"});
+    DirectoryLoader::Update update;
+    loader.load(testDir);
+    loader.wait();
+    loader.poll(update);
+    EXPECT_EQ(loader.getCachedCount(), 1u);
+
+    loader.load(testDir);
+    loader.wait();
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_TRUE(update.fromCache);
+    EXPECT_EQ(update.media.size(), 3u);
+
+    // A file added to a folder that held media changes that folder's mtime
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    write(testDir + "/b/c/new.mp3");
+    loader.load(testDir);
+    loader.wait();
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_FALSE(update.fromCache);
+    EXPECT_EQ(update.media.size(), 4u);
+
+    // Refresh always rescans
+    loader.load(testDir, true);
+    loader.wait();
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_FALSE(update.fromCache);
+}
+
+TEST_F(DirectoryLoaderTest, NoticesMediaAddedToFolderWithoutMedia)
+{
+    fs::create_directories(testDir + "/b/empty/deeper");
+    DirectoryLoader loader(&fileSystem, {".mp3", ".flac"});
+    DirectoryLoader::Update update;
+    loader.load(testDir);
+    loader.wait();
+    loader.poll(update);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    write(testDir + "/b/empty/deeper/new.mp3");
+    loader.load(testDir);
+    loader.wait();
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_FALSE(update.fromCache);
+    EXPECT_EQ(update.media.size(), 4u);
+}
+
+TEST_F(DirectoryLoaderTest, CacheKeepsMostRecentFolders)
+{
+    DirectoryLoader loader(&fileSystem, {".mp3", ".flac"}, 3, 2);
+    for (const auto &path : {testDir, testDir + "/a", testDir + "/b", testDir + "/a"})
+    {
+        loader.load(path);
+        loader.wait();
+    }
+    EXPECT_EQ(loader.getCachedCount(), 2u);
+
+    DirectoryLoader::Update update;
+    loader.load(testDir); // Evicted by the two after it
+    loader.wait();
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_FALSE(update.fromCache);
+}
+
+TEST_F(DirectoryLoaderTest, NewLoadDropsTheOneInProgress)
+{
+    NiceMock<MockFileSystem> mockFs;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::vector<std::string> slowFiles;
+    for (int i = 0; i < 1000; ++i)
+    {
+        slowFiles.push_back("/slow/" + std::to_string(i) + ".mp3");
+    }
+    ON_CALL(mockFs, scanDirectory("/slow", _, _))
+        .WillByDefault(::testing::Invoke(
+            [&](const std::string &, const std::vector<std::string> &, int)
+            {
+                entered = true;
+                while (!release)
+                {
+                    std::this_thread::yield();
+                }
+                return slowFiles;
+            }));
+    ON_CALL(mockFs, scanDirectory("/fast", _, _)).WillByDefault(Return(std::vector<std::string>{"/fast/1.mp3"}));
+
+    DirectoryLoader loader(&mockFs, {".mp3"});
+    loader.load("/slow");
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+    loader.load("/fast");
+    release = true;
+    loader.wait();
+
+    DirectoryLoader::Update update;
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_EQ(update.path, "/fast");
+    EXPECT_TRUE(update.reset);
+    EXPECT_TRUE(update.complete);
+    EXPECT_EQ(names(update.media), (std::vector<std::string>{"1.mp3"}));
+
+    // Without fingerprints there is nothing to validate a listing with
+    EXPECT_EQ(loader.getCachedCount(), 0u);
+}
+
+TEST_F(DirectoryLoaderTest, PublishesFoldersBeforeStampingThem)
+{
+    NiceMock<MockFileSystem> mockFs;
+    std::atomic<bool> stamping{false};
+    std::atomic<bool> release{false};
+    FileInfo folder;
+    folder.path = "/music/sub";
+    folder.name = "sub";
+    folder.isDirectory = true;
+    ON_CALL(mockFs, browse("/music")).WillByDefault(Return(std::vector<FileInfo>{folder}));
+    ON_CALL(mockFs, getFingerprint("/music", _)).WillByDefault(Return(true));
+    ON_CALL(mockFs, getFingerprint("/music/sub", _))
+        .WillByDefault(::testing::Invoke(
+            [&](const std::string &, FileFingerprint &)
+            {
+                stamping = true;
+                while (!release)
+                {
+                    std::this_thread::yield();
+                }
+                return true;
+            }));
+
+    DirectoryLoader loader(&mockFs, {".mp3"});
+    loader.load("/music");
+    while (!stamping)
+    {
+        std::this_thread::yield();
+    }
+
+    // The subfolder is still being stamped, yet the folders are already out
+    DirectoryLoader::Update update;
+    ASSERT_TRUE(loader.poll(update));
+    EXPECT_TRUE(update.reset);
+    EXPECT_FALSE(update.complete);
+    ASSERT_EQ(update.folders.size(), 1u);
+    EXPECT_EQ(update.folders[0].path, "/music/sub");
+    EXPECT_EQ(update.folders[0].name, "sub");
+    EXPECT_TRUE(update.folders[0].isDirectory);
+
+    release = true;
+    loader.wait();
+}
@@ -6,7 +6,10 @@
 #include "tests/mocks/MockFileSystem.h"
 #include "tests/mocks/MockPersistence.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 using ::testing::_;
 using ::testing::NiceMock;
@@ -21,6 +24,7 @@ public:
     using FileBrowserView::navigateTo;
     using FileBrowserView::navigateUp;
     using FileBrowserView::processFiles;
+    using FileBrowserView::pollDirectory;
 };
 
 class MockLibraryController : public LibraryController
@@ -29,6 +33,7 @@ class MockLibraryController : public LibraryController
     MockLibraryController() : LibraryController(nullptr, nullptr, nullptr, nullptr) {}
     MOCK_METHOD(bool, addMediaFile, (const std::string &), (override));
     MOCK_METHOD(void, addMediaFilesAsync, (const std::vector<std::string> &), (override));
+    MOCK_METHOD(bool, startDirectoryImport, (const std::string &), (override));
 MOCK_METHOD(std::unordered_set<std::string>, getAllTrackPaths, (), (const, override));
 };
 
@@ -103,6 +108,13 @@ class FileBrowserViewTest : public ::testing::Test
         return view->currentPath_;
     }
 
+    // Listing runs on the loader thread; block until it is done and apply it
+    void waitForListing()
+    {
+        view->loader_->wait();
+        view->pollDirectory();
+    }
+
     // Helper wrappers for private methods
     void navigateToHelper(const std::string &path)
     {
@@ -127,6 +139,7 @@ class FileBrowserViewTest : public ::testing::Test
     void onRefreshClickedHelper() { view->onRefreshClicked(); }
     void onHomeClickedHelper() { view->onHomeClicked(); }
     void onFolderDoubleClickedHelper(const std::string &path) { view->onFolderDoubleClicked(path); }
+    void onImportFolderClickedHelper() { view->onImportFolderClicked(); }
     void onAddSelectedClickedHelper() { view->onAddSelectedClicked(); }
     void onAddRandomClickedHelper() { view->onAddRandomClicked(); }
 };
@@ -149,9 +162,10 @@ TEST_F(FileBrowserViewTest, NavigateToChangesPathIfValid)
     EXPECT_CALL(*mockFs, isDirectory(newPath)).WillOnce(Return(true));
     // browse will be called to refresh
     EXPECT_CALL(*mockFs, browse(newPath)).WillOnce(Return(std::vector<FileInfo>{}));
-    EXPECT_CALL(*mockFs, getMediaFiles(newPath, _, _)).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_CALL(*mockFs, scanDirectory(newPath, _, _)).WillOnce(Return(std::vector<std::string>{}));
 
     navigateToHelper(newPath);
+    waitForListing();
 
     EXPECT_EQ(getCurrentPath(), newPath);
 }
@@ -175,9 +189,10 @@ TEST_F(FileBrowserViewTest, NavigateUpGoesToParent)
     // Expect checks for new path "/home/user"
     std::string parentPath = "/home/user";
     EXPECT_CALL(*mockFs, browse(parentPath)).WillOnce(Return(std::vector<FileInfo>{}));
-    EXPECT_CALL(*mockFs, getMediaFiles(parentPath, _, _)).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_CALL(*mockFs, scanDirectory(parentPath, _, _)).WillOnce(Return(std::vector<std::string>{}));
 
     navigateUpHelper();
+    waitForListing();
 
     EXPECT_EQ(getCurrentPath(), parentPath);
 }
@@ -230,6 +245,7 @@ TEST_F(FileBrowserViewTest, RenderWithFiles)
     EXPECT_CALL(*mockFs, browse(_)).WillRepeatedly(Return(files));
     
     view->show();
+    waitForListing();
     startFrame();
     view->renderPopup();
     endFrame();
@@ -257,6 +273,7 @@ TEST_F(FileBrowserViewTest, CallbackInteractions)
     EXPECT_CALL(*mockFs, isDirectory("/")).WillRepeatedly(Return(true));
     EXPECT_CALL(*mockFs, browse(_)).WillRepeatedly(Return(files));
     navigateToHelper("/");
+    waitForListing();
     
     // Select the file manually via fileSelector
     view->fileSelector_.clearSelection();
@@ -274,10 +291,11 @@ TEST_F(FileBrowserViewTest, RecursiveScanDeep)
     // Test recursive scan depth and extension filtering branches (Lines 290-312)
     EXPECT_CALL(*mockFs, exists("/music")).WillRepeatedly(Return(true));
     EXPECT_CALL(*mockFs, isDirectory("/music")).WillRepeatedly(Return(true));
-    EXPECT_CALL(*mockFs, getMediaFiles(_, _, 3))
+    EXPECT_CALL(*mockFs, scanDirectory(_, _, 3))
         .WillOnce(Return(std::vector<std::string>{"/m1.mp3", "/m2.flac"}));
     
     navigateToHelper("/music");
+    waitForListing();
     
     // Verify that currentTrackCount_ is updated
     // We can check through friend access or by rendering and seeing if a child is created.
@@ -298,10 +316,11 @@ TEST_F(FileBrowserViewTest, RandomSelection)
     for(const auto& f : files) mediaPaths.push_back(f.path);
     
     EXPECT_CALL(*mockFs, browse(_)).WillRepeatedly(Return(std::vector<FileInfo>{}));
-    EXPECT_CALL(*mockFs, getMediaFiles(_, _, 3)).WillRepeatedly(Return(mediaPaths));
+    EXPECT_CALL(*mockFs, scanDirectory(_, _, 3)).WillRepeatedly(Return(mediaPaths));
     
     view->show();
     view->navigateTo("/music");
+    waitForListing();
     
     // Simulate clicking "Add Random 20"
     // fileSelector_.selectRandom(20) is called, which we can verify
@@ -336,6 +355,7 @@ TEST_F(FileBrowserViewTest, NavigateUpEdgeCases)
     setCurrentPath("/a/b/c");
     EXPECT_CALL(*mockFs, browse("/a/b")).WillOnce(Return(std::vector<FileInfo>{}));
     navigateUpHelper();
+    waitForListing();
     EXPECT_EQ(getCurrentPath(), "/a/b");
 }
 
@@ -377,8 +397,8 @@ TEST_F(FileBrowserViewTest, SortAndDisableTracks)
     EXPECT_CALL(*mockFs, exists("/")).WillRepeatedly(Return(true));
     EXPECT_CALL(*mockFs, isDirectory("/")).WillRepeatedly(Return(true));
     
-    // Also mock getMediaFiles since browse is for folders only
-    EXPECT_CALL(*mockFs, getMediaFiles("/", _, _))
+    // Also mock the media scan since browse is for folders only
+    EXPECT_CALL(*mockFs, scanDirectory("/", _, _))
         .WillRepeatedly(Return(std::vector<std::string>{"/A.mp3", "/B.mp3", "/C.mp3"}));
 
     EXPECT_CALL(*mockLibController, getAllTrackPaths())
@@ -386,6 +406,7 @@ TEST_F(FileBrowserViewTest, SortAndDisableTracks)
     
     view->show(); 
     view->navigateTo("/"); // Trigger refresh with new mock expectations
+    waitForListing();
     
     const auto& disabled = view->fileSelector_.getDisabledItems();
     EXPECT_EQ(disabled.size(), 2);
@@ -394,6 +415,36 @@ TEST_F(FileBrowserViewTest, SortAndDisableTracks)
     EXPECT_FALSE(disabled.count("/B.mp3"));
 }
 
+TEST_F(FileBrowserViewTest, LibraryPathsFetchedOncePerListing)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < 1000; ++i)
+    {
+        paths.push_back("/many/" + std::to_string(1000 + i) + ".mp3");
+    }
+    EXPECT_CALL(*mockFs, exists("/many")).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mockFs, isDirectory("/many")).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mockFs, scanDirectory("/many", _, _)).WillRepeatedly(Return(paths));
+    EXPECT_CALL(*mockLibController, getAllTrackPaths())
+        .WillOnce(Return(std::unordered_set<std::string>{"/many/1000.mp3"}));
+
+    // Every batch the loader hands over is merged in without asking the library again
+    view->navigateTo("/many");
+    waitForListing();
+    while (view->pollDirectory())
+    {
+    }
+
+    const auto &items = view->fileSelector_.getItems();
+    ASSERT_EQ(items.size(), 1000u);
+    EXPECT_EQ(view->currentTrackCount_, 1000);
+    EXPECT_EQ(items.front().name, "1001.mp3");
+    EXPECT_EQ(items.back().name, "1000.mp3");
+    EXPECT_TRUE(std::is_sorted(items.begin(), items.end() - 1,
+                               [](const FileInfo &a, const FileInfo &b) { return a.name < b.name; }));
+    EXPECT_TRUE(view->fileSelector_.getDisabledItems().count("/many/1000.mp3"));
+}
+
 TEST_F(FileBrowserViewTest, AsyncAddWithLibraryMode)
 {
     std::vector<FileInfo> files;
@@ -403,6 +454,7 @@ TEST_F(FileBrowserViewTest, AsyncAddWithLibraryMode)
     EXPECT_CALL(*mockFs, browse(_)).WillRepeatedly(Return(files));
     
     view->show();
+    waitForListing();
     
     // Select the file
     view->fileSelector_.clearSelection();
@@ -422,6 +474,7 @@ TEST_F(FileBrowserViewTest, EventHandlersExhaustive)
     onRefreshClickedHelper();
     onHomeClickedHelper();
     onFolderDoubleClickedHelper("/home");
+    waitForListing();
 
     // 2. Playback/Selection modes
     view->setMode(FileBrowserView::BrowserMode::PLAYLIST_SELECTION);
@@ -473,3 +526,37 @@ TEST_F(FileBrowserViewTest, CanonicalPathFailures)
     // Let's use a path that is known to fail canonicalization if possible, like something with too many slashes?
     // Or just rely on the fact that we hit the loop.
 }
+
+TEST_F(FileBrowserViewTest, ImportFolderStartsBackgroundImport)
+{
+    view->currentPath_ = "/music";
+
+    EXPECT_CALL(*mockLibController, startDirectoryImport("/music")).WillOnce(Return(true));
+    onImportFolderClickedHelper();
+}
+
+TEST_F(FileBrowserViewTest, ListingDoesNotBlockTheUiThread)
+{
+    std::atomic<bool> release{false};
+    EXPECT_CALL(*mockFs, scanDirectory(_, _, 3))
+        .WillOnce(::testing::Invoke(
+            [&release](const std::string &, const std::vector<std::string> &, int)
+            {
+                while (!release)
+                {
+                    std::this_thread::yield();
+                }
+                return std::vector<std::string>{"/slow/a.mp3", "/slow/b.mp3"};
+            }));
+
+    // show() returns and frames render while the scan is still running
+    view->show();
+    startFrame();
+    view->render();
+    endFrame();
+    EXPECT_EQ(view->currentTrackCount_, 0);
+
+    release = true;
+    waitForListing();
+    EXPECT_EQ(view->currentTrackCount_, 2);
+}
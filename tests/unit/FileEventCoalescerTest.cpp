@@ -0,0 +1,80 @@
+#include "service/FileEventCoalescer.h"
+#include <gtest/gtest.h>
+
+using Kind = FileEvent::Kind;
+using std::chrono::milliseconds;
+
+class FileEventCoalescerTest : public ::testing::Test
+{
+  protected:
+    FileEventCoalescer coalescer{milliseconds(500), milliseconds(5000)};
+    FileEventCoalescer::Clock::time_point t0 = FileEventCoalescer::Clock::now();
+};
+
+TEST_F(FileEventCoalescerTest, WaitsForQuietPeriod)
+{
+    EXPECT_FALSE(coalescer.ready(t0));
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/a.mp3", false}, t0);
+    EXPECT_FALSE(coalescer.ready(t0 + milliseconds(499)));
+
+    // Every new event pushes the batch back
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/b.mp3", false}, t0 + milliseconds(400));
+    EXPECT_FALSE(coalescer.ready(t0 + milliseconds(600)));
+    EXPECT_TRUE(coalescer.ready(t0 + milliseconds(900)));
+    EXPECT_EQ(coalescer.take().size(), 2u);
+    EXPECT_TRUE(coalescer.empty());
+}
+
+TEST_F(FileEventCoalescerTest, LongBurstIsReleasedAfterMaxDelay)
+{
+    // A copy that never pauses for the quiet period
+    for (int i = 0; i <= 60; ++i)
+    {
+        coalescer.add(FileEvent{Kind::CHANGED, "/m/" + std::to_string(i) + ".mp3", false},
+                      t0 + milliseconds(100 * i));
+    }
+    EXPECT_EQ(coalescer.deadline(), t0 + milliseconds(5000));
+    EXPECT_TRUE(coalescer.ready(t0 + milliseconds(6000)));
+    EXPECT_EQ(coalescer.take().size(), 61u);
+}
+
+TEST_F(FileEventCoalescerTest, LatestEventPerPathWins)
+{
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/a.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/a.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::REMOVED, "/m/b.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/b.mp3", false}, t0); // Replaced in place
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/c.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::REMOVED, "/m/c.mp3", false}, t0); // Temporary file
+
+    std::vector<FileEvent> expected = {FileEvent{Kind::REMOVED, "/m/c.mp3", false},
+                                       FileEvent{Kind::CHANGED, "/m/a.mp3", false},
+                                       FileEvent{Kind::CHANGED, "/m/b.mp3", false}};
+    EXPECT_EQ(coalescer.take(), expected);
+}
+
+TEST_F(FileEventCoalescerTest, RemovedFolderSwallowsEventsBelowIt)
+{
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/album/1.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/album/disc2/1.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/album2/1.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/album.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::REMOVED, "/m/album", true}, t0);
+
+    std::vector<FileEvent> expected = {FileEvent{Kind::REMOVED, "/m/album", true},
+                                       FileEvent{Kind::CHANGED, "/m/album.mp3", false},
+                                       FileEvent{Kind::CHANGED, "/m/album2/1.mp3", false}};
+    EXPECT_EQ(coalescer.take(), expected);
+}
+
+TEST_F(FileEventCoalescerTest, RescansComeFirstAndOncePerFolder)
+{
+    coalescer.add(FileEvent{Kind::CHANGED, "/m/a.mp3", false}, t0);
+    coalescer.add(FileEvent{Kind::RESCAN, "/m", true}, t0);
+    coalescer.add(FileEvent{Kind::RESCAN, "/m", true}, t0);
+
+    std::vector<FileEvent> batch = coalescer.take();
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch[0], (FileEvent{Kind::RESCAN, "/m", true}));
+    EXPECT_EQ(batch[1], (FileEvent{Kind::CHANGED, "/m/a.mp3", false}));
+}
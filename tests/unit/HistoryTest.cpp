@@ -1,4 +1,5 @@
 #include "app/model/History.h"
+#include "tests/mocks/MemoryPersistence.h"
 #include "tests/mocks/MockPersistence.h"
 #include <gtest/gtest.h>
 
@@ -315,3 +316,35 @@ TEST_F(HistoryTest, GetRecentLimitedCount)
     EXPECT_EQ(recent.size(), 3);
 }
 
+
+TEST_F(HistoryTest, JournalAppendsInsteadOfRewriting)
+{
+    MemoryPersistence disk;
+    {
+        History history(3, &disk);
+        history.enableJournal();
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_TRUE(history.addTrack(std::make_shared<MediaFile>("/" + std::to_string(i) + ".mp3")));
+        }
+        history.addTrack(std::make_shared<MediaFile>("/2.mp3"));
+        history.removeTrackByPath("/3.mp3");
+    }
+    EXPECT_EQ(disk.saveCount(), 0);
+    EXPECT_EQ(disk.appendCount(), 7);
+
+    History restored(3, &disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.size(), 3);
+    EXPECT_EQ(restored.getTrack(0)->getPath(), "/2.mp3");
+    EXPECT_EQ(restored.getTrack(1)->getPath(), "/4.mp3");
+    EXPECT_EQ(restored.getTrack(2)->getPath(), "/1.mp3");
+
+    // Compaction folds the journal into history.json
+    EXPECT_TRUE(restored.save());
+    EXPECT_EQ(disk.contents("history.journal"), "");
+    History reloaded(3, &disk);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.getTrack(0)->getPath(), "/2.mp3");
+}
@@ -1,5 +1,6 @@
 
 #include "service/HybridMetadataReader.h"
+#include "tests/mocks/MockFileSystem.h"
 #include "tests/mocks/MockMetadataReader.h"
 #include <gtest/gtest.h>
 
@@ -143,3 +144,177 @@ TEST_F(HybridMetadataReaderTest, SupportsEditing)
     EXPECT_CALL(*secondaryMock, supportsEditing("c.txt")).WillOnce(Return(false));
     EXPECT_FALSE(reader->supportsEditing("c.txt"));
 }
+
+TEST_F(HybridMetadataReaderTest, SharedSecondaryServesSeveralReaders)
+{
+    auto shared = std::make_shared<NiceMock<MockMetadataReader>>();
+    MediaMetadata probed;
+    probed.duration = 42;
+    EXPECT_CALL(*shared, readMetadata(_)).Times(2).WillRepeatedly(Return(probed));
+
+    HybridMetadataReader first(std::make_unique<NiceMock<MockMetadataReader>>(), shared);
+    HybridMetadataReader second(std::make_unique<NiceMock<MockMetadataReader>>(), shared);
+
+    EXPECT_EQ(first.readMetadata("a.mkv").duration, 42);
+    EXPECT_EQ(second.readMetadata("b.mkv").duration, 42);
+}
+
+TEST_F(HybridMetadataReaderTest, ReadAlbumArtFallsBackToSecondary)
+{
+    AlbumArt art;
+    EXPECT_CALL(*primaryMock, readAlbumArt("a.mp3", _)).WillOnce(Return(true));
+    EXPECT_CALL(*secondaryMock, readAlbumArt("a.mp3", _)).Times(0);
+    EXPECT_TRUE(reader->readAlbumArt("a.mp3", art));
+
+    EXPECT_CALL(*primaryMock, readAlbumArt("b.mkv", _)).WillOnce(Return(false));
+    EXPECT_CALL(*secondaryMock, readAlbumArt("b.mkv", _)).WillOnce(Return(false));
+    EXPECT_FALSE(reader->readAlbumArt("b.mkv", art));
+}
+
+TEST(HybridMetadataReaderFastTierTest, FastTierAnswersWithoutFallback)
+{
+    auto fast = std::make_unique<NiceMock<MockMetadataReader>>();
+    auto primary = std::make_unique<NiceMock<MockMetadataReader>>();
+    auto secondary = std::make_shared<NiceMock<MockMetadataReader>>();
+    MediaMetadata meta;
+    meta.duration = 180;
+    meta.title = "Fast Title";
+    EXPECT_CALL(*fast, readMetadata("song.flac")).WillOnce(Return(meta));
+    EXPECT_CALL(*primary, readMetadata(_)).Times(0);
+    EXPECT_CALL(*secondary, readMetadata(_)).Times(0);
+
+    HybridMetadataReader reader(std::move(fast), std::move(primary), secondary);
+    MediaMetadata result = reader.readMetadata("song.flac");
+    EXPECT_EQ(result.duration, 180);
+    EXPECT_EQ(result.title, "Fast Title");
+}
+
+TEST(HybridMetadataReaderFastTierTest, FastTierMissFallsThroughToPrimary)
+{
+    auto fast = std::make_unique<NiceMock<MockMetadataReader>>();
+    auto primary = std::make_unique<NiceMock<MockMetadataReader>>();
+    auto secondary = std::make_shared<NiceMock<MockMetadataReader>>();
+    MediaMetadata meta;
+    meta.duration = 90;
+    meta.title = "Primary Title";
+    EXPECT_CALL(*fast, readMetadata("song.wav")).WillOnce(Return(MediaMetadata()));
+    EXPECT_CALL(*primary, readMetadata("song.wav")).WillOnce(Return(meta));
+    EXPECT_CALL(*secondary, readMetadata(_)).Times(0);
+    EXPECT_CALL(*fast, extractTags("song.wav", _)).WillOnce(Return(std::map<std::string, std::string>()));
+    EXPECT_CALL(*primary, extractTags("song.wav", _))
+        .WillOnce(Return(std::map<std::string, std::string>{{"title", "Primary Title"}}));
+
+    HybridMetadataReader reader(std::move(fast), std::move(primary), secondary);
+    EXPECT_EQ(reader.readMetadata("song.wav").title, "Primary Title");
+    EXPECT_EQ(reader.extractTags("song.wav", {"title"})["title"], "Primary Title");
+}
+
+TEST_F(HybridMetadataReaderTest, SecondaryOnlyFormatsSkipPrimary)
+{
+    reader->setSecondaryOnlyFormats({".mkv"});
+    MediaMetadata videoMeta;
+    videoMeta.duration = 3600;
+
+    EXPECT_CALL(*primaryMock, readMetadata(_)).Times(0);
+    EXPECT_CALL(*secondaryMock, readMetadata("/videos/Film.MKV")).WillOnce(Return(videoMeta));
+
+    EXPECT_EQ(reader->readMetadata("/videos/Film.MKV").duration, 3600);
+    EXPECT_EQ(reader->getStats().routed, 1u);
+    EXPECT_EQ(reader->getStats().secondary.hits, 1u);
+}
+
+TEST_F(HybridMetadataReaderTest, CountsHitsAndMissesPerTier)
+{
+    MediaMetadata good;
+    good.duration = 10;
+    EXPECT_CALL(*primaryMock, readMetadata("good.mp3")).WillOnce(Return(good));
+    EXPECT_CALL(*primaryMock, readMetadata("bad.mp3")).WillOnce(Return(MediaMetadata()));
+    EXPECT_CALL(*secondaryMock, readMetadata("bad.mp3")).WillOnce(Return(MediaMetadata()));
+
+    reader->readMetadata("good.mp3");
+    reader->readMetadata("bad.mp3");
+
+    const HybridReaderStats &stats = reader->getStats();
+    EXPECT_EQ(stats.primary.hits, 1u);
+    EXPECT_EQ(stats.primary.misses, 1u);
+    EXPECT_EQ(stats.secondary.hits, 0u);
+    EXPECT_EQ(stats.secondary.misses, 1u);
+    EXPECT_EQ(stats.fast.hits + stats.fast.misses, 0u);
+}
+
+TEST_F(HybridMetadataReaderTest, UnreadableFilesAreNotProbedTwice)
+{
+    NiceMock<MockFileSystem> fileSystem;
+    FileFingerprint fingerprint;
+    fingerprint.inode = 99;
+    ON_CALL(fileSystem, getFingerprint("broken.mp3", _))
+        .WillByDefault(::testing::DoAll(::testing::SetArgReferee<1>(fingerprint), Return(true)));
+    auto cache = std::make_shared<UnreadableFileCache>(nullptr, &fileSystem);
+    reader->setUnreadableCache(cache);
+
+    EXPECT_CALL(*primaryMock, readMetadata("broken.mp3")).Times(1).WillOnce(Return(MediaMetadata()));
+    EXPECT_CALL(*secondaryMock, readMetadata("broken.mp3")).Times(1).WillOnce(Return(MediaMetadata()));
+
+    EXPECT_EQ(reader->readMetadata("broken.mp3").duration, 0);
+    EXPECT_EQ(reader->readMetadata("broken.mp3").duration, 0);
+    EXPECT_EQ(reader->getStats().knownUnreadable, 1u);
+}
+
+TEST_F(HybridMetadataReaderTest, TaggedFilesWithoutDurationAreNotCached)
+{
+    NiceMock<MockFileSystem> fileSystem;
+    FileFingerprint fingerprint;
+    fingerprint.inode = 99;
+    ON_CALL(fileSystem, getFingerprint("blip.mp3", _))
+        .WillByDefault(::testing::DoAll(::testing::SetArgReferee<1>(fingerprint), Return(true)));
+    auto cache = std::make_shared<UnreadableFileCache>(nullptr, &fileSystem);
+    reader->setUnreadableCache(cache);
+
+    // Under a second long: tags but no duration
+    MediaMetadata tagged;
+    tagged.title = "Blip";
+    EXPECT_CALL(*primaryMock, readMetadata("blip.mp3")).Times(2).WillRepeatedly(Return(tagged));
+
+    EXPECT_EQ(reader->readMetadata("blip.mp3").title, "Blip");
+    EXPECT_FALSE(cache->isKnownUnreadable("blip.mp3"));
+    EXPECT_EQ(reader->readMetadata("blip.mp3").title, "Blip");
+    EXPECT_EQ(reader->getStats().knownUnreadable, 0u);
+}
+
+TEST_F(HybridMetadataReaderTest, RetryableFailuresAreNotCached)
+{
+    NiceMock<MockFileSystem> fileSystem;
+    FileFingerprint fingerprint;
+    fingerprint.inode = 99;
+    ON_CALL(fileSystem, getFingerprint("slow.mkv", _))
+        .WillByDefault(::testing::DoAll(::testing::SetArgReferee<1>(fingerprint), Return(true)));
+    auto cache = std::make_shared<UnreadableFileCache>(nullptr, &fileSystem);
+    reader->setUnreadableCache(cache);
+
+    MediaMetadata timedOut;
+    timedOut.retryable = true;
+    MediaMetadata loaded;
+    loaded.duration = 60;
+    EXPECT_CALL(*secondaryMock, readMetadata("slow.mkv")).WillOnce(Return(timedOut)).WillOnce(Return(loaded));
+
+    EXPECT_TRUE(reader->readMetadata("slow.mkv").retryable);
+    EXPECT_FALSE(cache->isKnownUnreadable("slow.mkv"));
+    EXPECT_EQ(reader->readMetadata("slow.mkv").duration, 60);
+    EXPECT_EQ(reader->getStats().knownUnreadable, 0u);
+}
+
+TEST(HybridMetadataReaderStatsTest, ReadersShareInjectedStats)
+{
+    auto stats = std::make_shared<HybridReaderStats>();
+    MediaMetadata meta;
+    meta.duration = 5;
+    for (int i = 0; i < 2; ++i)
+    {
+        auto primary = std::make_unique<NiceMock<MockMetadataReader>>();
+        ON_CALL(*primary, readMetadata(_)).WillByDefault(Return(meta));
+        HybridMetadataReader reader(std::move(primary), std::make_shared<NiceMock<MockMetadataReader>>());
+        reader.setStats(stats);
+        reader.readMetadata("song.mp3");
+    }
+    EXPECT_EQ(stats->primary.hits, 2u);
+}
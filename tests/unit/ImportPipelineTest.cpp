@@ -0,0 +1,289 @@
+#include "app/controller/ImportPipeline.h"
+#include "service/LocalFileSystem.h"
+#include "tests/mocks/MockFileSystem.h"
+#include "tests/mocks/MockMetadataReader.h"
+#include "tests/mocks/MockPersistence.h"
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class ImportPipelineTest : public ::testing::Test
+{
+  protected:
+    NiceMock<MockFileSystem> mockFs;
+    NiceMock<MockMetadataReader> mockMeta;
+    NiceMock<MockPersistence> mockPersist;
+    std::unique_ptr<Library> library;
+
+    void SetUp() override
+    {
+        library = std::make_unique<Library>(&mockPersist);
+    }
+
+    static std::vector<std::string> makePaths(int count)
+    {
+        std::vector<std::string> paths;
+        for (int i = 0; i < count; ++i)
+        {
+            paths.push_back("/music/" + std::to_string(i) + ".mp3");
+        }
+        return paths;
+    }
+
+    ImportPipeline::Options smallOptions()
+    {
+        ImportPipeline::Options options;
+        options.readers = 2;
+        options.queueCapacity = 8;
+        options.batchSize = 100;
+        return options;
+    }
+};
+
+TEST_F(ImportPipelineTest, ImportsEveryFileInBatches)
+{
+    EXPECT_CALL(mockFs, scanDirectory("/music", _, -1)).WillOnce(Return(makePaths(1000)));
+    EXPECT_CALL(mockMeta, readMetadata(_)).Times(1000).WillRepeatedly(Return(MediaMetadata()));
+
+    ImportPipeline pipeline(library.get(), &mockFs, &mockMeta, smallOptions());
+    std::vector<ImportProgress> reports;
+    pipeline.setProgressCallback([&](const ImportProgress &progress) { reports.push_back(progress); });
+    ASSERT_TRUE(pipeline.start("/music", {".mp3"}));
+    EXPECT_FALSE(pipeline.start("/music", {".mp3"}));
+    pipeline.wait();
+
+    EXPECT_EQ(library->size(), 1000u);
+    ImportProgress progress = pipeline.getProgress();
+    EXPECT_EQ(progress.discovered, 1000u);
+    EXPECT_EQ(progress.processed, 1000u);
+    EXPECT_EQ(progress.added, 1000u);
+    EXPECT_FALSE(progress.running);
+    EXPECT_FALSE(progress.cancelled);
+
+    // One report per committed batch (at most ten of them) plus the final one
+    ASSERT_GE(reports.size(), 2u);
+    EXPECT_LE(reports.size(), 11u);
+    EXPECT_FALSE(reports.back().running);
+    EXPECT_EQ(reports.back().added, 1000u);
+}
+
+TEST_F(ImportPipelineTest, SkipsKnownAndUnsupportedFiles)
+{
+    library->addMedia(std::make_shared<MediaFile>("/music/known.mp3"));
+    EXPECT_CALL(mockFs, scanDirectory(_, _, _))
+        .WillOnce(Return(std::vector<std::string>{"/music/known.mp3", "/music/notes.txt", "/music/new.mp3"}));
+    EXPECT_CALL(mockMeta, readMetadata("/music/known.mp3")).Times(0);
+    EXPECT_CALL(mockMeta, readMetadata("/music/new.mp3")).WillOnce(Return(MediaMetadata()));
+
+    ImportPipeline pipeline(library.get(), &mockFs, &mockMeta, smallOptions());
+    ASSERT_TRUE(pipeline.start("/music", {".mp3"}));
+    pipeline.wait();
+
+    EXPECT_EQ(pipeline.getProgress().added, 1u);
+    EXPECT_EQ(pipeline.getProgress().processed, 3u);
+    EXPECT_EQ(library->size(), 2u);
+}
+
+TEST_F(ImportPipelineTest, ScannerWaitsForSlowReaders)
+{
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    EXPECT_CALL(mockFs, scanDirectory(_, _, _)).WillOnce(Return(makePaths(200)));
+    EXPECT_CALL(mockMeta, readMetadata(_))
+        .WillRepeatedly(::testing::Invoke(
+            [gate](const std::string &)
+            {
+                gate.wait();
+                return MediaMetadata();
+            }));
+
+    ImportPipeline::Options options = smallOptions();
+    ImportPipeline pipeline(library.get(), &mockFs, &mockMeta, options);
+    ASSERT_TRUE(pipeline.start("/music", {".mp3"}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Blocked readers hold one path each; the queue holds the rest
+    EXPECT_LE(pipeline.getProgress().discovered, options.queueCapacity + options.readers);
+    EXPECT_TRUE(pipeline.getProgress().running);
+
+    release.set_value();
+    pipeline.wait();
+    EXPECT_EQ(library->size(), 200u);
+}
+
+TEST_F(ImportPipelineTest, CancelStopsWithoutReadingEverything)
+{
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    EXPECT_CALL(mockFs, scanDirectory(_, _, _)).WillOnce(Return(makePaths(5000)));
+    EXPECT_CALL(mockMeta, readMetadata(_))
+        .WillRepeatedly(::testing::Invoke(
+            [gate](const std::string &)
+            {
+                gate.wait();
+                return MediaMetadata();
+            }));
+
+    ImportPipeline pipeline(library.get(), &mockFs, &mockMeta, smallOptions());
+    ASSERT_TRUE(pipeline.start("/music", {".mp3"}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pipeline.cancel();
+    release.set_value();
+    pipeline.wait();
+
+    ImportProgress progress = pipeline.getProgress();
+    EXPECT_TRUE(progress.cancelled);
+    EXPECT_FALSE(progress.running);
+    EXPECT_LT(progress.discovered, 5000u);
+    // Files already read when the cancel arrived are still committed
+    EXPECT_EQ(library->size(), progress.added);
+    EXPECT_LE(progress.added, 2u);
+}
+
+TEST_F(ImportPipelineTest, RefusesToStartWithoutDependencies)
+{
+    ImportPipeline pipeline(nullptr, &mockFs, &mockMeta);
+    EXPECT_FALSE(pipeline.start("/music", {".mp3"}));
+    pipeline.wait();
+}
+
+TEST_F(ImportPipelineTest, CommitsInSourceOrderDespiteUnevenReads)
+{
+    std::vector<std::string> paths = makePaths(40);
+    EXPECT_CALL(mockMeta, readMetadata(_))
+        .WillRepeatedly(::testing::Invoke(
+            [](const std::string &path)
+            {
+                // Early files are the slowest, so later ones finish first
+                int index = std::stoi(path.substr(path.rfind('/') + 1));
+                std::this_thread::sleep_for(std::chrono::microseconds((40 - index) * 200));
+                return MediaMetadata();
+            }));
+
+    ImportPipeline::Options options = smallOptions();
+    options.readers = 4;
+    options.batchSize = 7;
+    ImportPipeline pipeline(library.get(), nullptr, &mockMeta, options);
+    ASSERT_TRUE(pipeline.start(paths));
+    pipeline.wait();
+
+    ASSERT_EQ(library->size(), paths.size());
+    std::vector<std::string> committed;
+    for (const auto &file : library->getAll())
+    {
+        committed.push_back(file->getPath());
+    }
+    EXPECT_EQ(committed, paths);
+}
+
+TEST_F(ImportPipelineTest, SlowReadHoldsBackReadersWithinWindow)
+{
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> reads{0};
+    EXPECT_CALL(mockMeta, readMetadata(_))
+        .WillRepeatedly(::testing::Invoke(
+            [gate, &reads](const std::string &path)
+            {
+                reads++;
+                if (path == "/music/0.mp3")
+                    gate.wait(); // A probe stuck on its timeout
+                return MediaMetadata();
+            }));
+
+    ImportPipeline::Options options = smallOptions();
+    options.readers = 4;
+    options.reorderWindow = 16;
+    ImportPipeline pipeline(library.get(), nullptr, &mockMeta, options);
+    ASSERT_TRUE(pipeline.start(makePaths(200)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Paths 0..15 at most; the rest wait for the first one to be committed
+    EXPECT_LE(reads.load(), 16);
+    EXPECT_EQ(library->size(), 0u);
+
+    release.set_value();
+    pipeline.wait();
+    EXPECT_EQ(library->size(), 200u);
+    EXPECT_EQ(reads.load(), 200);
+}
+
+TEST_F(ImportPipelineTest, EachWorkerGetsItsOwnReader)
+{
+    std::atomic<int> created{0};
+    ImportPipeline::Options options = smallOptions();
+    options.readers = 3;
+    options.readerFactory = [&created]() -> std::unique_ptr<IMetadataReader>
+    {
+        created++;
+        auto reader = std::make_unique<NiceMock<MockMetadataReader>>();
+        ON_CALL(*reader, readMetadata(_)).WillByDefault(Return(MediaMetadata()));
+        return reader;
+    };
+    EXPECT_CALL(mockMeta, readMetadata(_)).Times(0);
+
+    ImportPipeline pipeline(library.get(), nullptr, &mockMeta, options);
+    ASSERT_TRUE(pipeline.start(makePaths(30)));
+    pipeline.wait();
+
+    EXPECT_EQ(created.load(), 3);
+    EXPECT_EQ(library->size(), 30u);
+}
+
+TEST_F(ImportPipelineTest, ShortListsUseFewerWorkers)
+{
+    std::atomic<int> created{0};
+    ImportPipeline::Options options = smallOptions();
+    options.readers = 8;
+    options.readerFactory = [&created]() -> std::unique_ptr<IMetadataReader>
+    {
+        created++;
+        return nullptr; // Falls back to the shared reader
+    };
+    EXPECT_CALL(mockMeta, readMetadata(_)).Times(2).WillRepeatedly(Return(MediaMetadata()));
+
+    ImportPipeline pipeline(library.get(), nullptr, &mockMeta, options);
+    ASSERT_TRUE(pipeline.start(std::vector<std::string>{"/a.mp3", "/b.mp3"}));
+    pipeline.wait();
+
+    EXPECT_EQ(created.load(), 2);
+    EXPECT_EQ(library->size(), 2u);
+}
+
+TEST_F(ImportPipelineTest, ImportsEveryFileOfParallelScan)
+{
+    // Several walker threads call the sink at once
+    std::string root = "tests/assets/temp_import_parallel";
+    for (int dir = 0; dir < 8; ++dir)
+    {
+        std::string folder = root + "/" + std::to_string(dir) + "/inner";
+        std::filesystem::create_directories(folder);
+        for (int i = 0; i < 50; ++i)
+        {
+            std::ofstream(folder + "/" + std::to_string(i) + ".mp3").close();
+        }
+    }
+    EXPECT_CALL(mockMeta, readMetadata(_)).Times(400).WillRepeatedly(Return(MediaMetadata()));
+
+    LocalFileSystem parallel(LocalFileSystem::ScanMode::PARALLEL, 4);
+    ImportPipeline pipeline(library.get(), &parallel, &mockMeta, smallOptions());
+    size_t committedWhileRunning = 0;
+    pipeline.setProgressCallback(
+        [&](const ImportProgress &progress)
+        {
+            if (progress.running)
+                committedWhileRunning = progress.added;
+        });
+    ASSERT_TRUE(pipeline.start(root, {".mp3"}));
+    pipeline.wait();
+    std::filesystem::remove_all(root);
+
+    EXPECT_EQ(library->size(), 400u);
+    EXPECT_EQ(pipeline.getProgress().added, 400u);
+    EXPECT_GT(committedWhileRunning, 0u); // Batches went out during the scan, not all at the end
+}
@@ -0,0 +1,155 @@
+#include "service/InotifyWatcher.h"
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+using Kind = FileEvent::Kind;
+namespace fs = std::filesystem;
+
+class InotifyWatcherTest : public ::testing::Test
+{
+  protected:
+    std::string testDir = fs::absolute("tests/assets/temp_inotify").string();
+    InotifyWatcher watcher{{".mp3", ".flac"}, std::chrono::milliseconds(50), std::chrono::milliseconds(1000)};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<FileEvent> received;
+
+    void SetUp() override
+    {
+        fs::remove_all(testDir);
+        fs::create_directories(testDir + "/album");
+    }
+
+    void TearDown() override
+    {
+        watcher.stop();
+        fs::remove_all(testDir);
+    }
+
+    bool startWatching()
+    {
+        watcher.addRoot(testDir);
+        return watcher.start(
+            [this](const std::vector<FileEvent> &batch)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                received.insert(received.end(), batch.begin(), batch.end());
+                cv.notify_all();
+            });
+    }
+
+    bool waitFor(const FileEvent &event)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5),
+                           [&]() { return std::find(received.begin(), received.end(), event) != received.end(); });
+    }
+
+    // The watches are set up on the watcher thread after start() and addRoot() return
+    bool waitForWatchCount(size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (watcher.getWatchCount() != count)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void write(const std::string &path)
+    {
+        std::ofstream(path) << "data";
+    }
+};
+
+TEST_F(InotifyWatcherTest, ReportsWrittenAndDeletedFiles)
+{
+    if (!startWatching())
+    {
+        GTEST_SKIP() << "inotify not available";
+    }
+    ASSERT_TRUE(waitForWatchCount(2u));
+
+    write(testDir + "/album/song.mp3");
+    write(testDir + "/album/cover.jpg"); // Filtered out
+    ASSERT_TRUE(waitFor(FileEvent{Kind::CHANGED, testDir + "/album/song.mp3", false}));
+
+    fs::remove(testDir + "/album/song.mp3");
+    ASSERT_TRUE(waitFor(FileEvent{Kind::REMOVED, testDir + "/album/song.mp3", false}));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &event : received)
+    {
+        EXPECT_EQ(event.path.find("cover.jpg"), std::string::npos);
+    }
+}
+
+TEST_F(InotifyWatcherTest, FollowsNewAndRemovedFolders)
+{
+    if (!startWatching())
+    {
+        GTEST_SKIP() << "inotify not available";
+    }
+    ASSERT_TRUE(waitForWatchCount(2u));
+
+    // Moving a finished folder in is how most copy tools end
+    std::string staging = fs::absolute("tests/assets/temp_inotify_staging").string();
+    fs::create_directories(staging);
+    write(staging + "/track.flac");
+    fs::rename(staging, testDir + "/new_album");
+    ASSERT_TRUE(waitFor(FileEvent{Kind::CHANGED, testDir + "/new_album", true}));
+
+    // The new folder is watched too
+    write(testDir + "/new_album/bonus.mp3");
+    ASSERT_TRUE(waitFor(FileEvent{Kind::CHANGED, testDir + "/new_album/bonus.mp3", false}));
+    EXPECT_EQ(watcher.getWatchCount(), 3u);
+
+    fs::remove_all(testDir + "/album");
+    ASSERT_TRUE(waitFor(FileEvent{Kind::REMOVED, testDir + "/album", true}));
+    EXPECT_EQ(watcher.getWatchCount(), 2u);
+}
+
+TEST_F(InotifyWatcherTest, NoCallbackAfterStop)
+{
+    if (!startWatching())
+    {
+        GTEST_SKIP() << "inotify not available";
+    }
+    watcher.stop();
+    EXPECT_EQ(watcher.getWatchCount(), 0u);
+
+    write(testDir + "/album/late.mp3");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(received.empty());
+}
+
+TEST_F(InotifyWatcherTest, WatchesRootsAddedLaterAndAfterRestart)
+{
+    if (!startWatching())
+    {
+        GTEST_SKIP() << "inotify not available";
+    }
+    ASSERT_TRUE(waitForWatchCount(2u));
+
+    std::string other = fs::absolute("tests/assets/temp_inotify_other").string();
+    fs::create_directories(other + "/disc1");
+    EXPECT_TRUE(watcher.addRoot(other));
+    EXPECT_TRUE(watcher.addRoot(testDir + "/album")); // Already covered
+    ASSERT_TRUE(waitForWatchCount(4u));
+
+    watcher.stop();
+    EXPECT_EQ(watcher.getWatchCount(), 0u);
+    ASSERT_TRUE(watcher.start([](const std::vector<FileEvent> &) {}));
+    EXPECT_TRUE(waitForWatchCount(4u));
+
+    watcher.stop();
+    fs::remove_all(other);
+}
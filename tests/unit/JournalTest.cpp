@@ -0,0 +1,111 @@
+#include "utils/Journal.h"
+#include "tests/mocks/MemoryPersistence.h"
+#include <gtest/gtest.h>
+
+class JournalTest : public ::testing::Test
+{
+  protected:
+    MemoryPersistence persistence;
+    int baseWrites = 0;
+
+    Journal::BaseWriter countingWriter()
+    {
+        return [this]()
+        {
+            baseWrites++;
+            return true;
+        };
+    }
+};
+
+TEST_F(JournalTest, AppendsOneLinePerRecord)
+{
+    Journal journal(&persistence, "j.log", countingWriter());
+    EXPECT_TRUE(journal.append({{"op", "add"}, {"n", 1}}));
+    EXPECT_TRUE(journal.append({{"op", "add"}, {"n", 2}}));
+
+    EXPECT_EQ(journal.pending(), 2);
+    EXPECT_EQ(persistence.appendCount(), 2);
+    EXPECT_EQ(persistence.saveCount(), 0);
+    EXPECT_EQ(persistence.contents("j.log"), "{\"n\":1,\"op\":\"add\"}\n{\"n\":2,\"op\":\"add\"}\n");
+}
+
+TEST_F(JournalTest, ReplayStopsAtTornRecord)
+{
+    persistence.saveToFile("j.log", "{\"n\":1}\n\n{\"n\":2}\n{\"n\":3,\"op\":");
+
+    Journal journal(&persistence, "j.log", countingWriter());
+    std::vector<int> seen;
+    EXPECT_EQ(journal.replay([&](const nlohmann::json &r) { seen.push_back(r.at("n").get<int>()); }), 2);
+    EXPECT_EQ(seen, (std::vector<int>{1, 2}));
+    EXPECT_EQ(journal.pending(), 2);
+}
+
+TEST_F(JournalTest, ReplaySkipsRecordsThatThrow)
+{
+    persistence.saveToFile("j.log", "{\"n\":1}\n{\"x\":0}\n{\"n\":3}\n");
+
+    Journal journal(&persistence, "j.log", countingWriter());
+    int sum = 0;
+    EXPECT_EQ(journal.replay([&](const nlohmann::json &r) { sum += r.at("n").get<int>(); }), 2);
+    EXPECT_EQ(sum, 4);
+}
+
+TEST_F(JournalTest, CompactWritesBaseAndTruncates)
+{
+    Journal journal(&persistence, "j.log", countingWriter());
+    journal.append({{"op", "clear"}});
+
+    EXPECT_TRUE(journal.compact());
+    EXPECT_EQ(baseWrites, 1);
+    EXPECT_EQ(journal.pending(), 0);
+    EXPECT_EQ(persistence.contents("j.log"), "");
+}
+
+TEST_F(JournalTest, CompactKeepsRecordsAppendedDuringBaseWrite)
+{
+    Journal *self = nullptr;
+    Journal journal(&persistence, "j.log",
+                    [&]()
+                    {
+                        // A writer slips in while the base is being written
+                        self->append({{"op", "late"}});
+                        return true;
+                    });
+    self = &journal;
+    journal.append({{"op", "early"}});
+
+    EXPECT_TRUE(journal.compact());
+    EXPECT_EQ(journal.pending(), 2);
+    EXPECT_NE(persistence.contents("j.log").find("late"), std::string::npos);
+}
+
+TEST_F(JournalTest, FailedBaseWriteKeepsJournal)
+{
+    Journal journal(&persistence, "j.log", []() { return false; });
+    journal.append({{"op", "add"}});
+
+    EXPECT_FALSE(journal.compact());
+    EXPECT_EQ(journal.pending(), 1);
+}
+
+TEST_F(JournalTest, CompactsInBackgroundAtThreshold)
+{
+    Journal journal(&persistence, "j.log", countingWriter(), 4);
+    for (int i = 0; i < 4; ++i)
+    {
+        journal.append({{"n", i}});
+    }
+    journal.waitForCompaction();
+
+    EXPECT_EQ(baseWrites, 1);
+    EXPECT_EQ(journal.pending(), 0);
+}
+
+TEST_F(JournalTest, NullPersistence)
+{
+    Journal journal(nullptr, "j.log", countingWriter());
+    EXPECT_FALSE(journal.append({{"op", "add"}}));
+    EXPECT_EQ(journal.replay([](const nlohmann::json &) {}), 0);
+    EXPECT_FALSE(journal.compact());
+}
@@ -158,3 +158,117 @@ TEST_F(JsonPersistenceTest, DeserializeNull)
     EXPECT_FALSE(persistence.deserialize("{}", nullptr));
     EXPECT_FALSE(persistence.deserialize("", (void*)1));
 }
+
+TEST_F(JsonPersistenceTest, MapFileReadsBinaryContent)
+{
+    std::string content("bin\0ary\xff", 8);
+    ASSERT_TRUE(persistence.saveToFile(testFile, content));
+
+    auto mapped = persistence.mapFile(testFile);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_TRUE(mapped->isMapped());
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), content);
+
+    EXPECT_EQ(persistence.mapFile(testDir + "/missing.bin"), nullptr);
+    EXPECT_EQ(persistence.mapFile(testDir), nullptr);
+}
+
+TEST_F(JsonPersistenceTest, MapFileHandlesEmptyFile)
+{
+    ASSERT_TRUE(persistence.saveToFile(testFile, ""));
+    auto mapped = persistence.mapFile(testFile);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(mapped->size(), 0);
+}
+
+TEST_F(JsonPersistenceTest, AppendToFileCreatesAndExtends)
+{
+    std::string journal = testDir + "/nested/journal.log";
+    EXPECT_TRUE(persistence.appendToFile(journal, "one\n"));
+    EXPECT_TRUE(persistence.appendToFile(journal, "two\n"));
+
+    std::string content;
+    ASSERT_TRUE(persistence.loadFromFile(journal, content));
+    EXPECT_EQ(content, "one\ntwo\n");
+}
+
+TEST_F(JsonPersistenceTest, SaveReplacesAtomically)
+{
+    ASSERT_TRUE(persistence.saveToFile(testFile, "{\"v\":1}"));
+    ASSERT_TRUE(persistence.saveToFile(testFile, "{\"v\":2}"));
+
+    std::string loaded;
+    ASSERT_TRUE(persistence.loadFromFile(testFile, loaded));
+    EXPECT_EQ(loaded, "{\"v\":2}");
+    EXPECT_FALSE(fs::exists(testFile + ".tmp"));
+}
+
+TEST_F(JsonPersistenceTest, AsyncSaveIsReadableBeforeFlush)
+{
+    JsonPersistence async(JsonPersistence::WriteMode::ASYNC);
+    std::string path = testDir + "/async/state.json";
+    ASSERT_TRUE(async.saveToFile(path, "[1]"));
+
+    // Reads see the queued contents whether or not the writer got to them
+    std::string loaded;
+    EXPECT_TRUE(async.fileExists(path));
+    ASSERT_TRUE(async.loadFromFile(path, loaded));
+    EXPECT_EQ(loaded, "[1]");
+    auto mapped = async.mapFile(path);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), "[1]");
+
+    EXPECT_TRUE(async.flush());
+    std::ifstream disk(path);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(disk), std::istreambuf_iterator<char>()), "[1]");
+}
+
+TEST_F(JsonPersistenceTest, AsyncSavesCoalesceToNewest)
+{
+    {
+        JsonPersistence async(JsonPersistence::WriteMode::ASYNC);
+        for (int i = 0; i < 200; ++i)
+        {
+            async.saveToFile(testFile, std::to_string(i));
+        }
+        // Destructor drains the queue
+    }
+
+    std::string loaded;
+    ASSERT_TRUE(persistence.loadFromFile(testFile, loaded));
+    EXPECT_EQ(loaded, "199");
+}
+
+TEST_F(JsonPersistenceTest, AsyncAppendAndDeleteWaitForQueuedSave)
+{
+    JsonPersistence async(JsonPersistence::WriteMode::ASYNC);
+    std::string journal = testDir + "/journal.log";
+    ASSERT_TRUE(async.appendToFile(journal, "old\n"));
+
+    // Truncate then append: the append must not be overwritten by the queued truncate
+    async.saveToFile(journal, "");
+    ASSERT_TRUE(async.appendToFile(journal, "new\n"));
+    std::string loaded;
+    ASSERT_TRUE(async.loadFromFile(journal, loaded));
+    EXPECT_EQ(loaded, "new\n");
+
+    async.saveToFile(testFile, "{}");
+    EXPECT_TRUE(async.deleteFile(testFile));
+    EXPECT_TRUE(async.flush());
+    EXPECT_FALSE(fs::exists(testFile));
+}
+
+TEST_F(JsonPersistenceTest, AsyncFlushReportsFailedWrite)
+{
+    std::string fileAsDir = testDir + "/file_not_dir";
+    {
+        std::ofstream ofs(fileAsDir);
+        ofs << "data";
+    }
+
+    JsonPersistence async(JsonPersistence::WriteMode::ASYNC);
+    EXPECT_TRUE(async.saveToFile(fileAsDir + "/deep/file.json", "{}"));
+    EXPECT_FALSE(async.flush());
+    // The failure is reported once
+    EXPECT_TRUE(async.flush());
+}
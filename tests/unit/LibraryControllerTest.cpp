@@ -1,10 +1,12 @@
 #include "app/controller/LibraryController.h"
 #include "app/model/Library.h"
+#include "tests/mocks/MockDirectoryWatcher.h"
 #include "tests/mocks/MockFileSystem.h"
 #include "tests/mocks/MockMetadataReader.h"
 #include "tests/mocks/MockPersistence.h"
 #include "tests/mocks/MockPlaybackEngine.h"
 #include <gtest/gtest.h>
+#include <atomic>
 #include <thread>
 #include <chrono>
 
@@ -170,6 +172,20 @@ TEST_F(LibraryControllerTest, IndividualRemovals)
     EXPECT_EQ(library->size(), 0);
 }
 
+TEST_F(LibraryControllerTest, RemoveTracksBatchesAndReportsRemovedOnly)
+{
+    library->addMedia(std::make_shared<MediaFile>("/1.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/2.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/3.mp3"));
+
+    std::vector<std::string> removed;
+    controller->setOnTrackRemovedCallback([&](const std::string &path) { removed.push_back(path); });
+
+    controller->removeTracks({"/1.mp3", "/3.mp3", "/unknown.mp3"});
+    EXPECT_EQ(library->size(), 1);
+    EXPECT_EQ(removed, (std::vector<std::string>{"/1.mp3", "/3.mp3"}));
+}
+
 TEST_F(LibraryControllerTest, RefreshEmptyLibrary)
 {
     EXPECT_EQ(controller->refreshLibrary(), 0);
@@ -240,6 +256,26 @@ TEST_F(LibraryControllerTest, AddMediaFilesAsync)
     EXPECT_TRUE(library->contains("/async1.mp3"));
 }
 
+TEST_F(LibraryControllerTest, AddMediaFilesAsyncKeepsOrderAndJoins)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < 50; ++i)
+    {
+        paths.push_back("/ordered" + std::to_string(i) + ".mp3");
+    }
+    EXPECT_CALL(*mockMeta, readMetadata(_)).WillRepeatedly(Return(MediaMetadata()));
+
+    controller->addMediaFilesAsync(paths);
+    controller->waitForImports();
+
+    auto files = library->getAll();
+    ASSERT_EQ(files.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        EXPECT_EQ(files[i]->getPath(), paths[i]);
+    }
+}
+
 TEST_F(LibraryControllerTest, GetAllTrackPaths)
 {
     library->addMedia(std::make_shared<MediaFile>("/t1.mp3"));
@@ -271,3 +307,297 @@ TEST_F(LibraryControllerTest, AddMediaFilesAsyncLargeBatch)
     
     EXPECT_EQ(library->size(), 25);
 }
+
+TEST_F(LibraryControllerTest, RefreshSkipsFilesWithMatchingFingerprint)
+{
+    FileFingerprint stored;
+    stored.size = 100;
+    stored.mtime = 5;
+    stored.inode = 7;
+
+    auto same = std::make_shared<MediaFile>("/same.mp3");
+    same->setFingerprint(stored);
+    library->addMedia(same);
+    auto changed = std::make_shared<MediaFile>("/changed.mp3");
+    changed->setFingerprint(stored);
+    library->addMedia(changed);
+
+    FileFingerprint modified = stored;
+    modified.mtime = 6;
+    EXPECT_CALL(*mockFs, getFingerprint("/same.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(stored), Return(true)));
+    EXPECT_CALL(*mockFs, getFingerprint("/changed.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(modified), Return(true)));
+
+    MediaMetadata newMeta;
+    newMeta.title = "Retagged";
+    EXPECT_CALL(*mockMeta, readMetadata("/same.mp3")).Times(0);
+    EXPECT_CALL(*mockMeta, readMetadata("/changed.mp3")).WillOnce(Return(newMeta));
+
+    EXPECT_EQ(controller->refreshLibrary(), 1);
+    EXPECT_EQ(controller->getLastRefreshStats().skipped, 1);
+    EXPECT_EQ(controller->getLastRefreshStats().updated, 1);
+    EXPECT_EQ(library->getByPath("/changed.mp3")->getMetadata().title, "Retagged");
+    EXPECT_EQ(library->getByPath("/changed.mp3")->getFingerprint(), modified);
+}
+
+TEST_F(LibraryControllerTest, RefreshStampsFingerprintWhenTagsUnchanged)
+{
+    library->addMedia(std::make_shared<MediaFile>("/quiet.mp3"));
+
+    FileFingerprint current;
+    current.size = 1;
+    current.inode = 2;
+    EXPECT_CALL(*mockFs, getFingerprint("/quiet.mp3", _))
+        .WillRepeatedly(::testing::DoAll(::testing::SetArgReferee<1>(current), Return(true)));
+    EXPECT_CALL(*mockMeta, readMetadata("/quiet.mp3")).WillOnce(Return(MediaMetadata()));
+
+    EXPECT_EQ(controller->refreshLibrary(), 0);
+    EXPECT_EQ(controller->getLastRefreshStats().unchanged, 1);
+
+    // Second launch: nothing is read
+    EXPECT_EQ(controller->refreshLibrary(), 0);
+    EXPECT_EQ(controller->getLastRefreshStats().skipped, 1);
+}
+
+TEST_F(LibraryControllerTest, AddMediaFileRecordsFingerprint)
+{
+    FileFingerprint current;
+    current.size = 3;
+    current.mtime = 4;
+    EXPECT_CALL(*mockFs, getFingerprint("/new.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(current), Return(true)));
+
+    ASSERT_TRUE(controller->addMediaFile("/new.mp3"));
+    EXPECT_EQ(library->getByPath("/new.mp3")->getFingerprint(), current);
+}
+
+TEST_F(LibraryControllerTest, BackgroundDirectoryImport)
+{
+    std::vector<std::string> files;
+    for (int i = 0; i < 30; ++i)
+    {
+        files.push_back("/bg/" + std::to_string(i) + ".mp3");
+    }
+    EXPECT_CALL(*mockFs, scanDirectory("/bg", _, _)).WillOnce(Return(files));
+    EXPECT_CALL(*mockMeta, readMetadata(_)).WillRepeatedly(Return(MediaMetadata()));
+
+    ASSERT_TRUE(controller->startDirectoryImport("/bg"));
+    controller->waitForImports();
+
+    ImportProgress progress = controller->getImportProgress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_EQ(progress.added, 30u);
+    EXPECT_EQ(library->size(), 30u);
+
+    // A finished import can be followed by another one
+    EXPECT_CALL(*mockFs, scanDirectory("/empty", _, _)).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_TRUE(controller->startDirectoryImport("/empty"));
+    controller->cancelDirectoryImport();
+    controller->waitForImports();
+}
+
+TEST_F(LibraryControllerTest, MaintenanceVerifiesThenRefreshesInBackground)
+{
+    library->addMedia(std::make_shared<MediaFile>("/kept.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/gone.mp3"));
+    FileFingerprint current;
+    current.size = 10;
+    current.inode = 3;
+    EXPECT_CALL(*mockFs, getFingerprint("/kept.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(current), Return(true)));
+    EXPECT_CALL(*mockFs, getFingerprint("/gone.mp3", _)).WillOnce(Return(false));
+    EXPECT_CALL(*mockFs, exists("/gone.mp3")).WillOnce(Return(false));
+
+    MediaMetadata retagged;
+    retagged.title = "Kept";
+    retagged.duration = 30;
+    EXPECT_CALL(*mockMeta, readMetadata("/kept.mp3")).WillOnce(Return(retagged));
+    EXPECT_CALL(*mockMeta, readMetadata("/gone.mp3")).Times(0);
+
+    std::atomic<bool> finished{false};
+    ASSERT_TRUE(controller->startMaintenance([&finished]() { finished = true; }));
+    controller->waitForImports();
+
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(controller->isMaintenanceRunning());
+    EXPECT_FALSE(library->contains("/gone.mp3"));
+    EXPECT_EQ(library->getByPath("/kept.mp3")->getMetadata().title, "Kept");
+    EXPECT_EQ(library->getByPath("/kept.mp3")->getFingerprint(), current);
+    EXPECT_EQ(controller->getLastRefreshStats().updated, 1);
+}
+
+TEST_F(LibraryControllerTest, CancelStopsMaintenanceEarly)
+{
+    std::vector<std::shared_ptr<MediaFile>> files;
+    for (int i = 0; i < 3000; ++i)
+    {
+        files.push_back(std::make_shared<MediaFile>("/t" + std::to_string(i) + ".mp3"));
+    }
+    library->addMediaBatch(files);
+
+    // Each check is slow enough that the cancel lands in the first chunk
+    std::atomic<int> checked{0};
+    EXPECT_CALL(*mockFs, getFingerprint(_, _)).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mockFs, exists(_))
+        .WillRepeatedly(::testing::Invoke(
+            [&checked](const std::string &)
+            {
+                checked++;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                return true;
+            }));
+    EXPECT_CALL(*mockMeta, readMetadata(_)).Times(0);
+
+    ASSERT_TRUE(controller->startMaintenance());
+    EXPECT_FALSE(controller->startMaintenance()); // Only one pass at a time
+    while (checked == 0)
+    {
+        std::this_thread::yield();
+    }
+    controller->cancelImports();
+    controller->waitForImports();
+
+    EXPECT_LT(checked, 3000);
+    EXPECT_EQ(library->size(), 3000u);
+}
+
+TEST_F(LibraryControllerTest, FileEventsRemoveDeletedFilesAndFolders)
+{
+    for (const char *path : {"/m/a.mp3", "/m/sub/b.mp3", "/m/sub/c.mp3", "/m/subway.mp3", "/other/d.mp3"})
+    {
+        library->addMedia(std::make_shared<MediaFile>(path));
+    }
+    std::vector<std::string> notified;
+    controller->setOnTrackRemovedCallback([&notified](const std::string &path) { notified.push_back(path); });
+
+    controller->applyFileEvents({FileEvent{FileEvent::Kind::REMOVED, "/m/sub", true},
+                                 FileEvent{FileEvent::Kind::REMOVED, "/m/a.mp3", false},
+                                 FileEvent{FileEvent::Kind::REMOVED, "/m/never-added.mp3", false}});
+
+    EXPECT_EQ(library->size(), 2u);
+    EXPECT_TRUE(library->contains("/m/subway.mp3"));
+    EXPECT_TRUE(library->contains("/other/d.mp3"));
+    EXPECT_EQ(notified, (std::vector<std::string>{"/m/a.mp3", "/m/sub/b.mp3", "/m/sub/c.mp3"}));
+}
+
+TEST_F(LibraryControllerTest, FileEventsImportNewFilesAndRereadChangedOnes)
+{
+    library->addMedia(std::make_shared<MediaFile>("/m/edited.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/m/touched.mp3"));
+    library->updateMetadata("/m/touched.mp3", MediaMetadata(), FileFingerprint{7, 7, 7});
+
+    FileFingerprint edited{5, 6, 7};
+    EXPECT_CALL(*mockFs, getFingerprint("/m/edited.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(edited), Return(true)));
+    EXPECT_CALL(*mockFs, getFingerprint("/m/touched.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(FileFingerprint{7, 7, 7}), Return(true)));
+    EXPECT_CALL(*mockFs, getFingerprint("/m/new.flac", _)).WillRepeatedly(Return(false));
+
+    MediaMetadata retagged;
+    retagged.title = "Edited";
+    retagged.duration = 12;
+    EXPECT_CALL(*mockMeta, readMetadata("/m/edited.mp3")).WillOnce(Return(retagged));
+    EXPECT_CALL(*mockMeta, readMetadata("/m/touched.mp3")).Times(0);
+    EXPECT_CALL(*mockMeta, readMetadata("/m/new.flac")).WillOnce(Return(MediaMetadata()));
+
+    controller->applyFileEvents({FileEvent{FileEvent::Kind::CHANGED, "/m/edited.mp3", false},
+                                 FileEvent{FileEvent::Kind::CHANGED, "/m/touched.mp3", false},
+                                 FileEvent{FileEvent::Kind::CHANGED, "/m/new.flac", false},
+                                 FileEvent{FileEvent::Kind::CHANGED, "/m/cover.jpg", false}});
+    controller->waitForImports();
+
+    EXPECT_EQ(library->size(), 3u);
+    EXPECT_TRUE(library->contains("/m/new.flac"));
+    EXPECT_EQ(library->getByPath("/m/edited.mp3")->getMetadata().title, "Edited");
+    EXPECT_EQ(library->getByPath("/m/edited.mp3")->getFingerprint(), edited);
+}
+
+TEST_F(LibraryControllerTest, RescanReconcilesFolderWithLibrary)
+{
+    library->addMedia(std::make_shared<MediaFile>("/m/kept.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/m/lost.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/elsewhere/x.mp3"));
+
+    EXPECT_CALL(*mockFs, scanDirectory("/m", _, _))
+        .WillOnce(Return(std::vector<std::string>{"/m/kept.mp3", "/m/found.mp3"}));
+    EXPECT_CALL(*mockFs, getFingerprint(_, _)).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mockFs, exists("/m/kept.mp3")).WillOnce(Return(true));
+    EXPECT_CALL(*mockMeta, readMetadata("/m/found.mp3")).WillOnce(Return(MediaMetadata()));
+
+    controller->applyFileEvents({FileEvent{FileEvent::Kind::RESCAN, "/m", true}});
+    controller->waitForImports();
+
+    EXPECT_TRUE(library->contains("/m/kept.mp3"));
+    EXPECT_TRUE(library->contains("/m/found.mp3"));
+    EXPECT_FALSE(library->contains("/m/lost.mp3"));
+    EXPECT_TRUE(library->contains("/elsewhere/x.mp3"));
+}
+
+TEST_F(LibraryControllerTest, WatchingCoversFoldersAndAppliesBatches)
+{
+    ::testing::StrictMock<MockDirectoryWatcher> watcher;
+    controller->setDirectoryWatcher(&watcher);
+    controller->setLibraryFolders({"/music"});
+    library->addMedia(std::make_shared<MediaFile>("/music/album/a.mp3"));
+    library->addMedia(std::make_shared<MediaFile>("/podcasts/show/ep.mp3"));
+
+    IDirectoryWatcher::Callback callback;
+    EXPECT_CALL(watcher, addRoot("/music")).WillOnce(Return(true));
+    EXPECT_CALL(watcher, addRoot("/podcasts/show")).WillOnce(Return(true));
+    EXPECT_CALL(watcher, start(_)).WillOnce(::testing::DoAll(::testing::SaveArg<0>(&callback), Return(true)));
+    ASSERT_TRUE(controller->startWatching());
+    ASSERT_TRUE(callback);
+
+    std::vector<std::string> notified;
+    controller->setOnTrackRemovedCallback([&notified](const std::string &path) { notified.push_back(path); });
+
+    // Batches arrive on the watcher's thread; the removal itself waits for the main thread
+    std::atomic<bool> delivered{false};
+    std::thread watcherThread(
+        [&]()
+        {
+            callback({FileEvent{FileEvent::Kind::REMOVED, "/podcasts/show/ep.mp3", false}});
+            delivered = true;
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(delivered);
+    EXPECT_TRUE(library->contains("/podcasts/show/ep.mp3"));
+    EXPECT_TRUE(notified.empty());
+    while (!delivered)
+    {
+        controller->dispatchFileEvents();
+        std::this_thread::yield();
+    }
+    watcherThread.join();
+    EXPECT_FALSE(library->contains("/podcasts/show/ep.mp3"));
+    EXPECT_EQ(notified, (std::vector<std::string>{"/podcasts/show/ep.mp3"}));
+
+    // Imported folders are remembered and watched straight away
+    EXPECT_CALL(*mockFs, scanDirectory("/audiobooks", _, _)).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_CALL(watcher, addRoot("/audiobooks")).WillOnce(Return(true));
+    ASSERT_TRUE(controller->startDirectoryImport("/audiobooks"));
+    controller->waitForImports();
+    EXPECT_EQ(controller->getLibraryFolders(), (std::vector<std::string>{"/music", "/audiobooks"}));
+
+    EXPECT_CALL(watcher, stop());
+    controller->stopWatching();
+}
+
+TEST_F(LibraryControllerTest, StopWatchingReleasesBatchWaitingForMainThread)
+{
+    ::testing::NiceMock<MockDirectoryWatcher> watcher;
+    controller->setDirectoryWatcher(&watcher);
+    controller->setLibraryFolders({"/music"});
+    library->addMedia(std::make_shared<MediaFile>("/music/a.mp3"));
+
+    IDirectoryWatcher::Callback callback;
+    EXPECT_CALL(watcher, start(_)).WillOnce(::testing::DoAll(::testing::SaveArg<0>(&callback), Return(true)));
+    ASSERT_TRUE(controller->startWatching());
+
+    std::thread watcherThread([&]() { callback({FileEvent{FileEvent::Kind::REMOVED, "/music/a.mp3", false}}); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    controller->stopWatching(); // Without a main loop dispatching, only this lets the batch return
+    watcherThread.join();
+    EXPECT_TRUE(library->contains("/music/a.mp3"));
+}
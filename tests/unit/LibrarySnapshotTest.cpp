@@ -0,0 +1,177 @@
+#include "app/model/LibrarySnapshot.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+class LibrarySnapshotTest : public ::testing::Test
+{
+  protected:
+    std::vector<std::shared_ptr<MediaFile>> makeTracks(int count)
+    {
+        std::vector<std::shared_ptr<MediaFile>> files;
+        for (int i = 0; i < count; ++i)
+        {
+            MediaMetadata meta;
+            meta.title = "Song " + std::to_string(i);
+            meta.artist = "Same Artist";
+            meta.album = "Same Album";
+            meta.year = 2000 + i;
+            meta.track = i + 1;
+            meta.duration = 180 + i;
+            auto file = std::make_shared<MediaFile>("/music/" + std::to_string(i) + ".flac", meta);
+            file->setInLibrary(true);
+            files.push_back(file);
+        }
+        return files;
+    }
+
+    std::unique_ptr<LibrarySnapshot> openBytes(const std::string &bytes)
+    {
+        return LibrarySnapshot::open(MappedFile::fromString(bytes));
+    }
+};
+
+TEST_F(LibrarySnapshotTest, RoundTripKeepsEveryField)
+{
+    MediaMetadata meta;
+    meta.title = "Title";
+    meta.artist = "Artist";
+    meta.album = "Album";
+    meta.genre = "Jazz";
+    meta.codec = "flac";
+    meta.year = 1959;
+    meta.track = 2;
+    meta.duration = 545;
+    meta.bitrate = 900;
+    meta.sampleRate = 44100;
+    meta.channels = 2;
+    meta.hasAlbumArt = true;
+    meta.comment = "Take 3";
+    meta.customFields = {{"composer", "Miles Davis"}, {"label", ""}};
+    auto file = std::make_shared<MediaFile>("/jazz/So What.FLAC", meta);
+    file->setInLibrary(true);
+
+    auto snapshot = openBytes(LibrarySnapshot::encode({file, nullptr}));
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->size(), 1);
+    EXPECT_EQ(snapshot->path(0), "/jazz/So What.FLAC");
+
+    auto decoded = snapshot->materialize(0);
+    EXPECT_EQ(decoded->getPath(), "/jazz/So What.FLAC");
+    EXPECT_EQ(decoded->getExtension(), ".flac");
+    EXPECT_TRUE(decoded->isInLibrary());
+
+    const MediaMetadata &out = decoded->getMetadata();
+    EXPECT_EQ(out.title, "Title");
+    EXPECT_EQ(out.artist, "Artist");
+    EXPECT_EQ(out.album, "Album");
+    EXPECT_EQ(out.genre, "Jazz");
+    EXPECT_EQ(out.codec, "flac");
+    EXPECT_EQ(out.year, 1959);
+    EXPECT_EQ(out.track, 2);
+    EXPECT_EQ(out.duration, 545);
+    EXPECT_EQ(out.bitrate, 900);
+    EXPECT_EQ(out.sampleRate, 44100);
+    EXPECT_EQ(out.channels, 2);
+    EXPECT_TRUE(out.hasAlbumArt);
+    EXPECT_EQ(out.comment, "Take 3");
+    EXPECT_EQ(out.customFields, meta.customFields);
+}
+
+TEST_F(LibrarySnapshotTest, EmptyLibrary)
+{
+    auto snapshot = openBytes(LibrarySnapshot::encode({}));
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->size(), 0);
+    EXPECT_EQ(snapshot->path(0), "");
+}
+
+TEST_F(LibrarySnapshotTest, RepeatedStringsAreStoredOnce)
+{
+    std::string one = LibrarySnapshot::encode(makeTracks(1));
+    std::string many = LibrarySnapshot::encode(makeTracks(100));
+
+    // Artist and album appear once in the string table however many tracks share them
+    size_t perTrack = (many.size() - one.size()) / 99;
+    EXPECT_LT(perTrack, one.size() - std::string("Same Artist").size());
+
+    auto snapshot = openBytes(many);
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->size(), 100);
+    EXPECT_EQ(snapshot->metadata(57).title, "Song 57");
+    EXPECT_EQ(snapshot->metadata(57).artist, "Same Artist");
+    EXPECT_EQ(snapshot->metadata(99).year, 2099);
+}
+
+TEST_F(LibrarySnapshotTest, RejectsCorruptInput)
+{
+    std::string bytes = LibrarySnapshot::encode(makeTracks(3));
+
+    EXPECT_EQ(openBytes(""), nullptr);
+    EXPECT_EQ(openBytes("[{\"path\": \"/a.mp3\"}]"), nullptr);
+    EXPECT_EQ(openBytes(bytes.substr(0, bytes.size() - 1)), nullptr);
+    EXPECT_EQ(LibrarySnapshot::open(nullptr), nullptr);
+
+    // Header and section table are checked on open
+    std::string badHeader = bytes;
+    badHeader[8] ^= 0x01;
+    EXPECT_EQ(openBytes(badHeader), nullptr);
+    std::string badTable = bytes;
+    badTable[32] ^= 0x01;
+    EXPECT_EQ(openBytes(badTable), nullptr);
+
+    // The body only when it is read
+    std::string flipped = bytes;
+    flipped[flipped.size() - 2] ^= 0x20;
+    auto damaged = openBytes(flipped);
+    ASSERT_NE(damaged, nullptr);
+    EXPECT_FALSE(damaged->damaged());
+    EXPECT_EQ(damaged->path(0), "");
+    EXPECT_TRUE(damaged->damaged());
+
+    std::string wrongVersion = bytes;
+    wrongVersion[4] = static_cast<char>(LibrarySnapshot::VERSION + 1);
+    EXPECT_EQ(openBytes(wrongVersion), nullptr);
+
+    EXPECT_NE(openBytes(bytes), nullptr);
+}
+
+TEST_F(LibrarySnapshotTest, RoundTripKeepsFingerprint)
+{
+    auto files = makeTracks(2);
+    FileFingerprint fingerprint;
+    fingerprint.size = 4096;
+    fingerprint.mtime = 1700000000123456789;
+    fingerprint.inode = 77;
+    files[0]->setFingerprint(fingerprint);
+
+    auto snapshot = openBytes(LibrarySnapshot::encode(files));
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->materialize(0)->getFingerprint(), fingerprint);
+    EXPECT_FALSE(snapshot->materialize(1)->getFingerprint().isValid());
+}
+
+TEST_F(LibrarySnapshotTest, ChecksOnlyTheSectionsThatAreRead)
+{
+    // Long titles spread the string table over several sections
+    auto files = makeTracks(40);
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        MediaMetadata meta = files[i]->getMetadata();
+        meta.title = std::string(4096, static_cast<char>('a' + i % 26)) + std::to_string(i);
+        files[i]->setMetadata(meta);
+    }
+    std::string bytes = LibrarySnapshot::encode(files);
+    ASSERT_GT(bytes.size(), 2 * LibrarySnapshot::SECTION_SIZE);
+
+    // Damage the last title only
+    bytes[bytes.size() - 3] ^= 0x20;
+    auto snapshot = openBytes(bytes);
+    ASSERT_NE(snapshot, nullptr);
+
+    EXPECT_EQ(snapshot->metadata(0).title, files[0]->getMetadata().title);
+    EXPECT_EQ(snapshot->path(20), "/music/20.flac");
+    EXPECT_FALSE(snapshot->damaged());
+
+    EXPECT_EQ(snapshot->metadata(39).title, "");
+    EXPECT_TRUE(snapshot->damaged());
+}
@@ -1,6 +1,12 @@
 #include "app/model/Library.h"
+#include "app/model/LibrarySnapshot.h"
+#include "tests/mocks/MemoryPersistence.h"
 #include "tests/mocks/MockPersistence.h"
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <gtest/gtest.h>
+#include <thread>
 
 using ::testing::_;
 using ::testing::Return;
@@ -19,6 +25,21 @@ class LibraryTest : public ::testing::Test
     {
         lib.rebuildPathIndex();
     }
+
+    std::mutex &dataMutex(Library &lib)
+    {
+        return lib.dataMutex_;
+    }
+
+    size_t indexedTracks(Library &lib)
+    {
+        return lib.indexed_;
+    }
+
+    bool searchIndexComplete(Library &lib)
+    {
+        return lib.indexed_ == lib.mediaFiles_.size();
+    }
 };
 
 TEST_F(LibraryTest, SearchIsCaseInsensitive)
@@ -330,3 +351,488 @@ TEST_F(LibraryTest, LoadPartialJsonItems)
     EXPECT_TRUE(lib.load());
     EXPECT_EQ(lib.size(), 1);
 }
+
+TEST_F(LibraryTest, UpdateMetadataReindexesSearch)
+{
+    Library lib(nullptr);
+    MediaMetadata meta;
+    meta.title = "Old Name";
+    lib.addMedia(std::make_shared<MediaFile>("/u.mp3", meta));
+
+    meta.title = "New Name";
+    EXPECT_TRUE(lib.updateMetadata("/u.mp3", meta));
+    EXPECT_EQ(lib.getByPath("/u.mp3")->getMetadata().title, "New Name");
+    EXPECT_TRUE(lib.search("old", {"title"}).empty());
+    EXPECT_EQ(lib.search("new", {"title"}).size(), 1);
+
+    EXPECT_FALSE(lib.updateMetadata("/missing.mp3", meta));
+}
+
+TEST_F(LibraryTest, UpdateMetadataReachesEveryHolderOfTheTrack)
+{
+    Library lib(nullptr);
+    MediaMetadata meta;
+    meta.title = "Old Name";
+    lib.addMedia(std::make_shared<MediaFile>("/u.mp3", meta));
+    auto held = lib.getByPath("/u.mp3"); // As a playlist or the play queue would hold it
+    auto oldMetadata = held->getMetadataSnapshot();
+    uint64_t revision = held->getMetadataRevision();
+
+    meta.title = "New Name";
+    ASSERT_TRUE(lib.updateMetadata("/u.mp3", meta, FileFingerprint{1, 2, 3}));
+
+    EXPECT_EQ(lib.getByPath("/u.mp3"), held);
+    EXPECT_EQ(held->getMetadata().title, "New Name");
+    EXPECT_EQ(held->getFingerprint(), (FileFingerprint{1, 2, 3}));
+    EXPECT_GT(held->getMetadataRevision(), revision);
+    EXPECT_TRUE(held->isInLibrary());
+    // A reader that took the metadata before the update keeps a stable copy
+    EXPECT_EQ(oldMetadata->title, "Old Name");
+    EXPECT_EQ(lib.search("new name").size(), 1u);
+}
+
+TEST_F(LibraryTest, SearchIndexFollowsRemovalAndLoad)
+{
+    std::string json = "[{\"path\": \"/loaded.mp3\", \"metadata\": {\"title\": \"Loaded Song\"}}]";
+    EXPECT_CALL(*mockPersist, fileExists(_)).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile(_, _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(json), Return(true)));
+
+    Library lib(mockPersist.get());
+    MediaMetadata meta;
+    meta.title = "Added Song";
+    lib.addMedia(std::make_shared<MediaFile>("/added.mp3", meta));
+    EXPECT_EQ(lib.search("song", {"title"}).size(), 1);
+
+    // load() replaces the contents, so the index must follow
+    EXPECT_TRUE(lib.load());
+    auto results = lib.search("song", {"title"});
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0]->getPath(), "/loaded.mp3");
+
+    EXPECT_TRUE(lib.removeMedia("/loaded.mp3"));
+    EXPECT_TRUE(lib.search("song", {"title"}).empty());
+}
+
+TEST_F(LibraryTest, RemoveMediaBatchKeepsOrder)
+{
+    Library lib(nullptr);
+    for (int i = 0; i < 6; ++i)
+    {
+        lib.addMedia(std::make_shared<MediaFile>("/" + std::to_string(i) + ".mp3"));
+    }
+
+    EXPECT_EQ(lib.removeMediaBatch({"/1.mp3", "/4.mp3", "/missing.mp3"}), 2);
+    EXPECT_EQ(lib.removeMediaBatch({}), 0);
+    ASSERT_EQ(lib.size(), 4);
+
+    const auto &all = lib.getAll();
+    ASSERT_EQ(all.size(), 4);
+    EXPECT_EQ(all[0]->getPath(), "/0.mp3");
+    EXPECT_EQ(all[1]->getPath(), "/2.mp3");
+    EXPECT_EQ(all[2]->getPath(), "/3.mp3");
+    EXPECT_EQ(all[3]->getPath(), "/5.mp3");
+    EXPECT_EQ(lib.getByPath("/5.mp3"), all[3]);
+    EXPECT_EQ(lib.getByPath("/4.mp3"), nullptr);
+}
+
+TEST_F(LibraryTest, SingleRemovalsStayConsistent)
+{
+    Library lib(nullptr);
+    std::vector<std::shared_ptr<MediaFile>> files;
+    for (int i = 0; i < 10; ++i)
+    {
+        files.push_back(std::make_shared<MediaFile>("/" + std::to_string(i) + (i % 2 ? ".mp3" : ".ogg")));
+        lib.addMedia(files.back());
+    }
+
+    for (int i = 0; i < 10; i += 3)
+    {
+        EXPECT_TRUE(lib.removeMedia(files[i]->getPath()));
+        EXPECT_FALSE(files[i]->isInLibrary());
+    }
+
+    EXPECT_EQ(lib.size(), 6);
+    EXPECT_EQ(lib.getByPath("/8.ogg"), files[8]);
+    EXPECT_FALSE(lib.contains("/9.mp3"));
+
+    // Survivors keep their order once the gaps are closed
+    auto all = lib.getAll();
+    ASSERT_EQ(all.size(), 6);
+    EXPECT_EQ(all[0]->getPath(), "/1.mp3");
+    EXPECT_EQ(all[5]->getPath(), "/8.ogg");
+
+    // Re-adding a removed path appends it at the end
+    EXPECT_TRUE(lib.addMedia(files[0]));
+    EXPECT_EQ(lib.getAll().back(), files[0]);
+}
+
+TEST_F(LibraryTest, BulkRemovalIsFast)
+{
+    Library lib(nullptr);
+    std::vector<std::shared_ptr<MediaFile>> batch;
+    std::vector<std::string> paths;
+    for (int i = 0; i < 50000; ++i)
+    {
+        paths.push_back("/usb/track_" + std::to_string(i) + ".mp3");
+        batch.push_back(std::make_shared<MediaFile>(paths.back()));
+    }
+    lib.addMediaBatch(batch);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(lib.removeMediaBatch(paths), 50000);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(lib.size(), 0);
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 2000);
+}
+
+TEST_F(LibraryTest, SnapshotIsImmutableAcrossWrites)
+{
+    Library lib(nullptr);
+    auto a = std::make_shared<MediaFile>("/a.mp3");
+    auto b = std::make_shared<MediaFile>("/b.mp3");
+    lib.addMedia(a);
+    lib.addMedia(b);
+
+    auto before = lib.snapshot();
+    ASSERT_EQ(before->size(), 2);
+
+    lib.removeMedia("/a.mp3");
+    lib.addMediaBatch({std::make_shared<MediaFile>("/c.mp3"), std::make_shared<MediaFile>("/d.mp3")});
+
+    // The old snapshot still holds exactly what it held
+    ASSERT_EQ(before->size(), 2);
+    EXPECT_EQ((*before)[0], a);
+    EXPECT_EQ((*before)[1], b);
+
+    auto after = lib.snapshot();
+    ASSERT_EQ(after->size(), 3);
+    EXPECT_EQ((*after)[0], b);
+    EXPECT_EQ((*after)[2]->getPath(), "/d.mp3");
+    EXPECT_EQ(lib.getTracks()->size(), 3);
+
+    lib.clear();
+    EXPECT_TRUE(lib.snapshot()->empty());
+    EXPECT_EQ(after->size(), 3);
+}
+
+TEST_F(LibraryTest, SnapshotDoesNotWaitOnWriter)
+{
+    Library lib(nullptr);
+    lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+    auto first = lib.snapshot();
+    lib.addMedia(std::make_shared<MediaFile>("/b.mp3"));
+    EXPECT_TRUE(lib.hasPendingSnapshot());
+
+    {
+        // Simulate a writer in the middle of an import
+        std::lock_guard<std::mutex> writer(dataMutex(lib));
+        auto stale = lib.snapshot();
+        EXPECT_EQ(stale, first);
+        EXPECT_TRUE(lib.hasPendingSnapshot());
+    }
+
+    auto fresh = lib.snapshot();
+    EXPECT_EQ(fresh->size(), 2);
+    EXPECT_FALSE(lib.hasPendingSnapshot());
+}
+
+TEST_F(LibraryTest, SearchDoesNotWaitOnWriter)
+{
+    Library lib(nullptr);
+    MediaMetadata meta;
+    meta.title = "Blue in Green";
+    meta.artist = "Miles Davis";
+    lib.addMedia(std::make_shared<MediaFile>("/blue.mp3", meta));
+    meta.title = "So What";
+    lib.addMedia(std::make_shared<MediaFile>("/what.mp3", meta));
+    lib.snapshot();
+
+    // A writer on another thread holds the library for the whole search
+    std::promise<void> locked;
+    std::promise<void> release;
+    std::thread writer(
+        [&]()
+        {
+            std::lock_guard<std::mutex> lock(dataMutex(lib));
+            locked.set_value();
+            release.get_future().wait();
+        });
+    locked.get_future().wait();
+
+    auto results = lib.search("DAVIS", {"artist"});
+    EXPECT_EQ(results.size(), 2);
+    results = lib.search("green", {"title", "artist"});
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0]->getPath(), "/blue.mp3");
+    EXPECT_TRUE(lib.search("green", {"album"}).empty());
+
+    release.set_value();
+    writer.join();
+}
+
+TEST_F(LibraryTest, SnapshotReadersSurviveConcurrentImport)
+{
+    Library lib(nullptr);
+    std::atomic<bool> done{false};
+
+    std::thread importer(
+        [&]()
+        {
+            for (int b = 0; b < 50; ++b)
+            {
+                std::vector<std::shared_ptr<MediaFile>> batch;
+                for (int i = 0; i < 20; ++i)
+                {
+                    batch.push_back(std::make_shared<MediaFile>("/" + std::to_string(b * 20 + i) + ".mp3"));
+                }
+                lib.addMediaBatch(batch);
+                if (b % 5 == 0)
+                    lib.removeMedia("/" + std::to_string(b * 20) + ".mp3");
+            }
+            done = true;
+        });
+
+    size_t lastSize = 0;
+    bool sawNull = false;
+    while (!done)
+    {
+        auto snap = lib.snapshot();
+        for (const auto &file : *snap)
+        {
+            sawNull |= (file == nullptr);
+        }
+        lastSize = snap->size();
+    }
+    importer.join();
+
+    EXPECT_FALSE(sawNull);
+    EXPECT_LE(lastSize, 990u);
+    EXPECT_EQ(lib.snapshot()->size(), 990u);
+}
+
+TEST_F(LibraryTest, BinarySnapshotSaveAndLoad)
+{
+    std::string saved;
+    EXPECT_CALL(*mockPersist, saveToFile("data/library.bin", _))
+        .WillOnce(::testing::DoAll(::testing::SaveArg<1>(&saved), Return(true)));
+
+    Library source(mockPersist.get());
+    source.enableBinarySnapshot();
+    MediaMetadata meta;
+    meta.title = "Blue in Green";
+    meta.artist = "Miles Davis";
+    source.addMedia(std::make_shared<MediaFile>("/jazz/1.flac", meta));
+    source.addMedia(std::make_shared<MediaFile>("/jazz/2.flac"));
+    ASSERT_TRUE(source.save());
+
+    EXPECT_CALL(*mockPersist, fileExists("data/library.bin")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.bin", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(saved), Return(true)));
+
+    Library restored(mockPersist.get());
+    restored.enableBinarySnapshot();
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.size(), 2);
+    EXPECT_EQ(restored.getAll()[0]->getMetadata().artist, "Miles Davis");
+    EXPECT_TRUE(restored.getByPath("/jazz/2.flac")->isInLibrary());
+    ASSERT_EQ(restored.search("blue").size(), 1);
+}
+
+TEST_F(LibraryTest, BinarySnapshotFallsBackToJson)
+{
+    std::string json = "[{\"path\": \"/legacy.mp3\", \"metadata\": {\"title\": \"Old\"}}]";
+    EXPECT_CALL(*mockPersist, fileExists("data/library.bin")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.bin", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(std::string("garbage")), Return(true)));
+    EXPECT_CALL(*mockPersist, fileExists("data/library.json")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.json", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(json), Return(true)));
+
+    Library lib(mockPersist.get());
+    lib.enableBinarySnapshot();
+    ASSERT_TRUE(lib.load());
+    ASSERT_EQ(lib.size(), 1);
+    EXPECT_EQ(lib.getAll()[0]->getMetadata().title, "Old");
+}
+
+TEST_F(LibraryTest, DamagedBinarySnapshotFallsBackToJson)
+{
+    Library source(nullptr);
+    source.addMedia(std::make_shared<MediaFile>("/new.mp3"));
+    std::string damaged = LibrarySnapshot::encode(source.getAll());
+    damaged[damaged.size() - 1] ^= 0x20; // Last byte of the path
+
+    std::string json = "[{\"path\": \"/legacy.mp3\"}]";
+    EXPECT_CALL(*mockPersist, fileExists("data/library.bin")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.bin", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(damaged), Return(true)));
+    EXPECT_CALL(*mockPersist, fileExists("data/library.json")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.json", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(json), Return(true)));
+
+    Library lib(mockPersist.get());
+    lib.enableBinarySnapshot();
+    ASSERT_TRUE(lib.load());
+    ASSERT_EQ(lib.size(), 1);
+    EXPECT_EQ(lib.getAll()[0]->getPath(), "/legacy.mp3");
+}
+
+TEST_F(LibraryTest, BinaryLoadLeavesSearchIndexingForLater)
+{
+    Library source(nullptr);
+    for (int i = 0; i < 3000; ++i)
+    {
+        MediaMetadata meta;
+        meta.title = "Song " + std::to_string(i);
+        source.addMedia(std::make_shared<MediaFile>("/music/" + std::to_string(i) + ".mp3", meta));
+    }
+    std::string saved = LibrarySnapshot::encode(source.getAll());
+    EXPECT_CALL(*mockPersist, fileExists("data/library.bin")).WillOnce(Return(true));
+    EXPECT_CALL(*mockPersist, loadFromFile("data/library.bin", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(saved), Return(true)));
+
+    Library lib(mockPersist.get());
+    lib.enableBinarySnapshot();
+    ASSERT_TRUE(lib.load());
+    EXPECT_EQ(indexedTracks(lib), 0u);
+
+    // Until the index catches up, search scans and changes land in order
+    ASSERT_EQ(lib.search("song 2999").size(), 1u);
+    MediaMetadata meta;
+    meta.title = "Song 3000";
+    lib.addMedia(std::make_shared<MediaFile>("/music/3000.mp3", meta));
+    lib.removeMedia("/music/1.mp3");
+    meta.title = "Renamed";
+    lib.updateMetadata("/music/2.mp3", meta);
+    EXPECT_EQ(indexedTracks(lib), 0u);
+
+    lib.buildSearchIndex();
+    EXPECT_TRUE(searchIndexComplete(lib));
+    EXPECT_EQ(lib.search("song 1").size(), 1110u); // 10-19, 100-199 and 1000-1999; 1 was removed
+    EXPECT_EQ(lib.search("renamed").size(), 1u);
+    auto latest = lib.search("song 300");
+    ASSERT_EQ(latest.size(), 2u);
+    EXPECT_EQ(latest[0]->getPath(), "/music/300.mp3");
+    EXPECT_EQ(latest[1]->getPath(), "/music/3000.mp3");
+
+    // Once caught up, new tracks go straight into the index
+    meta.title = "Song 3001";
+    lib.addMedia(std::make_shared<MediaFile>("/music/3001.mp3", meta));
+    EXPECT_TRUE(searchIndexComplete(lib));
+    EXPECT_EQ(lib.search("song 3001").size(), 1u);
+}
+
+TEST_F(LibraryTest, JournalPersistsChangesWithoutRewrites)
+{
+    MemoryPersistence disk;
+    {
+        Library lib(&disk);
+        lib.enableJournal();
+        lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+        lib.addMediaBatch({std::make_shared<MediaFile>("/b.mp3"), std::make_shared<MediaFile>("/c.mp3")});
+        lib.removeMedia("/a.mp3");
+        MediaMetadata meta;
+        meta.title = "Renamed";
+        lib.updateMetadata("/c.mp3", meta);
+    }
+
+    // Four small appends, no full rewrite
+    EXPECT_EQ(disk.appendCount(), 4);
+    EXPECT_EQ(disk.saveCount(), 0);
+    EXPECT_FALSE(disk.fileExists("data/library.json"));
+
+    Library restored(&disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.size(), 2);
+    EXPECT_EQ(restored.getAll()[0]->getPath(), "/b.mp3");
+    EXPECT_EQ(restored.getByPath("/c.mp3")->getMetadata().title, "Renamed");
+    EXPECT_EQ(restored.search("renamed").size(), 1);
+    EXPECT_TRUE(restored.getByPath("/b.mp3")->isInLibrary());
+}
+
+TEST_F(LibraryTest, JournalFoldsIntoBaseOnSave)
+{
+    MemoryPersistence disk;
+    {
+        Library lib(&disk);
+        lib.enableJournal();
+        lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+        lib.addMedia(std::make_shared<MediaFile>("/b.mp3"));
+        ASSERT_TRUE(lib.save());
+        EXPECT_EQ(disk.contents("data/library.journal"), "");
+
+        // Changes after the compaction land in a fresh journal
+        lib.removeMedia("/a.mp3");
+        lib.clear();
+        lib.addMedia(std::make_shared<MediaFile>("/z.mp3"));
+    }
+
+    Library restored(&disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.size(), 1);
+    EXPECT_TRUE(restored.contains("/z.mp3"));
+}
+
+TEST_F(LibraryTest, JournalReplayIsIdempotent)
+{
+    MemoryPersistence disk;
+    Library lib(&disk);
+    lib.enableJournal();
+    lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+    lib.addMedia(std::make_shared<MediaFile>("/b.mp3"));
+    lib.removeMedia("/a.mp3");
+    lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+
+    // Simulate a crash after the base was written but before the journal was truncated
+    std::string journal = disk.contents("data/library.journal");
+    ASSERT_TRUE(lib.save());
+    disk.saveToFile("data/library.journal", journal);
+
+    Library restored(&disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.size(), 2);
+    EXPECT_EQ(restored.getAll()[0]->getPath(), "/b.mp3");
+    EXPECT_EQ(restored.getAll()[1]->getPath(), "/a.mp3");
+}
+
+TEST_F(LibraryTest, FingerprintPersistsThroughEveryFormat)
+{
+    FileFingerprint fingerprint;
+    fingerprint.size = 2048;
+    fingerprint.mtime = 1234567890;
+    fingerprint.inode = 99;
+
+    MemoryPersistence disk;
+    {
+        Library lib(&disk);
+        lib.enableJournal();
+        lib.addMedia(std::make_shared<MediaFile>("/a.mp3"));
+        lib.addMedia(std::make_shared<MediaFile>("/b.mp3"));
+        ASSERT_TRUE(lib.updateMetadata("/a.mp3", MediaMetadata(), fingerprint));
+    }
+
+    // Journal replay
+    Library journaled(&disk);
+    journaled.enableJournal();
+    ASSERT_TRUE(journaled.load());
+    EXPECT_EQ(journaled.getByPath("/a.mp3")->getFingerprint(), fingerprint);
+    EXPECT_FALSE(journaled.getByPath("/b.mp3")->getFingerprint().isValid());
+
+    // JSON save, then binary save
+    ASSERT_TRUE(journaled.save());
+    Library fromJson(&disk);
+    ASSERT_TRUE(fromJson.load());
+    EXPECT_EQ(fromJson.getByPath("/a.mp3")->getFingerprint(), fingerprint);
+
+    fromJson.enableBinarySnapshot();
+    ASSERT_TRUE(fromJson.save());
+    Library fromBinary(&disk);
+    fromBinary.enableBinarySnapshot();
+    ASSERT_TRUE(fromBinary.load());
+    EXPECT_EQ(fromBinary.getByPath("/a.mp3")->getFingerprint(), fingerprint);
+}
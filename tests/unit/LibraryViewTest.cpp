@@ -22,6 +22,7 @@ class LibraryViewTest : public ::testing::Test
     std::shared_ptr<NiceMock<MockPlaybackEngine>> mockEngine;
     std::shared_ptr<Library> library;
     std::unique_ptr<PlaylistManager> playlistManager;
+    std::unique_ptr<PlaylistController> playlistController;
     std::shared_ptr<PlaybackState> playbackState;
     std::shared_ptr<History> history;
     std::unique_ptr<PlaybackController> playbackController;
@@ -63,6 +64,8 @@ class LibraryViewTest : public ::testing::Test
 
         view = std::make_unique<LibraryView>(libraryController.get(), library.get(), playbackController.get(),
                                              playlistManager.get());
+        playlistController = std::make_unique<PlaylistController>(playlistManager.get(), library.get(), nullptr);
+        view->setPlaylistController(playlistController.get());
     }
 
     void TearDown() override
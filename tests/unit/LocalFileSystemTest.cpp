@@ -1,8 +1,10 @@
 #include "service/LocalFileSystem.h"
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <mutex>
 
 namespace fs = std::filesystem;
 
@@ -61,6 +63,15 @@ TEST_F(LocalFileSystemTest, BrowseDirectory)
     EXPECT_TRUE(contains(results, "subdir"));
 }
 
+TEST_F(LocalFileSystemTest, ListDirectoriesSkipsFiles)
+{
+    auto directories = fsClient.listDirectories(testDir);
+    ASSERT_EQ(directories.size(), 1u);
+    EXPECT_EQ(fs::path(directories[0]).filename().string(), "subdir");
+
+    EXPECT_TRUE(fsClient.listDirectories(testDir + "/missing").empty());
+}
+
 TEST_F(LocalFileSystemTest, ScanDirectoryDeep)
 {
     std::vector<std::string> exts = {".mp3"};
@@ -184,3 +195,122 @@ TEST_F(LocalFileSystemTest, ScanDepthLimits)
     // level3/file.mp3 is at depth 3
     EXPECT_EQ(fsClient.scanDirectory(testDir, {".mp3"}, 3).size(), 3); 
 }
+
+TEST_F(LocalFileSystemTest, FingerprintTracksContentChanges)
+{
+    std::string path = testDir + "/file1.mp3";
+    FileFingerprint before;
+    ASSERT_TRUE(fsClient.getFingerprint(path, before));
+    EXPECT_TRUE(before.isValid());
+    EXPECT_EQ(before.size, 0u);
+
+    FileFingerprint again;
+    ASSERT_TRUE(fsClient.getFingerprint(path, again));
+    EXPECT_EQ(before, again);
+
+    {
+        std::ofstream ofs(path, std::ios::app);
+        ofs << "more data";
+    }
+    FileFingerprint after;
+    ASSERT_TRUE(fsClient.getFingerprint(path, after));
+    EXPECT_NE(before, after);
+    EXPECT_EQ(after.size, 9u);
+
+    FileFingerprint missing;
+    EXPECT_FALSE(fsClient.getFingerprint(testDir + "/missing.mp3", missing));
+}
+
+TEST_F(LocalFileSystemTest, ParallelScanMatchesSequential)
+{
+    // A few hundred files over nested directories, with mixed-case extensions
+    for (int d = 0; d < 10; ++d)
+    {
+        std::string dir = testDir + "/tree/d" + std::to_string(d) + "/inner";
+        fs::create_directories(dir);
+        for (int f = 0; f < 20; ++f)
+        {
+            std::ofstream(dir + "/song" + std::to_string(f) + (f % 2 ? ".MP3" : ".flac")).close();
+            std::ofstream(dir + "/cover" + std::to_string(f) + ".jpg").close();
+        }
+    }
+    std::ofstream(testDir + "/.mp3").close(); // Dotfile, not an extension
+
+    LocalFileSystem parallel(LocalFileSystem::ScanMode::PARALLEL, 4);
+    EXPECT_EQ(parallel.getScanMode(), LocalFileSystem::ScanMode::PARALLEL);
+
+    for (int depth : {-1, 0, 1, 3})
+    {
+        auto expected = fsClient.scanDirectory(testDir, {".mp3", ".FLAC"}, depth);
+        std::sort(expected.begin(), expected.end());
+        auto actual = parallel.scanDirectory(testDir, {".mp3", ".FLAC"}, depth);
+        EXPECT_EQ(actual, expected) << "maxDepth " << depth;
+    }
+    EXPECT_EQ(parallel.scanDirectory(testDir, {".mp3", ".flac"}).size(), 202u);
+}
+
+TEST_F(LocalFileSystemTest, ParallelScanSurvivesSymlinkCycles)
+{
+    fs::create_directories(testDir + "/loop");
+    std::ofstream(testDir + "/loop/track.mp3").close();
+    fs::create_directory_symlink("..", testDir + "/loop/up");
+
+    LocalFileSystem parallel(LocalFileSystem::ScanMode::PARALLEL, 3);
+    auto results = parallel.scanDirectory(testDir + "/loop", {".mp3"});
+    EXPECT_FALSE(results.empty());
+    EXPECT_TRUE(containsStr(results, "track.mp3"));
+    EXPECT_TRUE(parallel.scanDirectory(testDir + "/missing", {".mp3"}).empty());
+}
+
+TEST_F(LocalFileSystemTest, StreamingScanStopsOnRequest)
+{
+    for (int i = 0; i < 50; ++i)
+    {
+        std::ofstream(testDir + "/subdir/extra" + std::to_string(i) + ".mp3").close();
+    }
+
+    for (auto mode : {LocalFileSystem::ScanMode::SEQUENTIAL, LocalFileSystem::ScanMode::PARALLEL})
+    {
+        LocalFileSystem scanner(mode, 2);
+        std::mutex mutex;
+        std::vector<std::string> streamed;
+        scanner.scanDirectoryStreaming(testDir, {".mp3"}, -1,
+                                       [&](const std::string &path)
+                                       {
+                                           std::lock_guard<std::mutex> lock(mutex);
+                                           streamed.push_back(path);
+                                           return true;
+                                       });
+        std::sort(streamed.begin(), streamed.end());
+        auto expected = fsClient.scanDirectory(testDir, {".mp3"});
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(streamed, expected);
+
+        std::atomic<int> seen{0};
+        scanner.scanDirectoryStreaming(testDir, {".mp3"}, -1, [&](const std::string &) { return ++seen < 5; });
+        // Parallel workers may each deliver one more match before noticing the stop
+        EXPECT_GE(seen.load(), 5);
+        EXPECT_LT(seen.load(), 52);
+    }
+}
+
+TEST_F(LocalFileSystemTest, VerifyFilesReportsMissingAndChanged)
+{
+    std::string same = testDir + "/file1.mp3";
+    std::string edited = testDir + "/subdir/file3.mp3";
+    FileFingerprint sameFp, editedFp;
+    ASSERT_TRUE(fsClient.getFingerprint(same, sameFp));
+    ASSERT_TRUE(fsClient.getFingerprint(edited, editedFp));
+    std::ofstream(edited) << "new tags";
+
+    std::vector<FileCheck> checks = {
+        {same, sameFp}, {testDir + "/gone.mp3", sameFp}, {edited, editedFp}, {testDir + "/file2.txt", {}}};
+    VerifyResult result = fsClient.verifyFiles(checks);
+
+    ASSERT_EQ(result.missing.size(), 1u);
+    EXPECT_EQ(result.missing[0], testDir + "/gone.mp3");
+    ASSERT_EQ(result.changed.size(), 2u); // Edited, and never fingerprinted
+    EXPECT_EQ(result.changed[0].first, edited);
+    EXPECT_EQ(result.changed[0].second.size, 8u);
+    EXPECT_EQ(result.changed[1].first, testDir + "/file2.txt");
+}
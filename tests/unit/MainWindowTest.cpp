@@ -161,8 +161,13 @@ TEST_F(MainWindowTest, RenderingStates)
     auto track = std::make_shared<MediaFile>("/art.mp3");
     MediaMetadata meta;
     meta.hasAlbumArt = true;
-    meta.albumArtData = {0x89, 0x50, 0x4E, 0x47}; // Fake PNG header
     track->setMetadata(meta);
+    AlbumArt fakeArt;
+    fakeArt.data = {0x89, 0x50, 0x4E, 0x47}; // Fake PNG header
+    EXPECT_CALL(*mockMeta, readAlbumArt("/art.mp3", _))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<1>(fakeArt), Return(true)));
+    AlbumArtStore artStore(mockMeta.get());
+    window->setAlbumArtStore(&artStore);
     playbackState->setPlayback(track, PlaybackStatus::PLAYING);
 
     startFrame();
@@ -175,6 +180,7 @@ TEST_F(MainWindowTest, RenderingStates)
     startFrame();
     window->render();
     endFrame();
+    window->setAlbumArtStore(nullptr);
 }
 
 TEST_F(MainWindowTest, PopupRendering)
@@ -1,9 +1,11 @@
 #include "app/model/MediaFile.h"
+#include <atomic>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <json.hpp>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -162,8 +164,42 @@ TEST_F(MediaFileTest, Setters)
 
     MediaMetadata meta;
     meta.album = "New Album";
+    uint64_t revision = file.getMetadataRevision();
     file.setMetadata(meta);
     EXPECT_EQ(file.getMetadata().album, "New Album");
+    EXPECT_GT(file.getMetadataRevision(), revision);
+}
+
+TEST_F(MediaFileTest, ReadersNeverSeeHalfUpdatedMetadata)
+{
+    MediaMetadata meta;
+    meta.title = "0";
+    meta.artist = "0";
+    MediaFile file(audioFile, meta);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader(
+        [&]()
+        {
+            while (!done)
+            {
+                MediaMetadata seen = file.getMetadata();
+                if (seen.title != seen.artist)
+                    torn++;
+            }
+        });
+    for (int i = 1; i <= 2000; ++i)
+    {
+        meta.title = meta.artist = std::to_string(i);
+        file.setMetadata(meta, FileFingerprint{static_cast<uint64_t>(i), i, 1});
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(file.getMetadata().title, "2000");
+    EXPECT_EQ(file.getFingerprint().size, 2000u);
 }
 
 TEST_F(MediaFileTest, JsonSerializationComprehensive)
@@ -176,6 +212,13 @@ TEST_F(MediaFileTest, JsonSerializationComprehensive)
     meta.year = 2024;
     meta.track = 5;
     meta.duration = 120;
+    meta.bitrate = 320;
+    meta.sampleRate = 48000;
+    meta.channels = 2;
+    meta.hasAlbumArt = true;
+    meta.codec = "mp3";
+    meta.comment = "JSON Comment";
+    meta.customFields = {{"composer", "JSON Composer"}};
 
     MediaFile original(audioFile, meta);
     original.setInLibrary(true);
@@ -194,6 +237,13 @@ TEST_F(MediaFileTest, JsonSerializationComprehensive)
     EXPECT_EQ(restored.getMetadata().year, 2024);
     EXPECT_EQ(restored.getMetadata().track, 5);
     EXPECT_EQ(restored.getMetadata().duration, 120);
+    EXPECT_EQ(restored.getMetadata().bitrate, 320);
+    EXPECT_EQ(restored.getMetadata().sampleRate, 48000);
+    EXPECT_EQ(restored.getMetadata().channels, 2);
+    EXPECT_TRUE(restored.getMetadata().hasAlbumArt);
+    EXPECT_EQ(restored.getMetadata().codec, "mp3");
+    EXPECT_EQ(restored.getMetadata().comment, "JSON Comment");
+    EXPECT_EQ(restored.getMetadata().customFields, meta.customFields);
     EXPECT_TRUE(restored.isInLibrary());
 }
 
@@ -224,3 +274,34 @@ TEST_F(MediaFileTest, JsonDeserializationPartial)
     EXPECT_EQ(m3.getMetadata().year, 1999);
     EXPECT_EQ(m3.getMetadata().title, ""); // Default
 }
+
+TEST_F(MediaFileTest, JsonFingerprintRoundTrip)
+{
+    MediaFile original(audioFile);
+    nlohmann::json j;
+    to_json(j, original);
+    EXPECT_FALSE(j.contains("fingerprint")); // Never stat'ed, nothing to store
+
+    FileFingerprint fingerprint;
+    fingerprint.size = 123;
+    fingerprint.mtime = 1700000000000000001;
+    fingerprint.inode = 42;
+    original.setFingerprint(fingerprint);
+    to_json(j, original);
+
+    MediaFile restored("");
+    from_json(j, restored);
+    EXPECT_EQ(restored.getFingerprint(), fingerprint);
+}
+
+TEST_F(MediaFileTest, JsonWithoutFullMetadataDropsFingerprint)
+{
+    // Saved before hasAlbumArt and the stream fields were stored: the file must be read again
+    nlohmann::json j = {{"path", "/test/old.mp3"},
+                        {"metadata", {{"title", "Old"}}},
+                        {"fingerprint", {{"size", 1}, {"mtime", 2}, {"inode", 3}}}};
+    MediaFile restored("");
+    from_json(j, restored);
+    EXPECT_EQ(restored.getMetadata().title, "Old");
+    EXPECT_FALSE(restored.getFingerprint().isValid());
+}
@@ -0,0 +1,75 @@
+#include "service/MpvMetadataReader.h"
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <vector>
+
+class MpvMetadataReaderTest : public ::testing::Test
+{
+  protected:
+    std::string sampleFlac = "tests/assets/sample.flac";
+
+    bool haveSample() const
+    {
+        return std::ifstream(sampleFlac).good();
+    }
+};
+
+TEST_F(MpvMetadataReaderTest, CreatesRequestedContexts)
+{
+    MpvMetadataReader reader(3);
+    EXPECT_EQ(reader.getContextCount(), 3u);
+
+    MpvMetadataReader atLeastOne(0);
+    EXPECT_EQ(atLeastOne.getContextCount(), 1u);
+}
+
+TEST_F(MpvMetadataReaderTest, MissingFileFailsWithoutWaitingForDeadline)
+{
+    MpvMetadataReader reader(1, std::chrono::milliseconds(5000));
+
+    auto start = std::chrono::steady_clock::now();
+    MediaMetadata meta = reader.readMetadata("tests/assets/does_not_exist.flac");
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(meta.duration, 0);
+    // An error event ends the probe; the 5 s deadline is never reached
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2500));
+    EXPECT_EQ(reader.getContextCount(), 1u);
+}
+
+TEST_F(MpvMetadataReaderTest, ContextIsReusableAfterAProbe)
+{
+    if (!haveSample())
+        GTEST_SKIP() << "sample.flac not available";
+
+    MpvMetadataReader reader(1);
+    MediaMetadata first = reader.readMetadata(sampleFlac);
+    reader.readMetadata("tests/assets/does_not_exist.flac");
+    MediaMetadata second = reader.readMetadata(sampleFlac);
+
+    EXPECT_EQ(first.duration, second.duration);
+    EXPECT_EQ(first.title, second.title);
+}
+
+TEST_F(MpvMetadataReaderTest, ParallelProbesShareThePool)
+{
+    if (!haveSample())
+        GTEST_SKIP() << "sample.flac not available";
+
+    MpvMetadataReader reader(2);
+    MediaMetadata expected = reader.readMetadata(sampleFlac);
+
+    // More callers than contexts: the extra ones wait for a free context
+    std::vector<std::future<MediaMetadata>> probes;
+    for (int i = 0; i < 6; ++i)
+    {
+        probes.push_back(std::async(std::launch::async, [&]() { return reader.readMetadata(sampleFlac); }));
+    }
+    for (auto &probe : probes)
+    {
+        EXPECT_EQ(probe.get().duration, expected.duration);
+    }
+    EXPECT_EQ(reader.getContextCount(), 2u);
+}
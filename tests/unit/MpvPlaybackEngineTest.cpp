@@ -1,5 +1,6 @@
 #include "service/MpvPlaybackEngine.h"
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <chrono>
 #include <gtest/gtest.h>
 #include <thread>
@@ -84,6 +85,35 @@ class MpvPlaybackEngineTest : public ::testing::Test
     {
         return engine.mpv_gl_;
     }
+
+    static constexpr uint64_t PAUSE = MpvPlaybackEngine::PROP_PAUSE;
+    static constexpr uint64_t IDLE_ACTIVE = MpvPlaybackEngine::PROP_IDLE_ACTIVE;
+    static constexpr uint64_t TIME_POS = MpvPlaybackEngine::PROP_TIME_POS;
+    static constexpr uint64_t DURATION = MpvPlaybackEngine::PROP_DURATION;
+    static constexpr uint64_t VOLUME = MpvPlaybackEngine::PROP_VOLUME;
+
+    void changeFlag(MpvPlaybackEngine &engine, uint64_t id, int flag)
+    {
+        mpv_event_property property{"", MPV_FORMAT_FLAG, &flag};
+        engine.onPropertyChange(id, &property);
+    }
+
+    void changeDouble(MpvPlaybackEngine &engine, uint64_t id, double value)
+    {
+        mpv_event_property property{"", MPV_FORMAT_DOUBLE, &value};
+        engine.onPropertyChange(id, &property);
+    }
+
+    void unavailable(MpvPlaybackEngine &engine, uint64_t id)
+    {
+        mpv_event_property property{"", MPV_FORMAT_NONE, nullptr};
+        engine.onPropertyChange(id, &property);
+    }
+
+    void postEndOfFile(MpvPlaybackEngine &engine)
+    {
+        engine.post(MpvPlaybackEngine::EngineEvent::END_OF_FILE);
+    }
 };
 
 TEST_F(MpvPlaybackEngineTest, InitAndProperties)
@@ -312,5 +342,123 @@ TEST_F(MpvPlaybackEngineTest, VideoRenderingLoop)
     }
 }
 
+TEST_F(MpvPlaybackEngineTest, GettersReadObservedProperties)
+{
+    try
+    {
+        MpvPlaybackEngine engine;
+        changeFlag(engine, IDLE_ACTIVE, 0);
+        changeFlag(engine, PAUSE, 0);
+        EXPECT_EQ(engine.getState(), PlaybackStatus::PLAYING);
+        changeFlag(engine, PAUSE, 1);
+        EXPECT_EQ(engine.getState(), PlaybackStatus::PAUSED);
+
+        changeDouble(engine, TIME_POS, 12.5);
+        changeDouble(engine, DURATION, 180.0);
+        changeDouble(engine, VOLUME, 40.0);
+        EXPECT_EQ(engine.getCurrentPosition(), 12.5);
+        EXPECT_EQ(engine.getDuration(), 180.0);
+        EXPECT_NEAR(engine.getVolume(), 0.4f, 0.001f);
+
+        // Unloading the file makes position and duration unavailable; the volume stays
+        unavailable(engine, TIME_POS);
+        unavailable(engine, DURATION);
+        unavailable(engine, VOLUME);
+        changeFlag(engine, IDLE_ACTIVE, 1);
+        EXPECT_EQ(engine.getCurrentPosition(), 0.0);
+        EXPECT_EQ(engine.getDuration(), 0.0);
+        EXPECT_NEAR(engine.getVolume(), 0.4f, 0.001f);
+        EXPECT_EQ(engine.getState(), PlaybackStatus::STOPPED);
+    }
+    catch (...)
+    {
+        GTEST_SKIP() << "MPV initialization failed";
+    }
+}
+
+TEST_F(MpvPlaybackEngineTest, PropertyEventsFollowPlayback)
+{
+    try
+    {
+        MpvPlaybackEngine engine;
+        engine.play(validMp3);
+        for (int i = 0; i < 100 && engine.getDuration() <= 0.0; ++i)
+        {
+            engine.updateVideo();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_GT(engine.getDuration(), 0.0);
+        EXPECT_EQ(engine.getState(), PlaybackStatus::PLAYING);
+
+        engine.pause();
+        EXPECT_EQ(engine.getState(), PlaybackStatus::PAUSED);
+        engine.stop();
+    }
+    catch (...)
+    {
+        GTEST_SKIP() << "MPV initialization failed";
+    }
+}
+
+TEST_F(MpvPlaybackEngineTest, ObserversRunOnlyFromDispatchEvents)
+{
+    class CountingObserver : public IObserver
+    {
+      public:
+        int updates = 0;
+        void update(void *subject) override
+        {
+            updates++;
+        }
+    };
+
+    try
+    {
+        MpvPlaybackEngine engine;
+        CountingObserver obs;
+        engine.attach(&obs);
+
+        postEndOfFile(engine);
+        postEndOfFile(engine);
+        EXPECT_EQ(obs.updates, 0);
+
+        engine.dispatchEvents();
+        EXPECT_EQ(obs.updates, 2);
+        engine.dispatchEvents();
+        EXPECT_EQ(obs.updates, 2);
+        engine.detach(&obs);
+    }
+    catch (...)
+    {
+        GTEST_SKIP() << "MPV initialization failed";
+    }
+}
+
+TEST_F(MpvPlaybackEngineTest, EndOfFileDetectedWithoutFrames)
+{
+    try
+    {
+        MpvPlaybackEngine engine;
+        engine.play(validMp3);
+        // No updateVideo() calls: the event thread alone keeps the engine current
+        for (int i = 0; i < 200 && engine.getDuration() <= 0.0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_GT(engine.getDuration(), 0.0);
+
+        engine.seek(std::max(0.0, engine.getDuration() - 0.2));
+        for (int i = 0; i < 300 && !engine.isFinished(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_TRUE(engine.isFinished());
+    }
+    catch (...)
+    {
+        GTEST_SKIP() << "MPV initialization failed";
+    }
+}
+
 SDL_Window *MpvPlaybackEngineTest::window = nullptr;
 SDL_GLContext MpvPlaybackEngineTest::glContext = nullptr;
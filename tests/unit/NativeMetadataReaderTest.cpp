@@ -0,0 +1,298 @@
+#include "service/NativeMetadataReader.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+std::string be32(uint32_t value)
+{
+    return {char(value >> 24), char(value >> 16), char(value >> 8), char(value)};
+}
+
+std::string le32(uint32_t value)
+{
+    return {char(value), char(value >> 8), char(value >> 16), char(value >> 24)};
+}
+
+std::string le64(uint64_t value)
+{
+    return le32(static_cast<uint32_t>(value)) + le32(static_cast<uint32_t>(value >> 32));
+}
+
+std::string syncsafe(uint32_t value)
+{
+    return {char((value >> 21) & 0x7F), char((value >> 14) & 0x7F), char((value >> 7) & 0x7F), char(value & 0x7F)};
+}
+
+std::string id3v23Frame(const std::string &id, const std::string &body)
+{
+    return id + be32(static_cast<uint32_t>(body.size())) + std::string(2, '\0') + body;
+}
+
+std::string id3v23Tag(const std::string &frames)
+{
+    return std::string("ID3\x03\x00\x00", 6) + syncsafe(static_cast<uint32_t>(frames.size())) + frames;
+}
+
+/**
+ * MPEG-1 Layer III, 128 kbit/s, 44.1 kHz, joint stereo: 417 bytes per frame
+ */
+std::string mpegFrame()
+{
+    std::string frame(417, '\0');
+    frame[0] = char(0xFF);
+    frame[1] = char(0xFB);
+    frame[2] = char(0x90);
+    frame[3] = char(0x40);
+    return frame;
+}
+
+std::string vorbisComments(const std::vector<std::string> &entries)
+{
+    std::string out = le32(6) + "vendor" + le32(static_cast<uint32_t>(entries.size()));
+    for (const auto &entry : entries)
+        out += le32(static_cast<uint32_t>(entry.size())) + entry;
+    return out;
+}
+
+std::string oggPage(uint32_t serial, uint32_t sequence, uint64_t granule, const std::string &packet)
+{
+    std::string lacing;
+    size_t left = packet.size();
+    while (left >= 255)
+    {
+        lacing += char(255);
+        left -= 255;
+    }
+    lacing += char(left);
+    return std::string("OggS\0\0", 6) + le64(granule) + le32(serial) + le32(sequence) + le32(0) +
+           char(lacing.size()) + lacing + packet;
+}
+
+std::string mp4Box(const std::string &type, const std::string &body)
+{
+    return be32(static_cast<uint32_t>(8 + body.size())) + type + body;
+}
+
+std::string ilstText(const std::string &type, const std::string &text)
+{
+    return mp4Box(type, mp4Box("data", be32(1) + be32(0) + text));
+}
+
+MediaMetadata parse(const std::string &extension, const std::string &bytes, bool *ok = nullptr)
+{
+    MediaMetadata metadata;
+    bool result = NativeMetadataReader::parse(extension, bytes.data(), bytes.size(), metadata);
+    if (ok)
+        *ok = result;
+    return metadata;
+}
+} // namespace
+
+TEST(NativeMetadataReaderTest, Mp3Id3v23AndXingFrameCount)
+{
+    std::string tag = id3v23Tag(id3v23Frame("TIT2", std::string("\0Song", 5)) +
+                                id3v23Frame("TPE1", std::string("\x01\xFF\xFE" "A\0r\0t\0", 9)) +
+                                id3v23Frame("TALB", std::string("\0Album", 6)) +
+                                id3v23Frame("TCON", std::string("\0(17)", 5)) +
+                                id3v23Frame("TYER", std::string("\0" "2001", 5)) +
+                                id3v23Frame("TRCK", std::string("\0" "7/12", 5)) +
+                                id3v23Frame("COMM", std::string("\0engdesc\0ignored", 16)) +
+                                id3v23Frame("COMM", std::string("\0eng\0Note", 9)) +
+                                id3v23Frame("APIC", std::string("\0image/png\0\x03\0data", 17)));
+
+    // Xing header after 32 bytes of side information, counting frames of 1152 samples at 44.1 kHz
+    std::string first = mpegFrame();
+    first.replace(36, 12, "Xing" + be32(1) + be32(3829));
+    std::string file = tag + first;
+    for (int i = 0; i < 3; ++i)
+        file += mpegFrame();
+
+    bool ok = false;
+    MediaMetadata meta = parse(".mp3", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.title, "Song");
+    EXPECT_EQ(meta.artist, "Art");
+    EXPECT_EQ(meta.album, "Album");
+    EXPECT_EQ(meta.genre, "Rock");
+    EXPECT_EQ(meta.year, 2001);
+    EXPECT_EQ(meta.track, 7);
+    EXPECT_EQ(meta.comment, "Note");
+    EXPECT_TRUE(meta.hasAlbumArt);
+    EXPECT_EQ(meta.duration, 100); // 3829 * 1152 / 44100 = 100.02 s
+    EXPECT_EQ(meta.sampleRate, 44100);
+    EXPECT_EQ(meta.channels, 2);
+    EXPECT_EQ(meta.codec, "MP3");
+}
+
+TEST(NativeMetadataReaderTest, Mp3ConstantBitrateWithId3v1)
+{
+    // 128 kbit/s: 16000 bytes per second, so 4 seconds of frames
+    std::string file;
+    while (file.size() < 64000)
+        file += mpegFrame();
+    file.resize(64000);
+
+    std::string v1(128, '\0');
+    v1.replace(0, 3, "TAG");
+    v1.replace(3, 5, "Title");
+    v1.replace(33, 6, "Artist");
+    v1.replace(93, 4, "1999");
+    v1[126] = 3;
+    v1[127] = 8; // Jazz
+    file += v1;
+
+    bool ok = false;
+    MediaMetadata meta = parse(".mp3", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.duration, 4);
+    EXPECT_EQ(meta.bitrate, 128);
+    EXPECT_EQ(meta.title, "Title");
+    EXPECT_EQ(meta.artist, "Artist");
+    EXPECT_EQ(meta.year, 1999);
+    EXPECT_EQ(meta.track, 3);
+    EXPECT_EQ(meta.genre, "Jazz");
+}
+
+TEST(NativeMetadataReaderTest, FlacStreamInfoCommentsAndPicture)
+{
+    // 48 kHz, stereo, 16 bit, 480000 samples = 10 s
+    std::string info(18, '\0');
+    info[10] = char(0x0B);
+    info[11] = char(0xB8);
+    info[12] = char(0x02);
+    info[13] = char(0xF0);
+    info.replace(14, 4, be32(480000));
+
+    std::string comments = vorbisComments({"title=Flac Song", "ARTIST=Someone", "Date=2015-03-01", "TRACKNUMBER=4"});
+    std::string picture(32, '\0');
+    std::string file = "fLaC" + std::string("\x00", 1) + be32(18).substr(1) + info;
+    file += std::string("\x04", 1) + be32(static_cast<uint32_t>(comments.size())).substr(1) + comments;
+    file += std::string("\x86", 1) + be32(static_cast<uint32_t>(picture.size())).substr(1) + picture;
+    file += std::string(120000, '\x55'); // 96 kbit/s of "audio"
+
+    bool ok = false;
+    MediaMetadata meta = parse(".flac", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.duration, 10);
+    EXPECT_EQ(meta.sampleRate, 48000);
+    EXPECT_EQ(meta.channels, 2);
+    EXPECT_EQ(meta.bitrate, 96);
+    EXPECT_EQ(meta.title, "Flac Song");
+    EXPECT_EQ(meta.artist, "Someone");
+    EXPECT_EQ(meta.year, 2015);
+    EXPECT_EQ(meta.track, 4);
+    EXPECT_TRUE(meta.hasAlbumArt);
+    EXPECT_EQ(meta.codec, "FLAC");
+}
+
+TEST(NativeMetadataReaderTest, OggVorbisUsesLastGranule)
+{
+    std::string ident = std::string("\x01vorbis", 7) + le32(0) + char(2) + le32(44100) + le32(0) + le32(160000) +
+                        le32(0) + char(0xB8) + char(1);
+    std::string comments = std::string("\x03vorbis", 7) + vorbisComments({"ALBUM=Ogg Album", "GENRE=Ambient"});
+
+    std::string file = oggPage(7, 0, 0, ident) + oggPage(7, 1, 0, comments);
+    file += oggPage(9, 0, 999999999, "other stream");
+    file += oggPage(7, 2, 44100 * 65, std::string(300, 'a'));
+
+    bool ok = false;
+    MediaMetadata meta = parse(".ogg", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.duration, 65);
+    EXPECT_EQ(meta.sampleRate, 44100);
+    EXPECT_EQ(meta.channels, 2);
+    EXPECT_EQ(meta.bitrate, 160);
+    EXPECT_EQ(meta.album, "Ogg Album");
+    EXPECT_EQ(meta.genre, "Ambient");
+    EXPECT_EQ(meta.codec, "Vorbis");
+}
+
+TEST(NativeMetadataReaderTest, OpusSubtractsPreSkip)
+{
+    std::string head = std::string("OpusHead", 8) + char(1) + char(2) + std::string("\x38\x01", 2) + le32(44100) +
+                       std::string(3, '\0');
+    std::string tags = std::string("OpusTags", 8) + vorbisComments({"TITLE=Opus Song"});
+
+    std::string file = oggPage(3, 0, 0, head) + oggPage(3, 1, 0, tags) + oggPage(3, 2, 312 + 48000 * 30, "x");
+
+    bool ok = false;
+    MediaMetadata meta = parse(".opus", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.duration, 30);
+    EXPECT_EQ(meta.sampleRate, 48000);
+    EXPECT_EQ(meta.title, "Opus Song");
+    EXPECT_EQ(meta.codec, "Opus");
+}
+
+TEST(NativeMetadataReaderTest, Mp4MovieHeaderSampleEntryAndIlst)
+{
+    std::string mvhd = mp4Box("mvhd", std::string(12, '\0') + be32(1000) + be32(215000) + std::string(80, '\0'));
+
+    std::string esds = mp4Box("esds", be32(0) + std::string("\x03\x19\x00\x01\x00", 5) + std::string("\x04\x11", 2) +
+                                          std::string("\x40\x15\x00\x00\x00", 5) + be32(256000) + be32(256000));
+    std::string mp4a = mp4Box("mp4a", std::string(16, '\0') + std::string("\x00\x02\x00\x10", 4) + be32(0) +
+                                          be32(44100u << 16) + esds);
+    std::string stsd = mp4Box("stsd", be32(0) + be32(1) + mp4a);
+    std::string hdlr = mp4Box("hdlr", be32(0) + be32(0) + "soun" + std::string(12, '\0'));
+    std::string trak = mp4Box("trak", mp4Box("mdia", hdlr + mp4Box("minf", mp4Box("stbl", stsd))));
+
+    std::string ilst = mp4Box("ilst", ilstText("\xA9nam", "M4A Song") + ilstText("\xA9" "ART", "M4A Artist") +
+                                          ilstText("\xA9" "day", "2020-01-01") +
+                                          mp4Box("trkn", mp4Box("data", be32(0) + be32(0) + be32(9) + be32(0))) +
+                                          mp4Box("covr", mp4Box("data", be32(14) + be32(0) + "png")));
+    std::string udta = mp4Box("udta", mp4Box("meta", be32(0) + ilst));
+
+    std::string file = mp4Box("ftyp", "M4A " + be32(0)) + mp4Box("moov", mvhd + trak + udta);
+
+    bool ok = false;
+    MediaMetadata meta = parse(".m4a", file, &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(meta.duration, 215);
+    EXPECT_EQ(meta.sampleRate, 44100);
+    EXPECT_EQ(meta.channels, 2);
+    EXPECT_EQ(meta.bitrate, 256);
+    EXPECT_EQ(meta.title, "M4A Song");
+    EXPECT_EQ(meta.artist, "M4A Artist");
+    EXPECT_EQ(meta.year, 2020);
+    EXPECT_EQ(meta.track, 9);
+    EXPECT_TRUE(meta.hasAlbumArt);
+    EXPECT_EQ(meta.codec, "AAC");
+}
+
+TEST(NativeMetadataReaderTest, GarbageAndTruncatedInputAreRejected)
+{
+    std::string garbage(4096, '\x7A');
+    for (const char *ext : {".mp3", ".flac", ".ogg", ".m4a"})
+    {
+        MediaMetadata meta;
+        EXPECT_FALSE(NativeMetadataReader::parse(ext, garbage.data(), garbage.size(), meta)) << ext;
+        EXPECT_FALSE(NativeMetadataReader::parse(ext, garbage.data(), 0, meta)) << ext;
+    }
+
+    // A tag that claims more bytes than the file has must not be read past the end
+    std::string truncated = id3v23Tag(id3v23Frame("TIT2", std::string("\0Song", 5)));
+    truncated.resize(truncated.size() - 3);
+    bool ok = true;
+    parse(".mp3", truncated, &ok);
+    EXPECT_FALSE(ok);
+}
+
+TEST(NativeMetadataReaderTest, UnsupportedFormatsAreLeftToOtherReaders)
+{
+    EXPECT_TRUE(NativeMetadataReader::isFormatSupported(".flac"));
+    EXPECT_TRUE(NativeMetadataReader::isFormatSupported(".m4a"));
+    EXPECT_FALSE(NativeMetadataReader::isFormatSupported(".wav"));
+    EXPECT_FALSE(NativeMetadataReader::isFormatSupported(".mkv"));
+
+    NativeMetadataReader reader;
+    std::string path = "native_reader_test.wav";
+    std::ofstream(path) << "RIFF";
+    EXPECT_EQ(reader.readMetadata(path).duration, 0);
+    EXPECT_TRUE(reader.extractTags(path, {"title"}).empty());
+    EXPECT_FALSE(reader.supportsEditing(path));
+    std::remove(path.c_str());
+}
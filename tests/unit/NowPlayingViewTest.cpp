@@ -22,6 +22,7 @@ class NowPlayingViewTest : public ::testing::Test
     std::shared_ptr<History> history;
     std::unique_ptr<PlaybackController> playbackController;
     std::unique_ptr<PlaylistManager> playlistManager;
+    std::unique_ptr<PlaylistController> playlistController;
 
     std::unique_ptr<NowPlayingView> view;
 
@@ -218,7 +219,8 @@ TEST_F(NowPlayingViewTest, FavoritesRemoval)
     playbackState->setPlayback(track, PlaybackStatus::PLAYING);
 
     playlistManager = std::make_unique<PlaylistManager>(mockPersist.get());
-    view->setPlaylistManager(playlistManager.get());
+    playlistController = std::make_unique<PlaylistController>(playlistManager.get(), nullptr, nullptr);
+    view->setPlaylistController(playlistController.get());
     
     // Add to favorites first
     auto favPlaylist = playlistManager->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME);
@@ -371,7 +373,8 @@ TEST_F(NowPlayingViewTest, EventHandlersExhaustive)
     playbackState->setPlayback(track, PlaybackStatus::PLAYING);
 
     playlistManager = std::make_unique<PlaylistManager>(mockPersist.get());
-    view->setPlaylistManager(playlistManager.get());
+    playlistController = std::make_unique<PlaylistController>(playlistManager.get(), nullptr, nullptr);
+    view->setPlaylistController(playlistController.get());
 
     // 1. onPlayClicked BRANCHES
     playbackState->setStatus(PlaybackStatus::PLAYING);
@@ -389,6 +392,9 @@ TEST_F(NowPlayingViewTest, EventHandlersExhaustive)
     onRepeatClickedHelper();
     onFavoriteClickedHelper(true);
     onFavoriteClickedHelper(false);
+    EXPECT_TRUE(playlistManager->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME)->contains("/t.mp3"));
+    onFavoriteClickedHelper(true);
+    EXPECT_FALSE(playlistManager->getPlaylist(PlaylistManager::FAVORITES_PLAYLIST_NAME)->contains("/t.mp3"));
 }
 
 TEST_F(NowPlayingViewTest, DestructorCleanup)
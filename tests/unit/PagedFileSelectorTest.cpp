@@ -138,6 +138,22 @@ TEST_F(PagedFileSelectorTest, PaginationUpdatesOnResize)
     EXPECT_EQ(getCurrentPage(), 1);
 }
 
+TEST_F(PagedFileSelectorTest, MergeItemsKeepsListSorted)
+{
+    auto byName = [](const FileInfo &a, const FileInfo &b) { return a.name < b.name; };
+    selector.setItemsPerPage(2);
+    selector.setItems({{"/a", "a", "mp3", 0, false}, {"/d", "d", "mp3", 0, false}});
+    selector.mergeItems({{"/e", "e", "mp3", 0, false}, {"/b", "b", "mp3", 0, false}}, byName);
+
+    const auto &items = selector.getItems();
+    ASSERT_EQ(items.size(), 4u);
+    EXPECT_EQ(items[0].name, "a");
+    EXPECT_EQ(items[1].name, "b");
+    EXPECT_EQ(items[2].name, "d");
+    EXPECT_EQ(items[3].name, "e");
+    EXPECT_EQ(getTotalPages(), 2);
+}
+
 TEST_F(PagedFileSelectorTest, SelectAll)
 {
     std::vector<FileInfo> items;
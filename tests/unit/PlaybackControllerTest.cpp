@@ -4,6 +4,7 @@
 #include "app/model/Playlist.h" // Needed for Playlist logic
 #include "tests/mocks/MockPersistence.h"
 #include "tests/mocks/MockPlaybackEngine.h"
+#include "tests/mocks/SimulatedPlaybackEngine.h"
 #include "utils/Config.h" // Added for Config mock
 #include <gtest/gtest.h>
 
@@ -247,23 +248,50 @@ TEST_F(PlaybackControllerTest, UpdateTimeAdvances)
     state->setDuration(100.0);
     state->setPosition(10.0);
 
-    // Regular update
-    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(false));
+    // Regular update; the end of file is the engine event's business, not polled here
+    EXPECT_CALL(*mockEngine, isFinished()).Times(0);
     controller->updateTime(0.5); // deltaTime=0.5
     EXPECT_EQ(state->getPosition(), 10.5);
 
-    // Finish via engine
-    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(true));
-    // Since we don't have a next track, it will stop or stay.
-    controller->updateTime(0.1);
-
     // Finish via time threshold
     state->setPosition(100.5);
-    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(false));
     // Should trigger handlePlaybackFinished because 100.5 + 1.0 > 100.0 + 1.0
     controller->updateTime(1.0);
 }
 
+TEST_F(PlaybackControllerTest, EndOfFileEventAdvancesOnce)
+{
+    auto t1 = std::make_shared<MediaFile>("/1.mp3");
+    auto t2 = std::make_shared<MediaFile>("/2.mp3");
+    controller->playContext({t1, t2}, 0);
+
+    // Frames before the event do not ask the engine
+    EXPECT_CALL(*mockEngine, isFinished()).Times(0);
+    controller->updateTime(0.1);
+    ::testing::Mock::VerifyAndClearExpectations(mockEngine.get());
+
+    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(true));
+    EXPECT_CALL(*mockEngine, play("/2.mp3")).WillOnce(Return(true));
+    controller->update(mockEngine.get());
+    EXPECT_EQ(state->getCurrentTrack(), t2);
+
+    // Further frames do not advance again
+    EXPECT_CALL(*mockEngine, isFinished()).Times(0);
+    EXPECT_CALL(*mockEngine, play(_)).Times(0);
+    controller->updateTime(0.1);
+}
+
+TEST_F(PlaybackControllerTest, ObservesEngineForItsLifetime)
+{
+    MockPlaybackEngine engine;
+    PlaybackState playbackState;
+    EXPECT_CALL(engine, attach(_));
+    auto observer = std::make_unique<PlaybackController>(&engine, &playbackState, nullptr);
+
+    EXPECT_CALL(engine, detach(observer.get()));
+    observer.reset();
+}
+
 TEST_F(PlaybackControllerTest, GlobalRepeatAllQueue)
 {
     auto t1 = std::make_shared<MediaFile>("/1.mp3");
@@ -287,10 +315,9 @@ TEST_F(PlaybackControllerTest, HandleFinishedRepeatOne)
     resetThrottle();
     EXPECT_CALL(*mockEngine, play("/1.mp3")).WillOnce(Return(true));
 
-    // Trigger handlePlaybackFinished directly via friend access if possible,
-    // or via updateTime with engine->isFinished()
+    // The engine's end-of-file event
     EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(true));
-    controller->updateTime(0.1);
+    controller->update(mockEngine.get());
 
     EXPECT_EQ(state->getCurrentTrack(), t1);
     EXPECT_EQ(state->getStatus(), PlaybackStatus::PLAYING);
@@ -370,8 +397,6 @@ TEST_F(PlaybackControllerTest, UpdateTimeZeroDuration)
     state->setDuration(0.0); // Unknown duration
     state->setPosition(0.0);
     
-    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(false));
-    
     // Should NOT trigger finish even if pos > 1.0 (condition is duration > 0)
     controller->updateTime(2.0); 
     // Position is clamped to duration (0.0) by PlaybackState
@@ -525,7 +550,6 @@ TEST_F(PlaybackControllerTest, UpdateTimeFallbackFinish)
     resetThrottle();
     
     // Next should be called
-    EXPECT_CALL(*mockEngine, isFinished()).WillOnce(Return(false));
     // expect next() call - hardest to verify directly without more mocks, 
     // but we can check if it attempts to play something else or logs "Playback finished"
     
@@ -541,3 +565,136 @@ TEST_F(PlaybackControllerTest, ToggleRepeatModeWithPlaylist)
     controller->toggleRepeatMode(); // NONE -> ONE
     EXPECT_EQ(playlist.getRepeatMode(), RepeatMode::ONE);
 }
+
+namespace
+{
+// Plays a queue of three tracks to the end, one frame at a time, and returns the silences between them
+std::vector<double> measureGaps(bool gapless, double loadLatency)
+{
+    SimulatedPlaybackEngine engine(loadLatency);
+    PlaybackState state;
+    PlaybackController controller(&engine, &state, nullptr);
+    controller.setGapless(gapless);
+
+    std::vector<std::shared_ptr<MediaFile>> queue;
+    for (int i = 1; i <= 3; ++i)
+    {
+        std::string path = "/" + std::to_string(i) + ".mp3";
+        MediaMetadata meta;
+        meta.duration = 12; // Tags round down; the audio runs a little longer
+        queue.push_back(std::make_shared<MediaFile>(path, meta));
+        engine.setTrackLength(path, 12.3);
+    }
+
+    controller.playContext(queue, 0);
+    const double frame = 1.0 / 60.0;
+    for (int i = 0; i < 60 * 45; ++i)
+    {
+        engine.advance(frame);
+        engine.dispatchEvents();
+        controller.updateTime(frame);
+    }
+
+    EXPECT_EQ(engine.getStarted(), (std::vector<std::string>{"/1.mp3", "/2.mp3", "/3.mp3"}));
+    return engine.getGaps();
+}
+} // namespace
+
+TEST_F(PlaybackControllerTest, GaplessRemovesSilenceBetweenTracks)
+{
+    const double loadLatency = 0.15;
+
+    auto withGaps = measureGaps(false, loadLatency);
+    ASSERT_EQ(withGaps.size(), 2u);
+    for (double gap : withGaps)
+    {
+        EXPECT_GE(gap, loadLatency);
+    }
+
+    auto gapless = measureGaps(true, loadLatency);
+    ASSERT_EQ(gapless.size(), 2u);
+    for (double gap : gapless)
+    {
+        EXPECT_NEAR(gap, 0.0, 1e-9);
+    }
+}
+
+TEST_F(PlaybackControllerTest, GaplessPreloadsUpcomingTrack)
+{
+    MediaMetadata meta;
+    meta.duration = 100;
+    auto t1 = std::make_shared<MediaFile>("/p1.mp3", meta);
+    auto t2 = std::make_shared<MediaFile>("/p2.mp3", meta);
+    Playlist playlist("Test");
+    playlist.addTrack(t1);
+    playlist.addTrack(t2);
+    playlist.setRepeatMode(RepeatMode::NONE);
+    controller->setCurrentPlaylist(&playlist);
+    controller->setGapless(true);
+
+    controller->play(t1);
+    state->setPosition(80.0);
+    EXPECT_CALL(*mockEngine, preloadNext(_)).Times(0);
+    controller->updateTime(1.0); // Not close enough to the end yet
+
+    EXPECT_CALL(*mockEngine, preloadNext("/p2.mp3")).WillOnce(Return(true));
+    controller->updateTime(10.0);
+    controller->updateTime(1.0); // Only once per track
+
+    // Nothing follows the last track of the playlist
+    resetThrottle();
+    controller->play(t2);
+    state->setPosition(95.0);
+    EXPECT_CALL(*mockEngine, clearPreload());
+    controller->updateTime(1.0);
+
+    // Repeat one preloads the same track again
+    controller->setRepeatMode(RepeatMode::ONE);
+    EXPECT_CALL(*mockEngine, preloadNext("/p2.mp3")).WillOnce(Return(true));
+    controller->updateTime(1.0);
+
+    // Turning gapless off drops the preload
+    EXPECT_CALL(*mockEngine, clearPreload());
+    controller->setGapless(false);
+    controller->updateTime(1.0);
+}
+
+TEST_F(PlaybackControllerTest, GaplessPreloadFollowsQueueAndPlaylistEdits)
+{
+    MediaMetadata meta;
+    meta.duration = 100;
+    auto t1 = std::make_shared<MediaFile>("/e1.mp3", meta);
+    auto t2 = std::make_shared<MediaFile>("/e2.mp3", meta);
+    auto t3 = std::make_shared<MediaFile>("/e3.mp3", meta);
+    controller->setGapless(true);
+
+    // Queue: the upcoming track is removed from the library after the preload
+    controller->playContext({t1, t2, t3}, 0);
+    state->setPosition(95.0);
+    EXPECT_CALL(*mockEngine, preloadNext("/e2.mp3")).WillOnce(Return(true));
+    controller->updateTime(1.0);
+    EXPECT_CALL(*mockEngine, preloadNext("/e3.mp3")).WillOnce(Return(true));
+    state->removeTrackFromQueue("/e2.mp3");
+    controller->updateTime(1.0);
+    controller->updateTime(1.0); // Nothing changed since
+
+    // Playlist: a track is inserted right after the current one
+    Playlist playlist("Edits");
+    playlist.addTrack(t1);
+    playlist.addTrack(t3);
+    controller->setCurrentPlaylist(&playlist);
+    resetThrottle();
+    controller->play(t1);
+    state->setPosition(95.0);
+    EXPECT_CALL(*mockEngine, preloadNext("/e3.mp3")).WillOnce(Return(true));
+    controller->updateTime(1.0);
+    EXPECT_CALL(*mockEngine, preloadNext("/e2.mp3")).WillOnce(Return(true));
+    playlist.insertTrack(t2, 1);
+    controller->updateTime(1.0);
+
+    // ...and removed again, leaving the last track next
+    EXPECT_CALL(*mockEngine, preloadNext("/e3.mp3")).WillOnce(Return(true));
+    playlist.removeTrackByPath("/e2.mp3");
+    controller->updateTime(1.0);
+    controller->setCurrentPlaylist(nullptr); // The playlist goes out of scope first
+}
@@ -33,4 +33,7 @@ TEST(PlaybackEngineInterfaceTest, DefaultVideoImplementations) {
     EXPECT_EQ(h, 0);
     
     engine.updateVideo(); // Should do nothing and not crash
+    engine.dispatchEvents();
+    EXPECT_FALSE(engine.preloadNext("/next.mp3"));
+    engine.clearPreload();
 }
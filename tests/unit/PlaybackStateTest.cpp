@@ -31,6 +31,24 @@ TEST(PlaybackStateTest, GetNextTrackAdvancesIndex)
     EXPECT_FALSE(state.hasNextTrack());
 }
 
+TEST(PlaybackStateTest, PeekNextTrackDoesNotAdvance)
+{
+    PlaybackState state;
+    EXPECT_EQ(state.peekNextTrack(), nullptr);
+
+    std::vector<std::shared_ptr<MediaFile>> queue;
+    queue.push_back(std::make_shared<MediaFile>("1.mp3"));
+    queue.push_back(std::make_shared<MediaFile>("2.mp3"));
+    state.setPlayQueue(queue);
+
+    EXPECT_EQ(state.peekNextTrack(), queue[0]);
+    EXPECT_EQ(state.peekNextTrack(), queue[0]);
+    state.getNextTrack();
+    EXPECT_EQ(state.peekNextTrack(), queue[1]);
+    state.getNextTrack();
+    EXPECT_EQ(state.peekNextTrack(), nullptr);
+}
+
 TEST(PlaybackStateTest, BackStackLogic)
 {
     PlaybackState state;
@@ -168,3 +186,22 @@ TEST(PlaybackStateTest, SetPlaybackEmptyPath)
     state.setPlayback(t, PlaybackStatus::PLAYING);
     EXPECT_EQ(state.getCurrentTrack(), t);
 }
+
+TEST(PlaybackStateTest, RemoveTrackFromQueueKeepsPosition)
+{
+    PlaybackState state;
+    auto t1 = std::make_shared<MediaFile>("1.mp3");
+    auto t2 = std::make_shared<MediaFile>("2.mp3");
+    auto t3 = std::make_shared<MediaFile>("3.mp3");
+    state.setPlayQueue({t1, t2, t3, t2});
+    state.setQueueIndex(2); // 3.mp3 is next
+    size_t revision = state.getQueueRevision();
+
+    state.removeTrackFromQueue("missing.mp3");
+    EXPECT_EQ(state.getQueueRevision(), revision);
+
+    state.removeTrackFromQueue("2.mp3"); // Once before and once after the position
+    EXPECT_NE(state.getQueueRevision(), revision);
+    EXPECT_EQ(state.getNextTrack(), t3);
+    EXPECT_EQ(state.getNextTrack(), nullptr);
+}
@@ -80,6 +80,19 @@ TEST_F(PlaylistControllerTest, AddToPlaylistSuccess)
     EXPECT_EQ(pl->getTracks()[0]->getPath(), "/song.mp3");
 }
 
+TEST_F(PlaylistControllerTest, AddTrackToPlaylistOutsideLibrary)
+{
+    controller->createPlaylist("Mix");
+    auto track = std::make_shared<MediaFile>("/history/only.mp3");
+
+    EXPECT_TRUE(controller->addTrackToPlaylist("Mix", track));
+    EXPECT_FALSE(controller->addTrackToPlaylist("Mix", track)); // Already there
+    EXPECT_FALSE(controller->addTrackToPlaylist("Ghost", track));
+    EXPECT_FALSE(controller->addTrackToPlaylist("Mix", nullptr));
+    EXPECT_TRUE(controller->getPlaylist("Mix")->contains("/history/only.mp3"));
+    EXPECT_FALSE(library->contains("/history/only.mp3"));
+}
+
 TEST_F(PlaylistControllerTest, ShufflePlaylistChangesOrder)
 {
     controller->createPlaylist("ShuffleMe");
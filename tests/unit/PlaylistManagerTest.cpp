@@ -1,4 +1,5 @@
 #include "app/model/PlaylistManager.h"
+#include "tests/mocks/MemoryPersistence.h"
 #include "tests/mocks/MockPersistence.h"
 #include <gtest/gtest.h>
 
@@ -193,3 +194,75 @@ TEST_F(PlaylistManagerTest, MigrationEdgeCases)
     PlaylistManager pm(mockPersist.get());
     EXPECT_TRUE(pm.loadAll());
 }
+
+TEST_F(PlaylistManagerTest, JournalRecordsChangesAndReplays)
+{
+    MemoryPersistence disk;
+    {
+        PlaylistManager pm(&disk);
+        pm.enableJournal();
+        pm.createPlaylist("Road");
+        pm.createPlaylist("Gym");
+        EXPECT_TRUE(pm.addTrackTo("Road", std::make_shared<MediaFile>("/a.mp3")));
+        EXPECT_TRUE(pm.addTrackTo("Road", std::make_shared<MediaFile>("/b.mp3")));
+        EXPECT_TRUE(pm.addTrackTo("Gym", std::make_shared<MediaFile>("/b.mp3")));
+        EXPECT_FALSE(pm.addTrackTo("Ghost", std::make_shared<MediaFile>("/b.mp3")));
+        EXPECT_TRUE(pm.removeTrackAt("Road", 0));
+        EXPECT_EQ(pm.removeTrackFromAll("/b.mp3"), 2);
+        EXPECT_TRUE(pm.addTrackTo("Gym", std::make_shared<MediaFile>("/c.mp3")));
+        EXPECT_TRUE(pm.renamePlaylist("Gym", "Run"));
+        EXPECT_TRUE(pm.deletePlaylist("Road"));
+    }
+    EXPECT_EQ(disk.saveCount(), 0);
+
+    PlaylistManager restored(&disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.loadAll());
+    EXPECT_FALSE(restored.exists("Road"));
+    EXPECT_FALSE(restored.exists("Gym"));
+    ASSERT_TRUE(restored.exists("Run"));
+    ASSERT_EQ(restored.getPlaylist("Run")->size(), 1);
+    EXPECT_EQ(restored.getPlaylist("Run")->getTrack(0)->getPath(), "/c.mp3");
+    EXPECT_TRUE(restored.exists("Now Playing"));
+    EXPECT_TRUE(restored.exists("Favorites"));
+}
+
+TEST_F(PlaylistManagerTest, JournalRecordsRemovalsByIndex)
+{
+    MemoryPersistence disk;
+    std::string journal;
+    {
+        PlaylistManager pm(&disk);
+        pm.enableJournal();
+        pm.createPlaylist("Road");
+        pm.addTrackTo("Road", std::make_shared<MediaFile>("/a.mp3"));
+        pm.addTrackTo("Road", std::make_shared<MediaFile>("/b.mp3"));
+        pm.addTrackTo("Road", std::make_shared<MediaFile>("/c.mp3"));
+        EXPECT_TRUE(pm.removeTrackAt("Road", 1));
+        journal = disk.contents("data/playlists.journal");
+        EXPECT_NE(journal.find("\"index\":1"), std::string::npos);
+
+        // Fold the journal into the base, then bring the same records back
+        ASSERT_TRUE(pm.saveAll());
+    }
+    disk.appendToFile("data/playlists.journal", journal);
+
+    PlaylistManager restored(&disk);
+    restored.enableJournal();
+    ASSERT_TRUE(restored.loadAll());
+    auto road = restored.getPlaylist("Road");
+    ASSERT_EQ(road->size(), 2);
+    EXPECT_EQ(road->getTrack(0)->getPath(), "/a.mp3");
+    EXPECT_EQ(road->getTrack(1)->getPath(), "/c.mp3");
+}
+
+TEST_F(PlaylistManagerTest, RemoveTrackFromAllRewritesWithoutJournal)
+{
+    MemoryPersistence disk;
+    PlaylistManager pm(&disk);
+    pm.addTrackTo("Favorites", std::make_shared<MediaFile>("/a.mp3"));
+    EXPECT_EQ(pm.removeTrackFromAll("/a.mp3"), 1);
+    EXPECT_EQ(disk.saveCount(), 1);
+    EXPECT_EQ(pm.removeTrackFromAll("/a.mp3"), 0);
+    EXPECT_EQ(disk.saveCount(), 1);
+}
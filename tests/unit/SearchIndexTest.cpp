@@ -0,0 +1,127 @@
+#include "app/model/SearchIndex.h"
+#include <gtest/gtest.h>
+
+class SearchIndexTest : public ::testing::Test
+{
+  protected:
+    SearchIndex index;
+
+    std::shared_ptr<MediaFile> makeTrack(const std::string &path, const std::string &title,
+                                         const std::string &artist = "", const std::string &album = "")
+    {
+        MediaMetadata meta;
+        meta.title = title;
+        meta.artist = artist;
+        meta.album = album;
+        return std::make_shared<MediaFile>(path, meta);
+    }
+
+    size_t documentSlots() const
+    {
+        return index.documents_.size();
+    }
+};
+
+TEST_F(SearchIndexTest, FindsSubstringCaseInsensitive)
+{
+    index.add(makeTrack("/1.mp3", "Bohemian Rhapsody", "Queen"));
+    index.add(makeTrack("/2.mp3", "Hey Jude", "The Beatles"));
+
+    auto results = index.search("RHAPS", {"title"});
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0]->getPath(), "/1.mp3");
+
+    EXPECT_EQ(index.search("beatles", {"artist"}).size(), 1);
+    EXPECT_TRUE(index.search("beatles", {"title"}).empty());
+}
+
+TEST_F(SearchIndexTest, TrigramsPresentButNotContiguousIsNoMatch)
+{
+    // The title holds every trigram of "abcab" ("abc", "bca", "cab") but not the substring itself
+    index.add(makeTrack("/1.mp3", "abc bca cab"));
+    EXPECT_TRUE(index.search("abcab", {"title"}).empty());
+    EXPECT_EQ(index.search("bca", {"title"}).size(), 1);
+}
+
+TEST_F(SearchIndexTest, ShortQueriesFallBackToScan)
+{
+    index.add(makeTrack("/1.mp3", "A"));
+    index.add(makeTrack("/2.mp3", "Xy"));
+
+    EXPECT_EQ(index.search("a", {"title"}).size(), 1);
+    EXPECT_EQ(index.search("XY", {"title"}).size(), 1);
+    EXPECT_TRUE(index.search("z", {"title"}).empty());
+}
+
+TEST_F(SearchIndexTest, ResultsKeepInsertionOrderWithoutDuplicates)
+{
+    index.add(makeTrack("/1.mp3", "Love", "", "Love Songs"));
+    index.add(makeTrack("/2.mp3", "Other", "", "Lovely"));
+    index.add(makeTrack("/3.mp3", "Lovesick"));
+
+    auto results = index.search("love", {"album", "title"});
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0]->getPath(), "/1.mp3");
+    EXPECT_EQ(results[1]->getPath(), "/2.mp3");
+    EXPECT_EQ(results[2]->getPath(), "/3.mp3");
+}
+
+TEST_F(SearchIndexTest, RemoveAndUpdate)
+{
+    auto a = makeTrack("/a.mp3", "First Song");
+    auto b = makeTrack("/b.mp3", "Second Song");
+    index.add(a);
+    index.add(b);
+
+    EXPECT_TRUE(index.remove(a.get()));
+    EXPECT_FALSE(index.remove(a.get()));
+    ASSERT_EQ(index.search("song", {"title"}).size(), 1);
+
+    MediaMetadata meta = b->getMetadata();
+    meta.title = "Renamed Track";
+    b->setMetadata(meta);
+    EXPECT_TRUE(index.update(b.get()));
+    EXPECT_TRUE(index.search("song", {"title"}).empty());
+    EXPECT_EQ(index.search("renamed", {"title"}).size(), 1);
+    EXPECT_FALSE(index.update(a.get()));
+}
+
+TEST_F(SearchIndexTest, UnknownFieldsAndEmptyQueryMatchNothing)
+{
+    index.add(makeTrack("/1.mp3", "Title"));
+    EXPECT_TRUE(index.search("title", {"unknown"}).empty());
+    EXPECT_TRUE(index.search("", {"title"}).empty());
+}
+
+TEST_F(SearchIndexTest, CompactionKeepsResultsAndOrder)
+{
+    std::vector<std::shared_ptr<MediaFile>> tracks;
+    for (int i = 0; i < 3000; ++i)
+    {
+        tracks.push_back(makeTrack("/" + std::to_string(i) + ".mp3", "Track " + std::to_string(i)));
+        index.add(tracks.back());
+    }
+    for (int i = 0; i < 3000; i += 3)
+    {
+        index.remove(tracks[i].get());
+        index.remove(tracks[i + 1].get());
+    }
+
+    EXPECT_EQ(index.size(), 1000);
+    EXPECT_LT(documentSlots(), 3000);
+
+    auto results = index.search("track", {"title"});
+    ASSERT_EQ(results.size(), 1000);
+    EXPECT_EQ(results.front()->getPath(), "/2.mp3");
+    EXPECT_EQ(results.back()->getPath(), "/2999.mp3");
+    // Live matches: 299, 2990, 2993, 2996, 2999
+    EXPECT_EQ(index.search("track 299", {"title"}).size(), 5);
+}
+
+TEST_F(SearchIndexTest, ClearDropsEverything)
+{
+    index.add(makeTrack("/1.mp3", "Title"));
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_TRUE(index.search("title", {"title"}).empty());
+}
@@ -177,8 +177,10 @@ TEST_F(TagLibMetadataReaderTest, ReadAlbumArtMP3)
 
     MediaMetadata meta = reader.readMetadata(artFile);
     EXPECT_TRUE(meta.hasAlbumArt);
-    EXPECT_EQ(meta.albumArtMimeType, "image/jpeg");
-    EXPECT_FALSE(meta.albumArtData.empty());
+    AlbumArt art;
+    ASSERT_TRUE(reader.readAlbumArt(artFile, art));
+    EXPECT_EQ(art.mimeType, "image/jpeg");
+    EXPECT_FALSE(art.data.empty());
 
     std::remove(artFile.c_str());
 }
@@ -210,8 +212,10 @@ TEST_F(TagLibMetadataReaderTest, ReadAlbumArtFLAC)
 
     MediaMetadata meta = reader.readMetadata(flacFile);
     EXPECT_TRUE(meta.hasAlbumArt);
-    EXPECT_EQ(meta.albumArtMimeType, "image/png");
-    EXPECT_FALSE(meta.albumArtData.empty());
+    AlbumArt art;
+    ASSERT_TRUE(reader.readAlbumArt(flacFile, art));
+    EXPECT_EQ(art.mimeType, "image/png");
+    EXPECT_FALSE(art.data.empty());
 
     std::remove(flacFile.c_str());
 }
@@ -238,3 +242,47 @@ TEST_F(TagLibMetadataReaderTest, WriteMetadataSaveFailure)
 
     std::remove(roFile.c_str());
 }
+
+TEST_F(TagLibMetadataReaderTest, TagsOnlyModeSkipsPropertiesAndArt)
+{
+    std::string artFile = "tests/assets/tags_only.mp3";
+    std::ifstream src(validMp3, std::ios::binary);
+    std::ofstream dst(artFile, std::ios::binary);
+    dst << src.rdbuf();
+    src.close();
+    dst.close();
+
+    TagLib::MPEG::File f(artFile.c_str());
+    TagLib::ID3v2::Tag *tag = f.ID3v2Tag(true);
+    tag->setTitle("Tagged");
+    TagLib::ID3v2::AttachedPictureFrame *frame = new TagLib::ID3v2::AttachedPictureFrame();
+    frame->setMimeType("image/jpeg");
+    frame->setPicture("fake_jpeg_data");
+    tag->addFrame(frame);
+    f.save();
+
+    TagLibMetadataReader tagsOnly(TagLibMetadataReader::ReadMode::TAGS_ONLY);
+    EXPECT_EQ(tagsOnly.getReadMode(), TagLibMetadataReader::ReadMode::TAGS_ONLY);
+    MediaMetadata light = tagsOnly.readMetadata(artFile);
+    EXPECT_EQ(light.title, "Tagged");
+    EXPECT_EQ(light.codec, "MP3");
+    EXPECT_EQ(light.bitrate, 0);
+    EXPECT_EQ(light.sampleRate, 0);
+    EXPECT_FALSE(light.hasAlbumArt);
+
+    // The default full mode reads properties and notes the cover from the same single open
+    MediaMetadata full = reader.readMetadata(artFile);
+    EXPECT_EQ(full.title, "Tagged");
+    EXPECT_GT(full.sampleRate, 0);
+    EXPECT_TRUE(full.hasAlbumArt);
+
+    std::remove(artFile.c_str());
+}
+
+TEST_F(TagLibMetadataReaderTest, ReadAlbumArtMissing)
+{
+    AlbumArt art;
+    EXPECT_FALSE(reader.readAlbumArt(nonExistentFile, art));
+    EXPECT_FALSE(reader.readAlbumArt("tests/assets/video.mkv", art));
+    EXPECT_TRUE(art.data.empty());
+}
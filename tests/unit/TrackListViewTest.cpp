@@ -10,6 +10,7 @@
 #include "tests/mocks/MockPlaybackEngine.h"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -31,13 +32,23 @@ class TestTrackListView : public TrackListView
     using TrackListView::renderTrackListTable;
     using TrackListView::calculateMarqueeOffset;
     using TrackListView::isHoveredRow;
-    
+    using TrackListView::popupRow_;
+
+    std::vector<size_t> renderedRows;
+
     void setControllers(ITrackListController* list, PlaybackController* play, PlaylistManager* pl) {
         listController_ = list;
         playbackController_ = play;
         playlistManager_ = pl;
     }
 
+    void renderTrackRow(const std::vector<std::shared_ptr<MediaFile>> &tracks, size_t i,
+                        const std::string &currentPath) override
+    {
+        renderedRows.push_back(i);
+        TrackListView::renderTrackRow(tracks, i, currentPath);
+    }
+
     void render() override {}
     void handleInput() override {}
     void update(void *) override {}
@@ -235,3 +246,45 @@ TEST_F(TrackListViewTest, PlayTrackOnClick)
     view->renderTrackListTable(testTracks);
     endFrame();
 }
+
+TEST_F(TrackListViewTest, RendersOnlyVisibleRows)
+{
+    std::vector<std::shared_ptr<MediaFile>> manyTracks;
+    for (int i = 0; i < 10000; ++i)
+    {
+        manyTracks.push_back(std::make_shared<MediaFile>("/many/track" + std::to_string(i) + ".mp3"));
+    }
+    manyTracks[3] = nullptr;
+
+    startFrame();
+    ImGui::SetNextWindowSize(ImVec2(800, 600));
+    ImGui::Begin("Library");
+    view->renderTrackListTable(manyTracks);
+    ImGui::End();
+    endFrame();
+
+    EXPECT_FALSE(view->renderedRows.empty());
+    EXPECT_LT(view->renderedRows.size(), 100u);
+    EXPECT_EQ(view->renderedRows.front(), 0u);
+}
+
+TEST_F(TrackListViewTest, RowWithOpenPopupStaysRendered)
+{
+    std::vector<std::shared_ptr<MediaFile>> manyTracks;
+    for (int i = 0; i < 10000; ++i)
+    {
+        manyTracks.push_back(std::make_shared<MediaFile>("/many/track" + std::to_string(i) + ".mp3"));
+    }
+    view->popupRow_ = 5000;
+
+    startFrame();
+    ImGui::SetNextWindowSize(ImVec2(800, 600));
+    ImGui::Begin("Library");
+    view->renderTrackListTable(manyTracks);
+    ImGui::End();
+    endFrame();
+
+    EXPECT_NE(std::find(view->renderedRows.begin(), view->renderedRows.end(), 5000u), view->renderedRows.end());
+    // The popup is not actually open, so the row is let go
+    EXPECT_EQ(view->popupRow_, -1);
+}
@@ -0,0 +1,99 @@
+#include "app/view/components/TrackRowCache.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class TrackRowCacheTest : public ::testing::Test
+{
+  protected:
+    TrackRowCache cache;
+
+    static std::shared_ptr<MediaFile> makeTrack(const std::string &path, const std::string &artist = "",
+                                                int duration = 0)
+    {
+        MediaMetadata meta;
+        meta.artist = artist;
+        meta.duration = duration;
+        return std::make_shared<MediaFile>(path, meta);
+    }
+};
+
+TEST_F(TrackRowCacheTest, FormatsRowText)
+{
+    auto track = makeTrack("/music/y2mate.com - Song.flac", "Artist", 185);
+    const auto &row = cache.get(track);
+
+    EXPECT_EQ(row.title, "Song");
+    EXPECT_EQ(row.artist, "Artist");
+    EXPECT_EQ(row.album, "Unknown Album");
+    EXPECT_EQ(row.subtitle, "Artist • Unknown Album");
+    EXPECT_EQ(row.format, "FLAC");
+    EXPECT_EQ(row.durationText, "3:05");
+    EXPECT_TRUE(row.sizeText.empty()); // No such file
+    EXPECT_EQ(row.titleFont, nullptr);
+}
+
+TEST_F(TrackRowCacheTest, SizeComesFromFingerprintWithoutStat)
+{
+    auto track = makeTrack("/music/missing.mp3");
+    FileFingerprint fingerprint;
+    fingerprint.size = 3 * 1024 * 1024;
+    fingerprint.inode = 1;
+    track->setFingerprint(fingerprint);
+
+    EXPECT_EQ(cache.get(track).sizeText, "3.00 MB");
+}
+
+TEST_F(TrackRowCacheTest, SizeFallsBackToFile)
+{
+    std::string path = "tests/assets/temp_track_row_cache.mp3";
+    fs::create_directories("tests/assets");
+    std::ofstream(path) << std::string(2048, 'x');
+
+    auto track = makeTrack(path);
+    EXPECT_EQ(cache.get(track).sizeText, "2.00 KB");
+    fs::remove(path);
+}
+
+TEST_F(TrackRowCacheTest, ReusesRowUntilMetadataChanges)
+{
+    auto track = makeTrack("/music/song.mp3", "Old");
+    auto *first = &cache.get(track);
+    first->titleWidth = 42.0f;
+    first->titleFont = reinterpret_cast<const ImFont *>(first);
+
+    EXPECT_EQ(&cache.get(track), first);
+    EXPECT_EQ(cache.get(track).titleWidth, 42.0f);
+
+    MediaMetadata meta;
+    meta.title = "New Title";
+    meta.artist = "New";
+    track->setMetadata(meta);
+
+    const auto &row = cache.get(track);
+    EXPECT_EQ(row.title, "New Title");
+    EXPECT_EQ(row.subtitle, "New • Unknown Album");
+    EXPECT_EQ(row.titleFont, nullptr); // Measured again
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(TrackRowCacheTest, DropsRowsOfDeletedTracksWhenFull)
+{
+    TrackRowCache small(2);
+    auto kept = makeTrack("/music/kept.mp3");
+    small.get(kept);
+    {
+        auto gone = makeTrack("/music/gone.mp3");
+        small.get(gone);
+    }
+    auto added = makeTrack("/music/added.mp3");
+    small.get(added);
+
+    EXPECT_EQ(small.size(), 2u);
+    EXPECT_EQ(small.get(kept).title, "kept");
+    EXPECT_EQ(small.get(added).title, "added");
+}
@@ -0,0 +1,99 @@
+#include "service/UnreadableFileCache.h"
+#include "tests/mocks/MemoryPersistence.h"
+#include "tests/mocks/MockFileSystem.h"
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+
+class UnreadableFileCacheTest : public ::testing::Test
+{
+  protected:
+    MemoryPersistence persistence;
+    NiceMock<MockFileSystem> fileSystem;
+    FileFingerprint broken;
+
+    void SetUp() override
+    {
+        broken.size = 0;
+        broken.mtime = 42;
+        broken.inode = 7;
+    }
+
+    void statAs(const std::string &path, const FileFingerprint &fingerprint)
+    {
+        ON_CALL(fileSystem, getFingerprint(path, _))
+            .WillByDefault(DoAll(SetArgReferee<1>(fingerprint), Return(true)));
+    }
+};
+
+TEST_F(UnreadableFileCacheTest, RemembersUnchangedFiles)
+{
+    statAs("/music/empty.mp3", broken);
+    UnreadableFileCache cache(&persistence, &fileSystem);
+
+    EXPECT_FALSE(cache.isKnownUnreadable("/music/empty.mp3"));
+    cache.markUnreadable("/music/empty.mp3");
+    EXPECT_TRUE(cache.isKnownUnreadable("/music/empty.mp3"));
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(UnreadableFileCacheTest, ChangedFileIsReadAgain)
+{
+    statAs("/music/empty.mp3", broken);
+    UnreadableFileCache cache(&persistence, &fileSystem);
+    cache.markUnreadable("/music/empty.mp3");
+
+    FileFingerprint rewritten = broken;
+    rewritten.size = 4096;
+    statAs("/music/empty.mp3", rewritten);
+    EXPECT_FALSE(cache.isKnownUnreadable("/music/empty.mp3"));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(UnreadableFileCacheTest, FilesThatCannotBeStatedAreNotRecorded)
+{
+    ON_CALL(fileSystem, getFingerprint(_, _)).WillByDefault(Return(false));
+    UnreadableFileCache cache(&persistence, &fileSystem);
+
+    cache.markUnreadable("/gone.mp3");
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(UnreadableFileCacheTest, SurvivesRestart)
+{
+    statAs("/music/empty.mp3", broken);
+    {
+        UnreadableFileCache cache(&persistence, &fileSystem);
+        cache.markUnreadable("/music/empty.mp3");
+        ASSERT_TRUE(cache.save());
+    }
+
+    UnreadableFileCache reloaded(&persistence, &fileSystem);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_TRUE(reloaded.isKnownUnreadable("/music/empty.mp3"));
+}
+
+TEST_F(UnreadableFileCacheTest, SavesOnlyWhenChanged)
+{
+    statAs("/music/empty.mp3", broken);
+    UnreadableFileCache cache(&persistence, &fileSystem);
+    EXPECT_TRUE(cache.save());
+    EXPECT_FALSE(persistence.fileExists(UnreadableFileCache::DEFAULT_PATH));
+
+    cache.markUnreadable("/music/empty.mp3");
+    EXPECT_TRUE(cache.save());
+    EXPECT_TRUE(persistence.fileExists(UnreadableFileCache::DEFAULT_PATH));
+}
+
+TEST_F(UnreadableFileCacheTest, CorruptListIsIgnored)
+{
+    persistence.saveToFile(UnreadableFileCache::DEFAULT_PATH, "{not json");
+    UnreadableFileCache cache(&persistence, &fileSystem);
+
+    EXPECT_FALSE(cache.load());
+    EXPECT_EQ(cache.size(), 0u);
+}